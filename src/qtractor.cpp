@@ -26,6 +26,10 @@
 
 #include "qtractorPaletteForm.h"
 
+#include "qtractorRtAudit.h"
+
+#include "qtractorDspProfile.h"
+
 #include <QLibraryInfo>
 #include <QTranslator>
 #include <QLocale>
@@ -469,6 +473,10 @@ void stacktrace ( int signo )
 int main ( int argc, char **argv )
 {
 	Q_INIT_RESOURCE(qtractor);
+#ifdef CONFIG_RTAUDIT
+	qtractorRtAudit::init();
+#endif
+	qtractorDspProfile::calibrate();
 #ifdef CONFIG_STACKTRACE
 #if defined(__GNUC__) && defined(Q_OS_LINUX)
 	::signal(SIGILL,  stacktrace);
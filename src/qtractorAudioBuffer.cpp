@@ -22,12 +22,16 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioPeak.h"
+#include "qtractorAudioStretch.h"
+#include "qtractorAudioTranscode.h"
 
 #include "qtractorTimeStretcher.h"
 
 #include "qtractorSession.h"
 #include "qtractorAudioEngine.h"
 
+#include "qtractorTrace.h"
+
 #include <cmath>
 
 
@@ -35,6 +39,24 @@
 #define QTRACTOR_RAMP_LENGTH	32
 
 
+// Mix helpers: linear gain ramp or per-frame gain envelope.
+static inline void qtractorAudioBuffer_mixRamp (
+	float *pFrames, const float *pBuffer, int nframes,
+	float fGain, float fGainStep )
+{
+	for (int n = 0; n < nframes; ++n)
+		pFrames[n] += (fGain + float(n) * fGainStep) * pBuffer[n];
+}
+
+static inline void qtractorAudioBuffer_mixFades (
+	float *pFrames, const float *pBuffer, int nframes,
+	float fGain, const float *pfFades )
+{
+	for (int n = 0; n < nframes; ++n)
+		pFrames[n] += fGain * pfFades[n] * pBuffer[n];
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioBufferThread -- Ring-cache manager thread.
 //
@@ -150,6 +172,9 @@ void qtractorAudioBufferThread::run (void)
 
 	m_mutex.unlock();
 
+	// Give back our trace buffer, if any.
+	qtractorTrace::release();
+
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorAudioBufferThread[%p]::run(): stopped.", this);
 #endif
@@ -163,6 +188,7 @@ void qtractorAudioBufferThread::process (void)
 	unsigned int w = m_iSyncWrite;
 
 	while (r != w) {
+		qtractorTraceScope trace("Audio buffer", "refill");
 		m_ppSyncItems[r]->sync();
 		++r &= m_iSyncMask;
 		w = m_iSyncWrite;
@@ -239,6 +265,8 @@ qtractorAudioBuffer::qtractorAudioBuffer (
 	m_fPitchShift    = 1.0f;
 
 	m_pTimeStretcher = nullptr;
+	m_bStretchCache  = false;
+	m_bTranscodeCache = false;
 
 	m_fGain          = 1.0f;
 	m_fPanning       = 0.0f;
@@ -323,14 +351,51 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 
 	const unsigned int iSampleRate = pSession->sampleRate();
 
+	// Time-stretch engine mode flags...
+	const unsigned int iFlags = timeStretchFlags();
+
+	// Play from the pre-rendered time-stretch cache, if ready;
+	// otherwise it gets scheduled while we fall back to live...
+	QString sOpenFilename = sFilename;
+	m_bStretchCache = false;
+	if ((m_bTimeStretch || m_bPitchShift)
+		&& (iMode & qtractorAudioFile::Read)) {
+		qtractorAudioStretchFactory *pStretchFactory
+			= qtractorAudioStretchFactory::getInstance();
+		if (pStretchFactory && pStretchFactory->isEnabled()) {
+			const QString& sCacheName = pStretchFactory->cacheName(
+				sFilename, m_fTimeStretch, m_fPitchShift, iFlags);
+			if (!sCacheName.isEmpty()) {
+				sOpenFilename = sCacheName;
+				m_bStretchCache = true;
+			}
+		}
+	}
+
+	// Likewise, play compressed files from their transcoded (PCM)
+	// cache, if ready; otherwise keep decoding live meanwhile...
+	m_bTranscodeCache = false;
+	if (!m_bStretchCache && (iMode & qtractorAudioFile::Read)) {
+		qtractorAudioTranscodeFactory *pTranscodeFactory
+			= qtractorAudioTranscodeFactory::getInstance();
+		if (pTranscodeFactory && pTranscodeFactory->isEnabled()) {
+			const QString& sCacheName
+				= pTranscodeFactory->cacheName(sFilename);
+			if (!sCacheName.isEmpty()) {
+				sOpenFilename = sCacheName;
+				m_bTranscodeCache = true;
+			}
+		}
+	}
+
 	// Get proper file type class...
 	m_pFile = qtractorAudioFileFactory::createAudioFile(
-		sFilename, m_iChannels, iSampleRate);
+		sOpenFilename, m_iChannels, iSampleRate);
 	if (m_pFile == nullptr)
 		return false;
 
 	// Go open it...
-	if (!m_pFile->open(sFilename, iMode)) {
+	if (!m_pFile->open(sOpenFilename, iMode)) {
 		delete m_pFile;
 		m_pFile = nullptr;
 		return false;
@@ -397,12 +462,7 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 		m_ppFrames[i] = new float [m_iBufferSize];
 
 	// Allocate time-stretch engine whether needed...
-	if (m_bTimeStretch || m_bPitchShift) {
-		unsigned int iFlags = qtractorTimeStretcher::None;
-		if (m_bWsolaTimeStretch)
-			iFlags |= qtractorTimeStretcher::WsolaTimeStretch;
-		if (m_bWsolaQuickSeek)
-			iFlags |= qtractorTimeStretcher::WsolaQuickSeek;
+	if ((m_bTimeStretch || m_bPitchShift) && !m_bStretchCache) {
 		m_pTimeStretcher = new qtractorTimeStretcher(iBuffers, iSampleRate,
 			m_fTimeStretch, m_fPitchShift, iFlags, m_iBufferSize);
 	}
@@ -538,6 +598,9 @@ void qtractorAudioBuffer::close (void)
 	m_fNextGain = 0.0f;
 	m_iRampGain = 0;
 
+	m_bStretchCache = false;
+	m_bTranscodeCache = false;
+
 	m_pPeakFile = nullptr;
 }
 
@@ -698,7 +761,8 @@ int qtractorAudioBuffer::write ( float **ppFrames, unsigned int iFrames,
 
 // Special kind of super-read/channel-mix.
 int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
-	unsigned short iChannels, unsigned int iOffset, float fGain )
+	unsigned short iChannels, unsigned int iOffset, float fGain,
+	const float *pfFades )
 {
 	if (m_pRingBuffer == nullptr)
 		return -1;
@@ -740,7 +804,7 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 			const unsigned int ri = m_pRingBuffer->readIndex();
 			while (ri < le && ri + iFrames >= le && nread > 0) {
 				m_iRampGain = -1;
-				nread = readMixFrames(ppFrames, le - ri, iChannels, iOffset, fGain);
+				nread = readMixFrames(ppFrames, le - ri, iChannels, iOffset, fGain, pfFades);
 				iFrames -= nread;
 				iOffset += nread;
 				ro = m_iOffset + ls;
@@ -751,7 +815,7 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 			le += m_iOffset;
 			while (le >= ro && ro + iFrames >= le && nread > 0) {
 				m_iRampGain = -1;
-				nread = readMixFrames(ppFrames, le - ro, iChannels, iOffset, fGain);
+				nread = readMixFrames(ppFrames, le - ro, iChannels, iOffset, fGain, pfFades);
 				iFrames -= nread;
 				iOffset += nread;
 				ro = ls;
@@ -765,7 +829,7 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 		m_iRampGain = -1;
 
 	// Mix the (remaining) data around...
-	nread = readMixFrames(ppFrames, iFrames, iChannels, iOffset, fGain);
+	nread = readMixFrames(ppFrames, iFrames, iChannels, iOffset, fGain, pfFades);
 	m_iReadOffset = (ro + nread);
 	if (m_iReadOffset >= re) {
 		// Force out-of-sync...
@@ -1305,7 +1369,7 @@ int qtractorAudioBuffer::writeBuffer ( unsigned int iFrames )
 // Special kind of super-read/channel-mix buffer helper.
 int qtractorAudioBuffer::readMixFrames (
 	float **ppFrames, unsigned int iFrames, unsigned short iChannels,
-	unsigned int iOffset, float fGain )
+	unsigned int iOffset, float fGain, const float *pfFades )
 {
 	if (iFrames == 0)
 		return 0;
@@ -1317,8 +1381,8 @@ int qtractorAudioBuffer::readMixFrames (
 	const unsigned short iBuffers = m_pRingBuffer->channels();
 
 	unsigned short i, j; int n;
-	float fGainIter, fGainStep1, fGainStep2;
-	float *pFrames, *pBuffer;
+	float fGainIter, fGainStep1;
+	float *pBuffer;
 
 	// HACK: Case of clip ramp in/out-set in this run...
 	if (m_iRampGain) {
@@ -1338,6 +1402,38 @@ int qtractorAudioBuffer::readMixFrames (
 	//	fPrevGain = fGain;
 	}
 
+	// Per-frame gains (fade envelope) in this run?
+	if (pfFades) {
+		pfFades += iOffset;
+		const float fNextGain = m_fGain * fGain;
+		m_fNextGain = fNextGain * pfFades[nread - 1];
+		if (iChannels == iBuffers) {
+			for (i = 0; i < iBuffers; ++i) {
+				qtractorAudioBuffer_mixFades(ppFrames[i] + iOffset,
+					m_ppBuffer[i], nread, fNextGain * m_pfGains[i], pfFades);
+			}
+		}
+		else if (iChannels > iBuffers) {
+			j = 0;
+			for (i = 0; i < iChannels; ++i) {
+				qtractorAudioBuffer_mixFades(ppFrames[i] + iOffset,
+					m_ppBuffer[j], nread, fNextGain * m_pfGains[j], pfFades);
+				if (++j >= iBuffers)
+					j = 0;
+			}
+		}
+		else { // (iChannels < iBuffers)
+			i = 0;
+			for (j = 0; j < iBuffers; ++j) {
+				qtractorAudioBuffer_mixFades(ppFrames[i] + iOffset,
+					m_ppBuffer[j], nread, fNextGain * m_pfGains[j], pfFades);
+				if (++i >= iChannels)
+					i = 0;
+			}
+		}
+		return nread;
+	}
+
 	// Reset running gain...
 	const float fNextGain = m_fGain * fGain;
 	const float fPrevGain = (m_fNextGain < 1E-9f ? fNextGain : m_fNextGain);
@@ -1346,23 +1442,17 @@ int qtractorAudioBuffer::readMixFrames (
 
 	if (iChannels == iBuffers) {
 		for (i = 0; i < iBuffers; ++i) {
-			pFrames = ppFrames[i] + iOffset;
-			pBuffer = m_ppBuffer[i];
-			fGainIter = fPrevGain * m_pfGains[i];
-			fGainStep2 = fGainStep1 * m_pfGains[i];
-			for (n = 0; n < nread; ++n, fGainIter += fGainStep2)
-				*pFrames++ += fGainIter * *pBuffer++;
+			qtractorAudioBuffer_mixRamp(ppFrames[i] + iOffset,
+				m_ppBuffer[i], nread, fPrevGain * m_pfGains[i],
+				fGainStep1 * m_pfGains[i]);
 		}
 	}
 	else if (iChannels > iBuffers) {
 		j = 0;
 		for (i = 0; i < iChannels; ++i) {
-			pFrames = ppFrames[i] + iOffset;
-			pBuffer = m_ppBuffer[j];
-			fGainIter = fPrevGain * m_pfGains[j];
-			fGainStep2 = fGainStep1 * m_pfGains[j];
-			for (n = 0; n < nread; ++n, fGainIter += fGainStep2)
-				*pFrames++ += fGainIter * *pBuffer++;
+			qtractorAudioBuffer_mixRamp(ppFrames[i] + iOffset,
+				m_ppBuffer[j], nread, fPrevGain * m_pfGains[j],
+				fGainStep1 * m_pfGains[j]);
 			if (++j >= iBuffers)
 				j = 0;
 		}
@@ -1370,12 +1460,9 @@ int qtractorAudioBuffer::readMixFrames (
 	else { // (iChannels < iBuffers)
 		i = 0;
 		for (j = 0; j < iBuffers; ++j) {
-			pFrames = ppFrames[i] + iOffset;
-			pBuffer = m_ppBuffer[j];
-			fGainIter = fPrevGain * m_pfGains[j];
-			fGainStep2 = fGainStep1 * m_pfGains[j];
-			for (n = 0; n < nread; ++n, fGainIter += fGainStep2)
-				*pFrames++ += fGainIter * *pBuffer++;
+			qtractorAudioBuffer_mixRamp(ppFrames[i] + iOffset,
+				m_ppBuffer[j], nread, fPrevGain * m_pfGains[j],
+				fGainStep1 * m_pfGains[j]);
 			if (++i >= iChannels)
 				i = 0;
 		}
@@ -1460,7 +1547,7 @@ unsigned long qtractorAudioBuffer::framesIn ( unsigned long iFrames ) const
 		iFrames = (unsigned long) (float(iFrames) * m_fResampleRatio);
 #endif
 
-	if (m_bTimeStretch)
+	if (m_bTimeStretch && !m_bStretchCache)
 		iFrames = (unsigned long) (float(iFrames) * m_fTimeStretch);
 
 	return iFrames;
@@ -1473,7 +1560,7 @@ unsigned long qtractorAudioBuffer::framesOut ( unsigned long iFrames ) const
 		iFrames = (unsigned long) (float(iFrames) / m_fResampleRatio);
 #endif
 
-	if (m_bTimeStretch)
+	if (m_bTimeStretch && !m_bStretchCache)
 		iFrames = (unsigned long) (float(iFrames) / m_fTimeStretch);
 
 	return iFrames;
@@ -1618,6 +1705,20 @@ bool qtractorAudioBuffer::isPitchShift (void) const
 }
 
 
+// Whether playing from a pre-rendered time-stretch cache file.
+bool qtractorAudioBuffer::isStretchCache (void) const
+{
+	return m_bStretchCache;
+}
+
+
+// Whether playing from a transcoded (PCM) cache file.
+bool qtractorAudioBuffer::isTranscodeCache (void) const
+{
+	return m_bTranscodeCache;
+}
+
+
 // Internal peak descriptor accessors.
 void qtractorAudioBuffer::setPeakFile ( qtractorAudioPeakFile *pPeakFile )
 {
@@ -1659,6 +1760,19 @@ bool qtractorAudioBuffer::isWsolaQuickSeek (void) const
 }
 
 
+// Time-stretch engine mode flags (as of local options).
+unsigned int qtractorAudioBuffer::timeStretchFlags (void) const
+{
+	unsigned int iFlags = qtractorTimeStretcher::None;
+	if (m_bWsolaTimeStretch)
+		iFlags |= qtractorTimeStretcher::WsolaTimeStretch;
+	if (m_bWsolaQuickSeek)
+		iFlags |= qtractorTimeStretcher::WsolaQuickSeek;
+
+	return iFlags;
+}
+
+
 // Sample-rate converter type (global option).
 int qtractorAudioBuffer::g_iDefaultResampleType = 2;	// SRC_SINC_FASTEST;
 
@@ -132,9 +132,11 @@ public:
 	int write(float **ppFrames, unsigned int iFrames,
 		unsigned short iChannels = 0, unsigned int iOffset = 0);
 
-	// Special kind of super-read/channel-mix.
+	// Special kind of super-read/channel-mix; optional per-frame
+	// gains (fade envelope) are indexed as the output frames are.
 	int readMix(float **ppFrames, unsigned int iFrames,
-		unsigned short iChannels, unsigned int iOffset, float fGain);
+		unsigned short iChannels, unsigned int iOffset, float fGain,
+		const float *pfFades = nullptr);
 
 	// Buffer data seek.
 	bool seek(unsigned long iFrame);
@@ -177,6 +179,12 @@ public:
 	float pitchShift() const;
 	bool isPitchShift() const;
 
+	// Whether playing from a pre-rendered time-stretch cache file.
+	bool isStretchCache() const;
+
+	// Whether playing from a transcoded (PCM) cache file.
+	bool isTranscodeCache() const;
+
 	// Sync thread state flags accessors.
 	enum SyncFlag { InitSync = 1, ReadSync = 2, WaitSync = 4, CloseSync = 8 };
 
@@ -207,6 +215,9 @@ public:
 	void setWsolaQuickSeek(bool bWsolaQuickSeek);
 	bool isWsolaQuickSeek() const;
 
+	// Time-stretch engine mode flags (as of local options).
+	unsigned int timeStretchFlags() const;
+
 	// WSOLA time-stretch modes (global options).
 	static void setDefaultWsolaTimeStretch(bool bWsolaTimeStretch);
 	static bool isDefaultWsolaTimeStretch();
@@ -239,7 +250,8 @@ protected:
 
 	// Special kind of super-read/channel-mix buffer helper.
 	int readMixFrames(float **ppFrames, unsigned int iFrames,
-		unsigned short iChannels, unsigned int iOffset, float fGain);
+		unsigned short iChannels, unsigned int iOffset, float fGain,
+		const float *pfFades);
 
 	// I/O buffer release.
 	void deleteIOBuffers();
@@ -290,6 +302,9 @@ private:
 
 	qtractorTimeStretcher *m_pTimeStretcher;
 
+	bool           m_bStretchCache;
+	bool           m_bTranscodeCache;
+
 	float          m_fGain;
 	float          m_fPanning;
 
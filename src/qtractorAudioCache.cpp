@@ -0,0 +1,687 @@
+// qtractorAudioCache.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioCache.h"
+#include "qtractorAudioSndFile.h"
+
+#include "qtractorSession.h"
+#include "qtractorAudioClip.h"
+
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <QCryptographicHash>
+
+#include <QThread>
+#include <QWaitCondition>
+
+
+// Audio file buffer size in frames per channel.
+static const unsigned int c_iAudioFrames = (32 * 1024);
+
+// Default cache temporary filename extension.
+static const QString c_sCacheTempExt = ".tmp";
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheThread -- Cache file rendering thread.
+//
+
+class qtractorAudioCacheThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioCacheThread(
+		qtractorAudioCacheFactory *pCacheFactory, unsigned int iSyncSize = 128);
+	// Destructor.
+	~qtractorAudioCacheThread();
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState);
+	bool runState() const;
+
+	// Wake from executive wait condition.
+	void sync(qtractorAudioCacheFile *pCacheFile = nullptr);
+
+	// Drop all pending items, waiting
+	// for any current rendering to finish.
+	void clear();
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+	void notifyCacheEvent() const;
+
+private:
+
+	// The owner factory reference.
+	qtractorAudioCacheFactory *m_pCacheFactory;
+
+	// The cache file queue instance reference.
+	unsigned int             m_iSyncSize;
+	unsigned int             m_iSyncMask;
+	qtractorAudioCacheFile **m_ppSyncItems;
+
+	volatile unsigned int    m_iSyncRead;
+	volatile unsigned int    m_iSyncWrite;
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+
+	// Held while consuming the queue.
+	QMutex m_render;
+};
+
+
+// Constructor.
+qtractorAudioCacheThread::qtractorAudioCacheThread (
+	qtractorAudioCacheFactory *pCacheFactory, unsigned int iSyncSize )
+	: m_pCacheFactory(pCacheFactory)
+{
+	m_iSyncSize = (64 << 1);
+	while (m_iSyncSize < iSyncSize)
+		m_iSyncSize <<= 1;
+	m_iSyncMask = (m_iSyncSize - 1);
+	m_ppSyncItems = new qtractorAudioCacheFile * [m_iSyncSize];
+	m_iSyncRead   = 0;
+	m_iSyncWrite  = 0;
+
+	::memset(m_ppSyncItems, 0,
+		m_iSyncSize * sizeof(qtractorAudioCacheFile *));
+
+	m_bRunState = false;
+}
+
+
+// Destructor.
+qtractorAudioCacheThread::~qtractorAudioCacheThread (void)
+{
+	delete [] m_ppSyncItems;
+}
+
+
+// Run state accessor.
+void qtractorAudioCacheThread::setRunState ( bool bRunState )
+{
+	m_bRunState = bRunState;
+}
+
+bool qtractorAudioCacheThread::runState (void) const
+{
+	return m_bRunState;
+}
+
+
+// Wake from executive wait condition.
+void qtractorAudioCacheThread::sync ( qtractorAudioCacheFile *pCacheFile )
+{
+	if (pCacheFile) {
+		// !pCacheFile->isWaitSync()
+		unsigned int n;
+		unsigned int r = m_iSyncRead;
+		unsigned int w = m_iSyncWrite;
+		if (w > r) {
+			n = ((r - w + m_iSyncSize) & m_iSyncMask) - 1;
+		} else if (r > w) {
+			n = (r - w) - 1;
+		} else {
+			n = m_iSyncSize - 1;
+		}
+		if (n > 0) {
+			pCacheFile->setWaitSync(true);
+			m_ppSyncItems[w] = pCacheFile;
+			m_iSyncWrite = (w + 1) & m_iSyncMask;
+		}
+	}
+
+	if (m_mutex.tryLock()) {
+		m_cond.wakeAll();
+		m_mutex.unlock();
+	}
+#ifdef CONFIG_DEBUG_0
+	else qDebug("qtractorAudioCacheThread[%p]::sync(): tryLock() failed.", this);
+#endif
+}
+
+
+// Drop all pending items.
+void qtractorAudioCacheThread::clear (void)
+{
+	QMutexLocker locker(&m_render);
+
+	unsigned int r = m_iSyncRead;
+	unsigned int w = m_iSyncWrite;
+	while (r != w) {
+		qtractorAudioCacheFile *pSyncItem = m_ppSyncItems[r];
+		if (pSyncItem)
+			pSyncItem->setWaitSync(false);
+		m_ppSyncItems[r] = nullptr;
+		++r &= m_iSyncMask;
+		w = m_iSyncWrite;
+	}
+	m_iSyncRead = r;
+}
+
+
+// The main thread executive cycle.
+void qtractorAudioCacheThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioCacheThread[%p]::run(): started...", this);
+#endif
+
+	m_mutex.lock();
+
+	m_bRunState = true;
+
+	while (m_bRunState) {
+		// Do whatever we must, then wait for more...
+		m_render.lock();
+		unsigned int r = m_iSyncRead;
+		unsigned int w = m_iSyncWrite;
+		while (m_bRunState && r != w) {
+			qtractorAudioCacheFile *pCacheFile = m_ppSyncItems[r];
+			if (pCacheFile && pCacheFile->isWaitSync()) {
+				const bool bRendered = pCacheFile->render(
+					&m_bRunState, m_pCacheFactory->quota());
+				pCacheFile->setWaitSync(false);
+				// Send notification event...
+				if (bRendered)
+					notifyCacheEvent();
+			}
+			m_ppSyncItems[r] = nullptr;
+			++r &= m_iSyncMask;
+			w = m_iSyncWrite;
+		}
+		m_iSyncRead = r;
+		m_render.unlock();
+		// Wait for sync...
+		if (m_bRunState)
+			m_cond.wait(&m_mutex);
+	}
+
+	m_mutex.unlock();
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioCacheThread[%p]::run(): stopped.\n", this);
+#endif
+}
+
+
+// Send notification event, someway...
+void qtractorAudioCacheThread::notifyCacheEvent (void) const
+{
+	if (m_bRunState)
+		m_pCacheFactory->notifyCacheEvent();
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheFile -- Background rendered cache file (base).
+//
+
+// Constructor.
+qtractorAudioCacheFile::qtractorAudioCacheFile ( const QString& sFilename,
+	const QString& sCacheKey, const QString& sCacheExt )
+{
+	// Initialize instance variables.
+	m_sFilename = sFilename;
+	m_sCacheExt = sCacheExt;
+
+	m_bWaitSync = false;
+	m_bFailed   = false;
+
+	// Set (unique) cache filename...
+	QDir dir;
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession)
+		dir.setPath(pSession->sessionDir());
+
+	const QFileInfo fileInfo(sFilename);
+	const QString& sCacheFilePrefix
+		= QFileInfo(dir, fileInfo.fileName()).filePath();
+	const QByteArray& aCacheHash = QCryptographicHash::hash(
+		sCacheKey.toUtf8(), QCryptographicHash::Sha1);
+	const QFileInfo cacheInfo(sCacheFilePrefix + '_'
+		+ QString::fromLatin1(aCacheHash.toHex())
+		+ sCacheExt);
+
+	m_sName = cacheInfo.absoluteFilePath();
+}
+
+
+// Default destructor.
+qtractorAudioCacheFile::~qtractorAudioCacheFile (void)
+{
+	cleanup();
+}
+
+
+// Source audio filename accessor.
+const QString& qtractorAudioCacheFile::filename (void) const
+{
+	return m_sFilename;
+}
+
+
+// Cache file name accessor.
+QString qtractorAudioCacheFile::name (void) const
+{
+	return m_sName;
+}
+
+
+// Whether the cache file is rendered and up-to-date.
+bool qtractorAudioCacheFile::isReady (void) const
+{
+	// Are we still waiting for its creation?
+	if (m_bWaitSync)
+		return false;
+
+	const QFileInfo fileInfo(m_sFilename);
+	const QFileInfo cacheInfo(m_sName);
+	return cacheInfo.exists()
+		&& cacheInfo.lastModified() >= fileInfo.lastModified();
+}
+
+
+// Whether the last rendering failed (eg. over quota).
+bool qtractorAudioCacheFile::isFailed (void) const
+{
+	return m_bFailed;
+}
+
+
+// Render the whole cache file (on the cache thread).
+bool qtractorAudioCacheFile::render (
+	volatile bool *pbRunState, unsigned long iQuota )
+{
+	qtractorAudioFile *pAudioFile
+		= qtractorAudioFileFactory::createAudioFile(m_sFilename);
+	if (pAudioFile == nullptr) {
+		m_bFailed = true;
+		return false;
+	}
+
+	if (!pAudioFile->open(m_sFilename)) {
+		delete pAudioFile;
+		m_bFailed = true;
+		return false;
+	}
+
+	const unsigned short iChannels = pAudioFile->channels();
+	const unsigned int iSampleRate = pAudioFile->sampleRate();
+	const int iSampleFormat = sampleFormat();
+
+	// Check whether it would fit the disk quota, if any...
+	if (iQuota > 0) {
+		const unsigned long long iSampleSize
+			= (iSampleFormat == SF_FORMAT_PCM_24 ? 3 : 4);
+		const unsigned long long iEstimate
+			= iSampleSize * iChannels * pAudioFile->frames();
+		const unsigned long long iUsage
+			= cacheUsage(QFileInfo(m_sName).absolutePath(), m_sCacheExt);
+		if (iUsage + iEstimate > (unsigned long long) iQuota << 20) {
+		#ifdef CONFIG_DEBUG
+			qDebug("qtractorAudioCacheFile[%p]::render(\"%s\")"
+				" over quota (%llu + %llu > %lu MB).", this,
+				m_sName.toUtf8().constData(), iUsage, iEstimate, iQuota);
+		#endif
+			pAudioFile->close();
+			delete pAudioFile;
+			m_bFailed = true;
+			return false;
+		}
+	}
+
+	// Rendered as given sample format, no dithering involved.
+	const QString& sTempName = m_sName + c_sCacheTempExt;
+	qtractorAudioSndFile *pCacheFile = new qtractorAudioSndFile(
+		iChannels, iSampleRate, c_iAudioFrames, SF_FORMAT_WAV | iSampleFormat);
+	if (!pCacheFile->open(sTempName, qtractorAudioFile::Write)) {
+		delete pCacheFile;
+		pAudioFile->close();
+		delete pAudioFile;
+		m_bFailed = true;
+		return false;
+	}
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioCacheFile[%p]::render(\"%s\") started...",
+		this, m_sName.toUtf8().constData());
+#endif
+
+	unsigned short i;
+	float **ppFrames = new float * [iChannels];
+	for (i = 0; i < iChannels; ++i)
+		ppFrames[i] = new float [c_iAudioFrames];
+
+	// Make sure audio file decoder makes no head-start...
+	pAudioFile->seek(0);
+
+	bool bResult = process(pAudioFile, pCacheFile,
+		ppFrames, c_iAudioFrames, pbRunState);
+
+	// Aborted?
+	if (!isRunState(pbRunState))
+		bResult = false;
+
+	for (i = 0; i < iChannels; ++i)
+		delete [] ppFrames[i];
+	delete [] ppFrames;
+
+	pCacheFile->close();
+	delete pCacheFile;
+
+	pAudioFile->close();
+	delete pAudioFile;
+
+	// Commit or discard the rendered file...
+	if (bResult) {
+		QFile::remove(m_sName);
+		bResult = QFile::rename(sTempName, m_sName);
+		m_bFailed = !bResult;
+	}
+
+	if (!bResult)
+		QFile::remove(sTempName);
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioCacheFile[%p]::render(\"%s\") done (%d).",
+		this, m_sName.toUtf8().constData(), int(bResult));
+#endif
+
+	return bResult;
+}
+
+
+// Physical removal.
+void qtractorAudioCacheFile::remove (void)
+{
+	QFile::remove(m_sName);
+}
+
+
+// Clean/close method.
+void qtractorAudioCacheFile::cleanup ( bool bAutoRemove )
+{
+	// Check if it's aborting (ought to be atomic)...
+	const bool bAborted = (m_bWaitSync || bAutoRemove);
+	m_bWaitSync = false;
+
+	// Physically remove the file if aborted...
+	if (bAborted)
+		remove();
+}
+
+
+// Sync thread state flags accessors.
+void qtractorAudioCacheFile::setWaitSync ( bool bWaitSync )
+{
+	m_bWaitSync = bWaitSync;
+}
+
+bool qtractorAudioCacheFile::isWaitSync (void) const
+{
+	return m_bWaitSync;
+}
+
+
+// Current cache disk usage (bytes), on a given directory.
+unsigned long long qtractorAudioCacheFile::cacheUsage (
+	const QString& sDir, const QString& sCacheExt )
+{
+	unsigned long long iUsage = 0;
+
+	const QDir dir(sDir);
+	const QFileInfoList& list = dir.entryInfoList(
+		QStringList() << ('*' + sCacheExt), QDir::Files);
+	QListIterator<QFileInfo> iter(list);
+	while (iter.hasNext())
+		iUsage += iter.next().size();
+
+	return iUsage;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheFactory -- Cache file factory (base).
+//
+
+// Constructor.
+qtractorAudioCacheFactory::qtractorAudioCacheFactory ( QObject *pParent )
+	: QObject(pParent), m_bEnabled(false), m_iQuota(0),
+		m_bAutoRemove(false), m_pCacheThread(nullptr)
+{
+}
+
+
+// Default destructor.
+qtractorAudioCacheFactory::~qtractorAudioCacheFactory (void)
+{
+	if (m_pCacheThread) {
+		if (m_pCacheThread->isRunning()) do {
+			m_pCacheThread->setRunState(false);
+		//	m_pCacheThread->terminate();
+			m_pCacheThread->sync();
+		} while (!m_pCacheThread->wait(100));
+		delete m_pCacheThread;
+		m_pCacheThread = nullptr;
+	}
+
+	cleanup();
+}
+
+
+// Enabled property.
+void qtractorAudioCacheFactory::setEnabled ( bool bEnabled )
+{
+	m_bEnabled = bEnabled;
+}
+
+bool qtractorAudioCacheFactory::isEnabled (void) const
+{
+	return m_bEnabled;
+}
+
+
+// Disk quota property (MB; 0 = unlimited).
+void qtractorAudioCacheFactory::setQuota ( unsigned long iQuota )
+{
+	m_iQuota = iQuota;
+}
+
+unsigned long qtractorAudioCacheFactory::quota (void) const
+{
+	return m_iQuota;
+}
+
+
+// Auto-delete property.
+void qtractorAudioCacheFactory::setAutoRemove ( bool bAutoRemove )
+{
+	m_bAutoRemove = bAutoRemove;
+}
+
+bool qtractorAudioCacheFactory::isAutoRemove (void) const
+{
+	return m_bAutoRemove;
+}
+
+
+// Ready cache file name, if any; otherwise schedule its rendering.
+QString qtractorAudioCacheFactory::readyName (
+	qtractorAudioCacheFile *pCacheFile )
+{
+	if (pCacheFile->isReady())
+		return pCacheFile->name();
+
+	if (m_pCacheThread == nullptr) {
+		m_pCacheThread = new qtractorAudioCacheThread(this);
+		m_pCacheThread->start(QThread::LowPriority);
+	}
+
+	// Not there yet, render it in the background,
+	// unless it has failed already (eg. over quota)...
+	if (!pCacheFile->isWaitSync() && !pCacheFile->isFailed())
+		sync(pCacheFile);
+
+	return QString();
+}
+
+
+// Whether a ready cache file exists (no scheduling).
+bool qtractorAudioCacheFactory::isCacheReady ( const QString& sCacheKey )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (!m_bEnabled)
+		return false;
+
+	qtractorAudioCacheFile *pCacheFile = m_files.value(sCacheKey);
+
+	return (pCacheFile && pCacheFile->isReady());
+}
+
+
+// Event notifier.
+void qtractorAudioCacheFactory::notifyCacheEvent (void)
+{
+	emit cacheEvent();
+}
+
+
+// Base sync method.
+void qtractorAudioCacheFactory::sync ( qtractorAudioCacheFile *pCacheFile )
+{
+	if (m_pCacheThread) m_pCacheThread->sync(pCacheFile);
+}
+
+
+// Cleanup method.
+void qtractorAudioCacheFactory::cleanup (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	// Abort any pending and current rendering...
+	CacheFiles::ConstIterator iter = m_files.constBegin();
+	const CacheFiles::ConstIterator& iter_end = m_files.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		qtractorAudioCacheFile *pCacheFile = iter.value();
+		pCacheFile->cleanup(m_bAutoRemove);
+	}
+
+	if (m_pCacheThread)
+		m_pCacheThread->clear();
+
+	qDeleteAll(m_files);
+	m_files.clear();
+}
+
+
+// Switch ready clips over to their cache files: new buffers
+// get opened (and initially synced) off the session lock,
+// then swapped in under it, seeked to the current frame.
+int qtractorAudioCacheFactory::updateClips ( qtractorSession *pSession )
+{
+	if (!isEnabled())
+		return 0;
+
+	// Don't mess while recording...
+	if (pSession->isRecording())
+		return 0;
+
+	// Open new buffers, once per (linked clips) buffer...
+	typedef QPair<qtractorAudioClip *, qtractorAudioBuffer *> SwapItem;
+	QList<SwapItem> items;
+	QList<qtractorAudioBuffer *> buffers;
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		// Only audio track/clips...
+		if (pTrack->trackType() != qtractorTrack::Audio)
+			continue;
+		for (qtractorClip *pClip = pTrack->clips().first();
+				pClip; pClip = pClip->next()) {
+			qtractorAudioClip *pAudioClip
+				= static_cast<qtractorAudioClip *> (pClip);
+			qtractorAudioBuffer *pOldBuff = pAudioClip->buffer();
+			if (pOldBuff == nullptr || buffers.contains(pOldBuff))
+				continue;
+			if (!isClipReady(pAudioClip))
+				continue;
+			qtractorAudioBuffer *pBuff = pAudioClip->createBuffer();
+			if (pBuff) {
+				items.append(SwapItem(pAudioClip, pBuff));
+				buffers.append(pOldBuff);
+			}
+		}
+	}
+
+	if (items.isEmpty())
+		return 0;
+
+	// Give the new buffers a chance to get initially synced...
+	for (int i = 0; i < 100; ++i) {
+		bool bInitSync = true;
+		QListIterator<SwapItem> iter(items);
+		while (bInitSync && iter.hasNext()) {
+			bInitSync = iter.next().second->isSyncFlag(
+				qtractorAudioBuffer::InitSync);
+		}
+		if (bInitSync)
+			break;
+		QThread::msleep(2);
+	}
+
+	// Swap them in, just once, at the current frame...
+	pSession->lock();
+	const unsigned long iFrame = pSession->playHead();
+	QListIterator<SwapItem> iter(items);
+	while (iter.hasNext()) {
+		const SwapItem& item = iter.next();
+		qtractorAudioClip *pAudioClip = item.first;
+		pAudioClip->swapBuffer(item.second);
+		const unsigned long iClipStart = pAudioClip->clipStart();
+		const unsigned long iClipEnd = iClipStart + pAudioClip->clipLength();
+		if (iFrame > iClipStart && iFrame < iClipEnd)
+			pAudioClip->seek(iFrame - iClipStart);
+		else
+			pAudioClip->seek(0);
+	}
+	pSession->unlock();
+
+	// Old buffers get closed and gone, off the session lock...
+	qDeleteAll(buffers);
+
+	return items.count();
+}
+
+
+// end of qtractorAudioCache.cpp
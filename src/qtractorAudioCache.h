@@ -0,0 +1,196 @@
+// qtractorAudioCache.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioCache_h
+#define __qtractorAudioCache_h
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+
+#include <QMutex>
+
+
+// Forward declarations.
+class qtractorAudioCacheThread;
+class qtractorAudioFile;
+class qtractorAudioClip;
+class qtractorSession;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheFile -- Background rendered cache file (base).
+//
+
+class qtractorAudioCacheFile
+{
+public:
+
+	// Constructor.
+	qtractorAudioCacheFile(const QString& sFilename,
+		const QString& sCacheKey, const QString& sCacheExt);
+
+	// Default destructor.
+	virtual ~qtractorAudioCacheFile();
+
+	// Source audio filename accessor.
+	const QString& filename() const;
+
+	// Cache file name accessor.
+	QString name() const;
+
+	// Whether the cache file is rendered and up-to-date.
+	bool isReady() const;
+
+	// Whether the last rendering failed (eg. over quota).
+	bool isFailed() const;
+
+	// Render the whole cache file (on the cache thread).
+	bool render(volatile bool *pbRunState, unsigned long iQuota);
+
+	// Physical removal.
+	void remove();
+
+	// Clean/close method.
+	void cleanup(bool bAutoRemove = false);
+
+	// Sync thread state flags accessors.
+	void setWaitSync(bool bWaitSync);
+	bool isWaitSync() const;
+
+	// Current cache disk usage (bytes), on a given directory.
+	static unsigned long long cacheUsage(
+		const QString& sDir, const QString& sCacheExt);
+
+protected:
+
+	// Cache file sample sub-format (SF_FORMAT_FLOAT, SF_FORMAT_PCM_24).
+	virtual int sampleFormat() const = 0;
+
+	// Process the whole source into the cache file.
+	virtual bool process(qtractorAudioFile *pAudioFile,
+		qtractorAudioFile *pCacheFile, float **ppFrames,
+		unsigned int iFrames, volatile bool *pbRunState) = 0;
+
+	// Whether rendering should go on.
+	bool isRunState(volatile bool *pbRunState) const
+		{ return *pbRunState && m_bWaitSync; }
+
+private:
+
+	// Instance variables.
+	QString        m_sFilename;
+	QString        m_sCacheExt;
+
+	QString        m_sName;
+
+	volatile bool  m_bWaitSync;
+	volatile bool  m_bFailed;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheFactory -- Cache file factory (base).
+//
+
+class qtractorAudioCacheFactory : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qtractorAudioCacheFactory(QObject *pParent = nullptr);
+	// Default destructor.
+	~qtractorAudioCacheFactory();
+
+	// Enabled property.
+	void setEnabled(bool bEnabled);
+	bool isEnabled() const;
+
+	// Disk quota property (MB; 0 = unlimited).
+	void setQuota(unsigned long iQuota);
+	unsigned long quota() const;
+
+	// Auto-delete property.
+	void setAutoRemove(bool bAutoRemove);
+	bool isAutoRemove() const;
+
+	// Cache ready event notification.
+	void notifyCacheEvent();
+
+	// Base sync method.
+	void sync(qtractorAudioCacheFile *pCacheFile = nullptr);
+
+	// Cleanup method.
+	void cleanup();
+
+	// Switch ready clips over to their cache files,
+	// returning the number of clips switched over.
+	int updateClips(qtractorSession *pSession);
+
+signals:
+
+	// Cache ready signal.
+	void cacheEvent();
+
+protected:
+
+	// Ready cache file name, if any; otherwise schedules
+	// its background rendering, unless it has failed
+	// already, and returns an empty string (factory
+	// mutex must be held).
+	QString readyName(qtractorAudioCacheFile *pCacheFile);
+
+	// Whether a ready cache file exists (no scheduling).
+	bool isCacheReady(const QString& sCacheKey);
+
+	// Whether a clip is due to switch over its cache file.
+	virtual bool isClipReady(qtractorAudioClip *pAudioClip) = 0;
+
+	// Factory mutex.
+	QMutex m_mutex;
+
+	// The list of managed cache files.
+	typedef QHash<QString, qtractorAudioCacheFile *> CacheFiles;
+
+	CacheFiles m_files;
+
+private:
+
+	// Enabled property.
+	bool m_bEnabled;
+
+	// Disk quota property (MB).
+	unsigned long m_iQuota;
+
+	// Auto-delete property.
+	bool m_bAutoRemove;
+
+	// The cache rendering detached thread.
+	qtractorAudioCacheThread *m_pCacheThread;
+};
+
+
+#endif  // __qtractorAudioCache_h
+
+
+// end of qtractorAudioCache.h
@@ -352,6 +352,54 @@ bool qtractorAudioClip::openAudioFile ( const QString& sFilename, int iMode )
 }
 
 
+// Cache file switch-over: create and open a brand new buffer,
+// as for the current clip settings (off the session lock).
+qtractorAudioBuffer *qtractorAudioClip::createBuffer (void) const
+{
+	if (m_pData == nullptr)
+		return nullptr;
+
+	qtractorTrack *pTrack = track();
+	if (pTrack == nullptr)
+		return nullptr;
+
+	qtractorAudioBus *pAudioBus
+		= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+	if (pAudioBus == nullptr)
+		return nullptr;
+
+	qtractorAudioBuffer *pOldBuff = m_pData->buffer();
+	qtractorAudioBuffer *pBuff = new qtractorAudioBuffer(
+		pTrack->syncThread(), pAudioBus->channels());
+
+	pBuff->setOffset(clipOffset());
+	pBuff->setLength(clipLength());
+	pBuff->setGain(clipGain());
+	pBuff->setPanning(clipPanning());
+	pBuff->setTimeStretch(m_fTimeStretch);
+	pBuff->setPitchShift(m_fPitchShift);
+	pBuff->setWsolaTimeStretch(m_bWsolaTimeStretch);
+	pBuff->setWsolaQuickSeek(m_bWsolaQuickSeek);
+	pBuff->setLoop(pOldBuff->loopStart(), pOldBuff->loopEnd());
+
+	if (!pBuff->open(filename())) {
+		delete pBuff;
+		return nullptr;
+	}
+
+	return pBuff;
+}
+
+
+// Cache file switch-over: swap in a new buffer, shared by
+// all linked clips (session lock must be held); returns
+// the old buffer, to be deleted off the session lock.
+qtractorAudioBuffer *qtractorAudioClip::swapBuffer ( qtractorAudioBuffer *pBuff )
+{
+	return (m_pData ? m_pData->swapBuffer(pBuff) : nullptr);
+}
+
+
 // Private cleanup.
 void qtractorAudioClip::closeAudioFile (void)
 {
@@ -591,6 +639,8 @@ void qtractorAudioClip::open (void)
 {
 	const QString sFilename(filename());
 	openAudioFile(sFilename);
+
+	updateSerial();
 }
 
 
@@ -602,9 +652,8 @@ void qtractorAudioClip::process (
 	if (pBuff == nullptr)
 		return;
 
-	qtractorAudioBus *pAudioBus
-		= static_cast<qtractorAudioBus *> (track()->outputBus());
-	if (pAudioBus == nullptr)
+	qtractorAudioRenderBuffer *pRenderBuffer = track()->renderBuffer();
+	if (pRenderBuffer == nullptr)
 		return;
 
 	// Get the next bunch from the clip...
@@ -619,23 +668,35 @@ void qtractorAudioClip::process (
 	const unsigned long iOffset
 		= (iFrameEnd < iClipEnd ? iFrameEnd : iClipEnd) - iClipStart;
 
+	// Per-frame fade-in/out gains, if any in this run...
+	float *pfFades = pRenderBuffer->fades();
+
 	if (iClipStart > iFrameStart) {
 		if (pBuff->inSync(0, iOffset)) {
+			const unsigned long iFrame = iClipStart - iFrameStart;
+			if (!fadeInOutGains(pfFades + iFrame, 0, iOffset))
+				pfFades = nullptr;
+			pRenderBuffer->touch(iFrameEnd - iFrameStart);
 			pBuff->readMix(
-				pAudioBus->buffer(),
+				pRenderBuffer->buffer(),
 				iOffset,
-				pAudioBus->channels(),
-				iClipStart - iFrameStart,
-				fadeInOutGain(iOffset));
+				pRenderBuffer->channels(),
+				iFrame,
+				1.0f, pfFades);
 		}
 	} else {
 		if (pBuff->inSync(iFrameStart - iClipStart, iOffset)) {
+			const unsigned long iFrames
+				= (iFrameEnd < iClipEnd ? iFrameEnd : iClipEnd) - iFrameStart;
+			if (!fadeInOutGains(pfFades, iFrameStart - iClipStart, iFrames))
+				pfFades = nullptr;
+			pRenderBuffer->touch(iFrameEnd - iFrameStart);
 			pBuff->readMix(
-				pAudioBus->buffer(),
-				(iFrameEnd < iClipEnd ? iFrameEnd : iClipEnd) - iFrameStart,
-				pAudioBus->channels(),
+				pRenderBuffer->buffer(),
+				iFrames,
+				pRenderBuffer->channels(),
 				0,
-				fadeInOutGain(iOffset));
+				1.0f, pfFades);
 		}
 	}
 }
@@ -654,8 +715,8 @@ void qtractorAudioClip::process_export (
 
 
 // Audio clip paint method.
-void qtractorAudioClip::draw (
-	QPainter *pPainter, const QRect& clipRect, unsigned long iClipOffset )
+void qtractorAudioClip::draw ( QPainter *pPainter, const QRect& clipRect,
+	unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer )
 {
 	qtractorSession *pSession = track()->session();
 	if (pSession == nullptr)
@@ -681,57 +742,52 @@ void qtractorAudioClip::draw (
 	if (iPeakLength < 1)
 		return;
 
-	// Polygon init...
-	unsigned short k;
+	// Polygon init (reusable per-view vertex buffer)...
+	QPolygon& poly = drawBuffer.poly;
 	const unsigned short iChannels = m_pPeak->channels();
-	const unsigned int iPolyPoints = (iPeakLength << 1);
-	QPolygon **pPolyMax = new QPolygon* [iChannels];
-	QPolygon **pPolyRms = new QPolygon* [iChannels];
-	for (k = 0; k < iChannels; ++k) {
-		pPolyMax[k] = new QPolygon(iPolyPoints);
-		pPolyRms[k] = new QPolygon(iPolyPoints);
-	}
+	const int iPolyPoints = int(iPeakLength << 1);
+	if (poly.size() < iPolyPoints)
+		poly.resize(iPolyPoints);
+	QPoint *pPoints = poly.data();
 
 	// Draw peak chart...
 	const int h1 = (clipRect.height() / iChannels);
 	const int h2 = (h1 >> 1);
 
-	int x, y, ymax, ymin, yrms;
-
-	// Build polygonal vertexes...
-	const int n2 = int(iPeakLength);
-	for (int n = 0; n < n2; ++n) {
-		x = clipRect.x() + (n * clipRect.width()) / n2;
-		y = clipRect.y() + h2;
-		for (k = 0; k < iChannels; ++k) {
-			const FractGain& fractGain = m_pFractGains[k];
-			const int h2gain = (h2 * fractGain.num);
-			ymax = (h2gain * pPeakFrames->max) >> fractGain.den;
-			ymin = (h2gain * pPeakFrames->min) >> fractGain.den;
-			yrms = (h2gain * pPeakFrames->rms) >> fractGain.den;
-			pPolyMax[k]->setPoint(n, x, y - ymax);
-			pPolyMax[k]->setPoint(iPolyPoints - n - 1, x, y + ymin);
-			pPolyRms[k]->setPoint(n, x, y - yrms);
-			pPolyRms[k]->setPoint(iPolyPoints - n - 1, x, y + yrms);
-			y += h1; ++pPeakFrames;
-		}
-	}
-
-	// Close, draw and free the polygons...
 	QColor fg(track()->foreground());
 	fg.setAlpha(200);
 	pPainter->setPen(fg.lighter(140));
 	pPainter->setBrush(fg);
-	for (k = 0; k < iChannels; ++k) {
-		pPainter->drawPolygon(*pPolyMax[k]);
-		pPainter->drawPolygon(*pPolyRms[k]);
-		delete pPolyRms[k];
-		delete pPolyMax[k];
-	}
 
-	// Done on polygons.
-	delete [] pPolyRms;
-	delete [] pPolyMax;
+	int x, y, ymax, ymin, yrms;
+
+	// Build polygonal vertexes, one channel at a time...
+	const int n2 = int(iPeakLength);
+	for (unsigned short k = 0; k < iChannels; ++k) {
+		const FractGain& fractGain = m_pFractGains[k];
+		const int h2gain = (h2 * fractGain.num);
+		const qtractorAudioPeakFile::Frame *pFrame = pPeakFrames + k;
+		y = clipRect.y() + h2 + k * h1;
+		// Max/min envelope...
+		for (int n = 0; n < n2; ++n, pFrame += iChannels) {
+			x = clipRect.x() + (n * clipRect.width()) / n2;
+			ymax = (h2gain * pFrame->max) >> fractGain.den;
+			ymin = (h2gain * pFrame->min) >> fractGain.den;
+			pPoints[n].setX(x);
+			pPoints[n].setY(y - ymax);
+			pPoints[iPolyPoints - n - 1].setX(x);
+			pPoints[iPolyPoints - n - 1].setY(y + ymin);
+		}
+		pPainter->drawPolygon(pPoints, iPolyPoints);
+		// RMS envelope (same abscissas)...
+		pFrame = pPeakFrames + k;
+		for (int n = 0; n < n2; ++n, pFrame += iChannels) {
+			yrms = (h2gain * pFrame->rms) >> fractGain.den;
+			pPoints[n].setY(y - yrms);
+			pPoints[iPolyPoints - n - 1].setY(y + yrms);
+		}
+		pPainter->drawPolygon(pPoints, iPolyPoints);
+	}
 }
 
 
@@ -83,6 +83,12 @@ public:
 	qtractorAudioBuffer *buffer() const
 		{ return (m_pData ? m_pData->buffer() : nullptr); }
 
+	// Cache file switch-over methods: a brand new buffer
+	// gets opened off the session lock, then swapped in
+	// under it (shared by all linked clips).
+	qtractorAudioBuffer *createBuffer() const;
+	qtractorAudioBuffer *swapBuffer(qtractorAudioBuffer *pBuff);
+
 	// Direct write method.
 	void write(float **ppBuffer, unsigned int iFrames,
 		unsigned short iChannels = 0, unsigned int iOffset = 0);
@@ -106,8 +112,8 @@ public:
 	void process_export(unsigned long iFrameStart, unsigned long iFrameEnd);
 
 	// Clip paint method.
-	void draw(QPainter *pPainter,
-		const QRect& clipRect, unsigned long iClipOffset);
+	void draw(QPainter *pPainter, const QRect& clipRect,
+		unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer);
 
 	// Clip update method (no-op).
 	void update() {}
@@ -139,6 +145,11 @@ public:
 		qtractorAudioBuffer *buffer() const
 			{ return m_pBuff; }
 
+		// Buffer swap method (returns the old one).
+		qtractorAudioBuffer *swapBuffer(qtractorAudioBuffer *pBuff)
+			{ qtractorAudioBuffer *pOldBuff = m_pBuff;
+				m_pBuff = pBuff; return pOldBuff; }
+
 		// Direct write method.
 		void write (float **ppBuffer, unsigned int iFrames,
 			unsigned short iChannels, unsigned int iOffset)
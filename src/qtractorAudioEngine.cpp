@@ -22,6 +22,9 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorAudioMonitor.h"
+#include "qtractorAudioLoudness.h"
+#include "qtractorRtAudit.h"
+#include "qtractorTrace.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioClip.h"
 
@@ -34,6 +37,7 @@
 #include "qtractorMidiEngine.h"
 #include "qtractorMidiManager.h"
 #include "qtractorPlugin.h"
+#include "qtractorInsertPlugin.h"
 #include "qtractorClip.h"
 
 #include "qtractorCurveFile.h"
@@ -50,6 +54,8 @@
 #endif
 #endif
 
+#include <jack/midiport.h>
+
 #ifdef CONFIG_JACK_SESSION
 #include <jack/session.h>
 #endif
@@ -61,6 +67,13 @@
 #include <QApplication>
 #include <QProgressBar>
 #include <QDomDocument>
+#include <QThread>
+
+#include <cstdint>
+
+
+// Session busy (editing) fade-out/in ramp length (frames).
+#define QTRACTOR_AUDIO_BUSY_RAMP 64
 
 #if defined(__SSE__)
 
@@ -262,6 +275,10 @@ private:
 
 static int qtractorAudioEngine_process ( jack_nframes_t nframes, void *pvArg )
 {
+	QTRACTOR_RT_AUDIT_PROCESS("qtractorAudioEngine::process");
+
+	qtractorTraceScope trace("JACK process", "process");
+
 	qtractorAudioEngine *pAudioEngine
 		= static_cast<qtractorAudioEngine *> (pvArg);
 
@@ -305,6 +322,8 @@ static int qtractorAudioEngine_xrun ( void *pvArg )
 	qtractorAudioEngine *pAudioEngine
 		= static_cast<qtractorAudioEngine *> (pvArg);
 
+	qtractorTrace::instant("JACK notify", "xrun");
+
 	pAudioEngine->notifyXrunEvent();
 
 	return 0;
@@ -499,6 +518,17 @@ qtractorAudioEngine::qtractorAudioEngine ( qtractorSession *pSession )
 	m_iBufferSizeEx = 0;
 	m_iBufferOffset = 0;
 
+	m_iTrackCycles = 0;
+	m_iSkipCycles = 0;
+
+	m_ppSumBuses = nullptr;
+	m_iSumBuses = 0;
+
+	m_pOutputSnapshot.storeRelease(nullptr);
+	m_bProcessBusy = false;
+
+	m_bPathLatenciesDirty = false;
+
 	m_bMasterAutoConnect = true;
 
 	// Audio-export freewheeling (internal) state.
@@ -512,6 +542,7 @@ qtractorAudioEngine::qtractorAudioEngine ( qtractorSession *pSession )
 	m_pExportFile  = nullptr;
 	m_pExportBuses = nullptr;
 	m_pExportBuffer = nullptr;
+	m_pExportLoudness = nullptr;
 	m_iExportOffset = 0;
 	m_iExportStart = 0;
 	m_iExportEnd   = 0;
@@ -783,6 +814,9 @@ bool qtractorAudioEngine::activate (void)
 	// Reset all dependable monitoring...
 	resetAllMonitors();
 
+	// Internal (summing) buses graph...
+	resetSumBuses();
+
 	// Time to activate ourselves...
 	jack_activate(m_pJackClient);
 
@@ -830,12 +864,19 @@ bool qtractorAudioEngine::start (void)
 	// Reset all dependables...
 	resetAllMonitors();
 
+	// Graph-wide plugin delay compensation,
+	// in case any plugin latency has changed...
+	resetPathLatencies();
+
 	// Make sure we have an actual session cursor...
 	resetMetro();
 
 	// Reset transport latency anyway...
 	m_iTransportLatency = 0;
 
+	// Reset idle-skipping statistics...
+	resetTrackCycles();
+
 	// Start transport rolling...
 	if (m_transportMode & qtractorBus::Output)
 		jack_transport_start(m_pJackClient);
@@ -856,6 +897,11 @@ void qtractorAudioEngine::stop (void)
 		jack_transport_locate(m_pJackClient, sessionCursor()->frame());
 	}
 
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorAudioEngine[%p]::stop() track-cycles=%lu skipped=%lu",
+		this, m_iTrackCycles, m_iSkipCycles);
+#endif
+
 	// MIDI plugin managers reset...
 	qtractorMidiManager *pMidiManager
 		= session()->midiManagers().first();
@@ -875,6 +921,10 @@ void qtractorAudioEngine::deactivate (void)
 	// Deactivate the JACK client first.
 	if (m_pJackClient)
 		jack_deactivate(m_pJackClient);
+
+	// No more JACK (foreign) threads tracing around...
+	qtractorTrace::release("JACK process");
+	qtractorTrace::release("JACK notify");
 }
 
 
@@ -890,6 +940,21 @@ void qtractorAudioEngine::clean (void)
 	deletePlayerBus();
 	deleteMetroBus();
 
+	// Clean physical output ports snapshot (no more cycles)...
+	resetOutputSnapshot(true);
+	reclaimOutputSnapshots(true);
+
+	// Clean internal (summing) buses graph...
+	if (m_ppSumBuses) {
+		delete [] m_ppSumBuses;
+		m_ppSumBuses = nullptr;
+	}
+	m_iSumBuses = 0;
+
+	// Free all pooled render buffers...
+	qDeleteAll(m_renderBuffers);
+	m_renderBuffers.clear();
+
 	// Terminate common player/metro sync thread...
 	if (m_pSyncThread) {
 		if (m_pSyncThread->isRunning()) do {
@@ -917,6 +982,11 @@ void qtractorAudioEngine::clean (void)
 		m_pExportFile = nullptr;
 	}
 
+	if (m_pExportLoudness) {
+		delete m_pExportLoudness;
+		m_pExportLoudness = nullptr;
+	}
+
 	// Close the JACK client, finally.
 	if (m_pJackClient) {
 		jack_client_close(m_pJackClient);
@@ -931,6 +1001,24 @@ void qtractorAudioEngine::clean (void)
 
 // Process cycle executive.
 int qtractorAudioEngine::process ( unsigned int nframes )
+{
+	// Mark the cycle epoch (odd while inside)...
+	m_iProcessEpoch.ref();
+
+	// JACK MIDI outputs must not resend last cycle's events,
+	// whichever way this cycle goes...
+	process_midi_clear(nframes);
+
+	const int iResult = process_cycle(nframes);
+
+	m_iProcessEpoch.ref();
+
+	return iResult;
+}
+
+
+// Regular process cycle executive (session acquired or not).
+int qtractorAudioEngine::process_cycle ( unsigned int nframes )
 {
 	// Don't bother with a thing, if not running.
 	if (!isActivated())
@@ -957,8 +1045,11 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 		return 0;
 
 	// Session RT-safeness lock...
-	if (!pSession->acquire())
+	if (!pSession->acquire()) {
+		// Busy editing, go gracefully silent...
+		process_busy(nframes);
 		return 0;
+	}
 
 	// Track whether audio output buses
 	// buses needs monitoring while idle...
@@ -1030,6 +1121,14 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 		}
 	}
 
+	// JACK MIDI output processing...
+	if (pSession->midiEngine()->isJackMidi()) {
+		const unsigned long iFrameTimeStart = pAudioCursor->frameTime();
+		const unsigned long iFrameTimeEnd   = iFrameTimeStart + nframes;
+		pSession->midiEngine()->process_jack(
+			iFrameTimeStart, iFrameTimeEnd, nframes);
+	}
+
 	// Don't go any further, if not playing.
 	if (!isPlaying()) {
 		// Do the idle processing...
@@ -1056,11 +1155,18 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 					// Plugin-chain processing...
 					qtractorAudioBus *pOutputBus
 						= static_cast<qtractorAudioBus *> (pTrack->outputBus());
-					if (pOutputBus) {
-						pOutputBus->buffer_prepare(nframes, pInputBus);
-						pPluginList->process(pOutputBus->buffer(), nframes);
-						pAudioMonitor->process(pOutputBus->buffer(), nframes);
-						pOutputBus->buffer_commit(nframes);
+					qtractorAudioRenderBuffer *pRenderBuffer
+						= pTrack->renderBuffer();
+					if (pOutputBus && pRenderBuffer) {
+						pOutputBus->buffer_prepare(
+							pRenderBuffer, nframes, pInputBus);
+						pRenderBuffer->touch(nframes);
+						float **ppBuffer = pRenderBuffer->buffer();
+						pPluginList->process(ppBuffer, nframes);
+						pPluginList->updateTail(ppBuffer, nframes,
+							pInputBus == nullptr, m_iSampleRate << 1);
+						pAudioMonitor->process(ppBuffer, nframes);
+						pOutputBus->buffer_commit(pRenderBuffer, nframes);
 						++iOutputBus;
 					}
 				}
@@ -1069,14 +1175,15 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 		// Process audition/pre-listening bus...
 		if (m_bPlayerBus && m_pPlayerBus)
 			m_pPlayerBus->process_commit(nframes);
-		// Pass-thru current audio buses...
-		for (pBus = buses().first(); pBus; pBus = pBus->next()) {
-			pAudioBus = static_cast<qtractorAudioBus *> (pBus);
-			if (pAudioBus && (iOutputBus > 0 || pAudioBus->isMonitor()))
+		// Pass-thru current audio buses (in summing graph order)...
+		for (unsigned int i = 0; i < m_iSumBuses; ++i) {
+			pAudioBus = m_ppSumBuses[i];
+			if (iOutputBus > 0 || pAudioBus->isMonitor())
 				pAudioBus->process_commit(nframes);
 		}
 		// Done as idle...
 		pAudioCursor->process(nframes);
+		process_snapshot(nframes);
 		pSession->release();
 		return 0;
 	}
@@ -1133,12 +1240,9 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 	pSession->process(pAudioCursor, iFrameStart, iFrameEnd);
 	m_iBufferOffset += (iFrameEnd - iFrameStart);
 
-	// Commit current audio buses...
-	for (pBus = buses().first(); pBus; pBus = pBus->next()) {
-		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
-		if (pAudioBus)
-			pAudioBus->process_commit(nframes);
-	}
+	// Commit current audio buses (in summing graph order)...
+	for (unsigned int i = 0; i < m_iSumBuses; ++i)
+		m_ppSumBuses[i]->process_commit(nframes);
 
 	// Regular range recording (if and when applicable)...
 	if (pSession->isRecording())
@@ -1167,6 +1271,9 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 	// (sure we have a MIDI engine, no?)
 	pSession->midiEngine()->sync();
 
+	// Keep track of what's been sent out...
+	process_snapshot(nframes);
+
 	// Release RT-safeness lock...
 	pSession->release();
 
@@ -1175,6 +1282,184 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 }
 
 
+// Session busy (locked) fallback: the session graph can't be
+// touched while being edited, but the (immutable) snapshot of
+// physical output ports can: ramp from whatever was last sent
+// down to silence, instead of leaving stale port buffers behind.
+void qtractorAudioEngine::process_busy ( unsigned int nframes )
+{
+	OutputSnapshot *pSnapshot = m_pOutputSnapshot.loadAcquire();
+	if (pSnapshot == nullptr)
+		return;
+
+	const unsigned int iRamp
+		= (nframes < QTRACTOR_AUDIO_BUSY_RAMP ? nframes : QTRACTOR_AUDIO_BUSY_RAMP);
+
+	for (unsigned int i = 0; i < pSnapshot->count; ++i) {
+		float *pBuffer = static_cast<float *> (
+			jack_port_get_buffer(pSnapshot->ports[i], nframes));
+		if (pBuffer == nullptr)
+			continue;
+		::memset(pBuffer, 0, nframes * sizeof(float));
+		const float fLast = pSnapshot->last[i];
+		if (fLast != 0.0f) {
+			const float fDelta = fLast / float(iRamp);
+			float fValue = fLast;
+			for (unsigned int n = 0; n < iRamp; ++n) {
+				fValue -= fDelta;
+				pBuffer[n] = fValue;
+			}
+			pSnapshot->last[i] = 0.0f;
+		}
+	}
+
+	m_bProcessBusy = true;
+}
+
+
+// Physical output ports snapshot update (last sample, fade-in).
+void qtractorAudioEngine::process_snapshot ( unsigned int nframes )
+{
+	OutputSnapshot *pSnapshot = m_pOutputSnapshot.loadAcquire();
+	if (pSnapshot == nullptr || nframes < 1)
+		return;
+
+	const unsigned int iRamp
+		= (nframes < QTRACTOR_AUDIO_BUSY_RAMP ? nframes : QTRACTOR_AUDIO_BUSY_RAMP);
+
+	for (unsigned int i = 0; i < pSnapshot->count; ++i) {
+		float *pBuffer = static_cast<float *> (
+			jack_port_get_buffer(pSnapshot->ports[i], nframes));
+		if (pBuffer == nullptr)
+			continue;
+		// Back from busy? fade-in...
+		if (m_bProcessBusy) {
+			const float fDelta = 1.0f / float(iRamp);
+			float fGain = 0.0f;
+			for (unsigned int n = 0; n < iRamp; ++n) {
+				fGain += fDelta;
+				pBuffer[n] *= fGain;
+			}
+		}
+		pSnapshot->last[i] = pBuffer[nframes - 1];
+	}
+
+	m_bProcessBusy = false;
+}
+
+
+// JACK MIDI output ports clearance (every cycle).
+void qtractorAudioEngine::process_midi_clear ( unsigned int nframes )
+{
+	OutputSnapshot *pSnapshot = m_pOutputSnapshot.loadAcquire();
+	if (pSnapshot == nullptr)
+		return;
+
+	for (unsigned int i = 0; i < pSnapshot->midiCount; ++i) {
+		void *pBuffer = jack_port_get_buffer(pSnapshot->midiPorts[i], nframes);
+		if (pBuffer)
+			jack_midi_clear_buffer(pBuffer);
+	}
+}
+
+
+// Physical output ports snapshot reset (or clear).
+void qtractorAudioEngine::resetOutputSnapshot ( bool bClear )
+{
+	OutputSnapshot *pSnapshot = nullptr;
+
+	if (!bClear) {
+		// Collect all current physical output ports...
+		QList<jack_port_t *> ports;
+		for (int j = 0; j < 2; ++j) {
+			qtractorBus *pBus = (j == 0 ? buses().first() : busesEx().first());
+			for ( ; pBus; pBus = pBus->next()) {
+				qtractorAudioBus *pAudioBus
+					= static_cast<qtractorAudioBus *> (pBus);
+				if (pAudioBus == nullptr
+					|| (pAudioBus->busMode() & qtractorBus::Output) == 0)
+					continue;
+				jack_port_t **ppOPorts = pAudioBus->outputPorts();
+				if (ppOPorts == nullptr)
+					continue;
+				const unsigned short iChannels = pAudioBus->channels();
+				for (unsigned short i = 0; i < iChannels; ++i) {
+					if (ppOPorts[i])
+						ports.append(ppOPorts[i]);
+				}
+			}
+		}
+		// Collect all current JACK MIDI output ports...
+		QList<jack_port_t *> midiPorts;
+		qtractorSession *pSession = session();
+		qtractorMidiEngine *pMidiEngine
+			= (pSession ? pSession->midiEngine() : nullptr);
+		if (pMidiEngine && pMidiEngine->isJackMidi()) {
+			for (int j = 0; j < 2; ++j) {
+				qtractorBus *pBus = (j == 0
+					? pMidiEngine->buses().first()
+					: pMidiEngine->busesEx().first());
+				for ( ; pBus; pBus = pBus->next()) {
+					qtractorMidiBus *pMidiBus
+						= static_cast<qtractorMidiBus *> (pBus);
+					if (pMidiBus && pMidiBus->jackMidiPort())
+						midiPorts.append(pMidiBus->jackMidiPort());
+				}
+			}
+		}
+		// Build the new (immutable) snapshot...
+		const unsigned int iCount = ports.count();
+		pSnapshot = new OutputSnapshot;
+		pSnapshot->count = iCount;
+		pSnapshot->ports = new jack_port_t * [iCount + 1];
+		pSnapshot->last  = new float [iCount + 1];
+		for (unsigned int i = 0; i < iCount; ++i) {
+			pSnapshot->ports[i] = ports.at(i);
+			pSnapshot->last[i]  = 0.0f;
+		}
+		const unsigned int iMidiCount = midiPorts.count();
+		pSnapshot->midiCount = iMidiCount;
+		pSnapshot->midiPorts = new jack_port_t * [iMidiCount + 1];
+		for (unsigned int i = 0; i < iMidiCount; ++i)
+			pSnapshot->midiPorts[i] = midiPorts.at(i);
+	}
+
+	// Publish it...
+	OutputSnapshot *pOldSnapshot
+		= m_pOutputSnapshot.fetchAndStoreOrdered(pSnapshot);
+
+	// Retire the old one: a cycle in progress might still be
+	// holding on it, so it's only reclaimed later, never waited...
+	if (pOldSnapshot) {
+		pOldSnapshot->epoch = m_iProcessEpoch.loadAcquire();
+		m_retiredSnapshots.append(pOldSnapshot);
+	}
+
+	reclaimOutputSnapshots();
+}
+
+
+// Retired output snapshots reclamation.
+void qtractorAudioEngine::reclaimOutputSnapshots ( bool bForce )
+{
+	const int iEpoch = m_iProcessEpoch.loadAcquire();
+
+	QMutableListIterator<OutputSnapshot *> iter(m_retiredSnapshots);
+	while (iter.hasNext()) {
+		OutputSnapshot *pSnapshot = iter.next();
+		// Retired outside a cycle, or that one's gone already?
+		if (bForce || (pSnapshot->epoch & 1) == 0
+			|| pSnapshot->epoch != iEpoch) {
+			delete [] pSnapshot->midiPorts;
+			delete [] pSnapshot->ports;
+			delete [] pSnapshot->last;
+			delete pSnapshot;
+			iter.remove();
+		}
+	}
+}
+
+
 // Freewheeling process cycle executive (needed for export).
 void qtractorAudioEngine::process_export ( unsigned int nframes )
 {
@@ -1198,6 +1483,14 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 	// Prepare the output buses first...
 	while (iter.hasNext())
 		iter.next()->process_prepare(nframes);
+	// Prepare all other output buses, as internal (summing)
+	// buses may well sum into ones that are not exported...
+	unsigned int i;
+	for (i = 0; i < m_iSumBuses; ++i) {
+		qtractorAudioBus *pSumBus = m_ppSumBuses[i];
+		if (!m_pExportBuses->contains(pSumBus))
+			pSumBus->process_prepare(nframes);
+	}
 	// Prepare all extra audio buses...
 	for (qtractorBus *pBusEx = busesEx().first();
 			pBusEx; pBusEx = pBusEx->next()) {
@@ -1241,15 +1534,25 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 		// Check end-of-export...
 		if (iFrameEnd > m_iExportEnd)
 			nframes -= (iFrameEnd - m_iExportEnd);
+		// Commit all internal (summing) buses first...
+		for (i = 0; i < m_iSumBuses; ++i) {
+			qtractorAudioBus *pSumBus = m_ppSumBuses[i];
+			if (pSumBus->isInternal())
+				pSumBus->process_commit(nframes);
+		}
 		// Commit the output buses...
 		iter.toFront();
 		while (iter.hasNext()) {
 			qtractorAudioBus *pExportBus = iter.next();
-			pExportBus->process_commit(nframes);
+			if (!pExportBus->isInternal())
+				pExportBus->process_commit(nframes);
 			m_pExportBuffer->process_add(pExportBus, nframes);
 		}
 		// Write to export file...
 		m_pExportFile->write(m_pExportBuffer->buffer(), nframes);
+		// Measure it (offline, non RT safe!)...
+		if (m_pExportLoudness)
+			m_pExportLoudness->process(m_pExportBuffer->buffer(), nframes);
 		// HACK! Freewheeling observers update (non RT safe!)...
 		qtractorSubject::flushQueue(false);
 	} else {
@@ -1495,6 +1798,13 @@ unsigned long qtractorAudioEngine::exportLength (void) const
 }
 
 
+// Last export loudness and true-peak meter accessor.
+qtractorAudioLoudness *qtractorAudioEngine::exportLoudness (void) const
+{
+	return m_pExportLoudness;
+}
+
+
 
 // Audio-export method.
 bool qtractorAudioEngine::fileExport (
@@ -1556,6 +1866,9 @@ bool qtractorAudioEngine::fileExport (
 	m_pExportBuses = new QList<qtractorAudioBus *> (exportBuses);
 	m_pExportFile  = pExportFile;
 	m_pExportBuffer = new qtractorAudioExportBuffer(iChannels, bufferSizeEx());
+	if (m_pExportLoudness)
+		delete m_pExportLoudness;
+	m_pExportLoudness = new qtractorAudioLoudness(iChannels, sampleRate());
 	m_iExportStart = iExportStart;
 	m_iExportEnd   = iExportEnd;
 	m_bExportDone  = false;
@@ -1579,19 +1892,24 @@ bool qtractorAudioEngine::fileExport (
 	}
 
 	// Make sure all track latencies are reset and
-	// maximum track latency is acquainted as offset...
+	// maximum track path latency is acquainted as offset...
 	m_iExportOffset = 0;
 
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		qtractorPluginList *pPluginList = pTrack->pluginList();
+		if (pPluginList)
+			pPluginList->resetLatency();
+	}
+
+	resetPathLatencies();
+
 	for (qtractorTrack *pTrack = pSession->tracks().first();
 			pTrack; pTrack = pTrack->next()) {
 		if (!pTrack->isMute() && (!pSession->soloTracks() || pTrack->isSolo())) {
-			qtractorPluginList *pPluginList = pTrack->pluginList();
-			if (pPluginList) {
-				pPluginList->resetLatency();
-				const unsigned long iLatency = pPluginList->latency();
-				if (m_iExportOffset < iLatency)
-					m_iExportOffset = iLatency;
-			}
+			const unsigned long iLatency = pTrack->pathLatency();
+			if (m_iExportOffset < iLatency)
+				m_iExportOffset = iLatency;
 		}
 	}
 
@@ -2261,6 +2579,13 @@ unsigned long qtractorAudioEngine::jackFrameTime (void) const
 }
 
 
+// Absolute frame time at the start of current process cycle (RT only).
+unsigned long qtractorAudioEngine::jackCycleTime (void) const
+{
+	return (m_pJackClient ? jack_last_frame_time(m_pJackClient) : 0);
+}
+
+
 // Reset all audio monitoring...
 void qtractorAudioEngine::resetAllMonitors (void)
 {
@@ -2298,6 +2623,616 @@ void qtractorAudioEngine::resetAllMonitors (void)
 }
 
 
+// Internal (summing) buses graph reset.
+void qtractorAudioEngine::resetSumBuses (void)
+{
+	QList<qtractorAudioBus *> list;
+	QHash<qtractorAudioBus *, qtractorAudioBus *> targets;
+
+	// First real output bus (master), the fallback target...
+	qtractorAudioBus *pMasterBus = nullptr;
+
+	// Resolve all internal bus summing targets...
+	for (qtractorBus *pBus = buses().first(); pBus; pBus = pBus->next()) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus == nullptr)
+			continue;
+		qtractorAudioBus *pSumBus = nullptr;
+		if (pAudioBus->isInternal()) {
+			pSumBus = static_cast<qtractorAudioBus *> (
+				findBus(pAudioBus->sumBusName()));
+			if (pSumBus == pAudioBus
+				|| (pSumBus && (pSumBus->busMode() & qtractorBus::Output) == 0))
+				pSumBus = nullptr;
+		}
+		else
+		if (pMasterBus == nullptr
+			&& (pAudioBus->busMode() & qtractorBus::Output)
+			&& (pAudioBus->busMode() & qtractorBus::Ex) == 0)
+			pMasterBus = pAudioBus;
+		targets.insert(pAudioBus, pSumBus);
+		list.append(pAudioBus);
+	}
+
+	const int iBuses = list.count();
+
+	// Break any feedback loops, only on the link that closes each one
+	// (buses just feeding into a loop are left alone)...
+	QHash<qtractorAudioBus *, int> visits; // 1=on current walk, 2=done.
+	QListIterator<qtractorAudioBus *> iter(list);
+	while (iter.hasNext()) {
+		QList<qtractorAudioBus *> path;
+		qtractorAudioBus *pSumBus = iter.next();
+		while (pSumBus && visits.value(pSumBus) == 0) {
+			visits.insert(pSumBus, 1);
+			path.append(pSumBus);
+			pSumBus = targets.value(pSumBus);
+		}
+		if (pSumBus && visits.value(pSumBus) == 1) {
+			qtractorAudioBus *pLoopBus = path.last();
+			qWarning("qtractorAudioEngine::resetSumBuses(): "
+				"\"%s\" summing loop ignored.",
+				pLoopBus->busName().toUtf8().constData());
+			targets.insert(pLoopBus, nullptr);
+		}
+		QListIterator<qtractorAudioBus *> path_iter(path);
+		while (path_iter.hasNext())
+			visits.insert(path_iter.next(), 2);
+	}
+
+	// Internal buses left without a target (orphans)
+	// fall back to the master output, never to be lost...
+	iter.toFront();
+	while (iter.hasNext()) {
+		qtractorAudioBus *pAudioBus = iter.next();
+		if (!pAudioBus->isInternal() || targets.value(pAudioBus))
+			continue;
+		qWarning("qtractorAudioEngine::resetSumBuses(): "
+			"\"%s\" summing target \"%s\" not available, using \"%s\".",
+			pAudioBus->busName().toUtf8().constData(),
+			pAudioBus->sumBusName().toUtf8().constData(),
+			pMasterBus ? pMasterBus->busName().toUtf8().constData() : "");
+		targets.insert(pAudioBus, pMasterBus);
+	}
+
+	// Get the graph depth of each bus (hops to a real output)...
+	QHash<qtractorAudioBus *, int> depths;
+	int iMaxDepth = 0;
+	iter.toFront();
+	while (iter.hasNext()) {
+		qtractorAudioBus *pAudioBus = iter.next();
+		int iDepth = 0;
+		qtractorAudioBus *pSumBus = targets.value(pAudioBus);
+		while (pSumBus) {
+			pSumBus = targets.value(pSumBus);
+			++iDepth;
+		}
+		depths.insert(pAudioBus, iDepth);
+		if (iMaxDepth < iDepth)
+			iMaxDepth = iDepth;
+	}
+
+	// Sort topologically: deepest (leaf) buses get committed first...
+	qtractorAudioBus **ppSumBuses = nullptr;
+	if (iBuses > 0)
+		ppSumBuses = new qtractorAudioBus * [iBuses];
+	unsigned int iSumBuses = 0;
+	for (int iDepth = iMaxDepth; iDepth >= 0; --iDepth) {
+		iter.toFront();
+		while (iter.hasNext()) {
+			qtractorAudioBus *pAudioBus = iter.next();
+			if (depths.value(pAudioBus) == iDepth)
+				ppSumBuses[iSumBuses++] = pAudioBus;
+		}
+	}
+
+	// Swap in the new graph, safely...
+	qtractorSession *pSession = session();
+	if (pSession)
+		pSession->lock();
+
+	iter.toFront();
+	while (iter.hasNext()) {
+		qtractorAudioBus *pAudioBus = iter.next();
+		pAudioBus->setSumBus(targets.value(pAudioBus));
+	}
+
+	qtractorAudioBus **ppOldSumBuses = m_ppSumBuses;
+	m_ppSumBuses = ppSumBuses;
+	m_iSumBuses  = iSumBuses;
+
+	if (pSession)
+		pSession->unlock();
+
+	if (ppOldSumBuses)
+		delete [] ppOldSumBuses;
+
+	// Physical outputs may have changed too...
+	resetOutputSnapshot();
+
+	// Bus graph has changed, so have path latencies...
+	resetPathLatencies();
+}
+
+
+// Plugin chain total latency (in frames), regardless of compensation.
+static unsigned long qtractorAudioEngine_chainLatency (
+	qtractorPluginList *pPluginList )
+{
+	unsigned long iLatency = 0;
+
+	if (pPluginList == nullptr)
+		return iLatency;
+
+	for (qtractorPlugin *pPlugin = pPluginList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		if (pPlugin->isActivated())
+			iLatency += pPlugin->latency();
+	}
+
+	return iLatency;
+}
+
+
+// Audio aux-send plugin predicate.
+static qtractorAudioAuxSendPlugin *qtractorAudioEngine_auxSendPlugin (
+	qtractorPlugin *pPlugin )
+{
+	qtractorPluginType *pType = pPlugin->type();
+	if (pType->typeHint() == qtractorPluginType::AuxSend && pType->index() > 0)
+		return static_cast<qtractorAudioAuxSendPlugin *> (pPlugin);
+	else
+		return nullptr;
+}
+
+
+// Graph-wide plugin delay compensation (path latencies) reset.
+void qtractorAudioEngine::resetPathLatencies (void)
+{
+	qtractorSession *pSession = session();
+	if (pSession == nullptr)
+		return;
+
+	m_bPathLatenciesDirty = false;
+
+	QHash<qtractorAudioBus *, unsigned long> paths;
+
+	// Output bus path latencies, all down to real outputs...
+	for (qtractorBus *pBus = buses().first(); pBus; pBus = pBus->next()) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			busPathLatency(pAudioBus, paths);
+	}
+
+	// Dry-run first: whether anything has actually changed...
+	const int iChanges = updatePathLatencies(paths, 0);
+	if (iChanges & PathDelays) {
+		// Delay lines may get (re)allocated: swap in, safely...
+		pSession->lock();
+		updatePathLatencies(paths, PathLatencies | PathDelays);
+		pSession->unlock();
+	}
+	else
+	if (iChanges & PathLatencies) {
+		// Plain (atomic) read-ahead values only...
+		updatePathLatencies(paths, PathLatencies);
+	}
+}
+
+
+// Deferred path latencies reset, only if marked dirty (non real-time).
+void qtractorAudioEngine::updatePathLatenciesDirty (void)
+{
+	if (m_bPathLatenciesDirty)
+		resetPathLatencies();
+}
+
+
+// Plugin delay compensation: compare and/or apply all path latencies
+// and delay lines; returns which ones were found different.
+int qtractorAudioEngine::updatePathLatencies (
+	const QHash<qtractorAudioBus *, unsigned long>& paths, int iApply )
+{
+	qtractorSession *pSession = session();
+	if (pSession == nullptr)
+		return 0;
+
+	int iChanges = 0;
+
+	for (qtractorBus *pBus = buses().first(); pBus; pBus = pBus->next()) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus == nullptr)
+			continue;
+		qtractorPluginList *pPluginList = pAudioBus->pluginList_out();
+		const unsigned long iPathLatency = paths.value(pAudioBus, 0);
+		const unsigned long iDryLatency
+			= qtractorAudioEngine_chainLatency(pPluginList)
+			+ paths.value(pAudioBus->sumBus(), 0);
+		const unsigned long iDelay
+			= (iPathLatency > iDryLatency ? iPathLatency - iDryLatency : 0);
+		const unsigned short iChannels = (iDelay > 0 ? pAudioBus->channels() : 0);
+		if (pAudioBus->pathLatency() != iPathLatency) {
+			iChanges |= PathLatencies;
+			if (iApply & PathLatencies)
+				pAudioBus->setPathLatency(iPathLatency);
+		}
+		qtractorAudioDelay *pOutputDelay = pAudioBus->outputDelay();
+		if (pOutputDelay->delay() != iDelay
+			|| pOutputDelay->channels() != iChannels) {
+			iChanges |= PathDelays;
+			if (iApply & PathDelays)
+				pOutputDelay->setDelay(iChannels, iDelay);
+		}
+		if (pPluginList
+			&& updateAuxSendDelays(pPluginList, iPathLatency, paths, iApply))
+			iChanges |= PathDelays;
+	}
+
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		qtractorPluginList *pPluginList = pTrack->pluginList();
+		if (pPluginList == nullptr)
+			continue;
+		qtractorAudioBus *pAudioBus = nullptr;
+		qtractorAudioRenderBuffer *pRenderBuffer = nullptr;
+		if (pTrack->trackType() == qtractorTrack::Audio) {
+			pAudioBus = static_cast<qtractorAudioBus *> (pTrack->outputBus());
+			pRenderBuffer = pTrack->renderBuffer();
+		} else {
+			qtractorMidiManager *pMidiManager = pPluginList->midiManager();
+			if (pMidiManager)
+				pAudioBus = pMidiManager->audioOutputBus();
+		}
+		unsigned long iPathLatency = 0;
+		unsigned long iDryLatency = 0;
+		if (pTrack->isPluginListLatency()) {
+			iDryLatency = qtractorAudioEngine_chainLatency(pPluginList)
+				+ paths.value(pAudioBus, 0);
+			// Only audio tracks may delay their own output...
+			if (pRenderBuffer) {
+				iPathLatency = listPathLatency(pPluginList,
+					paths.value(pAudioBus, 0), paths);
+			} else {
+				iPathLatency = iDryLatency;
+			}
+		}
+		unsigned long iDelay = 0;
+		unsigned short iChannels = 0;
+		if (pRenderBuffer && iPathLatency > iDryLatency) {
+			iDelay = iPathLatency - iDryLatency;
+			iChannels = pRenderBuffer->channels();
+		}
+		if (pTrack->pathLatency() != iPathLatency) {
+			iChanges |= PathLatencies;
+			if (iApply & PathLatencies)
+				pTrack->setPathLatency(iPathLatency);
+		}
+		qtractorAudioDelay *pOutputDelay = pTrack->outputDelay();
+		if (pOutputDelay->delay() != iDelay
+			|| pOutputDelay->channels() != iChannels) {
+			iChanges |= PathDelays;
+			if (iApply & PathDelays)
+				pOutputDelay->setDelay(iChannels, iDelay);
+		}
+		if (updateAuxSendDelays(pPluginList, iPathLatency, paths, iApply))
+			iChanges |= PathDelays;
+	}
+
+	return iChanges;
+}
+
+
+// Plugin delay compensation: an output bus path latency,
+// through its own plugin chain, aux-sends and internal
+// (summing) targets, all down to its real (JACK) output.
+unsigned long qtractorAudioEngine::busPathLatency ( qtractorAudioBus *pAudioBus,
+	QHash<qtractorAudioBus *, unsigned long>& paths ) const
+{
+	if (pAudioBus == nullptr)
+		return 0;
+
+	if ((pAudioBus->busMode() & qtractorBus::Output) == 0)
+		return 0;
+
+	if (paths.contains(pAudioBus))
+		return paths.value(pAudioBus);
+
+	// Mark as visited (breaks any aux-send feedback loops)...
+	paths.insert(pAudioBus, 0);
+
+	unsigned long iPathLatency = busPathLatency(pAudioBus->sumBus(), paths);
+
+	qtractorPluginList *pPluginList = pAudioBus->pluginList_out();
+	if (pPluginList)
+		iPathLatency = listPathLatency(pPluginList, iPathLatency, paths);
+
+	paths.insert(pAudioBus, iPathLatency);
+
+	return iPathLatency;
+}
+
+
+// Plugin delay compensation: a plugin chain path latency, the
+// longest either through its output or any of its aux-sends.
+unsigned long qtractorAudioEngine::listPathLatency (
+	qtractorPluginList *pPluginList, unsigned long iOutputLatency,
+	QHash<qtractorAudioBus *, unsigned long>& paths ) const
+{
+	unsigned long iPreLatency = 0;
+	unsigned long iPathLatency = 0;
+
+	for (qtractorPlugin *pPlugin = pPluginList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		if (!pPlugin->isActivated())
+			continue;
+		qtractorAudioAuxSendPlugin *pAuxSendPlugin
+			= qtractorAudioEngine_auxSendPlugin(pPlugin);
+		if (pAuxSendPlugin) {
+			const unsigned long iSendLatency = iPreLatency
+				+ busPathLatency(pAuxSendPlugin->audioBus(), paths);
+			if (iPathLatency < iSendLatency)
+				iPathLatency = iSendLatency;
+		}
+		iPreLatency += pPlugin->latency();
+	}
+
+	if (iPathLatency < iPreLatency + iOutputLatency)
+		iPathLatency = iPreLatency + iOutputLatency;
+
+	return iPathLatency;
+}
+
+
+// Plugin delay compensation: align all aux-send paths
+// of a plugin chain to the given (longest) path latency;
+// returns whether any of the send delays were different.
+bool qtractorAudioEngine::updateAuxSendDelays (
+	qtractorPluginList *pPluginList, unsigned long iPathLatency,
+	const QHash<qtractorAudioBus *, unsigned long>& paths, int iApply ) const
+{
+	bool bChanged = false;
+
+	unsigned long iPreLatency = 0;
+
+	for (qtractorPlugin *pPlugin = pPluginList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		if (!pPlugin->isActivated())
+			continue;
+		qtractorAudioAuxSendPlugin *pAuxSendPlugin
+			= qtractorAudioEngine_auxSendPlugin(pPlugin);
+		if (pAuxSendPlugin) {
+			const unsigned long iSendLatency = iPreLatency
+				+ paths.value(pAuxSendPlugin->audioBus(), 0);
+			const unsigned long iSendDelay = (iPathLatency > iSendLatency
+				? iPathLatency - iSendLatency : 0);
+			if (pAuxSendPlugin->sendDelay() != iSendDelay) {
+				bChanged = true;
+				if (iApply & PathDelays)
+					pAuxSendPlugin->setSendDelay(iSendDelay);
+			}
+		}
+		iPreLatency += pPlugin->latency();
+	}
+
+	return bChanged;
+}
+
+
+// Private (cache-aligned) render buffer pool methods.
+qtractorAudioRenderBuffer *qtractorAudioEngine::acquireRenderBuffer (
+	unsigned short iChannels )
+{
+	if (iChannels < 1)
+		return nullptr;
+
+	// Reuse some free one that fits, if any...
+	QMutableListIterator<qtractorAudioRenderBuffer *> iter(m_renderBuffers);
+	while (iter.hasNext()) {
+		qtractorAudioRenderBuffer *pRenderBuffer = iter.next();
+		if (pRenderBuffer->channels() == iChannels
+			&& pRenderBuffer->bufferSize() >= m_iBufferSizeEx) {
+			iter.remove();
+			pRenderBuffer->setSilent(false);
+			return pRenderBuffer;
+		}
+	}
+
+	// Otherwise, a brand new one...
+	return new qtractorAudioRenderBuffer(iChannels, m_iBufferSizeEx);
+}
+
+
+void qtractorAudioEngine::releaseRenderBuffer (
+	qtractorAudioRenderBuffer *pRenderBuffer )
+{
+	if (pRenderBuffer)
+		m_renderBuffers.append(pRenderBuffer);
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRenderBuffer -- Private (cache-aligned) render buffer
+//
+
+// Cache-line size (in number of floats; 64 bytes).
+static const uintptr_t c_iCacheLine = 16;
+
+// Constructor.
+qtractorAudioRenderBuffer::qtractorAudioRenderBuffer (
+	unsigned short iChannels, unsigned int iBufferSize )
+	: m_iChannels(iChannels), m_iBufferSize(iBufferSize), m_bSilent(false)
+{
+	// Each channel starts on its own cache-line...
+	const unsigned int iStride
+		= (m_iBufferSize + c_iCacheLine - 1) & ~(c_iCacheLine - 1);
+	const unsigned int iFrames = m_iChannels * iStride;
+
+	m_pBlock = new float [iFrames + c_iCacheLine];
+
+	const uintptr_t iAlign = c_iCacheLine * sizeof(float) - 1;
+	float *pFrames = reinterpret_cast<float *> (
+		(reinterpret_cast<uintptr_t> (m_pBlock) + iAlign) & ~iAlign);
+	::memset(pFrames, 0, iFrames * sizeof(float));
+
+	m_ppXBuffer = new float * [m_iChannels];
+	m_ppYBuffer = new float * [m_iChannels];
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		m_ppXBuffer[i] = pFrames + i * iStride;
+		m_ppYBuffer[i] = m_ppXBuffer[i];
+	}
+
+	m_pfFades = new float [m_iBufferSize];
+}
+
+
+// Destructor.
+qtractorAudioRenderBuffer::~qtractorAudioRenderBuffer (void)
+{
+	delete [] m_pfFades;
+	delete [] m_ppYBuffer;
+	delete [] m_ppXBuffer;
+	delete [] m_pBlock;
+}
+
+
+// Set current (offset) frame buffer.
+void qtractorAudioRenderBuffer::setOffset ( unsigned int iOffset )
+{
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		m_ppYBuffer[i] = m_ppXBuffer[i] + iOffset;
+}
+
+
+// Silence propagation: clear the (offset) buffer once,
+// as soon as some actual signal is about to be mixed in.
+void qtractorAudioRenderBuffer::touch ( unsigned int nframes )
+{
+	if (!m_bSilent)
+		return;
+
+	const unsigned int nbytes = nframes * sizeof(float);
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		::memset(m_ppYBuffer[i], 0, nbytes);
+
+	m_bSilent = false;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioDelay -- Preallocated (plugin delay compensation) delay line
+//
+
+// Constructor.
+qtractorAudioDelay::qtractorAudioDelay (void)
+	: m_iChannels(0), m_iDelay(0), m_iSize(0), m_iIndex(0),
+		m_ppBuffer(nullptr)
+{
+}
+
+
+// Destructor.
+qtractorAudioDelay::~qtractorAudioDelay (void)
+{
+	setDelay(0, 0);
+}
+
+
+// Delay line (re)allocation (non-RT).
+void qtractorAudioDelay::setDelay (
+	unsigned short iChannels, unsigned long iDelay )
+{
+	if (iChannels < 1 || iDelay < 1) {
+		if (m_ppBuffer) {
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				delete [] m_ppBuffer[i];
+			delete [] m_ppBuffer;
+			m_ppBuffer = nullptr;
+		}
+		m_iChannels = 0;
+		m_iDelay = 0;
+		m_iSize  = 0;
+		m_iIndex = 0;
+		return;
+	}
+
+	// Only grow when really needed...
+	if (iChannels != m_iChannels || iDelay > m_iSize) {
+		setDelay(0, 0);
+		m_ppBuffer = new float * [iChannels];
+		for (unsigned short i = 0; i < iChannels; ++i)
+			m_ppBuffer[i] = new float [iDelay];
+		m_iChannels = iChannels;
+		m_iSize = iDelay;
+	}
+
+	m_iDelay = iDelay;
+
+	reset();
+}
+
+
+// Clear the delay line (silence).
+void qtractorAudioDelay::reset (void)
+{
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		::memset(m_ppBuffer[i], 0, m_iSize * sizeof(float));
+
+	m_iIndex = 0;
+}
+
+
+// In-place delay processing.
+void qtractorAudioDelay::process ( float **ppBuffer, unsigned int nframes )
+{
+	if (m_iDelay < 1)
+		return;
+
+	unsigned long j = m_iIndex;
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		float *pBuffer = ppBuffer[i];
+		float *pDelay  = m_ppBuffer[i];
+		j = m_iIndex;
+		for (unsigned int n = 0; n < nframes; ++n) {
+			const float fSample = pDelay[j];
+			pDelay[j] = pBuffer[n];
+			pBuffer[n] = fSample;
+			if (++j >= m_iDelay)
+				j = 0;
+		}
+	}
+
+	m_iIndex = j;
+}
+
+
+// Delayed mix-down processing (aux-sends).
+void qtractorAudioDelay::process_add ( float **ppOBuffer, float **ppIBuffer,
+	unsigned int nframes, float fGain )
+{
+	if (m_iDelay < 1)
+		return;
+
+	unsigned long j = m_iIndex;
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		float *pOBuffer = ppOBuffer[i];
+		float *pIBuffer = ppIBuffer[i];
+		float *pDelay   = m_ppBuffer[i];
+		j = m_iIndex;
+		for (unsigned int n = 0; n < nframes; ++n) {
+			pOBuffer[n] += fGain * pDelay[j];
+			pDelay[j] = pIBuffer[n];
+			if (++j >= m_iDelay)
+				j = 0;
+		}
+	}
+
+	m_iIndex = j;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioBus -- Managed JACK port set
 //
@@ -2328,14 +3263,18 @@ qtractorAudioBus::qtractorAudioBus (
 
 	m_bAutoConnect = false;
 
+	m_pSumBus = nullptr;
+
+	setPathLatency(0);
+	m_pOutputDelay = new qtractorAudioDelay();
+
 	m_ppIPorts  = nullptr;
 	m_ppOPorts  = nullptr;
 
 	m_ppIBuffer = nullptr;
 	m_ppOBuffer = nullptr;
 
-	m_ppXBuffer = nullptr;
-	m_ppYBuffer = nullptr;
+	m_pRenderBuffer = nullptr;
 
 	m_bEnabled  = false;
 
@@ -2366,6 +3305,8 @@ qtractorAudioBus::~qtractorAudioBus (void)
 		delete m_pIPluginList;
 	if (m_pOPluginList)
 		delete m_pOPluginList;
+
+	delete m_pOutputDelay;
 }
 
 
@@ -2410,6 +3351,28 @@ bool qtractorAudioBus::isAutoConnect (void) const
 }
 
 
+// Internal (summing) bus target name accessors.
+void qtractorAudioBus::setSumBusName ( const QString& sSumBusName )
+{
+	m_sSumBusName = sSumBusName;
+}
+
+const QString& qtractorAudioBus::sumBusName (void) const
+{
+	return m_sSumBusName;
+}
+
+bool qtractorAudioBus::isInternal (void) const
+{
+	const qtractorBus::BusMode busMode
+		= qtractorAudioBus::busMode();
+
+	return !m_sSumBusName.isEmpty()
+		&& (busMode & qtractorBus::Output)
+		&& !(busMode & qtractorBus::Ex);
+}
+
+
 // Register and pre-allocate bus port buffers.
 bool qtractorAudioBus::open (void)
 {
@@ -2447,6 +3410,13 @@ bool qtractorAudioBus::open (void)
 		}
 	}
 
+	if (isInternal()) {
+		// Internal (summing) bus: no output ports, just own buffers...
+		m_ppOBuffer = new float * [m_iChannels];
+		for (i = 0; i < m_iChannels; ++i)
+			m_ppOBuffer[i] = new float [iBufferSizeEx];
+	}
+	else
 	if (busMode & qtractorBus::Output) {
 		// Register and allocate output port buffers...
 		m_ppOPorts  = new jack_port_t * [m_iChannels];
@@ -2462,13 +3432,8 @@ bool qtractorAudioBus::open (void)
 		}
 	}
 
-	// Allocate internal working bus buffers...
-	m_ppXBuffer = new float * [m_iChannels];
-	m_ppYBuffer = new float * [m_iChannels];
-	for (i = 0; i < m_iChannels; ++i) {
-		m_ppXBuffer[i] = new float [iBufferSizeEx];
-		m_ppYBuffer[i] = nullptr;
-	}
+	// Acquire internal working bus buffer...
+	m_pRenderBuffer = pAudioEngine->acquireRenderBuffer(m_iChannels);
 
 	// Update monitor subject names...
 	qtractorAudioBus::updateBusName();
@@ -2526,6 +3491,9 @@ void qtractorAudioBus::close (void)
 	}
 
 	if (busMode & qtractorBus::Output) {
+		// Make sure no output port gets used after gone...
+		if (m_ppOPorts)
+			pAudioEngine->resetOutputSnapshot(true);
 		// Unregister and free output ports,
 		// if we're not shutdown...
 		if (m_ppOPorts && pJackClient) {
@@ -2536,27 +3504,29 @@ void qtractorAudioBus::close (void)
 				}
 			}
 		}
-		// Free output ports.
+		// Free output ports,
+		// or own internal (summing) buffers...
 		if (m_ppOPorts)
 			delete [] m_ppOPorts;
+		else
+		if (m_ppOBuffer) {
+			for (i = 0; i < m_iChannels; ++i)
+				delete [] m_ppOBuffer[i];
+		}
 		m_ppOPorts = nullptr;
 		// Free output buffers.
 		if (m_ppOBuffer)
 			delete [] m_ppOBuffer;
 		m_ppOBuffer = nullptr;
+		// Free output delay line, if any.
+		m_pOutputDelay->setDelay(0, 0);
+		setPathLatency(0);
 	}
 
-	// Free internal buffers.
-	if (m_ppXBuffer) {
-		for (i = 0; i < m_iChannels; ++i)
-			delete [] m_ppXBuffer[i];
-		delete [] m_ppXBuffer;
-		m_ppXBuffer = nullptr;
-	}
-
-	if (m_ppYBuffer) {
-		delete [] m_ppYBuffer;
-		m_ppYBuffer = nullptr;
+	// Release internal working bus buffer.
+	if (m_pRenderBuffer) {
+		pAudioEngine->releaseRenderBuffer(m_pRenderBuffer);
+		m_pRenderBuffer = nullptr;
 	}
 }
 
@@ -2597,7 +3567,8 @@ void qtractorAudioBus::autoConnect (void)
 		}
 	}
 
-	if ((busMode & qtractorBus::Output) && outputs().isEmpty()) {
+	if ((busMode & qtractorBus::Output) && outputs().isEmpty()
+		&& !isInternal()) {
 		const char **ppszIPorts
 			= jack_get_ports(pJackClient,
 				0, JACK_DEFAULT_AUDIO_TYPE,
@@ -2705,8 +3676,10 @@ void qtractorAudioBus::process_prepare ( unsigned int nframes )
 
 	if (busMode & qtractorBus::Output) {
 		for (i = 0; i < m_iChannels; ++i) {
-			m_ppOBuffer[i] = static_cast<float *>
-				(jack_port_get_buffer(m_ppOPorts[i], nframes));
+			if (m_ppOPorts) {
+				m_ppOBuffer[i] = static_cast<float *>
+					(jack_port_get_buffer(m_ppOPorts[i], nframes));
+			}
 			// Zero-out output buffer...
 			::memset(m_ppOBuffer[i], 0, nframes * sizeof(float));
 		}
@@ -2742,18 +3715,41 @@ void qtractorAudioBus::process_commit ( unsigned int nframes )
 	if (!m_bEnabled)
 		return;
 
+	qtractorDspProfileScope dspProfile(&m_dspProfile);
+
 	if (m_pOPluginList)
 		m_pOPluginList->process(m_ppOBuffer, nframes);
+	if (m_ppOBuffer && m_pOutputDelay->delay() > 0)
+		m_pOutputDelay->process(m_ppOBuffer, nframes);
 	if (m_pOAudioMonitor)
 		m_pOAudioMonitor->process(m_ppOBuffer, nframes);
+
+	// Internal (summing) bus mix-down into its target...
+	if (m_pSumBus && m_pSumBus->isEnabled() && m_ppOBuffer) {
+		float **ppSumBuffer = m_pSumBus->out();
+		const unsigned short iSumChannels = m_pSumBus->channels();
+		if (iSumChannels > m_iChannels) {
+			// Spread over (eg. mono into stereo)...
+			unsigned short j = 0;
+			for (unsigned short i = 0; i < iSumChannels; ++i) {
+				(*m_pfnBufferAdd)(&ppSumBuffer[i], &m_ppOBuffer[j],
+					nframes, 1, 1, 0);
+				if (++j >= m_iChannels)
+					j = 0;
+			}
+		} else {
+			(*m_pfnBufferAdd)(ppSumBuffer, m_ppOBuffer,
+				nframes, iSumChannels, m_iChannels, 0);
+		}
+	}
 }
 
 
-// Bus-buffering methods.
-void qtractorAudioBus::buffer_prepare (
+// Bus-buffering methods (on a private render buffer).
+void qtractorAudioBus::buffer_prepare ( qtractorAudioRenderBuffer *pRenderBuffer,
 	unsigned int nframes, qtractorAudioBus *pInputBus )
 {
-	if (!m_bEnabled)
+	if (!m_bEnabled || pRenderBuffer == nullptr)
 		return;
 
 	qtractorAudioEngine *pAudioEngine
@@ -2764,56 +3760,64 @@ void qtractorAudioBus::buffer_prepare (
 	const unsigned int offset = pAudioEngine->bufferOffset();
 	const unsigned int nbytes = nframes * sizeof(float);
 
+	pRenderBuffer->setOffset(offset);
+
 	if (pInputBus == nullptr) {
-		for (unsigned short i = 0; i < m_iChannels; ++i) {
-			m_ppYBuffer[i] = m_ppXBuffer[i] + offset;
-			::memset(m_ppYBuffer[i], 0, nbytes);
-		}
+		// Defer clearing until something gets mixed in...
+		pRenderBuffer->setSilent(true);
 		return;
 	}
 
+	pRenderBuffer->setSilent(false);
+
+	const unsigned short iChannels = pRenderBuffer->channels();
+	float **ppXBuffer = pRenderBuffer->frames();
+	float **ppYBuffer = pRenderBuffer->buffer();
+
 	const unsigned short iBuffers = pInputBus->channels();
 	float **ppBuffer = pInputBus->in();
 
-	if (m_iChannels == iBuffers) {
+	if (iChannels == iBuffers) {
 		// Exact buffer copy...
-		for (unsigned short i = 0; i < iBuffers; ++i) {
-			m_ppYBuffer[i] = m_ppXBuffer[i] + offset;
-			::memcpy(m_ppYBuffer[i], ppBuffer[i] + offset, nbytes);
-		}
+		for (unsigned short i = 0; i < iBuffers; ++i)
+			::memcpy(ppYBuffer[i], ppBuffer[i] + offset, nbytes);
 	} else {
 		// Buffer merge/multiplex...
 		unsigned short i;
-		for (i = 0; i < m_iChannels; ++i) {
-			m_ppYBuffer[i] = m_ppXBuffer[i] + offset;
-			::memset(m_ppYBuffer[i], 0, nbytes);
-		}
-		if (m_iChannels > iBuffers) {
+		for (i = 0; i < iChannels; ++i)
+			::memset(ppYBuffer[i], 0, nbytes);
+		if (iChannels > iBuffers) {
 			unsigned short j = 0;
-			for (i = 0; i < m_iChannels; ++i) {
-				::memcpy(m_ppYBuffer[i], ppBuffer[j] + offset, nbytes);
+			for (i = 0; i < iChannels; ++i) {
+				::memcpy(ppYBuffer[i], ppBuffer[j] + offset, nbytes);
 				if (++j >= iBuffers)
 					j = 0;
 			}
-		} else { // (m_iChannels < iBuffers)
-			(*m_pfnBufferAdd)(m_ppXBuffer, ppBuffer,
-				nframes, m_iChannels, iBuffers, offset);
+		} else { // (iChannels < iBuffers)
+			(*m_pfnBufferAdd)(ppXBuffer, ppBuffer,
+				nframes, iChannels, iBuffers, offset);
 		}
 	}
 }
 
-void qtractorAudioBus::buffer_commit ( unsigned int nframes )
+void qtractorAudioBus::buffer_commit (
+	qtractorAudioRenderBuffer *pRenderBuffer, unsigned int nframes )
 {
 	if (!m_bEnabled || (busMode() & qtractorBus::Output) == 0)
 		return;
 
+	// Nothing to mix-down, if still silent...
+	if (pRenderBuffer == nullptr || pRenderBuffer->isSilent())
+		return;
+
 	qtractorAudioEngine *pAudioEngine
 		= static_cast<qtractorAudioEngine *> (engine());
 	if (pAudioEngine == nullptr)
 		return;
 
-	(*m_pfnBufferAdd)(m_ppOBuffer, m_ppXBuffer,
-		nframes, m_iChannels, m_iChannels, pAudioEngine->bufferOffset());
+	// Final (vectorized) sum into the bus output...
+	(*m_pfnBufferAdd)(m_ppOBuffer, pRenderBuffer->frames(), nframes,
+		m_iChannels, pRenderBuffer->channels(), pAudioEngine->bufferOffset());
 }
 
 
@@ -3102,6 +4106,8 @@ bool qtractorAudioBus::loadElement (
 		} else if (eProp.tagName() == "auto-connect") {
 			qtractorAudioBus::setAutoConnect(
 				qtractorDocument::boolFromText(eProp.text()));
+		} else if (eProp.tagName() == "sum-bus") {
+			qtractorAudioBus::setSumBusName(eProp.text());
 		} else if (eProp.tagName() == "input-gain") {
 			if (qtractorAudioBus::monitor_in())
 				qtractorAudioBus::monitor_in()->setGain(
@@ -3162,6 +4168,10 @@ bool qtractorAudioBus::saveElement (
 	pDocument->saveTextElement("auto-connect",
 		qtractorDocument::textFromBool(
 			qtractorAudioBus::isAutoConnect()), pElement);
+	if (!qtractorAudioBus::sumBusName().isEmpty()) {
+		pDocument->saveTextElement("sum-bus",
+			qtractorAudioBus::sumBusName(), pElement);
+	}
 
 	if (busMode & qtractorBus::Input) {
 		if (qtractorAudioBus::monitor_in()) {
@@ -24,18 +24,25 @@
 
 #include "qtractorAtomic.h"
 #include "qtractorEngine.h"
+#include "qtractorDspProfile.h"
 
 #include <jack/jack.h>
 
 #include <QObject>
+#include <QList>
+#include <QHash>
+#include <QAtomicPointer>
 
 
 // Forward declarations.
 class qtractorAudioBus;
+class qtractorAudioRenderBuffer;
+class qtractorAudioDelay;
 class qtractorAudioBuffer;
 class qtractorAudioMonitor;
 class qtractorAudioFile;
 class qtractorAudioExportBuffer;
+class qtractorAudioLoudness;
 class qtractorPluginList;
 class qtractorCurveList;
 
@@ -136,6 +143,13 @@ public:
 	// Buffer offset accessor.
 	unsigned int bufferOffset() const;
 
+	// Silence propagation (idle-skipping) statistics.
+	void updateTrackCycles(bool bSkipped)
+		{ ++m_iTrackCycles; if (bSkipped) ++m_iSkipCycles; }
+	unsigned long trackCycles() const { return m_iTrackCycles; }
+	unsigned long skipCycles()  const { return m_iSkipCycles;  }
+	void resetTrackCycles() { m_iTrackCycles = m_iSkipCycles = 0; }
+
 	// Audio (Master) bus defaults accessors.
 	void setMasterAutoConnect(bool bMasterAutoConnect);
 	bool isMasterAutoConnect() const;
@@ -153,6 +167,9 @@ public:
 	unsigned long exportOffset() const;
 	unsigned long exportLength() const;
 
+	// Last export loudness and true-peak meter accessor.
+	qtractorAudioLoudness *exportLoudness() const;
+
 	// Audio-export method.
 	bool fileExport(const QString& sExportPath,
 		const QList<qtractorAudioBus *>& exportBuses,
@@ -238,9 +255,33 @@ public:
 	// Absolute number of frames elapsed since engine start.
 	unsigned long jackFrameTime() const;
 
+	// Absolute frame time at the start of current process cycle.
+	unsigned long jackCycleTime() const;
+
 	// Reset all audio monitoring...
 	void resetAllMonitors();
 
+	// Internal (summing) buses graph reset.
+	void resetSumBuses();
+
+	// Physical output ports snapshot reset (or clear).
+	void resetOutputSnapshot(bool bClear = false);
+
+	// Graph-wide plugin delay compensation (path latencies) reset.
+	void resetPathLatencies();
+
+	// Deferred path latencies reset: mark the graph dirty only,
+	// then reset once, whenever idle (non real-time).
+	void setPathLatenciesDirty()
+		{ m_bPathLatenciesDirty = true; }
+	bool isPathLatenciesDirty() const
+		{ return m_bPathLatenciesDirty; }
+	void updatePathLatenciesDirty();
+
+	// Private (cache-aligned) render buffer pool methods.
+	qtractorAudioRenderBuffer *acquireRenderBuffer(unsigned short iChannels);
+	void releaseRenderBuffer(qtractorAudioRenderBuffer *pRenderBuffer);
+
 protected:
 
 	// Concrete device (de)activation methods.
@@ -265,9 +306,35 @@ protected:
 	// Freewheeling process cycle executive (needed for export).
 	void process_export(unsigned int nframes);
 
+	// Regular process cycle executive (session acquired or not).
+	int process_cycle(unsigned int nframes);
+
+	// Session busy (locked) fallback, de-clicked silence.
+	void process_busy(unsigned int nframes);
+
+	// Physical output ports snapshot update (last sample, fade-in).
+	void process_snapshot(unsigned int nframes);
+
+	// JACK MIDI output ports clearance (every cycle).
+	void process_midi_clear(unsigned int nframes);
+
 	// Metronome latency offset compensation.
 	unsigned long metro_offset(unsigned long iFrame) const;
 
+	// Plugin delay compensation helpers.
+	unsigned long busPathLatency(qtractorAudioBus *pAudioBus,
+		QHash<qtractorAudioBus *, unsigned long>& paths) const;
+	unsigned long listPathLatency(qtractorPluginList *pPluginList,
+		unsigned long iPathLatency,
+		QHash<qtractorAudioBus *, unsigned long>& paths) const;
+	enum { PathLatencies = 1, PathDelays = 2 };
+	int updatePathLatencies(
+		const QHash<qtractorAudioBus *, unsigned long>& paths, int iApply);
+	bool updateAuxSendDelays(qtractorPluginList *pPluginList,
+		unsigned long iPathLatency,
+		const QHash<qtractorAudioBus *, unsigned long>& paths,
+		int iApply) const;
+
 private:
 
 	// Special event notifier proxy object.
@@ -290,6 +357,50 @@ private:
 	// careful for proper loop concatenation.
 	unsigned int m_iBufferOffset;
 
+	// Silence propagation (idle-skipping) statistics.
+	volatile unsigned long m_iTrackCycles;
+	volatile unsigned long m_iSkipCycles;
+
+	// Internal (summing) buses graph,
+	// in topological (commit) order.
+	qtractorAudioBus **m_ppSumBuses;
+	unsigned int       m_iSumBuses;
+
+	// Physical output ports snapshot (de-click only): the only thing
+	// the RT thread touches while the session is locked for editing,
+	// to fade out whatever was last sent; published by atomic pointer
+	// swap, old ones retired to a garbage list and reclaimed later,
+	// once past any cycle that was in progress when retired.
+	struct OutputSnapshot
+	{
+		unsigned int  count;
+		jack_port_t **ports;
+		float        *last;		// Last sample sent (RT owned).
+		unsigned int  midiCount;
+		jack_port_t **midiPorts;	// JACK MIDI outputs (cleared).
+		int           epoch;	// Process cycle epoch when retired.
+	};
+
+	QAtomicPointer<OutputSnapshot> m_pOutputSnapshot;
+
+	// Retired output snapshots (garbage list).
+	QList<OutputSnapshot *> m_retiredSnapshots;
+
+	// Retired output snapshots reclamation.
+	void reclaimOutputSnapshots(bool bForce = false);
+
+	// Process cycle epoch (odd while inside a cycle).
+	QAtomicInt m_iProcessEpoch;
+
+	// Whether last cycle(s) went busy (fade-in next).
+	bool m_bProcessBusy;
+
+	// Whether path latencies are due for a (deferred) reset.
+	bool m_bPathLatenciesDirty;
+
+	// Private render buffer pool (free list).
+	QList<qtractorAudioRenderBuffer *> m_renderBuffers;
+
 	// Audio (Master) bus defaults.
 	bool m_bMasterAutoConnect;
 
@@ -310,6 +421,8 @@ private:
 	QList<qtractorAudioBus *> *m_pExportBuses;
 	qtractorAudioExportBuffer *m_pExportBuffer;
 
+	qtractorAudioLoudness *m_pExportLoudness;
+
 	// Audio metronome stuff.
 	bool                 m_bMetronome;
 	bool                 m_bMetroBus;
@@ -347,6 +460,106 @@ private:
 };
 
 
+//----------------------------------------------------------------------
+// class qtractorAudioRenderBuffer -- Private (cache-aligned) render buffer
+//
+
+class qtractorAudioRenderBuffer
+{
+public:
+
+	// Constructor.
+	qtractorAudioRenderBuffer(unsigned short iChannels, unsigned int iBufferSize);
+
+	// Destructor.
+	~qtractorAudioRenderBuffer();
+
+	// Brainless accessors.
+	unsigned short channels() const { return m_iChannels; }
+	unsigned int bufferSize() const { return m_iBufferSize; }
+
+	// Whole (non-offset) frame buffer accessor.
+	float **frames() const { return m_ppXBuffer; }
+
+	// Current (offset) frame buffer accessor.
+	float **buffer() const { return m_ppYBuffer; }
+
+	// Set current (offset) frame buffer.
+	void setOffset(unsigned int iOffset);
+
+	// Per-frame gains (clip fade envelope) scratch buffer.
+	float *fades() const { return m_pfFades; }
+
+	// Silence propagation: buffer is known to be silent
+	// (not yet cleared) until some signal gets mixed into it.
+	void setSilent(bool bSilent) { m_bSilent = bSilent; }
+	bool isSilent() const { return m_bSilent; }
+
+	// Clear the (offset) buffer once, if still silent.
+	void touch(unsigned int nframes);
+
+private:
+
+	// Instance variables.
+	unsigned short m_iChannels;
+	unsigned int   m_iBufferSize;
+
+	// Single contiguous block, channels at cache-line strides.
+	float  *m_pBlock;
+
+	float **m_ppXBuffer;
+	float **m_ppYBuffer;
+
+	float  *m_pfFades;
+
+	// Buffer silence flag (current cycle).
+	bool    m_bSilent;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioDelay -- Preallocated (plugin delay compensation) delay line
+//
+
+class qtractorAudioDelay
+{
+public:
+
+	// Constructor.
+	qtractorAudioDelay();
+
+	// Destructor.
+	~qtractorAudioDelay();
+
+	// Delay line (re)allocation (non-RT).
+	void setDelay(unsigned short iChannels, unsigned long iDelay);
+
+	// Brainless accessors.
+	unsigned short channels() const { return m_iChannels; }
+	unsigned long delay() const { return m_iDelay; }
+
+	// Clear the delay line (silence).
+	void reset();
+
+	// In-place delay processing.
+	void process(float **ppBuffer, unsigned int nframes);
+
+	// Delayed mix-down processing (aux-sends).
+	void process_add(float **ppOBuffer, float **ppIBuffer,
+		unsigned int nframes, float fGain);
+
+private:
+
+	// Instance variables.
+	unsigned short m_iChannels;
+	unsigned long  m_iDelay;
+	unsigned long  m_iSize;
+	unsigned long  m_iIndex;
+
+	float **m_ppBuffer;
+};
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioBus -- Managed JACK port set
 //
@@ -371,10 +584,42 @@ public:
 	void setAutoConnect(bool bAutoConnect);
 	bool isAutoConnect() const;
 
+	// Internal (summing) bus target name accessors;
+	// internal output buses have no JACK ports of their own
+	// and get summed directly into another (target) bus.
+	void setSumBusName(const QString& sSumBusName);
+	const QString& sumBusName() const;
+
+	bool isInternal() const;
+
+	// Internal (summing) bus target (resolved by engine).
+	void setSumBus(qtractorAudioBus *pSumBus)
+		{ m_pSumBus = pSumBus; }
+	qtractorAudioBus *sumBus() const
+		{ return m_pSumBus; }
+
+	// Plugin delay compensation: total output path latency
+	// and own output delay line (aligning aux-send paths).
+	void setPathLatency(unsigned long iPathLatency)
+		{ ATOMIC_SET(&m_pathLatency, int(iPathLatency)); }
+	unsigned long pathLatency() const
+		{ return (unsigned long) ATOMIC_GET(&m_pathLatency); }
+
+	qtractorAudioDelay *outputDelay() const
+		{ return m_pOutputDelay; }
+
+	// DSP load profile (bus commits).
+	qtractorDspProfile *dspProfile()
+		{ return &m_dspProfile; }
+
 	// Concrete activation methods.
 	bool open();
 	void close();
 
+	// JACK output ports (null if none or internal).
+	jack_port_t **outputPorts() const
+		{ return m_ppOPorts; }
+
 	// Auto-connect to physical ports.
 	void autoConnect();
 
@@ -383,16 +628,32 @@ public:
 	void process_monitor(unsigned int nframes);
 	void process_commit(unsigned int nframes);
 
-	// Bus-buffering methods.
+	// Bus-buffering methods (on a private render buffer).
+	void buffer_prepare(qtractorAudioRenderBuffer *pRenderBuffer,
+		unsigned int nframes, qtractorAudioBus *pInputBus = nullptr);
+	void buffer_commit(qtractorAudioRenderBuffer *pRenderBuffer,
+		unsigned int nframes);
+
+	// Bus-buffering methods (on its own render buffer).
 	void buffer_prepare(unsigned int nframes,
-		qtractorAudioBus *pInputBus = nullptr);
-	void buffer_commit(unsigned int nframes);
+		qtractorAudioBus *pInputBus = nullptr)
+		{ buffer_prepare(m_pRenderBuffer, nframes, pInputBus); }
+	void buffer_commit(unsigned int nframes)
+		{ buffer_commit(m_pRenderBuffer, nframes); }
+
+	// Silence propagation: bus-buffer is known to be silent
+	// (not yet cleared) until some signal gets mixed into it.
+	void buffer_touch(unsigned int nframes)
+		{ if (m_pRenderBuffer) m_pRenderBuffer->touch(nframes); }
+	bool isSilent() const
+		{ return (m_pRenderBuffer && m_pRenderBuffer->isSilent()); }
 
 	// Up-and-running predicate.
 	bool isEnabled() const { return m_bEnabled; }
 
 	// Frame buffer accessors.
-	float **buffer() const { return m_ppYBuffer; }
+	float **buffer() const
+		{ return (m_pRenderBuffer ? m_pRenderBuffer->buffer() : nullptr); }
 
 	float **in()  const	{ return m_ppIBuffer; }
 	float **out() const { return m_ppOBuffer; }
@@ -445,6 +706,17 @@ private:
 	unsigned short m_iChannels;
 	bool           m_bAutoConnect;
 
+	// Internal (summing) bus target.
+	QString           m_sSumBusName;
+	qtractorAudioBus *m_pSumBus;
+
+	// Plugin delay compensation.
+	qtractorAtomic      m_pathLatency;
+	qtractorAudioDelay *m_pOutputDelay;
+
+	// DSP load profile (bus commits).
+	qtractorDspProfile  m_dspProfile;
+
 	// Specific monitor instances.
 	qtractorAudioMonitor *m_pIAudioMonitor;
 	qtractorAudioMonitor *m_pOAudioMonitor;
@@ -458,8 +730,9 @@ private:
 	jack_port_t **m_ppOPorts;
 	float       **m_ppIBuffer;
 	float       **m_ppOBuffer;
-	float       **m_ppXBuffer;
-	float       **m_ppYBuffer;
+
+	// Own private render buffer.
+	qtractorAudioRenderBuffer *m_pRenderBuffer;
 
 	// Special under-work flag...
 	// (r/w access should be atomic)
@@ -0,0 +1,645 @@
+// qtractorAudioLoudness.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioLoudness.h"
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+
+#include <cmath>
+
+
+// True-peak interpolator taps (per phase) and phases (oversampling).
+#define QTRACTOR_TRUE_PEAK_TAPS    12
+#define QTRACTOR_TRUE_PEAK_PHASES  4
+
+// Short-term window, in 100ms sub-blocks (3s).
+#define QTRACTOR_LOUDNESS_BLOCKS   30
+
+// Integrated loudness histogram range (LUFS) and resolution (0.1 LU).
+#define QTRACTOR_LOUDNESS_HIST_MAX  10.0f
+#define QTRACTOR_LOUDNESS_HIST_BINS \
+	int(10.0f * (QTRACTOR_LOUDNESS_HIST_MAX - QTRACTOR_AUDIO_LOUDNESS_MIN))
+
+// Metering worker thread period (msecs).
+#define QTRACTOR_LOUDNESS_PERIOD   20
+
+
+// ITU-R BS.1770-4 Annex 2 -- 4x oversampling polyphase FIR.
+static const float c_afTruePeakTaps
+	[QTRACTOR_TRUE_PEAK_PHASES][QTRACTOR_TRUE_PEAK_TAPS] =
+{
+	{  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,
+	   0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+	   0.9721679687500f, -0.1022949218750f,  0.0476074218750f,
+	  -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+	{ -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,
+	   0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+	   0.7797851562500f, -0.2003173828125f,  0.1015625000000f,
+	  -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+	{ -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,
+	   0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+	   0.4650878906250f, -0.1665039062500f,  0.0891113281250f,
+	  -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+	{ -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,
+	   0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+	   0.1373291015625f, -0.0594482421875f,  0.0332031250000f,
+	  -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+
+// Mean-square energy to loudness (LUFS).
+static inline float qtractorAudioLoudness_lufs ( double fEnergy )
+{
+	if (fEnergy < 1E-10)
+		return QTRACTOR_AUDIO_LOUDNESS_MIN;
+
+	const float fLoudness = -0.691f + 10.0f * float(::log10(fEnergy));
+	return (fLoudness > QTRACTOR_AUDIO_LOUDNESS_MIN
+		? fLoudness : QTRACTOR_AUDIO_LOUDNESS_MIN);
+}
+
+// Linear value to decibels.
+static inline float qtractorAudioLoudness_dB ( float fValue )
+{
+	if (fValue < 1E-6f)
+		return QTRACTOR_AUDIO_LOUDNESS_MIN;
+
+	const float dB = 20.0f * ::log10f(fValue);
+	return (dB > QTRACTOR_AUDIO_LOUDNESS_MIN
+		? dB : QTRACTOR_AUDIO_LOUDNESS_MIN);
+}
+
+
+//----------------------------------------------------------------------
+// struct qtractorAudioLoudness::Channel -- Per-channel analysis state.
+//
+
+struct qtractorAudioLoudness::Channel
+{
+	// K-weighting filter states (pre-filter, RLB high-pass).
+	double x1[2], x2[2], y1[2], y2[2];
+
+	// True-peak interpolator history (doubled, no wrap-around).
+	float hist[2 * QTRACTOR_TRUE_PEAK_TAPS];
+	unsigned int ihist;
+
+	// Current sub-block sums (K-weighted and plain squares).
+	double zsum;
+	double ssum;
+
+	// Last 300ms worth of plain sub-block mean squares.
+	double rms[3];
+
+	// Readouts.
+	volatile float fSamplePeak;
+	volatile float fTruePeak;
+	volatile float fRms;
+};
+
+
+// Analyze a run of frames on a single channel.
+void qtractorAudioLoudness::processChannel (
+	Channel *pChannel, const float *pFrames, unsigned int iFrames )
+{
+	float fSamplePeak = pChannel->fSamplePeak;
+	float fTruePeak = pChannel->fTruePeak;
+
+	double zsum = pChannel->zsum;
+	double ssum = pChannel->ssum;
+
+	for (unsigned int n = 0; n < iFrames; ++n) {
+		const float x = pFrames[n];
+		// Sample peak...
+		const float ax = ::fabsf(x);
+		if (fSamplePeak < ax)
+			fSamplePeak = ax;
+		ssum += double(x) * double(x);
+		// True peak...
+		unsigned int i = pChannel->ihist;
+		i = (i + QTRACTOR_TRUE_PEAK_TAPS - 1) % QTRACTOR_TRUE_PEAK_TAPS;
+		pChannel->hist[i] = pChannel->hist[i + QTRACTOR_TRUE_PEAK_TAPS] = x;
+		pChannel->ihist = i;
+		const float *h = &pChannel->hist[i];
+		for (unsigned int p = 0; p < QTRACTOR_TRUE_PEAK_PHASES; ++p) {
+			const float *c = c_afTruePeakTaps[p];
+			float y = 0.0f;
+			for (unsigned int k = 0; k < QTRACTOR_TRUE_PEAK_TAPS; ++k)
+				y += c[k] * h[k];
+			y = ::fabsf(y);
+			if (fTruePeak < y)
+				fTruePeak = y;
+		}
+		// K-weighting...
+		double z = double(x);
+		for (unsigned int s = 0; s < 2; ++s) {
+			const double y = m_kb[s][0] * z
+				+ m_kb[s][1] * pChannel->x1[s] + m_kb[s][2] * pChannel->x2[s]
+				- m_ka[s][0] * pChannel->y1[s] - m_ka[s][1] * pChannel->y2[s];
+			pChannel->x2[s] = pChannel->x1[s];
+			pChannel->x1[s] = z;
+			pChannel->y2[s] = pChannel->y1[s];
+			pChannel->y1[s] = y;
+			z = y;
+		}
+		zsum += z * z;
+	}
+
+	// Avoid denormals creeping in on silence...
+	for (unsigned int s = 0; s < 2; ++s) {
+		if (::fabs(pChannel->y1[s]) < 1E-20) pChannel->y1[s] = 0.0;
+		if (::fabs(pChannel->y2[s]) < 1E-20) pChannel->y2[s] = 0.0;
+	}
+
+	pChannel->zsum = zsum;
+	pChannel->ssum = ssum;
+
+	pChannel->fSamplePeak = fSamplePeak;
+	pChannel->fTruePeak = (fTruePeak > fSamplePeak ? fTruePeak : fSamplePeak);
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioLoudnessThread -- Metering worker thread.
+//
+
+class qtractorAudioLoudnessThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioLoudnessThread() : m_bRunState(true) {}
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_bRunState = bRunState;
+		m_cond.wakeAll();
+	}
+
+	// Registry management.
+	void addLoudness(qtractorAudioLoudness *pLoudness)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_list.append(pLoudness);
+	}
+
+	int removeLoudness(qtractorAudioLoudness *pLoudness)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_list.removeAll(pLoudness);
+		return m_list.count();
+	}
+
+	// Synchronize all registered instances.
+	void syncAll()
+	{
+		QMutexLocker locker(&m_mutex);
+		sync();
+	}
+
+protected:
+
+	// Synchronize all registered instances (unlocked).
+	void sync()
+	{
+		QListIterator<qtractorAudioLoudness *> iter(m_list);
+		while (iter.hasNext())
+			iter.next()->sync();
+	}
+
+	// The main thread executive.
+	void run()
+	{
+		m_mutex.lock();
+		while (m_bRunState) {
+			sync();
+			m_cond.wait(&m_mutex, QTRACTOR_LOUDNESS_PERIOD);
+		}
+		m_mutex.unlock();
+	}
+
+private:
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+
+	// The registered (asynchronous) instances.
+	QList<qtractorAudioLoudness *> m_list;
+};
+
+
+// The common metering worker thread (lazily started).
+static qtractorAudioLoudnessThread *g_pLoudnessThread = nullptr;
+static QMutex g_loudnessMutex;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioLoudness -- Loudness and true-peak meter.
+//
+
+// Constructor.
+qtractorAudioLoudness::qtractorAudioLoudness (
+	unsigned short iChannels, unsigned int iSampleRate, bool bAsync )
+	: m_iChannels(iChannels), m_iSampleRate(iSampleRate),
+		m_pRingBuffer(nullptr), m_ppPubFrames(nullptr),
+		m_ppSyncFrames(nullptr), m_iSyncFrames(0),
+		m_iOverruns(0), m_iResetPending(0)
+{
+	if (m_iSampleRate < 8000)
+		m_iSampleRate = 48000;
+
+	m_pChannels = new Channel [m_iChannels];
+
+	// 100ms sub-blocks, as in 75% overlapping 400ms gating blocks.
+	m_iBlockSize = m_iSampleRate / 10;
+	m_iBlockFrames = 0;
+
+	m_pdBlocks = new double [QTRACTOR_LOUDNESS_BLOCKS];
+	m_iBlockIndex = 0;
+	m_iBlockCount = 0;
+
+	m_piHistCounts = new unsigned int [QTRACTOR_LOUDNESS_HIST_BINS];
+	m_pdHistEnergy = new double [QTRACTOR_LOUDNESS_HIST_BINS];
+
+	// K-weighting filter coefficients, for the actual sample-rate
+	// (ITU-R BS.1770-4; as re-derived from the 48kHz reference)...
+	const double fs = double(m_iSampleRate);
+	// Stage 1: high-shelf pre-filter.
+	double f0 = 1681.974450955533;
+	double Q  = 0.7071752369554196;
+	double K  = ::tan(M_PI * f0 / fs);
+	const double Vh = ::pow(10.0, 3.999843853973347 / 20.0);
+	const double Vb = ::pow(Vh, 0.4996667741545416);
+	double a0 = 1.0 + K / Q + K * K;
+	m_kb[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+	m_kb[0][1] = 2.0 * (K * K - Vh) / a0;
+	m_kb[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+	m_ka[0][0] = 2.0 * (K * K - 1.0) / a0;
+	m_ka[0][1] = (1.0 - K / Q + K * K) / a0;
+	// Stage 2: RLB high-pass.
+	f0 = 38.13547087602444;
+	Q  = 0.5003270373238773;
+	K  = ::tan(M_PI * f0 / fs);
+	a0 = 1.0 + K / Q + K * K;
+	m_kb[1][0] =  1.0;
+	m_kb[1][1] = -2.0;
+	m_kb[1][2] =  1.0;
+	m_ka[1][0] = 2.0 * (K * K - 1.0) / a0;
+	m_ka[1][1] = (1.0 - K / Q + K * K) / a0;
+
+	resetState();
+
+	// Asynchronous set up, about half a second worth of queue...
+	if (bAsync && m_iChannels > 0) {
+		m_pRingBuffer = new qtractorRingBuffer<float> (
+			m_iChannels, m_iSampleRate >> 1);
+		m_ppPubFrames = new float * [m_iChannels];
+		m_iSyncFrames = 1024;
+		m_ppSyncFrames = new float * [m_iChannels];
+		for (unsigned short i = 0; i < m_iChannels; ++i) {
+			m_ppPubFrames[i] = nullptr;
+			m_ppSyncFrames[i] = new float [m_iSyncFrames];
+		}
+		// Register on the common worker thread...
+		QMutexLocker locker(&g_loudnessMutex);
+		if (g_pLoudnessThread == nullptr) {
+			g_pLoudnessThread = new qtractorAudioLoudnessThread();
+			g_pLoudnessThread->start(QThread::LowPriority);
+		}
+		g_pLoudnessThread->addLoudness(this);
+	}
+}
+
+
+// Destructor.
+qtractorAudioLoudness::~qtractorAudioLoudness (void)
+{
+	// Unregister from the common worker thread,
+	// shutting it down when no longer needed...
+	if (m_pRingBuffer) {
+		QMutexLocker locker(&g_loudnessMutex);
+		if (g_pLoudnessThread
+			&& g_pLoudnessThread->removeLoudness(this) < 1) {
+			g_pLoudnessThread->setRunState(false);
+			g_pLoudnessThread->wait();
+			delete g_pLoudnessThread;
+			g_pLoudnessThread = nullptr;
+		}
+	}
+
+	if (m_ppSyncFrames) {
+		for (unsigned short i = 0; i < m_iChannels; ++i)
+			delete [] m_ppSyncFrames[i];
+		delete [] m_ppSyncFrames;
+	}
+
+	if (m_ppPubFrames)
+		delete [] m_ppPubFrames;
+
+	if (m_pRingBuffer)
+		delete m_pRingBuffer;
+
+	delete [] m_pdHistEnergy;
+	delete [] m_piHistCounts;
+	delete [] m_pdBlocks;
+
+	delete [] m_pChannels;
+}
+
+
+// Real-time publisher (asynchronous mode only, lock-free).
+void qtractorAudioLoudness::write (
+	float **ppFrames, unsigned int iFrames, unsigned short iChannels )
+{
+	if (m_pRingBuffer == nullptr)
+		return;
+
+	if (iChannels < 1)
+		iChannels = m_iChannels;
+
+	// Map (wrap-around) channels, as the monitors do...
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		m_ppPubFrames[i] = ppFrames[i % iChannels];
+
+	const int nwrite = m_pRingBuffer->write(m_ppPubFrames, iFrames);
+	if (nwrite < int(iFrames))
+		m_iOverruns += (iFrames - nwrite);
+}
+
+
+// Analysis processor (worker thread or offline).
+void qtractorAudioLoudness::process ( float **ppFrames, unsigned int iFrames )
+{
+	if (m_iResetPending > 0) {
+		m_iResetPending = 0;
+		resetState();
+	}
+
+	unsigned int iOffset = 0;
+	while (iOffset < iFrames) {
+		unsigned int nframes = m_iBlockSize - m_iBlockFrames;
+		if (nframes > iFrames - iOffset)
+			nframes = iFrames - iOffset;
+		for (unsigned short i = 0; i < m_iChannels; ++i) {
+			processChannel(&m_pChannels[i], ppFrames[i] + iOffset, nframes);
+		}
+		iOffset += nframes;
+		m_iBlockFrames += nframes;
+		if (m_iBlockFrames >= m_iBlockSize) {
+			m_iBlockFrames = 0;
+			processBlock();
+		}
+	}
+}
+
+
+// Drain and analyze whatever has been published so far.
+void qtractorAudioLoudness::sync (void)
+{
+	if (m_pRingBuffer == nullptr)
+		return;
+
+	int nread = m_pRingBuffer->read(m_ppSyncFrames, m_iSyncFrames);
+	while (nread > 0) {
+		process(m_ppSyncFrames, nread);
+		nread = m_pRingBuffer->read(m_ppSyncFrames, m_iSyncFrames);
+	}
+}
+
+
+// Request a reset of all measurements (any thread).
+void qtractorAudioLoudness::reset (void)
+{
+	++m_iResetPending;
+}
+
+
+// Reset all measurements (analysis side).
+void qtractorAudioLoudness::resetState (void)
+{
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		Channel *pChannel = &m_pChannels[i];
+		for (unsigned int s = 0; s < 2; ++s) {
+			pChannel->x1[s] = pChannel->x2[s] = 0.0;
+			pChannel->y1[s] = pChannel->y2[s] = 0.0;
+		}
+		for (unsigned int k = 0; k < 2 * QTRACTOR_TRUE_PEAK_TAPS; ++k)
+			pChannel->hist[k] = 0.0f;
+		pChannel->ihist = 0;
+		pChannel->zsum = 0.0;
+		pChannel->ssum = 0.0;
+		pChannel->rms[0] = pChannel->rms[1] = pChannel->rms[2] = 0.0;
+		pChannel->fSamplePeak = 0.0f;
+		pChannel->fTruePeak = 0.0f;
+		pChannel->fRms = 0.0f;
+	}
+
+	m_iBlockFrames = 0;
+
+	for (unsigned int j = 0; j < QTRACTOR_LOUDNESS_BLOCKS; ++j)
+		m_pdBlocks[j] = 0.0;
+	m_iBlockIndex = 0;
+	m_iBlockCount = 0;
+
+	for (int k = 0; k < QTRACTOR_LOUDNESS_HIST_BINS; ++k) {
+		m_piHistCounts[k] = 0;
+		m_pdHistEnergy[k] = 0.0;
+	}
+
+	m_fMomentary  = QTRACTOR_AUDIO_LOUDNESS_MIN;
+	m_fShortTerm  = QTRACTOR_AUDIO_LOUDNESS_MIN;
+	m_fIntegrated = QTRACTOR_AUDIO_LOUDNESS_MIN;
+}
+
+
+// End of a 100ms sub-block.
+void qtractorAudioLoudness::processBlock (void)
+{
+	const double fBlockSize = double(m_iBlockSize);
+
+	// All channels equally weighted (no surround layout known)...
+	double fEnergy = 0.0;
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		Channel *pChannel = &m_pChannels[i];
+		fEnergy += pChannel->zsum / fBlockSize;
+		pChannel->rms[m_iBlockIndex % 3] = pChannel->ssum / fBlockSize;
+		pChannel->fRms = float(::sqrt((pChannel->rms[0]
+			+ pChannel->rms[1] + pChannel->rms[2]) / 3.0));
+		pChannel->zsum = 0.0;
+		pChannel->ssum = 0.0;
+	}
+
+	m_pdBlocks[m_iBlockIndex] = fEnergy;
+	if (++m_iBlockIndex >= QTRACTOR_LOUDNESS_BLOCKS)
+		m_iBlockIndex = 0;
+	if (m_iBlockCount < QTRACTOR_LOUDNESS_BLOCKS)
+		++m_iBlockCount;
+
+	// Not enough for a 400ms gating block yet?
+	if (m_iBlockCount < 4)
+		return;
+
+	// Momentary (400ms) and short-term (up to 3s) windows...
+	double fMomentary = 0.0;
+	double fShortTerm = 0.0;
+	unsigned int j = m_iBlockIndex;
+	for (unsigned int k = 0; k < m_iBlockCount; ++k) {
+		j = (j + QTRACTOR_LOUDNESS_BLOCKS - 1) % QTRACTOR_LOUDNESS_BLOCKS;
+		if (k < 4)
+			fMomentary += m_pdBlocks[j];
+		fShortTerm += m_pdBlocks[j];
+	}
+	fMomentary /= 4.0;
+	fShortTerm /= double(m_iBlockCount);
+
+	m_fMomentary = qtractorAudioLoudness_lufs(fMomentary);
+	m_fShortTerm = qtractorAudioLoudness_lufs(fShortTerm);
+
+	// Gating block goes into the histogram (absolute gate)...
+	const float fLoudness = qtractorAudioLoudness_lufs(fMomentary);
+	if (fLoudness > QTRACTOR_AUDIO_LOUDNESS_MIN) {
+		int iBin = int(10.0f * (fLoudness - QTRACTOR_AUDIO_LOUDNESS_MIN));
+		if (iBin >= QTRACTOR_LOUDNESS_HIST_BINS)
+			iBin = QTRACTOR_LOUDNESS_HIST_BINS - 1;
+		++m_piHistCounts[iBin];
+		m_pdHistEnergy[iBin] += fMomentary;
+		updateIntegrated();
+	}
+}
+
+
+// Loudness histogram (integrated) evaluation.
+void qtractorAudioLoudness::updateIntegrated (void)
+{
+	double fEnergy = 0.0;
+	unsigned long iCount = 0;
+
+	int k = 0;
+	for ( ; k < QTRACTOR_LOUDNESS_HIST_BINS; ++k) {
+		iCount  += m_piHistCounts[k];
+		fEnergy += m_pdHistEnergy[k];
+	}
+
+	if (iCount < 1)
+		return;
+
+	// Relative gate (-10 LU), at the histogram resolution (0.1 LU)...
+	const float fGate
+		= qtractorAudioLoudness_lufs(fEnergy / double(iCount)) - 10.0f;
+	k = int(10.0f * (fGate - QTRACTOR_AUDIO_LOUDNESS_MIN));
+	if (k < 0)
+		k = 0;
+
+	fEnergy = 0.0;
+	iCount = 0;
+	for ( ; k < QTRACTOR_LOUDNESS_HIST_BINS; ++k) {
+		iCount  += m_piHistCounts[k];
+		fEnergy += m_pdHistEnergy[k];
+	}
+
+	if (iCount > 0)
+		m_fIntegrated = qtractorAudioLoudness_lufs(fEnergy / double(iCount));
+}
+
+
+// Per-channel readouts (linear; peaks held since last reset).
+float qtractorAudioLoudness::samplePeak ( unsigned short iChannel ) const
+{
+	return (iChannel < m_iChannels ? m_pChannels[iChannel].fSamplePeak : 0.0f);
+}
+
+float qtractorAudioLoudness::truePeak ( unsigned short iChannel ) const
+{
+	return (iChannel < m_iChannels ? m_pChannels[iChannel].fTruePeak : 0.0f);
+}
+
+float qtractorAudioLoudness::rms ( unsigned short iChannel ) const
+{
+	return (iChannel < m_iChannels ? m_pChannels[iChannel].fRms : 0.0f);
+}
+
+
+// Overall maximum true-peak (linear).
+float qtractorAudioLoudness::maxTruePeak (void) const
+{
+	float fTruePeak = 0.0f;
+
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		if (fTruePeak < m_pChannels[i].fTruePeak)
+			fTruePeak = m_pChannels[i].fTruePeak;
+	}
+
+	return fTruePeak;
+}
+
+
+// Pretty summary text (eg. for tool-tips).
+QString qtractorAudioLoudness::text (void) const
+{
+	float fSamplePeak = 0.0f;
+	float fRms = 0.0f;
+
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		if (fSamplePeak < m_pChannels[i].fSamplePeak)
+			fSamplePeak = m_pChannels[i].fSamplePeak;
+		if (fRms < m_pChannels[i].fRms)
+			fRms = m_pChannels[i].fRms;
+	}
+
+	QString sText;
+	sText += QObject::tr("Peak: %1 dBFS")
+		.arg(qtractorAudioLoudness_dB(fSamplePeak), 0, 'f', 1) + '\n';
+	sText += QObject::tr("True peak: %1 dBTP")
+		.arg(qtractorAudioLoudness_dB(maxTruePeak()), 0, 'f', 1) + '\n';
+	sText += QObject::tr("RMS: %1 dBFS")
+		.arg(qtractorAudioLoudness_dB(fRms), 0, 'f', 1) + '\n';
+	sText += QObject::tr("Momentary: %1 LUFS")
+		.arg(m_fMomentary, 0, 'f', 1) + '\n';
+	sText += QObject::tr("Short-term: %1 LUFS")
+		.arg(m_fShortTerm, 0, 'f', 1) + '\n';
+	sText += QObject::tr("Integrated: %1 LUFS")
+		.arg(m_fIntegrated, 0, 'f', 1);
+
+	return sText;
+}
+
+
+// Synchronize all asynchronous instances (any non-RT thread).
+void qtractorAudioLoudness::syncAll (void)
+{
+	QMutexLocker locker(&g_loudnessMutex);
+
+	if (g_pLoudnessThread)
+		g_pLoudnessThread->syncAll();
+}
+
+
+// end of qtractorAudioLoudness.cpp
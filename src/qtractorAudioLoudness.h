@@ -0,0 +1,168 @@
+// qtractorAudioLoudness.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioLoudness_h
+#define __qtractorAudioLoudness_h
+
+#include "qtractorRingBuffer.h"
+
+#include <QString>
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioLoudness -- Loudness and true-peak meter.
+//
+// Sample peak, 4x oversampled true-peak (ITU-R BS.1770-4 Annex 2),
+// RMS and EBU R128 momentary, short-term and integrated loudness.
+//
+// Synchronous instances are fed directly with process() (eg. offline,
+// while exporting); asynchronous ones get their frames published from
+// the real-time thread with write(), into a lock-free ring-buffer, and
+// analyzed later on a common low priority metering worker thread.
+//
+
+class qtractorAudioLoudness
+{
+public:
+
+	// Constructor.
+	qtractorAudioLoudness(unsigned short iChannels,
+		unsigned int iSampleRate, bool bAsync = false);
+
+	// Destructor.
+	~qtractorAudioLoudness();
+
+	// Properties accessors.
+	unsigned short channels() const
+		{ return m_iChannels; }
+	unsigned int sampleRate() const
+		{ return m_iSampleRate; }
+	bool isAsync() const
+		{ return (m_pRingBuffer != nullptr); }
+
+	// Real-time publisher (asynchronous mode only, lock-free);
+	// frames are silently dropped (and counted) on overflow.
+	void write(float **ppFrames,
+		unsigned int iFrames, unsigned short iChannels = 0);
+
+	// Analysis processor (worker thread or offline).
+	void process(float **ppFrames, unsigned int iFrames);
+
+	// Drain and analyze whatever has been published so far.
+	void sync();
+
+	// Request a reset of all measurements (any thread).
+	void reset();
+
+	// Per-channel readouts (linear; peaks held since last reset).
+	float samplePeak(unsigned short iChannel) const;
+	float truePeak(unsigned short iChannel) const;
+	float rms(unsigned short iChannel) const;
+
+	// Overall readouts (LUFS; QTRACTOR_AUDIO_LOUDNESS_MIN if none).
+	float momentary() const
+		{ return m_fMomentary; }
+	float shortTerm() const
+		{ return m_fShortTerm; }
+	float integrated() const
+		{ return m_fIntegrated; }
+
+	// Overall maximum true-peak (linear).
+	float maxTruePeak() const;
+
+	// Number of dropped (overflown) frames so far.
+	unsigned long overruns() const
+		{ return m_iOverruns; }
+
+	// Pretty summary text (eg. for tool-tips).
+	QString text() const;
+
+	// Synchronize all asynchronous instances (any non-RT thread).
+	static void syncAll();
+
+protected:
+
+	// Per-channel analysis state.
+	struct Channel;
+
+	// Analyze a run of frames on a single channel.
+	void processChannel(Channel *pChannel,
+		const float *pFrames, unsigned int iFrames);
+
+	// Reset all measurements (analysis side).
+	void resetState();
+
+	// End of a 100ms sub-block.
+	void processBlock();
+
+	// Loudness histogram (integrated) evaluation.
+	void updateIntegrated();
+
+private:
+
+	// Instance variables.
+	unsigned short m_iChannels;
+	unsigned int   m_iSampleRate;
+
+	// Asynchronous publishing stuff.
+	qtractorRingBuffer<float> *m_pRingBuffer;
+	float **m_ppPubFrames;
+	float **m_ppSyncFrames;
+	unsigned int m_iSyncFrames;
+
+	volatile unsigned long m_iOverruns;
+	volatile int m_iResetPending;
+
+	// Per-channel state.
+	Channel *m_pChannels;
+
+	// K-weighting filter coefficients (two biquad stages).
+	double m_kb[2][3];
+	double m_ka[2][2];
+
+	// Sub-block (100ms) accounting.
+	unsigned int m_iBlockSize;
+	unsigned int m_iBlockFrames;
+
+	// Short-term sub-block energies ring (3s).
+	double      *m_pdBlocks;
+	unsigned int m_iBlockIndex;
+	unsigned int m_iBlockCount;
+
+	// Integrated loudness gating histogram.
+	unsigned int *m_piHistCounts;
+	double       *m_pdHistEnergy;
+
+	// Overall readouts.
+	volatile float m_fMomentary;
+	volatile float m_fShortTerm;
+	volatile float m_fIntegrated;
+};
+
+
+// Loudness/level readouts floor (LUFS, dBFS).
+#define QTRACTOR_AUDIO_LOUDNESS_MIN  -70.0f
+
+
+#endif  // __qtractorAudioLoudness_h
+
+
+// end of qtractorAudioLoudness.h
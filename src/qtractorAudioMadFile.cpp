@@ -21,12 +21,13 @@
 
 #include "qtractorAbout.h"
 #include "qtractorAudioMadFile.h"
+#include "qtractorAudioSeekIndex.h"
 
 #include <sys/stat.h>
 
 
-// Frame list mutex.
-QMutex qtractorAudioMadFile::g_mutex;
+// Seek index resolution (one node per so many MPEG frames).
+#define QTRACTOR_MAD_SEEK_FRAMES	4
 
 
 //----------------------------------------------------------------------
@@ -58,6 +59,7 @@ qtractorAudioMadFile::qtractorAudioMadFile ( unsigned int iBufferSize )
 
 	// Frame mapping for sample-accurate seeking.
 	m_iSeekOffset = 0;
+	m_pSeekIndex  = nullptr;
 }
 
 // Destructor.
@@ -85,22 +87,22 @@ bool qtractorAudioMadFile::open ( const QString& sFilename, int iMode )
 	if (m_pFile == nullptr)
 		return false;
 
-	// Create the decoded frame list.
-	m_pFrameList = createFrameList(sFilename);
-	if (m_pFrameList == nullptr) {
-		close();
-		return false;
-	}
-
-	// We've been here before we'll the total decoded length of the file...
+	// Get the seek index, (re)built only once...
 	unsigned long iFramesEst = 0;
 
-	g_mutex.lock();
-
-	if (m_pFrameList->count() > 0)
-		iFramesEst = m_pFrameList->last().iOutputOffset;
+	m_pSeekIndex = qtractorAudioSeekIndex::getIndex(sFilename);
+	if (m_pSeekIndex == nullptr) {
+		// Build it on our own (no locks held), then publish it...
+		qtractorAudioSeekIndex *pSeekIndex
+			= new qtractorAudioSeekIndex(sFilename);
+		scanIndex(m_pFile, pSeekIndex);
+		m_pSeekIndex = qtractorAudioSeekIndex::putIndex(pSeekIndex);
+	}
+	if (m_pSeekIndex)
+		iFramesEst = m_pSeekIndex->frames();
 
-	g_mutex.unlock();
+	// Back to the very beginning...
+	::rewind(m_pFile);
 
 #ifdef CONFIG_LIBMAD
 	mad_stream_init(&m_madStream);
@@ -202,16 +204,7 @@ bool qtractorAudioMadFile::input (void)
 	if (iRead > 0) {
 		// Update the input offset, as for next time...
 		m_curr.iInputOffset += iRead;
-		// Time to add some frame mapping, on each 3rd iteration...
-		g_mutex.lock();
-		if ((++m_curr.iDecodeCount % 3) == 0 && (m_pFrameList->count() < 1
-			|| m_pFrameList->last().iOutputOffset < m_curr.iOutputOffset)) {
-			m_pFrameList->append(FrameNode(
-				m_curr.iInputOffset - iRemaining,
-				m_curr.iOutputOffset,
-				m_curr.iDecodeCount));
-		}
-		g_mutex.unlock();
+		++m_curr.iDecodeCount;
 		// Add some decode buffer guard...
 		if (iRead < (int) iReadSize) {
 			::memset(pReadStart + iRead, 0, MAD_BUFFER_GUARD);
@@ -240,8 +233,9 @@ bool qtractorAudioMadFile::decode (void)
 #ifdef CONFIG_LIBMAD
 
 	bool bError = (mad_frame_decode(&m_madFrame, &m_madStream) < 0);
-	while (bError && (m_madStream.error == MAD_ERROR_BUFLEN
-		|| MAD_RECOVERABLE(m_madStream.error))) {
+	while (bError && m_madStream.error != MAD_ERROR_BADDATAPTR
+		&& (m_madStream.error == MAD_ERROR_BUFLEN
+			|| MAD_RECOVERABLE(m_madStream.error))) {
 		if (!input())
 			return false;
 		bError = (mad_frame_decode(&m_madFrame, &m_madStream) < 0);
@@ -257,18 +251,24 @@ bool qtractorAudioMadFile::decode (void)
 	}
 #endif
 
-	if (bError)
+	// A frame with missing bit-reservoir data (eg. right after
+	// a seek) still gets through as silence, so that sample
+	// offsets are kept in sync with the seek index...
+	if (bError && m_madStream.error != MAD_ERROR_BADDATAPTR)
 		return MAD_RECOVERABLE(m_madStream.error);
 
-	mad_synth_frame(&m_madSynth, &m_madFrame);
+	if (!bError)
+		mad_synth_frame(&m_madSynth, &m_madFrame);
 
-	const unsigned int iFrames = m_madSynth.pcm.length;
+	const unsigned int iFrames = (bError
+		? 32 * MAD_NSBSAMPLES(&m_madFrame.header)
+		: m_madSynth.pcm.length);
 
 	if (m_ppRingBuffer == nullptr) {
 		// Set initial stream parameters.
 		m_iBitRate    = m_madFrame.header.bitrate;
-		m_iChannels   = m_madSynth.pcm.channels;
-		m_iSampleRate = m_madSynth.pcm.samplerate;
+		m_iChannels   = MAD_NCHANNELS(&m_madFrame.header);
+		m_iSampleRate = m_madFrame.header.samplerate;
 		// Create/allocate internal output ring-buffer.
 		m_iRingBufferSize = (4096 << 1);
 		while (m_iRingBufferSize < m_iInputBufferSize)
@@ -327,14 +327,8 @@ int qtractorAudioMadFile::read ( float **ppFrames, unsigned int iFrames )
 		if (iFrames > (m_iRingBufferSize >> 1))
 			iFrames = (m_iRingBufferSize >> 1);
 		while ((nread = readable()) < iFrames && !m_bEndOfStream) {
-			if (!decode()) {
-				g_mutex.lock();
-				if (m_pFrameList->count() < 1 ||
-					m_pFrameList->last().iOutputOffset < m_curr.iOutputOffset)
-					m_pFrameList->append(m_curr);
-				g_mutex.unlock();
+			if (!decode())
 				m_bEndOfStream = true;
-			}
 		}
 		if (nread > iFrames)
 			nread = iFrames;
@@ -385,32 +379,36 @@ bool qtractorAudioMadFile::seek ( unsigned long iOffset )
 	// This is the target situation...
 	m_iSeekOffset = iOffset;
 
-	// Are qe seeking backward or forward 
-	// from last known decoded position?
-	g_mutex.lock();
-	if (m_pFrameList->count() > 0
-		&& m_pFrameList->last().iOutputOffset > iOffset) {
-		// Assume the worst case (seek to very beginning...)
-		m_curr.iInputOffset  = 0;
-		m_curr.iOutputOffset = 0;
-		m_curr.iDecodeCount  = 0;
-		// Find the previous mapped 3rd frame that fits location...
-		QListIterator<FrameNode> iter(*m_pFrameList);
-		iter.toBack();
-		while (iter.hasPrevious()) {
-			if (iter.previous().iOutputOffset < iOffset) {
-				if (iter.hasPrevious())
-					m_curr = iter.previous();
-				break;
-			}
-		}
-		g_mutex.unlock();
+	// Are we seeking backward, or far enough forward
+	// from last known decoded position? Jump through
+	// the seek index then, with some pre-roll frames
+	// for the bit-reservoir to get refilled...
+	FrameNode node;
+	bool bJump = false;
+
+	// (the seek index is immutable, no locking needed)...
+	int i = (m_pSeekIndex ? m_pSeekIndex->find(iOffset) : -1);
+	if (i > 0)
+		--i;
+	if (i >= 0) {
+		const qtractorAudioSeekIndex::Node& seekNode = m_pSeekIndex->at(i);
+		node.iInputOffset  = seekNode.iInputOffset;
+		node.iOutputOffset = seekNode.iOutputOffset;
+	}
+
+	if (m_curr.iOutputOffset > iOffset)
+		bJump = true;
+	else
+	if (node.iOutputOffset > m_curr.iOutputOffset)
+		bJump = true;
+
+	if (bJump) {
+		m_curr = node;
 	#ifdef DEBUG_0
-		qDebug("qtractorAudioMadFile::seek(%lu) i=%lu o=%lu c=%u",
+		qDebug("qtractorAudioMadFile::seek(%lu) i=%lu o=%lu",
 			iOffset,
 			m_curr.iInputOffset,
-			m_curr.iOutputOffset,
-			m_curr.iDecodeCount);
+			m_curr.iOutputOffset);
 	#endif
 		// Rewind file position...
 		if (::fseek(m_pFile, m_curr.iInputOffset, SEEK_SET))
@@ -429,7 +427,6 @@ bool qtractorAudioMadFile::seek ( unsigned long iOffset )
 		if (!input())
 			return false;
 	}
-	else g_mutex.unlock();
 
 	// Reset ring-buffer pointers.
 	m_iRingBufferRead  = 0;
@@ -474,9 +471,11 @@ void qtractorAudioMadFile::close (void)
 		m_pFile = nullptr;
 	}
 
-	// Frame lists are never destroyed here
-	// (they're cached for whole life-time of the program).
-	m_pFrameList = nullptr;
+	// Seek indexes are shared (cached), just unreference...
+	if (m_pSeekIndex) {
+		m_pSeekIndex->releaseRef();
+		m_pSeekIndex = nullptr;
+	}
 
 	// Reset all other state relevant variables.
 	m_bEndOfStream = false;
@@ -543,36 +542,91 @@ unsigned int qtractorAudioMadFile::writable (void) const
 }
 
 
-// Frame list factory method.
-qtractorAudioMadFile::FrameList *qtractorAudioMadFile::createFrameList (
-	const QString& sFilename )
+// Seek index builder (header-only scan, no actual decoding).
+bool qtractorAudioMadFile::scanIndex (
+	FILE *pFile, qtractorAudioSeekIndex *pSeekIndex )
 {
-	// Frame list hash repository
-	// (declared here for proper cleanup).
-	class FrameListFactory : public QHash<QString, FrameList *>
-	{
-	public:
-		// Destructor.
-		~FrameListFactory()	{
-			QMutableHashIterator<QString, FrameList *> iter(*this);
-			while (iter.hasNext()) {
-				FrameList *pFrameList = iter.next().value();
-				iter.remove();
-				delete pFrameList;
+	pSeekIndex->clear();
+
+#ifdef CONFIG_LIBMAD
+
+	struct mad_stream madStream;
+	struct mad_header madHeader;
+
+	mad_stream_init(&madStream);
+	mad_header_init(&madHeader);
+
+	const unsigned int iBufferSize = (4096 << 4);
+	unsigned char *pBuffer = new unsigned char [iBufferSize + MAD_BUFFER_GUARD];
+
+	unsigned long iBufferOffset = 0;	// File offset of buffer start.
+	unsigned long iOutputOffset = 0;
+	unsigned long iFrame = 0;
+	bool bEndOfFile = false;
+
+	::rewind(pFile);
+
+	for (;;) {
+		// Need to (re)fill the input buffer?
+		if (madStream.buffer == nullptr
+			|| madStream.error == MAD_ERROR_BUFLEN) {
+			if (bEndOfFile)
+				break;
+			unsigned long iRemaining = 0;
+			if (madStream.next_frame) {
+				iRemaining = madStream.bufend - madStream.next_frame;
+				iBufferOffset += madStream.next_frame - pBuffer;
+				::memmove(pBuffer, madStream.next_frame, iRemaining);
 			}
+			unsigned long iRead = ::fread(pBuffer + iRemaining, 1,
+				iBufferSize - iRemaining, pFile);
+			if (iRead < iBufferSize - iRemaining) {
+				::memset(pBuffer + iRemaining + iRead, 0, MAD_BUFFER_GUARD);
+				iRead += MAD_BUFFER_GUARD;
+				bEndOfFile = true;
+			}
+			mad_stream_buffer(&madStream, pBuffer, iRemaining + iRead);
+			madStream.error = MAD_ERROR_NONE;
+		}
+		// Next frame header...
+		if (mad_header_decode(&madHeader, &madStream) < 0) {
+			if (madStream.error == MAD_ERROR_BUFLEN
+				|| MAD_RECOVERABLE(madStream.error))
+				continue;
+			break;
+		}
+		// Add some frame mapping, on each few frames...
+		if ((iFrame % QTRACTOR_MAD_SEEK_FRAMES) == 0) {
+			pSeekIndex->append(
+				iBufferOffset + (madStream.this_frame - pBuffer),
+				iOutputOffset);
 		}
-	};
+		iOutputOffset += 32 * MAD_NSBSAMPLES(&madHeader);
+		++iFrame;
+	}
 
-	// Do the factory thing here...
-	static FrameListFactory s_lists;
+	delete [] pBuffer;
 
-	FrameList *pFrameList = s_lists.value(sFilename, nullptr);
-	if (pFrameList == nullptr) {
-		pFrameList = new FrameList();
-		s_lists.insert(sFilename, pFrameList);
-	}
+	mad_header_finish(&madHeader);
+	mad_stream_finish(&madStream);
 
-	return pFrameList;
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorAudioMadFile::scanIndex(\"%s\") frames=%lu/%lu",
+		pSeekIndex->filename().toUtf8().constData(), iFrame, iOutputOffset);
+#endif
+
+	if (iFrame < 1)
+		return false;
+
+	pSeekIndex->commit(iOutputOffset);
+
+	return true;
+
+#else	// CONFIG_LIBMAD
+
+	return false;
+
+#endif
 }
 
 
@@ -24,7 +24,6 @@
 
 #include "qtractorAudioFile.h"
 
-#include <QList>
 #include <QMutex>
 
 #include <stdio.h>
@@ -34,6 +33,11 @@
 #include <mad.h>
 #endif
 
+
+// Forward declarations.
+class qtractorAudioSeekIndex;
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioMadFile -- Buffered audio file declaration.
 //
@@ -73,6 +77,9 @@ protected:
 	unsigned int readable() const;
 	unsigned int writable() const;
 
+	// Seek index builder (header-only scan).
+	static bool scanIndex(FILE *pFile, qtractorAudioSeekIndex *pSeekIndex);
+
 private:
 
 	// Instance variables.
@@ -115,19 +122,11 @@ private:
 		unsigned int  iDecodeCount;     // Decoder iteration count.
 	};
 
-	// Decoded frame list type.
-	typedef QList<FrameNode> FrameList;
-
-	// Frame list factory method.
-	static FrameList *createFrameList(const QString& sFilename);
-
-	// Frame list instance; 
-	FrameList *m_pFrameList;
 	// Current decoded frame node.
 	FrameNode m_curr;
 
-	// Frame list mutex.
-	static QMutex g_mutex;
+	// Seek index (shared, persistent).
+	qtractorAudioSeekIndex *m_pSeekIndex;
 };
 
 
@@ -22,6 +22,7 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioMeter.h"
 #include "qtractorAudioMonitor.h"
+#include "qtractorAudioLoudness.h"
 
 #include "qtractorObserverWidget.h"
 
@@ -33,6 +34,8 @@
 #include <QPixmap>
 #include <QLayout>
 #include <QLabel>
+#include <QToolTip>
+#include <QHelpEvent>
 
 #include <cmath>
 
@@ -518,6 +521,23 @@ void qtractorAudioMeter::resizeEvent ( QResizeEvent *pResizeEvent )
 }
 
 
+// Loudness and true-peak readouts tool-tip.
+bool qtractorAudioMeter::event ( QEvent *pEvent )
+{
+	if (pEvent->type() == QEvent::ToolTip && m_pAudioMonitor) {
+		qtractorAudioLoudness *pLoudness = m_pAudioMonitor->loudness();
+		if (pLoudness) {
+			QHelpEvent *pHelpEvent = static_cast<QHelpEvent *> (pEvent);
+			QToolTip::showText(pHelpEvent->globalPos(),
+				pLoudness->text(), this);
+			return true;
+		}
+	}
+
+	return qtractorMeter::event(pEvent);
+}
+
+
 // Virtual monitor accessor.
 void qtractorAudioMeter::setMonitor ( qtractorMonitor *pMonitor )
 {
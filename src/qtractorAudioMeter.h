@@ -143,6 +143,9 @@ protected:
 	// Specific event handlers.
 	void resizeEvent(QResizeEvent *);
 
+	// Loudness and true-peak readouts tool-tip.
+	bool event(QEvent *pEvent);
+
 private:
 
 	// Local instance variables.
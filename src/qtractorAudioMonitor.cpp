@@ -22,6 +22,9 @@
 #include "qtractorAudioMonitor.h"
 
 #include "qtractorAudioMeter.h"
+#include "qtractorAudioLoudness.h"
+
+#include "qtractorSession.h"
 
 #include <cmath>
 
@@ -55,69 +58,114 @@ static inline bool sse_enabled (void)
 #endif
 }
 
+// SSE horizontal maximum (of all 4 possible values).
+static inline float sse_max ( __m128 v )
+{
+	v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(v);
+}
+
 // SSE enabled processor versions.
 static inline void sse_process (
 	float *pFrames, unsigned int iFrames, float fGain, float *pfValue )
 {
+	const __m128 vs = _mm_set1_ps(-0.0f);
 	__m128 v0 = _mm_load_ps1(&fGain);
 	__m128 v1 = _mm_load_ps1(pfValue);
 	__m128 v2;
 
-	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames)
-		*pFrames++ *= fGain;
-	
+	float fValue = *pfValue;
+
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		*pFrames *= fGain;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
+
 	for (; iFrames >= 4; iFrames -= 4) {
 		v2 = _mm_mul_ps(_mm_loadu_ps(pFrames), v0);
-		v1 = _mm_max_ps(v2, v1);
+		v1 = _mm_max_ps(_mm_andnot_ps(vs, v2), v1);
 		_mm_store_ps(pFrames, v2);
 		pFrames += 4;
 	}
-	
-	for (; iFrames > 0; --iFrames)
-		*pFrames++ *= fGain;
 
-	*pfValue = *(float *) &v1; // CHEAT: take 1st of 4 possible values.
+	for (; iFrames > 0; --iFrames) {
+		*pFrames *= fGain;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
+
+	const float fMax = sse_max(v1);
+	*pfValue = (fValue < fMax ? fMax : fValue);
 }
 
 static inline void sse_process_ramp ( float *pFrames, unsigned int iFrames,
 	float fGainIter, float fGainLast, float *pfValue )
 {
+	const __m128 vs = _mm_set1_ps(-0.0f);
 	__m128 v1 = _mm_load_ps1(pfValue);
 	__m128 v2;
 
+	float fValue = *pfValue;
+
 	const float fGainStep = 4.0f * (fGainLast - fGainIter) / float(iFrames);
 
-	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames)
-		*pFrames++ *= fGainIter;
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		*pFrames *= fGainIter;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
 
 	for (; iFrames >= 4; iFrames -= 4) {
 		v2 = _mm_mul_ps(_mm_loadu_ps(pFrames), _mm_load_ps1(&fGainIter));
-		v1 = _mm_max_ps(v2, v1);
+		v1 = _mm_max_ps(_mm_andnot_ps(vs, v2), v1);
 		_mm_store_ps(pFrames, v2);
 		fGainIter += fGainStep;
 		pFrames += 4;
 	}
 
-	for (; iFrames > 0; --iFrames)
-		*pFrames++ *= fGainIter;
+	for (; iFrames > 0; --iFrames) {
+		*pFrames *= fGainIter;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
 
-	*pfValue = *(float *) &v1; // CHEAT: take 1st of 4 possible values.
+	const float fMax = sse_max(v1);
+	*pfValue = (fValue < fMax ? fMax : fValue);
 }
 
 static inline void sse_process_meter (
 	float *pFrames, unsigned int iFrames, float *pfValue )
 {
+	const __m128 vs = _mm_set1_ps(-0.0f);
 	__m128 v1 = _mm_load_ps1(pfValue);
 
-	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames)
-		++pFrames;
-	
+	float fValue = *pfValue;
+
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
+
 	for (; iFrames >= 4; iFrames -= 4) {
-		v1 = _mm_max_ps(_mm_loadu_ps(pFrames), v1);
+		v1 = _mm_max_ps(_mm_andnot_ps(vs, _mm_load_ps(pFrames)), v1);
 		pFrames += 4;
 	}
-	
-	*pfValue = *(float *) &v1; // CHEAT: take 1st of 4 possible values.
+
+	for (; iFrames > 0; --iFrames) {
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
+
+	const float fMax = sse_max(v1);
+	*pfValue = (fValue < fMax ? fMax : fValue);
 }
 
 #endif // __SSE__
@@ -127,6 +175,14 @@ static inline void sse_process_meter (
 
 #include "arm_neon.h"
 
+// NEON horizontal maximum (of all 4 possible values).
+static inline float neon_max ( float32x4_t v )
+{
+	float32x2_t v2 = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+	v2 = vpmax_f32(v2, v2);
+	return vget_lane_f32(v2, 0);
+}
+
 // NEON enabled processor versions.
 static inline void neon_process (
 	float *pFrames, unsigned int iFrames, float fGain, float *pfValue )
@@ -135,20 +191,31 @@ static inline void neon_process (
 	float32x4_t v1 = vld1q_dup_f32(pfValue);
 	float32x4_t v2;
 
-	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames)
-		*pFrames++ *= fGain;
+	float fValue = *pfValue;
+
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		*pFrames *= fGain;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
 
 	for (; iFrames >= 4; iFrames -= 4) {
 		v2 = vmulq_f32(vld1q_f32(pFrames), v0);
-		v1 = vmaxq_f32(v2, v1);
+		v1 = vmaxq_f32(vabsq_f32(v2), v1);
 		vst1q_f32(pFrames, v2);
 		pFrames += 4;
 	}
 
-	for (; iFrames > 0; --iFrames)
-		*pFrames++ *= fGain;
+	for (; iFrames > 0; --iFrames) {
+		*pFrames *= fGain;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
 
-	vst1q_lane_f32(pfValue, v1, 0); // CHEAT: take 1st of 4 possible values.
+	const float fMax = neon_max(v1);
+	*pfValue = (fValue < fMax ? fMax : fValue);
 }
 
 static inline void neon_process_ramp ( float *pFrames, unsigned int iFrames,
@@ -156,8 +223,13 @@ static inline void neon_process_ramp ( float *pFrames, unsigned int iFrames,
 {
 	const float fGainStepSingle = (fGainLast - fGainIter) / float(iFrames);
 
+	float fValue = *pfValue;
+
 	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
-		*pFrames++ *= fGainIter;
+		*pFrames *= fGainIter;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
 		fGainIter += fGainStepSingle;
 	}
 
@@ -175,18 +247,23 @@ static inline void neon_process_ramp ( float *pFrames, unsigned int iFrames,
 
 	for (; iFrames >= 4; iFrames -= 4) {
 		v2 = vmulq_f32(vld1q_f32(pFrames), vGainIter);
-		v1 = vmaxq_f32(v2, v1);
+		v1 = vmaxq_f32(vabsq_f32(v2), v1);
 		vst1q_f32(pFrames, v2);
 		vGainIter += vGainStep;
+		fGainIter += fGainStep;
 		pFrames += 4;
 	}
 
 	for (; iFrames > 0; --iFrames) {
-		*pFrames++ *= fGainIter;
+		*pFrames *= fGainIter;
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
 		fGainIter += fGainStepSingle;
 	}
 
-	vst1q_lane_f32(pfValue, v1, 3); // CHEAT: take 4th of 4 possible values.
+	const float fMax = neon_max(v1);
+	*pfValue = (fValue < fMax ? fMax : fValue);
 }
 
 static inline void neon_process_meter (
@@ -194,15 +271,27 @@ static inline void neon_process_meter (
 {
 	float32x4_t v1 = vld1q_dup_f32(pfValue);
 
-	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames)
-		++pFrames;
+	float fValue = *pfValue;
+
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
 
 	for (; iFrames >= 4; iFrames -= 4) {
-		v1 = vmaxq_f32(vld1q_f32(pFrames), v1);
+		v1 = vmaxq_f32(vabsq_f32(vld1q_f32(pFrames)), v1);
 		pFrames += 4;
 	}
 
-	vst1q_lane_f32(pfValue, v1, 0); // CHEAT: take 1st of 4 possible values.
+	for (; iFrames > 0; --iFrames) {
+		const float fAbs = ::fabsf(*pFrames++);
+		if (fValue < fAbs)
+			fValue = fAbs;
+	}
+
+	const float fMax = neon_max(v1);
+	*pfValue = (fValue < fMax ? fMax : fValue);
 }
 
 #endif // __ARM_NEON__
@@ -214,8 +303,9 @@ static inline void std_process (
 {
 	for (unsigned int n = 0; n < iFrames; ++n) {
 		pFrames[n] *= fGain;
-		if (*pfValue < pFrames[n])
-			*pfValue = pFrames[n];
+		const float fAbs = ::fabsf(pFrames[n]);
+		if (*pfValue < fAbs)
+			*pfValue = fAbs;
 	}
 }
 
@@ -226,8 +316,9 @@ static inline void std_process_ramp ( float *pFrames, unsigned int iFrames,
 
 	for (unsigned int n = 0; n < iFrames; ++n) {
 		pFrames[n] *= fGainIter;
-		if (*pfValue < pFrames[n])
-			*pfValue = pFrames[n];
+		const float fAbs = ::fabsf(pFrames[n]);
+		if (*pfValue < fAbs)
+			*pfValue = fAbs;
 		fGainIter += fGainStep;
 	}
 }
@@ -236,8 +327,9 @@ static inline void std_process_meter (
 	float *pFrames, unsigned int iFrames, float *pfValue )
 {
 	for (unsigned int n = 0; n < iFrames; ++n) {
-		if (*pfValue < pFrames[n])
-			*pfValue = pFrames[n];
+		const float fAbs = ::fabsf(pFrames[n]);
+		if (*pfValue < fAbs)
+			*pfValue = fAbs;
 	}
 }
 
@@ -249,7 +341,8 @@ static inline void std_process_meter (
 qtractorAudioMonitor::qtractorAudioMonitor ( unsigned short iChannels,
 	float fGain, float fPanning ) : qtractorMonitor(fGain, fPanning),
 	m_iChannels(0), m_piStamps(nullptr), m_pfValues(nullptr), m_pfPrevValues(nullptr),
-	m_pfGains(nullptr), m_pfPrevGains(nullptr), m_iProcessRamp(0)
+	m_pfGains(nullptr), m_pfPrevGains(nullptr), m_iProcessRamp(0),
+	m_pLoudness(nullptr)
 {
 	qtractorMonitor::gainSubject()->setMaxValue(2.0f);	// +6dB
 	qtractorMonitor::gainObserver()->setLogarithmic(true);
@@ -329,6 +422,12 @@ void qtractorAudioMonitor::setChannels ( unsigned short iChannels )
 		m_pfPrevGains = nullptr;
 	}
 
+	// Delete old loudness meter...
+	if (m_pLoudness) {
+		delete m_pLoudness;
+		m_pLoudness = nullptr;
+	}
+
 	// Set new value holders...
 	m_iChannels = iChannels;
 
@@ -345,6 +444,15 @@ void qtractorAudioMonitor::setChannels ( unsigned short iChannels )
 		}
 		// Initial population...
 		update();
+		// Loudness meter, if asked...
+		if (g_bLoudnessMetering) {
+			unsigned int iSampleRate = 0;
+			qtractorSession *pSession = qtractorSession::getInstance();
+			if (pSession)
+				iSampleRate = pSession->sampleRate();
+			m_pLoudness = new qtractorAudioLoudness(
+				m_iChannels, iSampleRate, true);
+		}
 	}
 }
 
@@ -377,10 +485,34 @@ void qtractorAudioMonitor::reset (void)
 		m_pfPrevGains[i] = 0.0f;
 	}
 
+	if (m_pLoudness)
+		m_pLoudness->reset();
+
 	++m_iProcessRamp;
 }
 
 
+// Loudness and true-peak meter accessor (optional).
+qtractorAudioLoudness *qtractorAudioMonitor::loudness (void) const
+{
+	return m_pLoudness;
+}
+
+
+// Loudness and true-peak metering global option.
+bool qtractorAudioMonitor::g_bLoudnessMetering = false;
+
+void qtractorAudioMonitor::setLoudnessMetering ( bool bLoudnessMetering )
+{
+	g_bLoudnessMetering = bLoudnessMetering;
+}
+
+bool qtractorAudioMonitor::isLoudnessMetering (void)
+{
+	return g_bLoudnessMetering;
+}
+
+
 // Batch processors.
 void qtractorAudioMonitor::process (
 	float **ppFrames, unsigned int iFrames, unsigned short iChannels )
@@ -447,6 +579,10 @@ void qtractorAudioMonitor::process (
 		}
 		// Done normal-processing.
 	}
+
+	// Publish to the loudness meter (lock-free)...
+	if (m_pLoudness)
+		m_pLoudness->write(ppFrames, iFrames, iChannels);
 }
 
 
@@ -476,6 +612,10 @@ void qtractorAudioMonitor::process_meter (
 				i = 0;
 		}
 	}
+
+	// Publish to the loudness meter (lock-free)...
+	if (m_pLoudness)
+		m_pLoudness->write(ppFrames, iFrames, iChannels);
 }
 
 
@@ -26,6 +26,7 @@
 
 // Forward decls.
 class qtractorAudioMeter;
+class qtractorAudioLoudness;
 
 
 //----------------------------------------------------------------------------
@@ -60,6 +61,13 @@ public:
 	// Reset channel gain trackers.
 	void reset();
 
+	// Loudness and true-peak meter accessor (optional).
+	qtractorAudioLoudness *loudness() const;
+
+	// Loudness and true-peak metering global option.
+	static void setLoudnessMetering(bool bLoudnessMetering);
+	static bool isLoudnessMetering();
+
 protected:
 
 	// Rebuild the whole panning-gain array...
@@ -76,10 +84,16 @@ private:
 	float         *m_pfPrevGains;
 	volatile int   m_iProcessRamp;
 
+	// Loudness and true-peak meter (off the RT path).
+	qtractorAudioLoudness *m_pLoudness;
+
 	// Monitoring evaluator processor.
 	void (*m_pfnProcess)(float *, unsigned int, float, float *);
 	void (*m_pfnProcessRamp)(float *, unsigned int, float, float, float *);
 	void (*m_pfnProcessMeter)(float *, unsigned int, float *);
+
+	// Loudness and true-peak metering global option.
+	static bool g_bLoudnessMetering;
 };
 
 
@@ -26,6 +26,8 @@
 
 #include "qtractorSession.h"
 
+#include "qtractorTrace.h"
+
 #include <QApplication>
 #include <QFileInfo>
 #include <QDir>
@@ -74,7 +76,8 @@ public:
 	bool runState() const;
 
 	// Wake from executive wait condition.
-	void sync(qtractorAudioPeakFile *pPeakFile = nullptr);
+	void sync(qtractorAudioPeakFile *pPeakFile = nullptr,
+		bool bEnvelopes = false);
 
 protected:
 
@@ -160,15 +163,18 @@ bool qtractorAudioPeakThread::runState (void) const
 
 
 // Wake from executive wait condition.
-void qtractorAudioPeakThread::sync ( qtractorAudioPeakFile *pPeakFile )
+void qtractorAudioPeakThread::sync (
+	qtractorAudioPeakFile *pPeakFile, bool bEnvelopes )
 {
 	if (pPeakFile == nullptr) {
 		unsigned int r = m_iSyncRead;
 		unsigned int w = m_iSyncWrite;
 		while (r != w) {
 			qtractorAudioPeakFile *pSyncItem = m_ppSyncItems[r];
-			if (pSyncItem)
+			if (pSyncItem) {
 				pSyncItem->setWaitSync(false);
+				pSyncItem->setEnvelopeSync(false);
+			}
 			++r &= m_iSyncMask;
 			w = m_iSyncWrite;
 		}
@@ -186,7 +192,10 @@ void qtractorAudioPeakThread::sync ( qtractorAudioPeakFile *pPeakFile )
 			n = m_iSyncSize - 1;
 		}
 		if (n > 0) {
-			pPeakFile->setWaitSync(true);
+			if (bEnvelopes)
+				pPeakFile->setEnvelopeSync(true);
+			else
+				pPeakFile->setWaitSync(true);
 			m_ppSyncItems[w] = pPeakFile;
 			m_iSyncWrite = (w + 1) & m_iSyncMask;
 		}
@@ -220,15 +229,24 @@ void qtractorAudioPeakThread::run (void)
 		while (m_bRunState && r != w) {
 			m_pPeakFile = m_ppSyncItems[r];
 			if (m_pPeakFile && m_pPeakFile->isWaitSync()) {
+				qtractorTraceScope trace("Audio peak", "peak file");
 				if (openPeakFile()) {
 					// Go ahead with the whole bunch...
 					while (writePeakFile());
 					// We're done.
 					closePeakFile();
+					// Level-of-detail envelopes, while here...
+					m_pPeakFile->buildEnvelopes();
 				}
 				m_pPeakFile->setWaitSync(false);
 				m_pPeakFile = nullptr;
 			}
+			else
+			if (m_pPeakFile && m_pPeakFile->isEnvelopeSync()) {
+				qtractorTraceScope trace("Audio peak", "envelopes");
+				m_pPeakFile->buildEnvelopes();
+				m_pPeakFile = nullptr;
+			}
 			m_ppSyncItems[r] = nullptr;
 			++r &= m_iSyncMask;
 			w = m_iSyncWrite;
@@ -245,6 +263,9 @@ void qtractorAudioPeakThread::run (void)
 
 	m_mutex.unlock();
 
+	// Give back our trace buffer, if any.
+	qtractorTrace::release();
+
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorAudioPeakThread[%p]::run(): stopped.\n", this);
 #endif
@@ -378,6 +399,14 @@ qtractorAudioPeakFile::qtractorAudioPeakFile (
 	m_iBuffLength  = 0;
 	m_iBuffOffset  = 0;
 
+	for (int i = 0; i < EnvelopeLevels; ++i) {
+		m_ppEnvelopes[i] = nullptr;
+		m_iEnvelopeLengths[i] = 0;
+	}
+
+	m_bEnvelopeSync = false;
+	m_bEnvelopeDone = false;
+
 	m_bWaitSync = false;
 
 	m_iRefCount = 0;
@@ -487,6 +516,8 @@ void qtractorAudioPeakFile::closeRead (void)
 	m_iBuffSize   = 0;
 	m_iBuffLength = 0;
 	m_iBuffOffset = 0;
+
+	clearEnvelopes();
 }
 
 
@@ -604,6 +635,156 @@ unsigned int qtractorAudioPeakFile::readBuffer (
 }
 
 
+// Level-of-detail envelope frames (coarser peak periods).
+qtractorAudioPeakFile::Frame *qtractorAudioPeakFile::readEnvelope (
+	unsigned short iLevel, unsigned long iPeakOffset, unsigned int iPeakLength )
+{
+	if (iLevel < 1 || iLevel > EnvelopeLevels)
+		return nullptr;
+
+	// Must be open for reading and up-to-date...
+	if (m_openMode != Read || m_bWaitSync)
+		return nullptr;
+
+	// Envelopes are built on the peak thread, never here;
+	// meanwhile, the caller falls back to the peak file...
+	if (!m_bEnvelopeDone) {
+		if (!m_bEnvelopeSync) {
+			qtractorAudioPeakFactory *pPeakFactory
+				= qtractorAudioPeakFactory::getInstance();
+			if (pPeakFactory)
+				pPeakFactory->syncEnvelopes(this);
+		}
+		return nullptr;
+	}
+
+	// Make things critical...
+	QMutexLocker locker(&m_mutex);
+
+	const int i = iLevel - 1;
+	if (m_ppEnvelopes[i] == nullptr
+		|| iPeakOffset + iPeakLength > m_iEnvelopeLengths[i])
+		return nullptr;
+
+	return m_ppEnvelopes[i] + m_peakHeader.channels * iPeakOffset;
+}
+
+
+// Level-of-detail envelopes builder (on the peak thread):
+// the whole peak file is read through its own file handle,
+// so that the mutex is only held to swap the results in.
+bool qtractorAudioPeakFile::buildEnvelopes (void)
+{
+	Frame *ppEnvelopes[EnvelopeLevels];
+	unsigned long iEnvelopeLengths[EnvelopeLevels];
+	for (int i = 0; i < EnvelopeLevels; ++i) {
+		ppEnvelopes[i] = nullptr;
+		iEnvelopeLengths[i] = 0;
+	}
+
+	QFile file(m_peakFile.fileName());
+	Header header;
+	header.period   = 0;
+	header.channels = 0;
+	if (file.open(QIODevice::ReadOnly)
+		&& file.read((char *) &header, sizeof(Header))
+			== qint64(sizeof(Header))) {
+		const unsigned short iChannels = header.channels;
+		const unsigned int nsize = iChannels * sizeof(Frame);
+		const qint64 iFileSize = file.size() - qint64(sizeof(Header));
+		const unsigned long iPeakFrames = (nsize > 0 && iFileSize > 0
+			? (unsigned long) (iFileSize / nsize) : 0);
+		const unsigned int iFactor = (1 << EnvelopeShift);
+		if (iPeakFrames >= iFactor) {
+			// Allocate all levels, zero means silence...
+			unsigned long iLength = iPeakFrames;
+			for (int i = 0; i < EnvelopeLevels; ++i) {
+				iLength = (iLength + iFactor - 1) >> EnvelopeShift;
+				ppEnvelopes[i] = new Frame [iChannels * iLength];
+				::memset(ppEnvelopes[i], 0, iLength * nsize);
+				iEnvelopeLengths[i] = iLength;
+			}
+			// Fold the whole peak file into the first level, chunk-wise...
+			const unsigned int iChunk = (iFactor << 8);
+			Frame *pChunk = new Frame [iChannels * iChunk];
+			Frame *pEnvelope = ppEnvelopes[0];
+			unsigned long iPeakOffset = 0;
+			while (iPeakOffset < iPeakFrames) {
+				const qint64 nread = file.read((char *) pChunk, iChunk * nsize);
+				if (nread < qint64(nsize))
+					break;
+				const unsigned int iFrames = (unsigned int) (nread / nsize);
+				for (unsigned int n = 0; n < iFrames; ++n) {
+					const unsigned long j = (iPeakOffset + n) >> EnvelopeShift;
+					for (unsigned short k = 0; k < iChannels; ++k) {
+						const Frame *pFrame = &pChunk[n * iChannels + k];
+						Frame *pNewFrame = &pEnvelope[j * iChannels + k];
+						if (pNewFrame->max < pFrame->max)
+							pNewFrame->max = pFrame->max;
+						if (pNewFrame->min < pFrame->min)
+							pNewFrame->min = pFrame->min;
+						if (pNewFrame->rms < pFrame->rms)
+							pNewFrame->rms = pFrame->rms;
+					}
+				}
+				iPeakOffset += iFrames;
+			}
+			delete [] pChunk;
+			// Fold each next level from the previous one...
+			for (int i = 1; i < EnvelopeLevels; ++i) {
+				const Frame *pPrevEnvelope = ppEnvelopes[i - 1];
+				const unsigned long iPrevLength = iEnvelopeLengths[i - 1];
+				pEnvelope = ppEnvelopes[i];
+				for (unsigned long n = 0; n < iPrevLength; ++n) {
+					const unsigned long j = (n >> EnvelopeShift);
+					for (unsigned short k = 0; k < iChannels; ++k) {
+						const Frame *pFrame = &pPrevEnvelope[n * iChannels + k];
+						Frame *pNewFrame = &pEnvelope[j * iChannels + k];
+						if (pNewFrame->max < pFrame->max)
+							pNewFrame->max = pFrame->max;
+						if (pNewFrame->min < pFrame->min)
+							pNewFrame->min = pFrame->min;
+						if (pNewFrame->rms < pFrame->rms)
+							pNewFrame->rms = pFrame->rms;
+					}
+				}
+			}
+		}
+	}
+	file.close();
+
+	// Make things critical, just to swap in the new levels...
+	QMutexLocker locker(&m_mutex);
+
+	clearEnvelopes();
+
+	for (int i = 0; i < EnvelopeLevels; ++i) {
+		m_ppEnvelopes[i] = ppEnvelopes[i];
+		m_iEnvelopeLengths[i] = iEnvelopeLengths[i];
+	}
+
+	// Done, even if there's nothing worth it (too short)...
+	m_bEnvelopeDone = true;
+	m_bEnvelopeSync = false;
+
+	return (m_ppEnvelopes[0] != nullptr);
+}
+
+
+// Level-of-detail envelopes cleaner (mutex must be held).
+void qtractorAudioPeakFile::clearEnvelopes (void)
+{
+	for (int i = 0; i < EnvelopeLevels; ++i) {
+		if (m_ppEnvelopes[i])
+			delete [] m_ppEnvelopes[i];
+		m_ppEnvelopes[i] = nullptr;
+		m_iEnvelopeLengths[i] = 0;
+	}
+
+	m_bEnvelopeDone = false;
+}
+
+
 // Open an new peak file for writing.
 bool qtractorAudioPeakFile::openWrite (
 	unsigned short iChannels, unsigned int iSampleRate )
@@ -627,6 +808,9 @@ bool qtractorAudioPeakFile::openWrite (
 		m_openMode = None;
 	}
 
+	// Envelopes are not valid anymore...
+	clearEnvelopes();
+
 	// Just open and go ahead with it...
 	if (!m_peakFile.open(QIODevice::ReadWrite | QIODevice::Truncate))
 		return false;
@@ -850,6 +1034,17 @@ bool qtractorAudioPeakFile::isWaitSync (void) const
 }
 
 
+void qtractorAudioPeakFile::setEnvelopeSync ( bool bEnvelopeSync )
+{
+	m_bEnvelopeSync = bEnvelopeSync;
+}
+
+bool qtractorAudioPeakFile::isEnvelopeSync (void) const
+{
+	return m_bEnvelopeSync;
+}
+
+
 // Peak filename standard.
 QString qtractorAudioPeakFile::peakName (
 	const QString& sFilename, float fTimeStretch )
@@ -865,7 +1060,7 @@ QString qtractorAudioPeakFile::peakName (
 // Constructor.
 qtractorAudioPeak::qtractorAudioPeak ( qtractorAudioPeakFile *pPeakFile )
 	: m_pPeakFile(pPeakFile), m_pPeakFrames(nullptr),
-		m_iPeakLength(0), m_iPeakHash(0)
+		m_iPeakSize(0), m_iPeakLength(0), m_iPeakHash(0)
 {
 	m_pPeakFile->addRef();
 }
@@ -874,7 +1069,7 @@ qtractorAudioPeak::qtractorAudioPeak ( qtractorAudioPeakFile *pPeakFile )
 // Copy contructor.
 qtractorAudioPeak::qtractorAudioPeak ( const qtractorAudioPeak& peak )
 	: m_pPeakFile(peak.m_pPeakFile), m_pPeakFrames(nullptr),
-		m_iPeakLength(0), m_iPeakHash(0)
+		m_iPeakSize(0), m_iPeakLength(0), m_iPeakHash(0)
 {
 	m_pPeakFile->addRef();
 }
@@ -918,7 +1113,7 @@ qtractorAudioPeakFile::Frame *qtractorAudioPeak::peakFrames (
 		return nullptr;
 
 	// Have we been here before?
-	if (m_pPeakFrames) {
+	if (m_iPeakLength > 0) {
 		// Check if we have the same previous hash...
 		if (!m_pPeakFile->isWaitSync()) {
 			const unsigned int iPeakHash
@@ -930,37 +1125,60 @@ qtractorAudioPeakFile::Frame *qtractorAudioPeak::peakFrames (
 				return m_pPeakFrames;
 			m_iPeakHash = iPeakHash;
 		}
-		// Clenup previous frame-buffers...
-		delete [] m_pPeakFrames;
-		m_pPeakFrames = nullptr;
+		// Invalidate previous frame-buffers...
 		m_iPeakLength = 0;
 	}
 
-	// Grab them in...
+	// Level-of-detail: grab them in from the coarsest
+	// envelope level still having more frames than pixels...
 	const unsigned long iPeakOffset = (iFrameOffset / iPeakPeriod);
-	qtractorAudioPeakFile::Frame *pPeakFrames
-		= m_pPeakFile->read(iPeakOffset, iPeakLength);
+	qtractorAudioPeakFile::Frame *pPeakFrames = nullptr;
+	unsigned int iLevelLength = iPeakLength;
+	unsigned short iLevel = qtractorAudioPeakFile::EnvelopeLevels;
+	for ( ; iLevel > 0 && pPeakFrames == nullptr; --iLevel) {
+		const unsigned short iShift
+			= iLevel * qtractorAudioPeakFile::EnvelopeShift;
+		iLevelLength = (iPeakLength >> iShift);
+		if (iLevelLength >= (unsigned int) width) {
+			pPeakFrames = m_pPeakFile->readEnvelope(
+				iLevel, (iPeakOffset >> iShift), iLevelLength);
+		}
+	}
+	if (pPeakFrames == nullptr) {
+		iLevelLength = iPeakLength;
+		pPeakFrames = m_pPeakFile->read(iPeakOffset, iPeakLength);
+	}
 	if (pPeakFrames == nullptr)
 		return nullptr;
 
 	// Check if we better aggregate over the frame buffer....
-	const int p1 = int(iPeakLength);
-	const int n1 = iChannels * p1;
-
-	if (width < p1 && width > 1) {
-		const int w2 = (width >> 1) + 1;
-		const int n2 = iChannels * w2;
+	const unsigned int p1 = iLevelLength;
+	const unsigned int w2 = (width < int(p1) && width > 1)
+		? (width >> 1) + 1 : p1;
+
+	// Reuse the interim buffer, if large enough...
+	const unsigned int n2 = iChannels * w2;
+	if (m_iPeakSize < n2) {
+		if (m_pPeakFrames)
+			delete [] m_pPeakFrames;
 		m_pPeakFrames = new qtractorAudioPeakFile::Frame [n2];
-		int n = 0; int i = 0;
-		while (n < n2) {
-			const int i2 = (n * p1) / w2;
+		m_iPeakSize = n2;
+	}
+
+	if (w2 < p1) {
+		// Reduce to (min/max/rms) buckets...
+		for (unsigned int n = 0; n < w2; ++n) {
+			const unsigned int i1 = ((unsigned long) n * p1) / w2;
+			unsigned int i2 = ((unsigned long) (n + 1) * p1) / w2;
+			if (i2 <= i1)
+				i2 = i1 + 1;
 			for (unsigned short k = 0; k < iChannels; ++k) {
-				qtractorAudioPeakFile::Frame *pNewFrame = &m_pPeakFrames[n++];
-				qtractorAudioPeakFile::Frame *pOldFrame = &pPeakFrames[i + k];
-				pNewFrame->max = pOldFrame->max;
-				pNewFrame->min = pOldFrame->min;
-				pNewFrame->rms = pOldFrame->rms;
-				for (int j = i + 1; j < i2; j += iChannels) {
+				qtractorAudioPeakFile::Frame *pNewFrame
+					= &m_pPeakFrames[n * iChannels + k];
+				const qtractorAudioPeakFile::Frame *pOldFrame
+					= &pPeakFrames[i1 * iChannels + k];
+				*pNewFrame = *pOldFrame;
+				for (unsigned int i = i1 + 1; i < i2; ++i) {
 					pOldFrame += iChannels;
 					if (pNewFrame->max < pOldFrame->max)
 						pNewFrame->max = pOldFrame->max;
@@ -970,18 +1188,16 @@ qtractorAudioPeakFile::Frame *qtractorAudioPeak::peakFrames (
 						pNewFrame->rms = pOldFrame->rms;
 				}
 			}
-			i = i2;
 		}
 		// New-indirect frame buffer length...
-		m_iPeakLength = n / iChannels;
+		m_iPeakLength = w2;
 		// Done-indirect.
 	} else {
 		// Direct-copy frame-buffer...
-		m_pPeakFrames = new qtractorAudioPeakFile::Frame [n1];
 		::memcpy(m_pPeakFrames, pPeakFrames,
-			n1 * sizeof(qtractorAudioPeakFile::Frame));
+			n2 * sizeof(qtractorAudioPeakFile::Frame));
 		// New-direct frame buffer length...
-		m_iPeakLength = iPeakLength;
+		m_iPeakLength = p1;
 		// Done-direct.
 	}
 
@@ -1111,6 +1327,13 @@ void qtractorAudioPeakFactory::sync ( qtractorAudioPeakFile *pPeakFile )
 }
 
 
+// Envelopes (re)build sync method.
+void qtractorAudioPeakFactory::syncEnvelopes ( qtractorAudioPeakFile *pPeakFile )
+{
+	if (m_pPeakThread) m_pPeakThread->sync(pPeakFile, true);
+}
+
+
 // Cleanup method.
 void qtractorAudioPeakFactory::cleanup (void)
 {
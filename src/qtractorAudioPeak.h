@@ -80,6 +80,16 @@ public:
 	Frame *read(unsigned long iPeakOffset, unsigned int iPeakLength);
 	void closeRead();
 
+	// Level-of-detail envelopes: each level is a (max/min/rms)
+	// reduction of the previous one by (1 << EnvelopeShift) frames.
+	enum { EnvelopeLevels = 3, EnvelopeShift = 4 };
+
+	Frame *readEnvelope(unsigned short iLevel,
+		unsigned long iPeakOffset, unsigned int iPeakLength);
+
+	// Level-of-detail envelopes builder (on the peak thread).
+	bool buildEnvelopes();
+
 	// Write peak from audio frame methods.
 	bool openWrite(unsigned short iChannels, unsigned int iSampleRate);
 	int write(float **ppAudioFrames, unsigned int iAudioFrames);
@@ -99,6 +109,9 @@ public:
 	void setWaitSync(bool bWaitSync);
 	bool isWaitSync() const;
 
+	void setEnvelopeSync(bool bEnvelopeSync);
+	bool isEnvelopeSync() const;
+
 	// Peak filename standard.
 	static QString peakName(const QString& sFilename, float fTimeStretch);
 
@@ -111,6 +124,9 @@ protected:
 	unsigned int readBuffer(unsigned int iBuffOffset,
 		unsigned long iPeakOffset, unsigned int iPeakFrames);
 
+	// Level-of-detail envelopes cleaner.
+	void clearEnvelopes();
+
 private:
 
 	// Instance variables.
@@ -128,6 +144,13 @@ private:
 	unsigned int   m_iBuffLength;
 	unsigned long  m_iBuffOffset;
 
+	// Level-of-detail envelopes.
+	Frame         *m_ppEnvelopes[EnvelopeLevels];
+	unsigned long  m_iEnvelopeLengths[EnvelopeLevels];
+
+	volatile bool  m_bEnvelopeSync;
+	volatile bool  m_bEnvelopeDone;
+
 	QMutex         m_mutex;
 
 	volatile bool  m_bWaitSync;
@@ -197,9 +220,10 @@ private:
 	// Instance variable (ref'counted).
 	qtractorAudioPeakFile *m_pPeakFile;
 
-	// Interim scaling buffer and hash.
+	// Interim scaling buffer (reusable) and hash.
 	qtractorAudioPeakFile::Frame *m_pPeakFrames;
 
+	unsigned int m_iPeakSize;
 	unsigned int m_iPeakLength;
 	unsigned int m_iPeakHash;
 };
@@ -238,6 +262,9 @@ public:
 	// Base sync method.
 	void sync(qtractorAudioPeakFile *pPeakFile = nullptr);
 
+	// Envelopes (re)build sync method.
+	void syncEnvelopes(qtractorAudioPeakFile *pPeakFile);
+
 	// Cleanup method.
 	void cleanup();
 
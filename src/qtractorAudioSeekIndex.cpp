@@ -0,0 +1,363 @@
+// qtractorAudioSeekIndex.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioSeekIndex.h"
+
+#include "qtractorSession.h"
+
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QHash>
+#include <QDateTime>
+#include <QMutex>
+
+
+// Default seek index filename extension.
+static const QString c_sSeekIndexExt = ".seek";
+
+// Seek index file magic and version numbers.
+static const quint32 c_iSeekIndexMagic   = 0x5154534b; // "QTSK"
+static const quint32 c_iSeekIndexVersion = 1;
+
+
+// Seek index file header.
+struct qtractorAudioSeekIndex_Header
+{
+	quint32 magic;
+	quint32 version;
+	quint64 size;
+	qint64  time;
+	quint64 frames;
+	quint32 count;
+	quint32 reserved;
+};
+
+// Seek index file node.
+struct qtractorAudioSeekIndex_Node
+{
+	quint64 input;
+	quint64 output;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioSeekIndex -- Compressed audio file seek index.
+//
+
+// Constructor.
+qtractorAudioSeekIndex::qtractorAudioSeekIndex ( const QString& sFilename )
+	: m_sFilename(sFilename), m_iFrames(0),
+		m_iFileSize(0), m_iFileTime(0), m_bValid(false), m_iRefCount(1)
+{
+}
+
+
+// Sidecar (index) file name, next to the peak files.
+QString qtractorAudioSeekIndex::indexName (void) const
+{
+	QDir dir;
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession)
+		dir.setPath(pSession->sessionDir());
+
+	const QFileInfo fileInfo(m_sFilename);
+	const QString& sIndexPrefix
+		= QFileInfo(dir, fileInfo.fileName()).filePath();
+	return sIndexPrefix + '_'
+		+ QString::number(qHash(fileInfo.absoluteFilePath()), 16)
+		+ c_sSeekIndexExt;
+}
+
+
+// Index building methods.
+void qtractorAudioSeekIndex::clear (void)
+{
+	m_nodes.clear();
+
+	m_iFrames = 0;
+
+	m_iFileSize = 0;
+	m_iFileTime = 0;
+
+	m_bValid = false;
+}
+
+
+void qtractorAudioSeekIndex::append (
+	unsigned long iInputOffset, unsigned long iOutputOffset )
+{
+	// Keep it strictly monotonic...
+	if (!m_nodes.isEmpty()
+		&& m_nodes.last().iOutputOffset >= iOutputOffset)
+		return;
+
+	m_nodes.append(Node(iInputOffset, iOutputOffset));
+}
+
+
+void qtractorAudioSeekIndex::commit ( unsigned long iFrames )
+{
+	m_nodes.squeeze();
+
+	m_iFrames = iFrames;
+	m_bValid = fileStamp(m_iFileSize, m_iFileTime);
+}
+
+
+// Find the last node at or before a given frame offset;
+// returns the node index or -1 when none.
+int qtractorAudioSeekIndex::find ( unsigned long iOffset ) const
+{
+	int lo = 0;
+	int hi = m_nodes.count();
+
+	while (lo < hi) {
+		const int mid = (lo + hi) >> 1;
+		if (m_nodes.at(mid).iOutputOffset > iOffset)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo - 1;
+}
+
+
+// Sidecar file persistence.
+bool qtractorAudioSeekIndex::load (void)
+{
+	m_nodes.clear();
+	m_iFrames = 0;
+	m_bValid = false;
+
+	quint64 iSize = 0;
+	qint64  iTime = 0;
+	if (!fileStamp(iSize, iTime))
+		return false;
+
+	QFile file(indexName());
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	qtractorAudioSeekIndex_Header header;
+	if (file.read((char *) &header, sizeof(header)) != qint64(sizeof(header))
+		|| header.magic != c_iSeekIndexMagic
+		|| header.version != c_iSeekIndexVersion
+		|| header.size != iSize
+		|| header.time != iTime) {
+		file.close();
+		return false;
+	}
+
+	const qint64 nbytes
+		= qint64(header.count) * sizeof(qtractorAudioSeekIndex_Node);
+	if (nbytes != file.size() - qint64(sizeof(header))) {
+		file.close();
+		return false;
+	}
+
+	QVector<qtractorAudioSeekIndex_Node> nodes(header.count);
+	if (file.read((char *) nodes.data(), nbytes) != nbytes) {
+		file.close();
+		return false;
+	}
+
+	file.close();
+
+	m_nodes.reserve(nodes.count());
+	QVector<qtractorAudioSeekIndex_Node>::ConstIterator iter = nodes.constBegin();
+	const QVector<qtractorAudioSeekIndex_Node>::ConstIterator& iter_end = nodes.constEnd();
+	for ( ; iter != iter_end; ++iter)
+		m_nodes.append(Node(iter->input, iter->output));
+
+	m_iFrames = header.frames;
+
+	m_iFileSize = iSize;
+	m_iFileTime = iTime;
+
+	m_bValid = true;
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorAudioSeekIndex::load(\"%s\") nodes=%d frames=%lu",
+		m_sFilename.toUtf8().constData(), m_nodes.count(), m_iFrames);
+#endif
+
+	return true;
+}
+
+
+bool qtractorAudioSeekIndex::save (void) const
+{
+	if (!m_bValid)
+		return false;
+
+	QFile file(indexName());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	qtractorAudioSeekIndex_Header header;
+	header.magic    = c_iSeekIndexMagic;
+	header.version  = c_iSeekIndexVersion;
+	header.size     = m_iFileSize;
+	header.time     = m_iFileTime;
+	header.frames   = m_iFrames;
+	header.count    = m_nodes.count();
+	header.reserved = 0;
+
+	bool bResult = (file.write((const char *) &header, sizeof(header))
+		== qint64(sizeof(header)));
+
+	QVector<Node>::ConstIterator iter = m_nodes.constBegin();
+	const QVector<Node>::ConstIterator& iter_end = m_nodes.constEnd();
+	for ( ; bResult && iter != iter_end; ++iter) {
+		qtractorAudioSeekIndex_Node node;
+		node.input  = iter->iInputOffset;
+		node.output = iter->iOutputOffset;
+		bResult = (file.write((const char *) &node, sizeof(node))
+			== qint64(sizeof(node)));
+	}
+
+	file.close();
+
+	// Never leave a partial index behind...
+	if (!bResult)
+		file.remove();
+
+	return bResult;
+}
+
+
+// Source file signature (size and mtime).
+bool qtractorAudioSeekIndex::fileStamp ( quint64& iSize, qint64& iTime ) const
+{
+	const QFileInfo fileInfo(m_sFilename);
+	if (!fileInfo.exists())
+		return false;
+
+	iSize = fileInfo.size();
+	iTime = fileInfo.lastModified().toMSecsSinceEpoch();
+
+	return true;
+}
+
+
+// Shared index cache, holding one reference of each published index.
+class qtractorAudioSeekIndex_Cache : public QHash<QString, qtractorAudioSeekIndex *>
+{
+public:
+
+	// Destructor.
+	~qtractorAudioSeekIndex_Cache()
+	{
+		iterator iter = begin();
+		const iterator& iter_end = end();
+		for ( ; iter != iter_end; ++iter)
+			iter.value()->releaseRef();
+	}
+
+	// The one and only cache lock.
+	QMutex mutex;
+};
+
+static qtractorAudioSeekIndex_Cache& qtractorAudioSeekIndex_cache (void)
+{
+	static qtractorAudioSeekIndex_Cache s_cache;
+	return s_cache;
+}
+
+
+// Shared index cache: get a referenced, up-to-date index,
+// either cached or loaded from its sidecar file.
+qtractorAudioSeekIndex *qtractorAudioSeekIndex::getIndex (
+	const QString& sFilename )
+{
+	qtractorAudioSeekIndex_Cache& cache = qtractorAudioSeekIndex_cache();
+	QMutexLocker locker(&cache.mutex);
+
+	qtractorAudioSeekIndex *pSeekIndex = cache.value(sFilename, nullptr);
+
+	// Still up-to-date? otherwise just drop it off the cache,
+	// as it might still be in use (read-only) elsewhere...
+	if (pSeekIndex) {
+		quint64 iSize = 0;
+		qint64  iTime = 0;
+		if (!pSeekIndex->fileStamp(iSize, iTime)
+			|| iSize != pSeekIndex->m_iFileSize
+			|| iTime != pSeekIndex->m_iFileTime) {
+			cache.remove(sFilename);
+			pSeekIndex->releaseRef();
+			pSeekIndex = nullptr;
+		}
+	}
+
+	// Try the sidecar file then...
+	if (pSeekIndex == nullptr) {
+		pSeekIndex = new qtractorAudioSeekIndex(sFilename);
+		if (!pSeekIndex->load()) {
+			pSeekIndex->releaseRef();
+			return nullptr;
+		}
+		cache.insert(sFilename, pSeekIndex);
+	}
+
+	pSeekIndex->addRef();
+	return pSeekIndex;
+}
+
+
+// Shared index cache: publish a newly built (committed) index.
+qtractorAudioSeekIndex *qtractorAudioSeekIndex::putIndex (
+	qtractorAudioSeekIndex *pSeekIndex )
+{
+	if (!pSeekIndex->isValid()) {
+		pSeekIndex->releaseRef();
+		return nullptr;
+	}
+
+	const QString& sFilename = pSeekIndex->filename();
+
+	qtractorAudioSeekIndex_Cache& cache = qtractorAudioSeekIndex_cache();
+	QMutexLocker locker(&cache.mutex);
+
+	// Someone else got there first?
+	qtractorAudioSeekIndex *pOldSeekIndex = cache.value(sFilename, nullptr);
+	if (pOldSeekIndex) {
+		if (pOldSeekIndex->m_iFileSize == pSeekIndex->m_iFileSize
+			&& pOldSeekIndex->m_iFileTime == pSeekIndex->m_iFileTime) {
+			pSeekIndex->releaseRef();
+			pOldSeekIndex->addRef();
+			return pOldSeekIndex;
+		}
+		cache.remove(sFilename);
+		pOldSeekIndex->releaseRef();
+	}
+
+	pSeekIndex->save();
+
+	cache.insert(sFilename, pSeekIndex);
+	pSeekIndex->addRef();
+	return pSeekIndex;
+}
+
+
+// end of qtractorAudioSeekIndex.cpp
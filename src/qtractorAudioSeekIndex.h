@@ -0,0 +1,134 @@
+// qtractorAudioSeekIndex.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioSeekIndex_h
+#define __qtractorAudioSeekIndex_h
+
+#include <QString>
+#include <QVector>
+#include <QAtomicInt>
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioSeekIndex -- Compressed audio file seek index.
+//
+// Maps decoded sample frame offsets to input byte offsets, as built once
+// by a compressed file decoder (MP3, Ogg) and kept in a sidecar file next
+// to the peak files, validated by the source file size and mtime.
+// Once published in the shared cache, an index is immutable and may be
+// read by any thread without locking, for as long as it is referenced.
+//
+
+class qtractorAudioSeekIndex
+{
+public:
+
+	// Index node.
+	struct Node
+	{
+		// Member constructor.
+		Node(unsigned long i = 0, unsigned long o = 0)
+			: iInputOffset(i), iOutputOffset(o) {}
+		// Member fields.
+		unsigned long iInputOffset;     // Bytes from input file.
+		unsigned long iOutputOffset;    // Sample frames on output.
+	};
+
+	// Constructor.
+	qtractorAudioSeekIndex(const QString& sFilename);
+
+	// Source file name accessor.
+	const QString& filename() const
+		{ return m_sFilename; }
+
+	// Sidecar (index) file name, next to the peak files.
+	QString indexName() const;
+
+	// Whether the index is complete (built or loaded).
+	bool isValid() const
+		{ return m_bValid; }
+
+	// Index building methods.
+	void clear();
+	void append(unsigned long iInputOffset, unsigned long iOutputOffset);
+	void commit(unsigned long iFrames);
+
+	// Index node accessors.
+	int count() const
+		{ return m_nodes.count(); }
+	const Node& at(int i) const
+		{ return m_nodes.at(i); }
+
+	// Total number of decoded frames.
+	unsigned long frames() const
+		{ return m_iFrames; }
+
+	// Find the last node at or before a given frame offset;
+	// returns the node index or -1 when none.
+	int find(unsigned long iOffset) const;
+
+	// Sidecar file persistence.
+	bool load();
+	bool save() const;
+
+	// Reference counting methods.
+	void addRef()
+		{ m_iRefCount.ref(); }
+	void releaseRef()
+		{ if (!m_iRefCount.deref()) delete this; }
+
+	// Shared index cache: get a referenced, up-to-date index,
+	// either cached or loaded from its sidecar file; returns
+	// null when there's none yet (to be built by the caller).
+	static qtractorAudioSeekIndex *getIndex(const QString& sFilename);
+
+	// Shared index cache: publish a newly built (committed) index,
+	// taking over the caller's reference; returns the referenced
+	// index actually shared, or null when the given one is invalid.
+	static qtractorAudioSeekIndex *putIndex(qtractorAudioSeekIndex *pSeekIndex);
+
+protected:
+
+	// Source file signature (size and mtime).
+	bool fileStamp(quint64& iSize, qint64& iTime) const;
+
+private:
+
+	// Instance variables.
+	QString       m_sFilename;
+
+	QVector<Node> m_nodes;
+
+	unsigned long m_iFrames;
+
+	quint64       m_iFileSize;
+	qint64        m_iFileTime;
+
+	bool          m_bValid;
+
+	QAtomicInt    m_iRefCount;
+};
+
+
+#endif  // __qtractorAudioSeekIndex_h
+
+
+// end of qtractorAudioSeekIndex.h
@@ -0,0 +1,218 @@
+// qtractorAudioStretch.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioStretch.h"
+#include "qtractorAudioSndFile.h"
+#include "qtractorAudioClip.h"
+
+#include "qtractorTimeStretcher.h"
+
+
+// Default stretch cache filename extension.
+static const QString c_sStretchFileExt = ".stretch.wav";
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchFile -- Pre-rendered time-stretch cache file.
+//
+
+// Constructor.
+qtractorAudioStretchFile::qtractorAudioStretchFile ( const QString& sFilename,
+	float fTimeStretch, float fPitchShift, unsigned int iFlags )
+	: qtractorAudioCacheFile(sFilename,
+		stretchName(sFilename, fTimeStretch, fPitchShift, iFlags),
+		c_sStretchFileExt)
+{
+	// Initialize instance variables.
+	m_fTimeStretch = fTimeStretch;
+	m_fPitchShift  = fPitchShift;
+	m_iFlags       = iFlags;
+}
+
+
+// Audio properties accessors.
+float qtractorAudioStretchFile::timeStretch (void) const
+{
+	return m_fTimeStretch;
+}
+
+float qtractorAudioStretchFile::pitchShift (void) const
+{
+	return m_fPitchShift;
+}
+
+unsigned int qtractorAudioStretchFile::flags (void) const
+{
+	return m_iFlags;
+}
+
+
+QString qtractorAudioStretchFile::stretchName (void) const
+{
+	return stretchName(filename(), m_fTimeStretch, m_fPitchShift, m_iFlags);
+}
+
+
+// Rendered as 32bit float, no dithering nor clipping involved.
+int qtractorAudioStretchFile::sampleFormat (void) const
+{
+	return SF_FORMAT_FLOAT;
+}
+
+
+// Time-stretch the whole source into the cache file.
+bool qtractorAudioStretchFile::process ( qtractorAudioFile *pAudioFile,
+	qtractorAudioFile *pCacheFile, float **ppFrames,
+	unsigned int iFrames, volatile bool *pbRunState )
+{
+	qtractorTimeStretcher *pTimeStretcher
+		= new qtractorTimeStretcher(
+			pAudioFile->channels(), pAudioFile->sampleRate(),
+			m_fTimeStretch, m_fPitchShift, m_iFlags, iFrames);
+
+	bool bResult = true;
+	bool bFlush  = false;
+
+	while (bResult && isRunState(pbRunState)) {
+		// Read another bunch of frames from the source audio file...
+		if (!bFlush) {
+			const int nread = pAudioFile->read(ppFrames, iFrames);
+			if (nread > 0) {
+				pTimeStretcher->process(ppFrames, nread);
+			} else {
+				pTimeStretcher->flush();
+				bFlush = true;
+			}
+		}
+		// Drain whatever the stretcher has got ready...
+		unsigned int nahead = pTimeStretcher->available();
+		while (bResult && nahead > 0) {
+			if (nahead > iFrames)
+				nahead = iFrames;
+			nahead = pTimeStretcher->retrieve(ppFrames, nahead);
+			if (nahead > 0) {
+				const int nwrite = pCacheFile->write(ppFrames, nahead);
+				bResult = (nwrite == int(nahead));
+				nahead = pTimeStretcher->available();
+			}
+		}
+		// Done?
+		if (bFlush)
+			break;
+	}
+
+	delete pTimeStretcher;
+
+	return bResult;
+}
+
+
+// Stretch filename standard.
+QString qtractorAudioStretchFile::stretchName ( const QString& sFilename,
+	float fTimeStretch, float fPitchShift, unsigned int iFlags )
+{
+	return sFilename
+		+ '_' + QString::number(fTimeStretch)
+		+ '_' + QString::number(fPitchShift)
+		+ '_' + QString::number(iFlags);
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchFactory -- Stretch cache file factory.
+//
+
+// Singleton instance pointer.
+qtractorAudioStretchFactory *qtractorAudioStretchFactory::g_pStretchFactory = nullptr;
+
+// Singleton instance accessor (static).
+qtractorAudioStretchFactory *qtractorAudioStretchFactory::getInstance (void)
+{
+	return g_pStretchFactory;
+}
+
+
+// Constructor.
+qtractorAudioStretchFactory::qtractorAudioStretchFactory ( QObject *pParent )
+	: qtractorAudioCacheFactory(pParent)
+{
+	// Pseudo-singleton reference setup.
+	g_pStretchFactory = this;
+}
+
+
+// Default destructor.
+qtractorAudioStretchFactory::~qtractorAudioStretchFactory (void)
+{
+	// Pseudo-singleton reference shut-down.
+	g_pStretchFactory = nullptr;
+}
+
+
+// Ready cache file name, if any; otherwise schedule its rendering.
+QString qtractorAudioStretchFactory::cacheName ( const QString& sFilename,
+	float fTimeStretch, float fPitchShift, unsigned int iFlags )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (!isEnabled())
+		return QString();
+
+	const QString& sStretchName = qtractorAudioStretchFile::stretchName(
+		sFilename, fTimeStretch, fPitchShift, iFlags);
+	qtractorAudioCacheFile *pStretchFile = m_files.value(sStretchName);
+	if (pStretchFile == nullptr) {
+		pStretchFile = new qtractorAudioStretchFile(
+			sFilename, fTimeStretch, fPitchShift, iFlags);
+		m_files.insert(sStretchName, pStretchFile);
+	}
+
+	return readyName(pStretchFile);
+}
+
+
+// Whether a ready cache file exists (no scheduling).
+bool qtractorAudioStretchFactory::isReady ( const QString& sFilename,
+	float fTimeStretch, float fPitchShift, unsigned int iFlags )
+{
+	return isCacheReady(qtractorAudioStretchFile::stretchName(
+		sFilename, fTimeStretch, fPitchShift, iFlags));
+}
+
+
+// Whether a clip is due to switch over its cache file.
+bool qtractorAudioStretchFactory::isClipReady ( qtractorAudioClip *pAudioClip )
+{
+	qtractorAudioBuffer *pBuff = pAudioClip->buffer();
+	if (pBuff == nullptr || pBuff->isStretchCache())
+		return false;
+
+	if (!pBuff->isTimeStretch() && !pBuff->isPitchShift())
+		return false;
+
+	return isReady(pAudioClip->filename(),
+		pBuff->timeStretch(), pBuff->pitchShift(),
+		pBuff->timeStretchFlags());
+}
+
+
+// end of qtractorAudioStretch.cpp
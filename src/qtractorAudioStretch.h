@@ -0,0 +1,111 @@
+// qtractorAudioStretch.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioStretch_h
+#define __qtractorAudioStretch_h
+
+#include "qtractorAudioCache.h"
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchFile -- Pre-rendered time-stretch cache file.
+//
+
+class qtractorAudioStretchFile : public qtractorAudioCacheFile
+{
+public:
+
+	// Constructor.
+	qtractorAudioStretchFile(const QString& sFilename,
+		float fTimeStretch, float fPitchShift, unsigned int iFlags);
+
+	// Audio properties accessors.
+	float timeStretch() const;
+	float pitchShift() const;
+	unsigned int flags() const;
+
+	QString stretchName() const;
+
+	// Stretch filename standard.
+	static QString stretchName(const QString& sFilename,
+		float fTimeStretch, float fPitchShift, unsigned int iFlags);
+
+protected:
+
+	// Rendered as 32bit float, no dithering nor clipping involved.
+	int sampleFormat() const;
+
+	// Time-stretch the whole source into the cache file.
+	bool process(qtractorAudioFile *pAudioFile,
+		qtractorAudioFile *pCacheFile, float **ppFrames,
+		unsigned int iFrames, volatile bool *pbRunState);
+
+private:
+
+	// Instance variables.
+	float          m_fTimeStretch;
+	float          m_fPitchShift;
+	unsigned int   m_iFlags;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchFactory -- Stretch cache file factory.
+//
+
+class qtractorAudioStretchFactory : public qtractorAudioCacheFactory
+{
+public:
+
+	// Constructor.
+	qtractorAudioStretchFactory(QObject *pParent = nullptr);
+	// Default destructor.
+	~qtractorAudioStretchFactory();
+
+	// Ready cache file name, if any; otherwise
+	// schedules its background rendering and
+	// returns an empty string (live fallback).
+	QString cacheName(const QString& sFilename,
+		float fTimeStretch, float fPitchShift, unsigned int iFlags);
+
+	// Whether a ready cache file exists (no scheduling).
+	bool isReady(const QString& sFilename,
+		float fTimeStretch, float fPitchShift, unsigned int iFlags);
+
+	// Singleton instance accessor.
+	static qtractorAudioStretchFactory *getInstance();
+
+protected:
+
+	// Whether a clip is due to switch over its cache file.
+	bool isClipReady(qtractorAudioClip *pAudioClip);
+
+private:
+
+	// The pseudo-singleton instance.
+	static qtractorAudioStretchFactory *g_pStretchFactory;
+};
+
+
+#endif  // __qtractorAudioStretch_h
+
+
+// end of qtractorAudioStretch.h
@@ -0,0 +1,191 @@
+// qtractorAudioTranscode.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioTranscode.h"
+#include "qtractorAudioSndFile.h"
+#include "qtractorAudioClip.h"
+
+#include <QFileInfo>
+
+
+// Default transcode cache filename extension.
+static const QString c_sTranscodeFileExt = ".pcm.wav";
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioTranscodeFile -- Transcoded (PCM) cache file.
+//
+
+// Constructor.
+qtractorAudioTranscodeFile::qtractorAudioTranscodeFile (
+	const QString& sFilename, int iFormat )
+	: qtractorAudioCacheFile(sFilename,
+		QFileInfo(sFilename).absoluteFilePath()
+			+ '_' + QString::number(iFormat),
+		c_sTranscodeFileExt)
+{
+	// Initialize instance variables.
+	m_iFormat = iFormat;
+}
+
+
+// Audio properties accessors.
+int qtractorAudioTranscodeFile::format (void) const
+{
+	return m_iFormat;
+}
+
+
+// Rendered as 32bit float or 24bit PCM, no dithering involved.
+int qtractorAudioTranscodeFile::sampleFormat (void) const
+{
+	return (m_iFormat == qtractorAudioTranscodeFactory::Pcm24
+		? SF_FORMAT_PCM_24 : SF_FORMAT_FLOAT);
+}
+
+
+// Transcode the whole source into the cache file.
+bool qtractorAudioTranscodeFile::process ( qtractorAudioFile *pAudioFile,
+	qtractorAudioFile *pCacheFile, float **ppFrames,
+	unsigned int iFrames, volatile bool *pbRunState )
+{
+	bool bResult = true;
+
+	while (bResult && isRunState(pbRunState)) {
+		// Read another bunch of frames from the source audio file...
+		const int nread = pAudioFile->read(ppFrames, iFrames);
+		if (nread < 1)
+			break;
+		const int nwrite = pCacheFile->write(ppFrames, nread);
+		bResult = (nwrite == nread);
+	}
+
+	return bResult;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioTranscodeFactory -- Transcode cache file factory.
+//
+
+// Singleton instance pointer.
+qtractorAudioTranscodeFactory *qtractorAudioTranscodeFactory::g_pTranscodeFactory = nullptr;
+
+// Singleton instance accessor (static).
+qtractorAudioTranscodeFactory *qtractorAudioTranscodeFactory::getInstance (void)
+{
+	return g_pTranscodeFactory;
+}
+
+
+// Constructor.
+qtractorAudioTranscodeFactory::qtractorAudioTranscodeFactory ( QObject *pParent )
+	: qtractorAudioCacheFactory(pParent), m_iFormat(Float)
+{
+	// Pseudo-singleton reference setup.
+	g_pTranscodeFactory = this;
+}
+
+
+// Default destructor.
+qtractorAudioTranscodeFactory::~qtractorAudioTranscodeFactory (void)
+{
+	// Pseudo-singleton reference shut-down.
+	g_pTranscodeFactory = nullptr;
+}
+
+
+// Cache sample format property.
+void qtractorAudioTranscodeFactory::setFormat ( int iFormat )
+{
+	m_iFormat = iFormat;
+}
+
+int qtractorAudioTranscodeFactory::format (void) const
+{
+	return m_iFormat;
+}
+
+
+// Ready cache file name, if any; otherwise schedule its transcoding.
+QString qtractorAudioTranscodeFactory::cacheName ( const QString& sFilename )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (!isEnabled() || !isCompressed(sFilename))
+		return QString();
+
+	const QString& sTranscodeKey
+		= sFilename + '_' + QString::number(m_iFormat);
+	qtractorAudioCacheFile *pTranscodeFile = m_files.value(sTranscodeKey);
+	if (pTranscodeFile == nullptr) {
+		pTranscodeFile = new qtractorAudioTranscodeFile(sFilename, m_iFormat);
+		m_files.insert(sTranscodeKey, pTranscodeFile);
+	}
+
+	return readyName(pTranscodeFile);
+}
+
+
+// Whether a ready cache file exists (no scheduling).
+bool qtractorAudioTranscodeFactory::isReady ( const QString& sFilename )
+{
+	return isCacheReady(sFilename + '_' + QString::number(m_iFormat));
+}
+
+
+// Whether a clip is due to switch over its cache file.
+bool qtractorAudioTranscodeFactory::isClipReady ( qtractorAudioClip *pAudioClip )
+{
+	qtractorAudioBuffer *pBuff = pAudioClip->buffer();
+	if (pBuff == nullptr
+		|| pBuff->isTranscodeCache() || pBuff->isStretchCache())
+		return false;
+
+	return isReady(pAudioClip->filename());
+}
+
+
+// Whether a given file is of some compressed format.
+bool qtractorAudioTranscodeFactory::isCompressed ( const QString& sFilename )
+{
+	const QString& sExt = QFileInfo(sFilename).suffix().toLower();
+	const qtractorAudioFileFactory::FileFormat *pFormat
+		= qtractorAudioFileFactory::types().value(sExt, nullptr);
+	if (pFormat == nullptr)
+		return false;
+
+	switch (pFormat->type) {
+	case qtractorAudioFileFactory::VorbisFile:
+	case qtractorAudioFileFactory::MadFile:
+		return true;
+	case qtractorAudioFileFactory::SndFile: {
+		const int iMajor = (pFormat->data & SF_FORMAT_TYPEMASK);
+		return (iMajor == SF_FORMAT_FLAC || iMajor == SF_FORMAT_OGG);
+	}
+	default:
+		return false;
+	}
+}
+
+
+// end of qtractorAudioTranscode.cpp
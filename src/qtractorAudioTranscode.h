@@ -0,0 +1,111 @@
+// qtractorAudioTranscode.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioTranscode_h
+#define __qtractorAudioTranscode_h
+
+#include "qtractorAudioCache.h"
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioTranscodeFile -- Transcoded (PCM) cache file.
+//
+
+class qtractorAudioTranscodeFile : public qtractorAudioCacheFile
+{
+public:
+
+	// Constructor.
+	qtractorAudioTranscodeFile(const QString& sFilename, int iFormat);
+
+	// Audio properties accessors.
+	int format() const;
+
+protected:
+
+	// Rendered as 32bit float or 24bit PCM, no dithering involved.
+	int sampleFormat() const;
+
+	// Transcode the whole source into the cache file.
+	bool process(qtractorAudioFile *pAudioFile,
+		qtractorAudioFile *pCacheFile, float **ppFrames,
+		unsigned int iFrames, volatile bool *pbRunState);
+
+private:
+
+	// Instance variables.
+	int m_iFormat;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioTranscodeFactory -- Transcode cache file factory.
+//
+
+class qtractorAudioTranscodeFactory : public qtractorAudioCacheFactory
+{
+public:
+
+	// Constructor.
+	qtractorAudioTranscodeFactory(QObject *pParent = nullptr);
+	// Default destructor.
+	~qtractorAudioTranscodeFactory();
+
+	// Cache sample formats.
+	enum Format { Float = 0, Pcm24 = 1 };
+
+	// Cache sample format property.
+	void setFormat(int iFormat);
+	int format() const;
+
+	// Ready cache file name, if any; otherwise
+	// schedules its background transcoding and
+	// returns an empty string (live fallback).
+	QString cacheName(const QString& sFilename);
+
+	// Whether a ready cache file exists (no scheduling).
+	bool isReady(const QString& sFilename);
+
+	// Whether a given file is of some compressed format.
+	static bool isCompressed(const QString& sFilename);
+
+	// Singleton instance accessor.
+	static qtractorAudioTranscodeFactory *getInstance();
+
+protected:
+
+	// Whether a clip is due to switch over its cache file.
+	bool isClipReady(qtractorAudioClip *pAudioClip);
+
+private:
+
+	// Cache sample format property.
+	int m_iFormat;
+
+	// The pseudo-singleton instance.
+	static qtractorAudioTranscodeFactory *g_pTranscodeFactory;
+};
+
+
+#endif  // __qtractorAudioTranscode_h
+
+
+// end of qtractorAudioTranscode.h
@@ -21,6 +21,7 @@
 
 #include "qtractorAbout.h"
 #include "qtractorAudioVorbisFile.h"
+#include "qtractorAudioSeekIndex.h"
 
 #ifdef CONFIG_LIBVORBIS
 // libvorbis encoder API.
@@ -32,6 +33,10 @@
 #include <time.h>
 
 
+// Maximum decode-forward distance after an indexed seek (frames).
+#define QTRACTOR_VORBIS_SEEK_MAX	(1 << 16)
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioVorbisFile -- Buffered audio file implementation.
 //
@@ -62,6 +67,9 @@ qtractorAudioVorbisFile::qtractorAudioVorbisFile ( unsigned short iChannels,
 
 	// Encoding quality (write-only).
 	m_iQuality = iQuality;
+
+	// Seek index (read-only).
+	m_pSeekIndex = nullptr;
 }
 
 // Destructor.
@@ -110,6 +118,16 @@ bool qtractorAudioVorbisFile::open ( const QString& sFilename, int iMode )
 
 		case Read:
 		{
+			// Get the seek index, (re)built only once...
+			m_pSeekIndex = qtractorAudioSeekIndex::getIndex(sFilename);
+			if (m_pSeekIndex == nullptr) {
+				// Build it on our own (no locks held), then publish it...
+				qtractorAudioSeekIndex *pSeekIndex
+					= new qtractorAudioSeekIndex(sFilename);
+				scanIndex(m_pFile, pSeekIndex);
+				m_pSeekIndex = qtractorAudioSeekIndex::putIndex(pSeekIndex);
+			}
+			::rewind(m_pFile);
 			// Open the Ogg Vorbis file for decoding...
 			if (::ov_open(m_pFile, &m_ovfile, nullptr, 0) < 0) {
 				close();
@@ -298,7 +316,38 @@ bool qtractorAudioVorbisFile::seek ( unsigned long iOffset )
 #endif
 
 #ifdef CONFIG_LIBVORBIS
+
+	// Jump through the seek index first, if any...
+	long iInputOffset = -1;
+
+	// (the seek index is immutable, no locking needed)...
+	const int i = (m_pSeekIndex ? m_pSeekIndex->find(iOffset) : -1);
+	if (i >= 0)
+		iInputOffset = m_pSeekIndex->at(i).iInputOffset;
+
+	if (iInputOffset >= 0 && ::ov_raw_seek(&m_ovfile, iInputOffset) == 0) {
+		const ogg_int64_t iTarget = iOffset;
+		ogg_int64_t iPos = ::ov_pcm_tell(&m_ovfile);
+		// Decode (and discard) up to the exact target frame...
+		if (iPos >= 0 && iTarget - iPos < QTRACTOR_VORBIS_SEEK_MAX) {
+			while (iPos < iTarget) {
+				float **ppBuffer;
+				const int iFrames = (iTarget - iPos < m_iBufferSize
+					? int(iTarget - iPos) : int(m_iBufferSize));
+				const long nread = ::ov_read_float(
+					&m_ovfile, &ppBuffer, iFrames, &m_ovsect);
+				if (nread <= 0)
+					break;
+				iPos += nread;
+			}
+		}
+		if (iPos == iTarget)
+			return true;
+	}
+
+	// Otherwise do the (bisection) seek thing...
 	return (::ov_pcm_seek(&m_ovfile, iOffset) == 0);
+
 #else
 	return false;
 #endif
@@ -348,6 +397,12 @@ void qtractorAudioVorbisFile::close (void)
 	m_ovinfo = nullptr;
 #endif
 
+	// Seek indexes are shared (cached), just unreference...
+	if (m_pSeekIndex) {
+		m_pSeekIndex->releaseRef();
+		m_pSeekIndex = nullptr;
+	}
+
 	m_iMode = qtractorAudioVorbisFile::None;
 	m_iFrames = 0;
 }
@@ -393,6 +448,91 @@ unsigned int qtractorAudioVorbisFile::sampleRate (void) const
 }
 
 
+// Seek index builder (page-only scan, no actual decoding).
+bool qtractorAudioVorbisFile::scanIndex (
+	FILE *pFile, qtractorAudioSeekIndex *pSeekIndex )
+{
+	pSeekIndex->clear();
+
+#ifdef CONFIG_LIBVORBIS
+
+	ogg_sync_state ovsync;
+	ogg_page ovpage;
+
+	ogg_sync_init(&ovsync);
+
+	long iPageOffset = 0;	// File offset of next page.
+	long iSerialNo = -1;
+	bool bChained = false;
+
+	// Each node maps a page to the frame offset where its first
+	// new packet begins (ie. the previous page granule position)...
+	ogg_int64_t iGranulePos = 0;
+
+	::rewind(pFile);
+
+	for (;;) {
+		const long n = ogg_sync_pageseek(&ovsync, &ovpage);
+		if (n < 0) {
+			// Skipped some garbage...
+			iPageOffset -= n;
+			continue;
+		}
+		if (n == 0) {
+			// Need more data...
+			char *pBuffer = ogg_sync_buffer(&ovsync, 4096);
+			const long iRead = ::fread(pBuffer, 1, 4096, pFile);
+			if (iRead < 1)
+				break;
+			ogg_sync_wrote(&ovsync, iRead);
+			continue;
+		}
+		// Got a whole page...
+		const long iSerialPage = ogg_page_serialno(&ovpage);
+		if (iSerialNo < 0)
+			iSerialNo = iSerialPage;
+		else
+		if (iSerialNo != iSerialPage) {
+			// Chained or multiplexed: leave it to bisection...
+			bChained = true;
+			break;
+		}
+		const ogg_int64_t iPageGranulePos = ogg_page_granulepos(&ovpage);
+		if (iPageGranulePos >= 0) {
+			pSeekIndex->append(iPageOffset, iGranulePos);
+			iGranulePos = iPageGranulePos;
+		}
+		iPageOffset += n;
+	}
+
+	ogg_sync_clear(&ovsync);
+
+	if (iSerialNo < 0)
+		return false;
+
+	if (bChained) {
+		pSeekIndex->clear();
+		iGranulePos = 0;
+	}
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorAudioVorbisFile::scanIndex(\"%s\") nodes=%d frames=%lu",
+		pSeekIndex->filename().toUtf8().constData(),
+		pSeekIndex->count(), (unsigned long) iGranulePos);
+#endif
+
+	pSeekIndex->commit(iGranulePos);
+
+	return true;
+
+#else	// CONFIG_LIBVORBIS
+
+	return false;
+
+#endif
+}
+
+
 // Translate quality index into vorbis encoder specific. (static)
 int qtractorAudioVorbisFile::quality ( int iQuality )
 {
@@ -24,6 +24,8 @@
 
 #include "qtractorAudioFile.h"
 
+#include <stdio.h>
+
 #ifdef CONFIG_LIBVORBIS
 // libvorbis API.
 #include <vorbis/codec.h>
@@ -31,6 +33,10 @@
 #endif
 
 
+// Forward declarations.
+class qtractorAudioSeekIndex;
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioVorbisFile -- Buffered audio file declaration.
 //
@@ -71,6 +77,9 @@ protected:
 	// Flush encoder buffers.
 	void flush(bool fEos = false);
 
+	// Seek index builder (page-only scan).
+	static bool scanIndex(FILE *pFile, qtractorAudioSeekIndex *pSeekIndex);
+
 private:
 
 	int              m_iMode;       // open mode (Read only).
@@ -99,6 +108,9 @@ private:
 
 	unsigned int     m_iBufferSize; // estimated buffer size.
 	int              m_iQuality;    // encoding quality (write-only).
+
+	// Seek index (shared, persistent; read-only).
+	qtractorAudioSeekIndex *m_pSeekIndex;
 };
 
 
@@ -169,6 +169,9 @@ qtractorBusForm::qtractorBusForm ( QWidget *pParent )
 	QObject::connect(m_ui.AudioAutoConnectCheckBox,
 		SIGNAL(clicked()),
 		SLOT(changed()));
+	QObject::connect(m_ui.AudioSumBusComboBox,
+		SIGNAL(activated(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.MidiInstrumentComboBox,
 		SIGNAL(activated(int)),
 		SLOT(changed()));
@@ -307,6 +310,7 @@ void qtractorBusForm::showBus ( qtractorBus *pBus )
 	// Update some dependable specifics...
 	updateMidiInstruments();
 	updateMidiSysex();
+	updateAudioSumBuses();
 
 	// Show bus properties into view pane...
 	if (pBus) {
@@ -325,6 +329,10 @@ void qtractorBusForm::showBus ( qtractorBus *pBus )
 					pAudioBus->channels());
 				m_ui.AudioAutoConnectCheckBox->setChecked(
 					pAudioBus->isAutoConnect());
+				const int iSumBus = m_ui.AudioSumBusComboBox->findText(
+					pAudioBus->sumBusName());
+				m_ui.AudioSumBusComboBox->setCurrentIndex(
+					iSumBus > 0 ? iSumBus : 0);
 				// Set plugin lists...
 				if (pAudioBus->busMode() & qtractorBus::Input)
 					m_ui.InputPluginListView->setPluginList(
@@ -571,6 +579,11 @@ bool qtractorBusForm::updateBus ( qtractorBus *pBus )
 			m_ui.AudioChannelsSpinBox->value());
 		pUpdateBusCommand->setAutoConnect(
 			m_ui.AudioAutoConnectCheckBox->isChecked());
+		pUpdateBusCommand->setSumBusName(
+			(busMode & qtractorBus::Output)
+			&& m_ui.AudioSumBusComboBox->currentIndex() > 0
+			? m_ui.AudioSumBusComboBox->currentText()
+			: QString());
 		break;
 	case qtractorTrack::Midi:
 		pUpdateBusCommand->setInstrumentName(
@@ -677,6 +690,11 @@ void qtractorBusForm::createBus (void)
 			m_ui.AudioChannelsSpinBox->value());
 		pCreateBusCommand->setAutoConnect(
 			m_ui.AudioAutoConnectCheckBox->isChecked());
+		pCreateBusCommand->setSumBusName(
+			(busMode & qtractorBus::Output)
+			&& m_ui.AudioSumBusComboBox->currentIndex() > 0
+			? m_ui.AudioSumBusComboBox->currentText()
+			: QString());
 		break;
 	case qtractorTrack::Midi:
 		pCreateBusCommand->setInstrumentName(
@@ -837,6 +855,9 @@ void qtractorBusForm::stabilizeForm (void)
 		m_ui.AudioBusGroup->setVisible(true);
 		m_ui.MidiBusGroup->setEnabled(false);
 		m_ui.MidiBusGroup->setVisible(false);
+		bEnabled = (busMode & qtractorBus::Output);
+		m_ui.AudioSumBusTextLabel->setEnabled(bEnabled);
+		m_ui.AudioSumBusComboBox->setEnabled(bEnabled);
 	}
 	else
 	if (m_pBus && m_pBus->busType() == qtractorTrack::Midi) {
@@ -1038,6 +1059,41 @@ void qtractorBusForm::updateMidiInstruments (void)
 }
 
 
+// Refresh internal (summing) bus target list.
+void qtractorBusForm::updateAudioSumBuses (void)
+{
+	m_ui.AudioSumBusComboBox->clear();
+	m_ui.AudioSumBusComboBox->addItem(tr("(JACK ports)"));
+
+	// Care of audio output bus...
+	if (m_pBus == nullptr)
+		return;
+	if (m_pBus->busType() != qtractorTrack::Audio)
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr)
+		return;
+
+	qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+	if (pAudioEngine == nullptr)
+		return;
+
+	// Avoid superfluous change notifications...
+	++m_iDirtySetup;
+
+	const QIcon& icon = QIcon(":/images/trackAudio.png");
+	for (qtractorBus *pBus = pAudioEngine->buses().first();
+			pBus; pBus = pBus->next()) {
+		if (pBus != m_pBus && (pBus->busMode() & qtractorBus::Output))
+			m_ui.AudioSumBusComboBox->addItem(icon, pBus->busName());
+	}
+
+	// Done.
+	--m_iDirtySetup;
+}
+
+
 // Update SysEx status.
 void qtractorBusForm::updateMidiSysex (void)
 {
@@ -87,6 +87,8 @@ protected:
 	void updateMidiInstruments();
 	void updateMidiSysex();
 
+	void updateAudioSumBuses();
+
 	void resetPluginLists();
 
 	void refreshBuses();
@@ -40,6 +40,62 @@
 
 #include <QDomDocument>
 
+#include <cmath>
+
+
+// Fade curve table resolution (number of segments).
+#define QTRACTOR_FADE_TABLE_SIZE 1024
+
+
+// Fade curve table lookup (linear interpolated).
+static inline float qtractorClip_fadeGain (
+	const float *pfTable, unsigned long iOffset, unsigned long iLength )
+{
+	const float t = float(QTRACTOR_FADE_TABLE_SIZE)
+		* float(iOffset) / float(iLength);
+	const unsigned int k = (unsigned int) t;
+	if (k >= QTRACTOR_FADE_TABLE_SIZE)
+		return pfTable[QTRACTOR_FADE_TABLE_SIZE];
+	return pfTable[k] + (t - float(k)) * (pfTable[k + 1] - pfTable[k]);
+}
+
+
+// Fade curve table rendering, over a range of frames:
+// each table segment is a straight line run, which the
+// compiler may well vectorize (no table gather per frame).
+static void qtractorClip_fadeGains ( float *pfGains,
+	const float *pfTable, unsigned long iOffset, unsigned int nframes,
+	unsigned long iLength )
+{
+	const double fScale = double(QTRACTOR_FADE_TABLE_SIZE) / double(iLength);
+
+	while (nframes > 0) {
+		const double t = fScale * double(iOffset);
+		const unsigned int k = (unsigned int) t;
+		if (k >= QTRACTOR_FADE_TABLE_SIZE) {
+			const float fGain = pfTable[QTRACTOR_FADE_TABLE_SIZE];
+			for (unsigned int n = 0; n < nframes; ++n)
+				pfGains[n] = fGain;
+			break;
+		}
+		// Frames up to the next table node...
+		unsigned long iNext = (unsigned long) ::ceil(double(k + 1) / fScale);
+		if (iNext <= iOffset)
+			iNext = iOffset + 1;
+		unsigned int nrun = iNext - iOffset;
+		if (nrun > nframes)
+			nrun = nframes;
+		const float fDelta = pfTable[k + 1] - pfTable[k];
+		const float fGain0 = pfTable[k] + float(t - double(k)) * fDelta;
+		const float fSlope = float(fScale) * fDelta;
+		for (unsigned int n = 0; n < nrun; ++n)
+			pfGains[n] = fGain0 + float(n) * fSlope;
+		pfGains += nrun;
+		iOffset += nrun;
+		nframes -= nrun;
+	}
+}
+
 
 //-------------------------------------------------------------------------
 // qtractorClip -- Track clip capsule.
@@ -57,6 +113,8 @@ qtractorClip::qtractorClip ( qtractorTrack *pTrack )
 	m_pFadeInFunctor  = nullptr;
 	m_pFadeOutFunctor = nullptr;
 
+	m_iSerial = 0;
+
 	clear();
 }
 
@@ -285,20 +343,76 @@ void qtractorClip::setFadeOutLength ( unsigned long iFadeOutLength )
 float qtractorClip::fadeInOutGain ( unsigned long iOffset ) const
 {
 	if (m_iFadeInLength > 0 && iOffset < m_iFadeInLength) {
-		return (*m_pFadeInFunctor)(
-			float(iOffset) / float(m_iFadeInLength));
+		return qtractorClip_fadeGain(
+			m_pFadeInFunctor->table(), iOffset, m_iFadeInLength);
 	}
 
 	if (m_iFadeOutLength > 0 && iOffset > m_iClipLength - m_iFadeOutLength) {
-		return (*m_pFadeOutFunctor)(
-			float(iOffset - (m_iClipLength - m_iFadeOutLength))
-				/ float(m_iFadeOutLength));
+		return qtractorClip_fadeGain(
+			m_pFadeOutFunctor->table(),
+			iOffset - (m_iClipLength - m_iFadeOutLength), m_iFadeOutLength);
 	}
 
 	return (iOffset < m_iClipLength ? 1.0f : 0.0f);
 }
 
 
+// Compute per-frame clip gains (envelope), given current fade-in/out
+// slopes; returns false if there's no fade over the whole range.
+bool qtractorClip::fadeInOutGains (
+	float *pfGains, unsigned long iOffset, unsigned int nframes ) const
+{
+	const unsigned long iFadeOutStart = m_iClipLength - m_iFadeOutLength;
+	const unsigned long iOffsetEnd = iOffset + nframes;
+
+	// Flat (unity gain) all the way through?
+	if (iOffset >= m_iFadeInLength && iOffsetEnd <= iFadeOutStart)
+		return false;
+
+	unsigned int n = 0;
+	unsigned int nfade;
+
+	// Fade-in part...
+	if (iOffset < m_iFadeInLength) {
+		nfade = m_iFadeInLength - iOffset;
+		if (nfade > nframes)
+			nfade = nframes;
+		qtractorClip_fadeGains(pfGains,
+			m_pFadeInFunctor->table(), iOffset, nfade, m_iFadeInLength);
+		iOffset += nfade;
+		n += nfade;
+	}
+
+	// Flat part...
+	if (n < nframes && iOffset < iFadeOutStart) {
+		nfade = iFadeOutStart - iOffset;
+		if (nfade > nframes - n)
+			nfade = nframes - n;
+		for (unsigned int i = 0; i < nfade; ++i)
+			pfGains[n + i] = 1.0f;
+		iOffset += nfade;
+		n += nfade;
+	}
+
+	// Fade-out part...
+	if (n < nframes && iOffset < m_iClipLength) {
+		nfade = m_iClipLength - iOffset;
+		if (nfade > nframes - n)
+			nfade = nframes - n;
+		qtractorClip_fadeGains(pfGains + n,
+			m_pFadeOutFunctor->table(), iOffset - iFadeOutStart, nfade,
+			m_iFadeOutLength);
+		n += nfade;
+	}
+
+	// Past the clip end...
+	for ( ; n < nframes; ++n)
+		pfGains[n] = 0.0f;
+
+	return true;
+}
+
+
 // Clip time reference settler method.
 void qtractorClip::updateClipTime (void)
 {
@@ -329,8 +443,8 @@ void qtractorClip::updateClipTime (void)
 
 
 // Base clip drawing method.
-void qtractorClip::drawClip (
-	QPainter *pPainter, const QRect& clipRect, unsigned long iClipOffset )
+void qtractorClip::drawClip ( QPainter *pPainter, const QRect& clipRect,
+	unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer )
 {
 	// Draw the framed rectangle and background...
 	pPainter->drawRect(clipRect);
@@ -349,7 +463,7 @@ void qtractorClip::drawClip (
 		Qt::AlignLeft | Qt::AlignBottom | Qt::TextSingleLine, clipTitle());
 
 	// Draw clip contents (virtual)
-	draw(pPainter, clipRect, iClipOffset);
+	draw(pPainter, clipRect, iClipOffset, drawBuffer);
 
 	// Avoid drawing fade in/out handles
 	// on still empty clips (eg. while recording)
@@ -488,8 +602,8 @@ void qtractorClip::drawClip (
 
 
 // Recording clip drawing method.
-void qtractorClip::drawClipRecord (
-	QPainter *pPainter, const QRect& clipRect, unsigned long iClipOffset )
+void qtractorClip::drawClipRecord ( QPainter *pPainter, const QRect& clipRect,
+	unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer )
 {
 	// Draw the framed rectangle and background...
 	pPainter->drawRect(clipRect);
@@ -498,7 +612,7 @@ void qtractorClip::drawClipRecord (
 	update();
 
 	// Draw clip contents (virtual)...
-	draw(pPainter, clipRect, iClipOffset);
+	draw(pPainter, clipRect, iClipOffset, drawBuffer);
 
 	// Draw red shade overlay...
 	pPainter->fillRect(clipRect, QColor(255, 0, 0, 120));
@@ -783,6 +897,9 @@ qtractorClip::FadeType qtractorClip::fadeInTypeFromText ( const QString& sText )
 	else 
 	if (sText == "InOutCubic")
 		fadeType = InOutCubic;
+	else 
+	if (sText == "EqualPower")
+		fadeType = EqualPower;
 
 	return fadeType;
 }
@@ -808,6 +925,9 @@ qtractorClip::FadeType qtractorClip::fadeOutTypeFromText ( const QString& sText
 	else 
 	if (sText == "InOutCubic")
 		fadeType = InOutCubic;
+	else 
+	if (sText == "EqualPower")
+		fadeType = EqualPower;
 
 	return fadeType;
 }
@@ -838,6 +958,9 @@ QString qtractorClip::textFromFadeType ( FadeType fadeType )
 	case InOutCubic:
 		sText = "InOutCubic";
 		break;
+	case EqualPower:
+		sText = "EqualPower";
+		break;
 	}
 
 	return sText;
@@ -1136,6 +1259,21 @@ struct FadeInOutCubic
 };
 
 
+// Equal-power (quarter sine/cosine) fade: constant power cross-fades.
+//
+struct FadeEqualPower
+{
+	float operator() (float t, float a, float b) const
+	{
+		t *= float(M_PI_2);
+		if (a < 0.0f)
+			return a * (1.0f - ::cosf(t)) + b;
+		else
+			return a * ::sinf(t) + b;
+	}
+};
+
+
 // Fade model class.
 //
 struct FadeMode
@@ -1162,6 +1300,25 @@ struct FadeOutMode : public FadeMode
 };
 
 
+// Fade curve table template class.
+//
+template<typename M, typename F>
+struct FadeTable
+{
+	FadeTable()
+	{
+		const M mode;
+		const F func;
+		for (unsigned int i = 0; i <= QTRACTOR_FADE_TABLE_SIZE; ++i) {
+			values[i] = func(float(i) / float(QTRACTOR_FADE_TABLE_SIZE),
+				mode.a, mode.b);
+		}
+	}
+
+	float values[QTRACTOR_FADE_TABLE_SIZE + 1];
+};
+
+
 // Fade functor template class.
 //
 template<typename M, typename F>
@@ -1169,11 +1326,19 @@ class FadeCurve : public qtractorClip::FadeFunctor
 {
 public:
 
-	FadeCurve() : m_mode(M()), m_func(F()) {}
+	FadeCurve() : m_mode(M()), m_func(F())
+		{ m_pTable = table(); }
 
 	float operator() (float t) const
 		{ return m_func(t, m_mode.a, m_mode.b); }
 
+	// Shared curve table, built once per mode/type.
+	static const float *table()
+	{
+		static const FadeTable<M, F> s_table;
+		return s_table.values;
+	}
+
 private:
 
 	M m_mode;
@@ -1204,6 +1369,8 @@ qtractorClip::FadeFunctor *qtractorClip::createFadeFunctor (
 			return new FadeCurve<FadeInMode, FadeOutCubic> ();
 		case InOutCubic:
 			return new FadeCurve<FadeInMode, FadeInOutCubic> ();
+		case EqualPower:
+			return new FadeCurve<FadeInMode, FadeEqualPower> ();
 		default:
 			break;
 		}
@@ -1225,6 +1392,8 @@ qtractorClip::FadeFunctor *qtractorClip::createFadeFunctor (
 			return new FadeCurve<FadeOutMode, FadeOutCubic> ();
 		case InOutCubic:
 			return new FadeCurve<FadeOutMode, FadeInOutCubic> ();
+		case EqualPower:
+			return new FadeCurve<FadeOutMode, FadeEqualPower> ();
 		default:
 			break;
 		}
@@ -24,6 +24,9 @@
 
 #include "qtractorTrack.h"
 
+#include <QPolygon>
+#include <QVector>
+
 
 // Forward declarations.
 class qtractorClipCommand;
@@ -31,6 +34,18 @@ class qtractorClipCommand;
 class QWidget;
 
 
+//-------------------------------------------------------------------------
+// qtractorClipDrawBuffer -- Clip paint scratch buffers (one per view).
+
+class qtractorClipDrawBuffer
+{
+public:
+
+	QPolygon poly;               // Audio peak vertexes.
+	QVector<unsigned char> grid; // MIDI density hit-counts.
+};
+
+
 //-------------------------------------------------------------------------
 // qtractorClip -- Track clip capsule.
 
@@ -124,7 +139,8 @@ public:
 		InOutQuad,
 		InCubic,
 		OutCubic,
-		InOutCubic
+		InOutCubic,
+		EqualPower
 	};
 
 	// Clip fade-in type accessors
@@ -148,14 +164,19 @@ public:
 	// Compute clip gain, given current fade-in/out slopes.
 	float fadeInOutGain(unsigned long iOffset) const;
 
+	// Compute per-frame clip gains (envelope), given current fade-in/out
+	// slopes; returns false if there's no fade over the whole range.
+	bool fadeInOutGains(float *pfGains,
+		unsigned long iOffset, unsigned int nframes) const;
+
 	// Clip time reference settler method.
 	void updateClipTime();
 
 	// Clip paint methods.
-	void drawClip(QPainter *pPainter,
-		const QRect& clipRect, unsigned long iClipOffset);
-	void drawClipRecord(QPainter *pPainter,
-		const QRect& clipRect, unsigned long iClipOffset);
+	void drawClip(QPainter *pPainter, const QRect& clipRect,
+		unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer);
+	void drawClipRecord(QPainter *pPainter, const QRect& clipRect,
+		unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer);
 
 	// Clip (re)open method.
 	virtual void open() = 0;
@@ -181,8 +202,8 @@ public:
 		unsigned long iFrameStart, unsigned long iFrameEnd) = 0;
 
 	// Clip paint method.
-	virtual void draw(QPainter *pPainter,
-		const QRect& clipRect, unsigned long iClipOffset) = 0;
+	virtual void draw(QPainter *pPainter, const QRect& clipRect,
+		unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer) = 0;
 
 	// Clip update method.
 	virtual void update() = 0;
@@ -202,6 +223,12 @@ public:
 	bool isDirty() const
 		{ return m_bDirty; }
 
+	// Contents change serial (eg. for cached views).
+	void updateSerial()
+		{ ++m_iSerial; }
+	unsigned int serial() const
+		{ return m_iSerial; }
+
 	// Document element methods.
 	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
 	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement);
@@ -342,8 +369,17 @@ public:
 	{
 	public:
 
+		FadeFunctor() : m_pTable(nullptr) {}
 		virtual ~FadeFunctor() {}
 		virtual float operator() (float t) const = 0;
+
+		// Pre-computed (shared) curve table accessor.
+		const float *table() const
+			{ return m_pTable; }
+
+	protected:
+
+		const float *m_pTable;
 	};
 
 protected:
@@ -399,6 +435,9 @@ private:
 
 	// Local dirty flag.
 	bool m_bDirty;
+
+	// Contents change serial.
+	unsigned int m_iSerial;
 };
 
 
@@ -31,6 +31,7 @@
 #include "qtractorMidiEngine.h"
 #include "qtractorMidiClip.h"
 #include "qtractorFiles.h"
+#include "qtractorSessionJournal.h"
 
 #include "qtractorMidiEditCommand.h"
 #include "qtractorTimeScaleCommand.h"
@@ -594,6 +595,146 @@ bool qtractorClipCommand::isEmpty (void) const
 }
 
 
+// Approximate memory held by this command.
+unsigned long qtractorClipCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize()
+		+ sizeof(*this) - sizeof(qtractorCommand)
+		+ m_items.count() * (sizeof(Item *) + sizeof(Item));
+
+	// Clips owned (removed or not added) are ours too,
+	// and so are any MIDI time-stretch edit commands...
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		if (pItem->autoDelete)
+			iMemorySize += clipMemorySize(pItem->clip);
+		if (pItem->editCommand)
+			iMemorySize += pItem->editCommand->memorySize();
+	}
+
+	QListIterator<qtractorTrackCommand *> track_iter(m_trackCommands);
+	while (track_iter.hasNext())
+		iMemorySize += track_iter.next()->memorySize();
+
+	return iMemorySize;
+}
+
+
+// MIDI edit commands that may be safely prepared: none of which
+// clip gets closed and re-opened, nor shares its sequence with
+// another one, otherwise all bets are off.
+QList<qtractorMidiEditCommand *> qtractorClipCommand::prepareEditCommands (
+	bool bRedo ) const
+{
+	QList<qtractorMidiEditCommand *> list;
+
+	bool bPrepare = false;
+
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		qtractorMidiEditCommand *pEditCommand = iter.next()->editCommand;
+		if (pEditCommand == nullptr)
+			continue;
+		qtractorMidiClip *pMidiClip = pEditCommand->midiClip();
+		if (pMidiClip == nullptr || m_clips.contains(pMidiClip))
+			return QList<qtractorMidiEditCommand *> ();
+		QListIterator<qtractorMidiEditCommand *> list_iter(list);
+		while (list_iter.hasNext()) {
+			if (pMidiClip->isLinkedClip(list_iter.next()->midiClip()))
+				return QList<qtractorMidiEditCommand *> ();
+		}
+		if (pEditCommand->isPrepare(bRedo))
+			bPrepare = true;
+		list.append(pEditCommand);
+	}
+
+	if (!bPrepare)
+		list.clear();
+
+	return list;
+}
+
+
+// Heavy MIDI edit preparation (eg. multi-clip stretch).
+bool qtractorClipCommand::isPrepare ( bool bRedo ) const
+{
+	return !prepareEditCommands(bRedo).isEmpty();
+}
+
+
+bool qtractorClipCommand::prepare ( bool bRedo )
+{
+	const QList<qtractorMidiEditCommand *>& list = prepareEditCommands(bRedo);
+
+	const int iCount = list.count();
+	for (int i = 0; i < iCount; ++i) {
+		qtractorMidiEditCommand *pEditCommand = list.at(i);
+		if (isCancel())
+			return false;
+		if (pEditCommand->isPrepare(bRedo) && !pEditCommand->prepare(bRedo))
+			return false;
+		setProgress((100 * (i + 1)) / iCount);
+	}
+
+	return true;
+}
+
+
+void qtractorClipCommand::unprepare (void)
+{
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		qtractorMidiEditCommand *pEditCommand = iter.next()->editCommand;
+		if (pEditCommand)
+			pEditCommand->unprepare();
+	}
+}
+
+
+// Session journal delta: clips (geometry and contents), unless
+// tracks are also added or removed (structural change).
+bool qtractorClipCommand::journal ( qtractorSessionJournal *pJournal ) const
+{
+	if (!m_trackCommands.isEmpty())
+		return false;
+
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext())
+		pJournal->touch(iter.next()->clip);
+
+	return true;
+}
+
+
+// Approximate memory held by a clip and its contents.
+unsigned long qtractorClipCommand::clipMemorySize ( qtractorClip *pClip )
+{
+	if (pClip == nullptr)
+		return 0;
+
+	qtractorTrack *pTrack = pClip->track();
+	if (pTrack == nullptr || pTrack->trackType() != qtractorTrack::Midi)
+		return sizeof(qtractorAudioClip);
+
+	unsigned long iMemorySize = sizeof(qtractorMidiClip);
+
+	qtractorMidiClip *pMidiClip = static_cast<qtractorMidiClip *> (pClip);
+	qtractorMidiSequence *pSeq = pMidiClip->sequence();
+	if (pSeq) {
+		iMemorySize += sizeof(qtractorMidiSequence);
+		for (qtractorMidiEvent *pEvent = pSeq->events().first();
+				pEvent; pEvent = pEvent->next()) {
+			iMemorySize += sizeof(qtractorMidiEvent);
+			if (pEvent->type() == qtractorMidiEvent::SYSEX)
+				iMemorySize += pEvent->sysex_len();
+		}
+	}
+
+	return iMemorySize;
+}
+
+
 // Common executive method.
 bool qtractorClipCommand::execute ( bool bRedo )
 {
@@ -962,6 +1103,25 @@ void qtractorClipRangeCommand::addTimeScaleNodeCommand (
 
 
 // Executive override.
+// Heavy MIDI edit preparation (not across tempo-map changes).
+bool qtractorClipRangeCommand::isPrepare ( bool bRedo ) const
+{
+	return m_timeScaleNodeCommands.isEmpty()
+		&& qtractorClipCommand::isPrepare(bRedo);
+}
+
+
+// Session journal delta: clips and automation curves.
+bool qtractorClipRangeCommand::journal ( qtractorSessionJournal *pJournal ) const
+{
+	QListIterator<qtractorCurveEditCommand *> iter(m_curveEditCommands);
+	while (iter.hasNext())
+		pJournal->touch(iter.next()->curve());
+
+	return qtractorClipCommand::journal(pJournal);
+}
+
+
 bool qtractorClipRangeCommand::execute ( bool bRedo )
 {
 	qtractorSession *pSession = qtractorSession::getInstance();
@@ -1108,6 +1268,56 @@ bool qtractorClipToolCommand::isEmpty (void) const
 }
 
 
+// Heavy MIDI edit preparation (eg. multi-clip quantize),
+// clips are never linked to each other here, see above.
+bool qtractorClipToolCommand::isPrepare ( bool bRedo ) const
+{
+	QListIterator<qtractorMidiEditCommand *> iter(m_midiEditCommands);
+	while (iter.hasNext()) {
+		if (iter.next()->isPrepare(bRedo))
+			return true;
+	}
+
+	return false;
+}
+
+
+bool qtractorClipToolCommand::prepare ( bool bRedo )
+{
+	const int iCount = m_midiEditCommands.count();
+	for (int i = 0; i < iCount; ++i) {
+		qtractorMidiEditCommand *pMidiEditCommand = m_midiEditCommands.at(i);
+		if (isCancel())
+			return false;
+		if (pMidiEditCommand->isPrepare(bRedo)
+			&& !pMidiEditCommand->prepare(bRedo))
+			return false;
+		setProgress((100 * (i + 1)) / iCount);
+	}
+
+	return true;
+}
+
+
+void qtractorClipToolCommand::unprepare (void)
+{
+	QListIterator<qtractorMidiEditCommand *> iter(m_midiEditCommands);
+	while (iter.hasNext())
+		iter.next()->unprepare();
+}
+
+
+// Session journal delta: all MIDI clips contents.
+bool qtractorClipToolCommand::journal ( qtractorSessionJournal *pJournal ) const
+{
+	QListIterator<qtractorMidiEditCommand *> iter(m_midiEditCommands);
+	while (iter.hasNext())
+		pJournal->touch(iter.next()->midiClip());
+
+	return true;
+}
+
+
 // Virtual command methods.
 bool qtractorClipToolCommand::redo (void)
 {
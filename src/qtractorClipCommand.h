@@ -100,11 +100,28 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory held by this command (bytes).
+	unsigned long memorySize() const;
+
+	// Approximate memory held by a clip and its contents (bytes).
+	static unsigned long clipMemorySize(qtractorClip *pClip);
+
+	// Heavy MIDI edit preparation (off the GUI thread).
+	bool isPrepare(bool bRedo) const;
+	bool prepare(bool bRedo);
+	void unprepare();
+
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 protected:
 
 	// Common executive method.
 	virtual bool execute(bool bRedo);
 
+	// MIDI edit commands that may be safely prepared.
+	QList<qtractorMidiEditCommand *> prepareEditCommands(bool bRedo) const;
+
 private:
 
 	// Primitive command types.
@@ -224,6 +241,12 @@ public:
 	void addTimeScaleNodeCommand(
 		qtractorTimeScaleNodeCommand *pTimeScaleNodeCommand);
 
+	// Heavy MIDI edit preparation (not across tempo-map changes).
+	bool isPrepare(bool bRedo) const;
+
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 protected:
 
 	// Executive override.
@@ -265,6 +288,14 @@ public:
 	bool redo();
 	bool undo();
 
+	// Heavy MIDI edit preparation (off the GUI thread).
+	bool isPrepare(bool bRedo) const;
+	bool prepare(bool bRedo);
+	void unprepare();
+
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 protected:
 
 	// Filename and length swap transaction...
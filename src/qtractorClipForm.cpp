@@ -73,6 +73,7 @@ void qtractorClipForm::initFadeTypes (void)
 		QT_TR_NOOP("Cubic 1"),		// InCubic
 		QT_TR_NOOP("Cubic 2"),		// OutCubic
 		QT_TR_NOOP("Cubic 3"),		// InOutCubic
+		QT_TR_NOOP("Equal Power"),	// EqualPower
 
 		nullptr
 	};
@@ -83,8 +84,15 @@ void qtractorClipForm::initFadeTypes (void)
 		for (int i = 0; s_aFadeTypeNames[i]; ++i) {
 			FadeTypeInfo& info = g_fadeTypes[i];
 			info.name = tr(s_aFadeTypeNames[i]);
-			info.iconFadeIn  = pmFadeIn.copy(i << 4, 0, 16, 16);
-			info.iconFadeOut = pmFadeOut.copy(i << 4, 0, 16, 16);
+			// Equal-power shapes are alike the quadratic ones...
+			int iFadeIn  = i;
+			int iFadeOut = i;
+			if (i == int(qtractorClip::EqualPower)) {
+				iFadeIn  = int(qtractorClip::OutQuad);
+				iFadeOut = int(qtractorClip::InQuad);
+			}
+			info.iconFadeIn  = pmFadeIn.copy(iFadeIn << 4, 0, 16, 16);
+			info.iconFadeOut = pmFadeOut.copy(iFadeOut << 4, 0, 16, 16);
 		}
 	}
 }
@@ -19,11 +19,46 @@
 
 *****************************************************************************/
 
+#include "qtractorAbout.h"
 #include "qtractorCommand.h"
 
+#include "qtractorSessionJournal.h"
+
 #include <QRegularExpression>
 
+#include <QApplication>
+#include <QProgressDialog>
 #include <QAction>
+#include <QThread>
+
+
+//----------------------------------------------------------------------
+// class qtractorCommandThread -- Command preparation thread.
+//
+
+class qtractorCommandThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorCommandThread(qtractorCommand *pCommand, bool bRedo)
+		: QThread(), m_pCommand(pCommand), m_bRedo(bRedo), m_bResult(false) {}
+
+	// Preparation result.
+	bool result() const { return m_bResult; }
+
+protected:
+
+	// The main thread executive.
+	void run() { m_bResult = m_pCommand->prepare(m_bRedo); }
+
+private:
+
+	// Instance variables.
+	qtractorCommand *m_pCommand;
+	bool m_bRedo;
+	volatile bool m_bResult;
+};
 
 
 //----------------------------------------------------------------------
@@ -35,6 +70,13 @@ qtractorCommandList::qtractorCommandList (void)
 {
 	m_pLastCommand = nullptr;
 
+	m_bPreparing = false;
+
+	m_pJournal = nullptr;
+
+	m_iMaxMemory = g_iDefaultMaxMemory;
+	m_iMemoryUsage = 0;
+
 	m_commands.setAutoDelete(true);
 }
 
@@ -48,9 +90,14 @@ qtractorCommandList::~qtractorCommandList (void)
 // Command stack cleaner.
 void qtractorCommandList::clear (void)
 {
+	qDeleteAll(m_pending);
+	m_pending.clear();
+
 	m_commands.clear();
 
 	m_pLastCommand = nullptr;
+
+	m_iMemoryUsage = 0;
 }
 
 
@@ -75,7 +122,7 @@ void qtractorCommandList::removeLastCommand (void)
 {
 	if (m_pLastCommand) {
 		qtractorCommand *pPrevCommand = m_pLastCommand->prev();
-		m_commands.remove(m_pLastCommand);
+		removeCommand(m_pLastCommand);
 		m_pLastCommand = pPrevCommand;
 	}
 }
@@ -90,6 +137,7 @@ void qtractorCommandList::backout ( qtractorCommand *pCommand )
 	while (m_pLastCommand && m_pLastCommand != pCommand) {
 		flags |= m_pLastCommand->flags();
 		m_pLastCommand->undo();
+		journalCommand(m_pLastCommand);
 		removeLastCommand();
 		++iUpdate;
 	}
@@ -106,17 +154,24 @@ bool qtractorCommandList::push ( qtractorCommand *pCommand )
 	qtractorCommand *pNextCommand = nextCommand();
 	while (pNextCommand) {
 		qtractorCommand *pLateCommand = pNextCommand->next();
-		m_commands.remove(pNextCommand);
+		removeCommand(pNextCommand);
 		pNextCommand = pLateCommand;
 	}
 
 	if (pCommand == nullptr)
 		return false;
 
+	// Previous one may have grown since pushed...
+	if (m_pLastCommand)
+		updateMemorySize(m_pLastCommand);
+
 	// It must be this last one...
 	m_commands.append(pCommand);
 	m_pLastCommand = m_commands.last();
 
+	updateMemorySize(m_pLastCommand);
+	evictCommands();
+
 	return (m_pLastCommand != nullptr);
 }
 
@@ -124,14 +179,35 @@ bool qtractorCommandList::exec ( qtractorCommand *pCommand )
 {
 	bool bResult = false;
 
+	// Issued from the event loop while another one is being
+	// prepared (eg. progress dialog): queue it for later...
+	if (pCommand && m_bPreparing) {
+		m_pending.append(pCommand);
+		return true;
+	}
+
+	// Prepare command, maybe off the GUI thread...
+	if (pCommand && !prepare(pCommand, true)) {
+		delete pCommand;
+		execPending();
+		return false;
+	}
+
 	// Append command...
 	if (push(pCommand)) {
 		// Execute operation...
 		bResult = m_pLastCommand->redo();
+		// Account its (now settled) memory size...
+		updateMemorySize(m_pLastCommand);
+		evictCommands();
+		// Journal what it touched...
+		journalCommand(m_pLastCommand);
 		// Notify commanders...
 		emit updateNotifySignal(m_pLastCommand->flags());
 	}
 
+	execPending();
+
 	return bResult;
 }
 
@@ -139,14 +215,23 @@ bool qtractorCommandList::undo (void)
 {
 	bool bResult = false;
 
-	if (m_pLastCommand) {
+	if (m_pLastCommand && !m_bPreparing) {
+		// Prepare command, maybe off the GUI thread...
+		if (!prepare(m_pLastCommand, false)) {
+			execPending();
+			return false;
+		}
 		// Undo operation...
 		bResult = m_pLastCommand->undo();
+		// Journal what it touched...
+		journalCommand(m_pLastCommand);
 		// Backward one command...
 		const unsigned int flags = m_pLastCommand->flags();
 		m_pLastCommand = m_pLastCommand->prev();
 		// Notify commanders...
 		emit updateNotifySignal(flags);
+		// Catch up with any queued meanwhile...
+		execPending();
 	}
 
 	return bResult;
@@ -156,19 +241,196 @@ bool qtractorCommandList::redo (void)
 {
 	bool bResult = false;
 
+	// No history walking while preparing...
+	if (m_bPreparing)
+		return false;
+
+	// Prepare next command, maybe off the GUI thread...
+	qtractorCommand *pNextCommand = nextCommand();
+	if (pNextCommand && !prepare(pNextCommand, true)) {
+		execPending();
+		return false;
+	}
+
 	// Forward one command...
-	m_pLastCommand = nextCommand();
+	m_pLastCommand = pNextCommand;
 	if (m_pLastCommand) {
 		// Redo operation...
 		bResult = m_pLastCommand->redo();
+		// Journal what it touched...
+		journalCommand(m_pLastCommand);
 		// Notify commanders...
 		emit updateNotifySignal(m_pLastCommand->flags());
 	}
 
+	// Catch up with any queued meanwhile...
+	execPending();
+
+	return bResult;
+}
+
+
+// Whether a command is being prepared, off the GUI thread.
+bool qtractorCommandList::isPreparing (void) const
+{
+	return m_bPreparing;
+}
+
+
+// Command preparation (off the GUI thread, with progress).
+bool qtractorCommandList::prepare ( qtractorCommand *pCommand, bool bRedo )
+{
+	if (!pCommand->isPrepare(bRedo))
+		return true;
+
+	m_bPreparing = true;
+
+	pCommand->setCancel(false);
+
+	QProgressDialog progress(pCommand->name(),
+		QObject::tr("Cancel"), 0, 100, QApplication::activeWindow());
+	progress.setWindowModality(Qt::ApplicationModal);
+	progress.setMinimumDuration(200);
+
+	qtractorCommandThread thread(pCommand, bRedo);
+	thread.start();
+
+	while (!thread.wait(20)) {
+		if (progress.wasCanceled())
+			pCommand->setCancel(true);
+		progress.setValue(pCommand->progress());
+	}
+
+	const bool bResult = (thread.result() && !pCommand->isCancel());
+	if (!bResult)
+		pCommand->unprepare();
+
+	progress.reset();
+
+	m_bPreparing = false;
+
 	return bResult;
 }
 
 
+// Session journal (per command deltas) accessors.
+void qtractorCommandList::setJournal ( qtractorSessionJournal *pJournal )
+{
+	m_pJournal = pJournal;
+}
+
+qtractorSessionJournal *qtractorCommandList::journal (void) const
+{
+	return m_pJournal;
+}
+
+
+// Mark whatever a command touched into the journal,
+// or else everything, when that is not known.
+void qtractorCommandList::journalCommand ( qtractorCommand *pCommand )
+{
+	if (m_pJournal && !pCommand->journal(m_pJournal))
+		m_pJournal->touchAll();
+}
+
+
+// Execute any commands queued while preparing, in order.
+void qtractorCommandList::execPending (void)
+{
+	while (!m_pending.isEmpty() && !m_bPreparing)
+		exec(m_pending.takeFirst());
+}
+
+
+// History memory budget (bytes; zero=unlimited).
+void qtractorCommandList::setMaxMemory ( unsigned long iMaxMemory )
+{
+	m_iMaxMemory = iMaxMemory;
+
+	evictCommands();
+}
+
+unsigned long qtractorCommandList::maxMemory (void) const
+{
+	return m_iMaxMemory;
+}
+
+
+// Current history memory usage (bytes, approx.)
+unsigned long qtractorCommandList::memoryUsage (void) const
+{
+	return m_iMemoryUsage;
+}
+
+
+// Command memory (re)accounting.
+void qtractorCommandList::updateMemorySize ( qtractorCommand *pCommand )
+{
+	if (m_iMemoryUsage > pCommand->m_iMemorySize)
+		m_iMemoryUsage -= pCommand->m_iMemorySize;
+	else
+		m_iMemoryUsage = 0;
+
+	pCommand->compact();
+	pCommand->m_iMemorySize = pCommand->memorySize();
+
+	m_iMemoryUsage += pCommand->m_iMemorySize;
+}
+
+
+// Command removal, with memory accounting.
+void qtractorCommandList::removeCommand ( qtractorCommand *pCommand )
+{
+	if (m_iMemoryUsage > pCommand->m_iMemorySize)
+		m_iMemoryUsage -= pCommand->m_iMemorySize;
+	else
+		m_iMemoryUsage = 0;
+
+	m_commands.remove(pCommand);
+}
+
+
+// Evict oldest commands, while over memory budget;
+// the current (last) command is always kept though.
+void qtractorCommandList::evictCommands (void)
+{
+	if (m_iMaxMemory == 0 || m_bPreparing)
+		return;
+
+	int iEvicted = 0;
+
+	qtractorCommand *pCommand = m_commands.first();
+	while (pCommand && pCommand != m_pLastCommand
+		&& m_iMemoryUsage > m_iMaxMemory) {
+		qtractorCommand *pNextCommand = pCommand->next();
+		removeCommand(pCommand);
+		pCommand = pNextCommand;
+		++iEvicted;
+	}
+
+#ifdef CONFIG_DEBUG
+	if (iEvicted > 0) {
+		qDebug("qtractorCommandList[%p]::evictCommands() evicted=%d usage=%lu max=%lu",
+			this, iEvicted, m_iMemoryUsage, m_iMaxMemory);
+	}
+#endif
+}
+
+
+// Default history memory budget (global option).
+unsigned long qtractorCommandList::g_iDefaultMaxMemory = 0;
+
+void qtractorCommandList::setDefaultMaxMemory ( unsigned long iMaxMemory )
+{
+	g_iDefaultMaxMemory = iMaxMemory;
+}
+
+unsigned long qtractorCommandList::defaultMaxMemory (void)
+{
+	return g_iDefaultMaxMemory;
+}
+
+
 // Command action update helper.
 void qtractorCommandList::updateAction (
 	QAction *pAction, qtractorCommand *pCommand ) const
@@ -26,10 +26,13 @@
 
 #include <QObject>
 #include <QString>
+#include <QList>
 
 // Forward declarations.
 class QAction;
 
+class qtractorSessionJournal;
+
 
 //----------------------------------------------------------------------
 // class qtractorCommand - declaration.
@@ -41,7 +44,8 @@ public:
 
 	// Constructor.
 	qtractorCommand(const QString& sName)
-		: m_sName(sName), m_flags(Refresh) {}
+		: m_sName(sName), m_flags(Refresh),
+			m_iProgress(0), m_bCancel(false), m_iMemorySize(0) {}
 
 	// Virtual destructor.
 	virtual ~qtractorCommand() {}
@@ -88,8 +92,37 @@ public:
 	virtual bool redo() = 0;
 	virtual bool undo() = 0;
 
+	// Heavy data preparation, run off the GUI thread
+	// right before redo/undo, whenever applicable...
+	virtual bool isPrepare(bool /*bRedo*/) const { return false; }
+	virtual bool prepare(bool /*bRedo*/) { return true; }
+	// Discard any prepared data (eg. on cancel).
+	virtual void unprepare() {}
+
+	// Approximate memory held by this command (bytes);
+	// subclasses holding edit data should add their own.
+	virtual unsigned long memorySize() const
+		{ return sizeof(*this) + m_sName.size() * sizeof(QChar); }
+
+	// Release any spare capacity, once pushed into history.
+	virtual void compact() {}
+
+	// Session journal delta: marks whatever this command touches
+	// (eg. MIDI clips, automation curves); false when unknown.
+	virtual bool journal(qtractorSessionJournal */*pJournal*/) const
+		{ return false; }
+
+	// Preparation progress (percent) and cancellation.
+	int progress() const { return m_iProgress; }
+
+	void setCancel(bool bCancel) { m_bCancel = bCancel; }
+	bool isCancel() const { return m_bCancel; }
+
 protected:
 
+	// Preparation progress (percent) setter.
+	void setProgress(int iProgress) { m_iProgress = iProgress; }
+
 	// Discrete flag accessors.
 	void setFlags(unsigned int flags, bool bOn = true)
 		{ if (bOn) m_flags |= flags; else m_flags &= ~flags; }
@@ -102,6 +135,15 @@ private:
 	// Instance variables.
 	QString      m_sName;
 	unsigned int m_flags;
+
+	// Preparation progress/cancel (thread shared).
+	volatile int  m_iProgress;
+	volatile bool m_bCancel;
+
+	// Accounted memory size (as of last push).
+	unsigned long m_iMemorySize;
+
+	friend class qtractorCommandList;
 };
 
 
@@ -144,6 +186,44 @@ public:
 	// Command action update helper.
 	void updateAction(QAction *pAction, qtractorCommand *pCommand) const;
 
+	// Whether a command is being prepared, off the GUI thread.
+	bool isPreparing() const;
+
+	// Session journal (per command deltas) accessors.
+	void setJournal(qtractorSessionJournal *pJournal);
+	qtractorSessionJournal *journal() const;
+
+	// History memory budget (bytes; zero=unlimited).
+	void setMaxMemory(unsigned long iMaxMemory);
+	unsigned long maxMemory() const;
+
+	// Current history memory usage (bytes, approx.)
+	unsigned long memoryUsage() const;
+
+	// Default history memory budget (global option).
+	static void setDefaultMaxMemory(unsigned long iMaxMemory);
+	static unsigned long defaultMaxMemory();
+
+protected:
+
+	// Command preparation (off the GUI thread, with progress).
+	bool prepare(qtractorCommand *pCommand, bool bRedo);
+
+	// Execute any commands queued while preparing.
+	void execPending();
+
+	// Mark whatever a command touched into the journal.
+	void journalCommand(qtractorCommand *pCommand);
+
+	// Command memory (re)accounting.
+	void updateMemorySize(qtractorCommand *pCommand);
+
+	// Command removal, with memory accounting.
+	void removeCommand(qtractorCommand *pCommand);
+
+	// Evict oldest commands, while over memory budget.
+	void evictCommands();
+
 signals:
 
 	// Command update notification.
@@ -155,6 +235,20 @@ private:
 	qtractorList<qtractorCommand> m_commands;
 
 	qtractorCommand *m_pLastCommand;
+
+	bool m_bPreparing;
+
+	// Commands issued while preparing (queued).
+	QList<qtractorCommand *> m_pending;
+
+	// Session journal (per command deltas).
+	qtractorSessionJournal *m_pJournal;
+
+	// History memory accounting.
+	unsigned long m_iMaxMemory;
+	unsigned long m_iMemoryUsage;
+
+	static unsigned long g_iDefaultMaxMemory;
 };
 
 
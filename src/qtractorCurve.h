@@ -393,6 +393,19 @@ public:
 	// Curve edit list command executive.
 	bool execute(bool bRedo = true);
 
+	// Approximate memory held (bytes).
+	unsigned long memorySize() const
+	{
+		unsigned long iMemorySize = m_items.count()
+			* (sizeof(Item *) + sizeof(Item));
+		QListIterator<Item *> iter(m_items);
+		while (iter.hasNext()) {
+			if (iter.next()->autoDelete)
+				iMemorySize += sizeof(qtractorCurve::Node);
+		}
+		return iMemorySize;
+	}
+
 protected:
 
 	// Primitive command types.
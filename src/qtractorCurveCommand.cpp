@@ -23,6 +23,7 @@
 #include "qtractorCurveCommand.h"
 
 #include "qtractorSession.h"
+#include "qtractorSessionJournal.h"
 
 #include "qtractorMainForm.h"
 #include "qtractorTracks.h"
@@ -88,6 +89,15 @@ qtractorCurveCommand::qtractorCurveCommand (
 }
 
 
+// Session journal delta: this very curve.
+bool qtractorCurveCommand::journal ( qtractorSessionJournal *pJournal ) const
+{
+	pJournal->touch(m_pCurve);
+
+	return true;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorCurveListCommand - declaration.
 //
@@ -100,6 +110,20 @@ qtractorCurveListCommand::qtractorCurveListCommand (
 }
 
 
+// Session journal delta: all curves in list.
+bool qtractorCurveListCommand::journal ( qtractorSessionJournal *pJournal ) const
+{
+	if (m_pCurveList == nullptr)
+		return false;
+
+	for (qtractorCurve *pCurve = m_pCurveList->first();
+			pCurve; pCurve = pCurve->next())
+		pJournal->touch(pCurve);
+
+	return true;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorCurveSelectCommand - declaration.
 //
@@ -384,6 +408,15 @@ bool qtractorCurveEditCommand::isEmpty (void) const
 }
 
 
+// Undo history memory accounting.
+unsigned long qtractorCurveEditCommand::memorySize (void) const
+{
+	return qtractorCurveCommand::memorySize()
+		+ sizeof(*this) - sizeof(qtractorCurveCommand)
+		+ m_edits.memorySize();
+}
+
+
 // Common executive method.
 bool qtractorCurveEditCommand::execute ( bool bRedo )
 {
@@ -562,6 +595,18 @@ bool qtractorCurveCaptureListCommand::isEmpty (void) const
 }
 
 
+// Session journal delta: all curves in all lists.
+bool qtractorCurveCaptureListCommand::journal (
+	qtractorSessionJournal *pJournal ) const
+{
+	QListIterator<qtractorCurveEditListCommand *> iter(m_commands);
+	while (iter.hasNext())
+		iter.next()->journal(pJournal);
+
+	return true;
+}
+
+
 // Virtual command methods.
 bool qtractorCurveCaptureListCommand::redo (void)
 {
@@ -62,6 +62,9 @@ public:
 	// Accessor.
 	qtractorCurve *curve() const { return m_pCurve; }
 
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 protected:
 
 	// Instance variables.
@@ -80,6 +83,9 @@ public:
 	// Constructor.
 	qtractorCurveListCommand(const QString& sName, qtractorCurveList *pCurveList);
 
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 protected:
 
 	// Instance variables.
@@ -306,6 +312,9 @@ public:
 	// Composite predicate.
 	bool isEmpty() const;
 
+	// Undo history memory accounting.
+	unsigned long memorySize() const;
+
 protected:
 
 	// Virtual executive method.
@@ -413,6 +422,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 private:
 
 	// Instance variables.
@@ -0,0 +1,197 @@
+// qtractorDspProfile.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorDspProfile.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+
+
+// Global enablement.
+volatile bool qtractorDspProfile::g_bEnabled = false;
+
+// Global reset request (epoch).
+volatile unsigned int qtractorDspProfile::g_iResetEpoch = 0;
+
+
+// Timestamp counter rate calibration reference.
+static QElapsedTimer g_dspProfileTimer;
+static unsigned long long g_iDspProfileStartTicks = 0;
+
+
+// Histogram bucket index (half-octaves).
+static inline int qtractorDspProfile_bucket ( unsigned long long iTicks )
+{
+	if (iTicks < 2)
+		return 0;
+
+	const int k = 63 - __builtin_clzll(iTicks);
+	const int i = (k << 1) + int((iTicks >> (k - 1)) & 1);
+
+	return (i < QTRACTOR_DSP_PROFILE_BUCKETS ? i : QTRACTOR_DSP_PROFILE_BUCKETS - 1);
+}
+
+
+// Histogram bucket upper bound (ticks).
+static inline double qtractorDspProfile_bound ( int i )
+{
+	const double d = double(1ULL << (i >> 1));
+	return (i & 1 ? 2.0 * d : 1.5 * d);
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorDspProfile -- DSP load profile (per process object).
+//
+
+// Constructor.
+qtractorDspProfile::qtractorDspProfile (void)
+	: m_iResetEpoch(g_iResetEpoch), m_iCount(0), m_iSumTicks(0), m_iMaxTicks(0)
+{
+	for (int i = 0; i < QTRACTOR_DSP_PROFILE_BUCKETS; ++i)
+		m_buckets[i] = 0;
+}
+
+
+// Accumulate one timing (real-time).
+void qtractorDspProfile::update ( unsigned long long iTicks )
+{
+	const unsigned int iResetEpoch = g_iResetEpoch;
+	if (m_iResetEpoch != iResetEpoch) {
+		m_iResetEpoch = iResetEpoch;
+		m_iCount = 0;
+		m_iSumTicks = 0;
+		m_iMaxTicks = 0;
+		for (int i = 0; i < QTRACTOR_DSP_PROFILE_BUCKETS; ++i)
+			m_buckets[i] = 0;
+	}
+
+	++m_buckets[qtractorDspProfile_bucket(iTicks)];
+
+	m_iSumTicks += iTicks;
+	if (m_iMaxTicks < iTicks)
+		m_iMaxTicks = iTicks;
+
+	++m_iCount;
+}
+
+
+// Readouts (non real-time; micro-seconds).
+float qtractorDspProfile::mean (void) const
+{
+	const unsigned long iCount = count();
+	if (iCount < 1)
+		return 0.0f;
+
+	return float(double(m_iSumTicks) / double(iCount) / ticksPerUsec());
+}
+
+
+float qtractorDspProfile::p99 (void) const
+{
+	const unsigned long iCount = count();
+	if (iCount < 1)
+		return 0.0f;
+
+	// Nearest upper bucket bound, never above maximum...
+	const unsigned long iRank = iCount - (iCount / 100);
+	unsigned long n = 0;
+	int i = 0;
+	for ( ; i < QTRACTOR_DSP_PROFILE_BUCKETS - 1; ++i) {
+		n += m_buckets[i];
+		if (n >= iRank)
+			break;
+	}
+
+	const double ticks
+		= qMin(qtractorDspProfile_bound(i), double(m_iMaxTicks));
+	return float(ticks / ticksPerUsec());
+}
+
+
+float qtractorDspProfile::max (void) const
+{
+	if (count() < 1)
+		return 0.0f;
+
+	return float(double(m_iMaxTicks) / ticksPerUsec());
+}
+
+
+// Pretty summary text (eg. for tool-tips).
+QString qtractorDspProfile::text (void) const
+{
+	if (!g_bEnabled || count() < 1)
+		return QString();
+
+	return QObject::tr("DSP: %1 / %2 / %3 us (mean/p99/max)")
+		.arg(QString::number(mean(), 'f', 1))
+		.arg(QString::number(p99(),  'f', 1))
+		.arg(QString::number(max(),  'f', 1));
+}
+
+
+// Global enablement (profiling is off by default).
+void qtractorDspProfile::setEnabled ( bool bEnabled )
+{
+	// Start afresh...
+	if (bEnabled && !g_bEnabled)
+		reset();
+
+	g_bEnabled = bEnabled;
+}
+
+
+// Timestamp counter rate calibration (once, at startup):
+// just take the reference, estimates get refined over time.
+void qtractorDspProfile::calibrate (void)
+{
+	g_dspProfileTimer.start();
+	g_iDspProfileStartTicks = ticks();
+}
+
+
+// Timestamp counter rate estimate (non real-time).
+double qtractorDspProfile::ticksPerUsec (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	static double s_dTicksPerUsec = 0.0;
+
+	// Not calibrated yet? start right now...
+	if (!g_dspProfileTimer.isValid())
+		calibrate();
+
+	// Refine as time goes by...
+	const qint64 iElapsed = g_dspProfileTimer.nsecsElapsed();
+	if (iElapsed > 0) {
+		s_dTicksPerUsec = 1000.0
+			* double(ticks() - g_iDspProfileStartTicks) / double(iElapsed);
+	}
+
+	return (s_dTicksPerUsec > 0.0 ? s_dTicksPerUsec : 1.0);
+#else
+	return 1000.0; // Nanoseconds.
+#endif
+}
+
+
+// end of qtractorDspProfile.cpp
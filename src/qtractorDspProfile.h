@@ -0,0 +1,144 @@
+// qtractorDspProfile.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorDspProfile_h
+#define __qtractorDspProfile_h
+
+#include <QString>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+
+// Number of (half-octave) histogram buckets.
+#define QTRACTOR_DSP_PROFILE_BUCKETS 64
+
+
+//----------------------------------------------------------------------
+// class qtractorDspProfile -- DSP load profile (per process object).
+//
+// Cycle timings are accumulated by the real-time thread only (single
+// writer, lock-free) into a logarithmic histogram, and then read out
+// (approximately) from the GUI thread: mean, 99th percentile and max.
+//
+
+class qtractorDspProfile
+{
+public:
+
+	// Constructor.
+	qtractorDspProfile();
+
+	// Timestamp counter (TSC where available).
+	static unsigned long long ticks()
+	{
+	#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+	#else
+		struct timespec ts;
+		::clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	#endif
+	}
+
+	// Accumulate one timing (real-time).
+	void update(unsigned long long iTicks);
+
+	// Request a reset of all profiles' timings (any thread).
+	static void reset()
+		{ ++g_iResetEpoch; }
+
+	// Readouts (non real-time; micro-seconds).
+	unsigned long count() const
+		{ return (m_iResetEpoch == g_iResetEpoch ? m_iCount : 0); }
+
+	float mean() const;
+	float p99() const;
+	float max() const;
+
+	// Pretty summary text (eg. for tool-tips).
+	QString text() const;
+
+	// Global enablement (profiling is off by default).
+	static void setEnabled(bool bEnabled);
+	static bool isEnabled()
+		{ return g_bEnabled; }
+
+	// Timestamp counter rate calibration (once, at startup).
+	static void calibrate();
+
+	// Timestamp counter rate estimate (non real-time).
+	static double ticksPerUsec();
+
+private:
+
+	// Instance variables.
+	volatile unsigned int  m_iResetEpoch;
+
+	volatile unsigned long m_iCount;
+	unsigned long long     m_iSumTicks;
+	unsigned long long     m_iMaxTicks;
+
+	volatile unsigned long m_buckets[QTRACTOR_DSP_PROFILE_BUCKETS];
+
+	// Global enablement.
+	static volatile bool g_bEnabled;
+
+	// Global reset request (epoch).
+	static volatile unsigned int g_iResetEpoch;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorDspProfileScope -- DSP load profile timing guard.
+//
+
+class qtractorDspProfileScope
+{
+public:
+
+	// Constructor.
+	qtractorDspProfileScope(qtractorDspProfile *pDspProfile)
+		: m_pDspProfile(qtractorDspProfile::isEnabled() ? pDspProfile : nullptr),
+			m_iStartTicks(m_pDspProfile ? qtractorDspProfile::ticks() : 0) {}
+
+	// Destructor.
+	~qtractorDspProfileScope()
+	{
+		if (m_pDspProfile)
+			m_pDspProfile->update(qtractorDspProfile::ticks() - m_iStartTicks);
+	}
+
+private:
+
+	// Instance variables.
+	qtractorDspProfile *m_pDspProfile;
+	unsigned long long  m_iStartTicks;
+};
+
+
+#endif  // __qtractorDspProfile_h
+
+
+// end of qtractorDspProfile.h
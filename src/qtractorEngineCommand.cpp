@@ -64,6 +64,7 @@ qtractorBusCommand::qtractorBusCommand ( const QString& sName,
 			if (pAudioBus) {
 				m_iChannels = pAudioBus->channels();
 				m_bAutoConnect = pAudioBus->isAutoConnect();
+				m_sSumBusName = pAudioBus->sumBusName();
 			}
 			break;
 		}
@@ -104,6 +105,7 @@ bool qtractorBusCommand::createBus (void)
 			pAudioBus = new qtractorAudioBus(pAudioEngine,
 				m_sBusName, m_busMode, m_bMonitor, m_iChannels);
 			pAudioBus->setAutoConnect(m_bAutoConnect);
+			pAudioBus->setSumBusName(m_sSumBusName);
 			pAudioEngine->addBus(pAudioBus);
 			pAudioEngine->resetPlayerBus();
 			pAudioEngine->resetMetroBus();
@@ -136,8 +138,10 @@ bool qtractorBusCommand::createBus (void)
 	m_pBus->open();
 
 	// Yet special for audio buses...
-	if (pAudioBus)
+	if (pAudioBus) {
 		pAudioBus->autoConnect();
+		pSession->audioEngine()->resetSumBuses();
+	}
 
 	// Update mixer (look for new strips...)
 	qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
@@ -191,6 +195,7 @@ bool qtractorBusCommand::updateBus (void)
 	qtractorMidiBus *pMidiBus = nullptr;
 	unsigned short iChannels = 0;
 	bool bAutoConnect = false;
+	QString sSumBusName;
 	QString sInstrumentName;
 	switch (m_pBus->busType()) {
 	case qtractorTrack::Audio:
@@ -198,6 +203,7 @@ bool qtractorBusCommand::updateBus (void)
 		if (pAudioBus) {
 			iChannels = pAudioBus->channels();
 			bAutoConnect = pAudioBus->isAutoConnect();
+			sSumBusName = pAudioBus->sumBusName();
 		}
 		break;
 	case qtractorTrack::Midi:
@@ -298,6 +304,17 @@ bool qtractorBusCommand::updateBus (void)
 	if (pAudioBus) {
 		pAudioBus->setChannels(m_iChannels);
 		pAudioBus->setAutoConnect(m_bAutoConnect);
+		pAudioBus->setSumBusName(m_sSumBusName);
+		// Keep internal (summing) buses targetting this one...
+		qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+		for (qtractorBus *pBus = pAudioEngine->buses().first();
+				pBus; pBus = pBus->next()) {
+			qtractorAudioBus *pSumBus
+				= static_cast<qtractorAudioBus *> (pBus);
+			if (pSumBus && pSumBus != pAudioBus
+				&& pSumBus->sumBusName() == sBusName)
+				pSumBus->setSumBusName(m_sBusName);
+		}
 	}
 	if (pMidiBus) {
 		pMidiBus->setInstrumentName(m_sInstrumentName);
@@ -307,8 +324,10 @@ bool qtractorBusCommand::updateBus (void)
 	m_pBus->open();
 
 	// Yet special for audio buses...
-	if (pAudioBus)
+	if (pAudioBus) {
 		pAudioBus->autoConnect();
+		pSession->audioEngine()->resetSumBuses();
+	}
 
 	// Restore previous connections...
 	if (m_busMode & qtractorBus::Input)
@@ -367,6 +386,7 @@ bool qtractorBusCommand::updateBus (void)
 	m_bMonitor  = bMonitor;
 	m_iChannels = iChannels;
 	m_bAutoConnect = bAutoConnect;
+	m_sSumBusName = sSumBusName;
 	m_sInstrumentName = sInstrumentName;
 
 	// Carry on...
@@ -474,6 +494,7 @@ bool qtractorBusCommand::deleteBus (void)
 		if (pAudioEngine) {
 			pAudioEngine->resetPlayerBus();
 			pAudioEngine->resetMetroBus();
+			pAudioEngine->resetSumBuses();
 		}
 		break;
 	}
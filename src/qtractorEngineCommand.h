@@ -79,6 +79,11 @@ public:
 	bool isAutoConnect() const
 		{ return m_bAutoConnect; }
 
+	void setSumBusName(const QString& sSumBusName)
+		{ m_sSumBusName = sSumBusName; }
+	const QString& sumBusName() const
+		{ return m_sSumBusName; }
+
 	// Special MIDI bus properties accessors.
 	void setInstrumentName(const QString& sInstrumentName)
 		{ m_sInstrumentName = sInstrumentName; }
@@ -105,6 +110,7 @@ private:
 	bool                     m_bMonitor;
 	unsigned short           m_iChannels;
 	bool                     m_bAutoConnect;
+	QString                  m_sSumBusName;
 	QString                  m_sInstrumentName;
 };
 
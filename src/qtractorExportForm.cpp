@@ -26,6 +26,7 @@
 #include "qtractorMidiEngine.h"
 
 #include "qtractorAudioFile.h"
+#include "qtractorAudioLoudness.h"
 
 #include "qtractorMainForm.h"
 #include "qtractorTracks.h"
@@ -39,6 +40,8 @@
 #include <QFileInfo>
 #include <QUrl>
 
+#include <cmath>
+
 
 //----------------------------------------------------------------------------
 // qtractorExportForm -- UI wrapper form.
@@ -739,6 +742,28 @@ void qtractorExportTrackForm::accept (void)
 				pMainForm->appendMessages(
 					tr("Audio file export: \"%1\" complete.")
 					.arg(sExportPath));
+				// Log and show the measured loudness and true-peak...
+				qtractorAudioLoudness *pLoudness
+					= pAudioEngine->exportLoudness();
+				if (pLoudness) {
+					const float fTruePeak = pLoudness->maxTruePeak();
+					const QString sIntegrated = QString::number(
+						pLoudness->integrated(), 'f', 1);
+					const QString sTruePeak = QString::number(
+						fTruePeak > 1E-6f
+							? 20.0f * ::log10f(fTruePeak)
+							: QTRACTOR_AUDIO_LOUDNESS_MIN, 'f', 1);
+					pMainForm->appendMessages(
+						tr("Audio file export: %1 LUFS integrated,"
+						" %2 dBTP true-peak.")
+						.arg(sIntegrated).arg(sTruePeak));
+					QMessageBox::information(this,
+						tr("Information"),
+						tr("Audio file export:\n\n\"%1\"\n\n"
+						"Integrated loudness:\t%2 LUFS\n"
+						"True-peak:\t\t%3 dBTP")
+						.arg(sExportPath).arg(sIntegrated).arg(sTruePeak));
+				}
 			} else {
 				// Log the failure...
 				pMainForm->appendMessagesError(
@@ -32,6 +32,8 @@
 
 #include "qtractorPluginListView.h"
 
+#include "qtractorRtAudit.h"
+
 
 #if defined(__SSE__)
 
@@ -635,6 +637,22 @@ void qtractorAudioInsertPlugin::process (
 }
 
 
+// Plugin current latency (in frames);
+// returns are always one period behind sends.
+unsigned long qtractorAudioInsertPlugin::latency (void) const
+{
+	if (m_pAudioBus == nullptr || !m_pAudioBus->isEnabled())
+		return 0;
+
+	qtractorAudioEngine *pAudioEngine
+		= static_cast<qtractorAudioEngine *> (m_pAudioBus->engine());
+	if (pAudioEngine == nullptr)
+		return 0;
+
+	return pAudioEngine->bufferSize();
+}
+
+
 // Pseudo-plugin configuration handlers.
 void qtractorAudioInsertPlugin::configure (
 	const QString& sKey, const QString& sValue )
@@ -1210,6 +1228,9 @@ qtractorAudioAuxSendPlugin::qtractorAudioAuxSendPlugin (
 		this, pAuxSendType->channels());
 #endif
 
+	// Plugin delay compensation line.
+	m_pSendDelay = new qtractorAudioDelay();
+
 	// Custom optimized processors.
 #if defined(__SSE__)
 	if (sse_enabled()) {
@@ -1240,6 +1261,8 @@ qtractorAudioAuxSendPlugin::~qtractorAudioAuxSendPlugin (void)
 {
 	// Cleanup plugin instance...
 	setChannels(0);
+
+	delete m_pSendDelay;
 }
 
 
@@ -1275,6 +1298,9 @@ void qtractorAudioAuxSendPlugin::setChannels ( unsigned short iChannels )
 	if (m_pAudioBus)
 		m_pAudioBus = nullptr;
 
+	// Reset delay line...
+	m_pSendDelay->setDelay(0, 0);
+
 	// Set new instance number...
 	setInstances(iInstances);
 	if (iInstances < 1) {
@@ -1351,6 +1377,24 @@ const QString& qtractorAudioAuxSendPlugin::audioBusName (void) const
 	return m_sAudioBusName;
 }
 
+qtractorAudioBus *qtractorAudioAuxSendPlugin::audioBus (void) const
+{
+	return m_pAudioBus;
+}
+
+
+// Plugin delay compensation (send path alignment).
+void qtractorAudioAuxSendPlugin::setSendDelay ( unsigned long iSendDelay )
+{
+	if (iSendDelay != m_pSendDelay->delay())
+		m_pSendDelay->setDelay(channels(), iSendDelay);
+}
+
+unsigned long qtractorAudioAuxSendPlugin::sendDelay (void) const
+{
+	return m_pSendDelay->delay();
+}
+
 
 // Audio bus to appear on plugin lists.
 void qtractorAudioAuxSendPlugin::updateAudioBusName (void) const
@@ -1367,6 +1411,8 @@ void qtractorAudioAuxSendPlugin::updateAudioBusName (void) const
 void qtractorAudioAuxSendPlugin::process (
 	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
 {
+	QTRACTOR_RT_AUDIT_SCOPE("qtractorAudioAuxSendPlugin::process");
+
 	if (m_pAudioBus == nullptr)
 		return;
 
@@ -1383,7 +1429,10 @@ void qtractorAudioAuxSendPlugin::process (
 		::memcpy(ppOBuffer[i], ppIBuffer[i], nframes * sizeof(float));
 
 	const float fGain = m_pSendGainParam->value();
-	(*m_pfnProcessAdd)(ppOut, ppOBuffer, nframes, iChannels, fGain);
+	if (m_pSendDelay->delay() > 0)
+		m_pSendDelay->process_add(ppOut, ppOBuffer, nframes, fGain);
+	else
+		(*m_pfnProcessAdd)(ppOut, ppOBuffer, nframes, iChannels, fGain);
 
 //	m_pAudioBus->process_commit(nframes);
 }
@@ -1612,6 +1661,8 @@ void qtractorMidiAuxSendPlugin::updateMidiBusName (void) const
 void qtractorMidiAuxSendPlugin::process (
 	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
 {
+	QTRACTOR_RT_AUDIT_SCOPE("qtractorMidiAuxSendPlugin::process");
+
 	qtractorSession *pSession = qtractorSession::getInstance();
 	qtractorMidiManager *pMidiManager = list()->midiManager();
 	if (m_pMidiBus && m_pMidiOutputBuffer && pMidiManager && pSession) {
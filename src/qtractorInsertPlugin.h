@@ -28,6 +28,7 @@
 
 // Forward declarations.
 class qtractorAudioBus;
+class qtractorAudioDelay;
 class qtractorMidiBus;
 class qtractorMidiInputBuffer;
 class qtractorMidiOutputBuffer;
@@ -149,6 +150,10 @@ public:
 	// The main plugin processing procedure.
 	void process(float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
 
+	// Plugin current latency (in frames);
+	// the send/return round-trip (one period).
+	unsigned long latency() const;
+
 	// Plugin configuration handlers.
 	void configure(const QString& sKey, const QString& sValue);
 
@@ -359,9 +364,15 @@ public:
 	void setAudioBusName(const QString& sAudioBusName);
 	const QString& audioBusName() const;
 
+	qtractorAudioBus *audioBus() const;
+
 	// Audio bus to appear on plugin lists.
 	void updateAudioBusName() const;
 
+	// Plugin delay compensation (send path alignment).
+	void setSendDelay(unsigned long iSendDelay);
+	unsigned long sendDelay() const;
+
 protected:
 
 	// Do the actual (de)activation.
@@ -374,6 +385,8 @@ private:
 	qtractorAudioBus *m_pAudioBus;
 	QString           m_sAudioBusName;
 
+	qtractorAudioDelay *m_pSendDelay;
+
 	Param *m_pSendGainParam;
 
 	// Custom optimized processors.
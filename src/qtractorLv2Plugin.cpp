@@ -38,6 +38,9 @@
 
 #include "qtractorMainForm.h"
 
+#include "qtractorRtAudit.h"
+#include "qtractorTrace.h"
+
 #ifdef CONFIG_LV2_STATE
 // LV2 State/Presets: standard directory access.
 // For local file vs. URI manipulations.
@@ -195,6 +198,7 @@ const char *qtractorLv2Plugin::lv2_urid_unmap ( LV2_URID id )
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QElapsedTimer>
 
 #include <jack/ringbuffer.h>
 
@@ -230,6 +234,24 @@ public:
 	// Process work.
 	void process();
 
+	// Pool-wide monotonic clock (nanoseconds).
+	static qint64 clock();
+
+protected:
+
+	// Request/response ring-buffer item header.
+	struct Header
+	{
+		uint32_t size;
+		qint64   stamp;
+	};
+
+	// Ring-buffer item writer/reader helpers.
+	static bool write_item(jack_ringbuffer_t *pRingBuffer,
+		uint32_t size, const void *data);
+	static bool read_item(jack_ringbuffer_t *pRingBuffer,
+		Header& header, void *data, uint32_t iMaxSize);
+
 private:
 
 	// Instance members.
@@ -240,12 +262,21 @@ private:
 	LV2_Feature         m_lv2_schedule_feature;
 	LV2_Worker_Schedule m_lv2_schedule;
 
+	// Preallocated request/response arenas.
 	jack_ringbuffer_t  *m_pRequests;
 	jack_ringbuffer_t  *m_pResponses;
+	void               *m_pRequest;
 	void               *m_pResponse;
 
-	static qtractorLv2WorkerThread *g_pWorkerThread;
-	static unsigned int             g_iWorkerRefCount;
+	// Pool thread this worker is bound to (ordering guarantee).
+	qtractorLv2WorkerThread *m_pWorkerThread;
+
+	// Worker thread pool.
+	static qtractorLv2WorkerThread **g_ppWorkerThreads;
+	static unsigned int              g_iWorkerThreads;
+	static unsigned int              g_iWorkerRefCount;
+
+	static QElapsedTimer g_clock;
 };
 
 static LV2_Worker_Status qtractor_lv2_worker_schedule (
@@ -281,7 +312,7 @@ static LV2_Worker_Status qtractor_lv2_worker_respond (
 }
 
 //----------------------------------------------------------------------
-// class qtractorLv2WorkerThread -- LV2 Worker/Schedule thread.
+// class qtractorLv2WorkerThread -- LV2 Worker/Schedule pool thread.
 //
 class qtractorLv2WorkerThread : public QThread
 {
@@ -299,6 +330,23 @@ public:
 	// Wake from executive wait condition.
 	void sync(qtractorLv2Worker *pLv2Worker = nullptr);
 
+	// Bound workers reference count (load balancing).
+	void addRef() { ++m_iRefCount; }
+	void removeRef() { --m_iRefCount; }
+	unsigned int refCount() const { return m_iRefCount; }
+
+	// Latency statistics (nanoseconds).
+	void stats_update(qint64 iWaitTime, qint64 iWorkTime);
+	void stats_reset();
+
+	unsigned long stats_jobs()     const { return m_iStatsJobs; }
+	qint64        stats_max_wait() const { return m_iStatsMaxWait; }
+	qint64        stats_max_work() const { return m_iStatsMaxWork; }
+	qint64 stats_avg_wait() const
+		{ return (m_iStatsJobs > 0 ? m_iStatsSumWait / m_iStatsJobs : 0); }
+	qint64 stats_avg_work() const
+		{ return (m_iStatsJobs > 0 ? m_iStatsSumWork / m_iStatsJobs : 0); }
+
 protected:
 
 	// The main thread executive.
@@ -306,7 +354,7 @@ protected:
 
 private:
 
-	// The peak file queue instance reference.
+	// The worker queue instance reference.
 	unsigned int          m_iSyncSize;
 	unsigned int          m_iSyncMask;
 	qtractorLv2Worker   **m_ppSyncItems;
@@ -317,6 +365,16 @@ private:
 	// Whether the thread is logically running.
 	volatile bool m_bRunState;
 
+	// Bound workers reference count.
+	unsigned int m_iRefCount;
+
+	// Latency statistics.
+	unsigned long m_iStatsJobs;
+	qint64        m_iStatsSumWait;
+	qint64        m_iStatsSumWork;
+	qint64        m_iStatsMaxWait;
+	qint64        m_iStatsMaxWork;
+
 	// Thread synchronization objects.
 	QMutex m_mutex;
 	QWaitCondition m_cond;
@@ -336,6 +394,10 @@ qtractorLv2WorkerThread::qtractorLv2WorkerThread ( unsigned int iSyncSize )
 	::memset(m_ppSyncItems, 0, m_iSyncSize * sizeof(qtractorLv2Worker *));
 
 	m_bRunState = false;
+
+	m_iRefCount = 0;
+
+	stats_reset();
 }
 
 // Destructor.
@@ -386,6 +448,30 @@ void qtractorLv2WorkerThread::sync ( qtractorLv2Worker *pLv2Worker )
 #endif
 }
 
+// Latency statistics accumulator (worker thread only).
+void qtractorLv2WorkerThread::stats_update (
+	qint64 iWaitTime, qint64 iWorkTime )
+{
+	++m_iStatsJobs;
+
+	m_iStatsSumWait += iWaitTime;
+	m_iStatsSumWork += iWorkTime;
+
+	if (m_iStatsMaxWait < iWaitTime)
+		m_iStatsMaxWait = iWaitTime;
+	if (m_iStatsMaxWork < iWorkTime)
+		m_iStatsMaxWork = iWorkTime;
+}
+
+void qtractorLv2WorkerThread::stats_reset (void)
+{
+	m_iStatsJobs    = 0;
+	m_iStatsSumWait = 0;
+	m_iStatsSumWork = 0;
+	m_iStatsMaxWait = 0;
+	m_iStatsMaxWork = 0;
+}
+
 // The main thread executive cycle.
 void qtractorLv2WorkerThread::run (void)
 {
@@ -413,16 +499,32 @@ void qtractorLv2WorkerThread::run (void)
 
 	m_mutex.unlock();
 
-#ifdef CONFIG_DEBUG_0
-	qDebug("qtractorLv2WorkerThread[%p]::run(): stopped.\n", this);
+	// Give back our trace buffer, if any.
+	qtractorTrace::release();
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorLv2WorkerThread[%p]::run(): stopped"
+		" (jobs=%lu wait=%lld/%lldus work=%lld/%lldus).", this,
+		stats_jobs(),
+		stats_avg_wait() / 1000, stats_max_wait() / 1000,
+		stats_avg_work() / 1000, stats_max_work() / 1000);
 #endif
 }
 
 //----------------------------------------------------------------------
 // class qtractorLv2Worker -- LV2 Worker/Schedule item impl.
 //
-qtractorLv2WorkerThread *qtractorLv2Worker::g_pWorkerThread   = nullptr;
-unsigned int             qtractorLv2Worker::g_iWorkerRefCount = 0;
+qtractorLv2WorkerThread **qtractorLv2Worker::g_ppWorkerThreads = nullptr;
+unsigned int              qtractorLv2Worker::g_iWorkerThreads  = 0;
+unsigned int              qtractorLv2Worker::g_iWorkerRefCount = 0;
+
+QElapsedTimer qtractorLv2Worker::g_clock;
+
+// Pool-wide monotonic clock (nanoseconds).
+qint64 qtractorLv2Worker::clock (void)
+{
+	return g_clock.nsecsElapsed();
+}
 
 // Constructor.
 qtractorLv2Worker::qtractorLv2Worker (
@@ -448,63 +550,126 @@ qtractorLv2Worker::qtractorLv2Worker (
 
 	m_pRequests  = ::jack_ringbuffer_create(4096);
 	m_pResponses = ::jack_ringbuffer_create(4096);
+	m_pRequest   = (void *) ::malloc(4096);
 	m_pResponse  = (void *) ::malloc(4096);
 
+	::jack_ringbuffer_mlock(m_pRequests);
+	::jack_ringbuffer_mlock(m_pResponses);
+
+	// Start the worker thread pool, if not already...
 	if (++g_iWorkerRefCount == 1) {
-		g_pWorkerThread = new qtractorLv2WorkerThread();
-		g_pWorkerThread->start();
+		g_clock.start();
+		int iWorkerThreads = QThread::idealThreadCount() - 1;
+		if (iWorkerThreads < 1)
+			iWorkerThreads = 1;
+		else
+		if (iWorkerThreads > 8)
+			iWorkerThreads = 8;
+		g_iWorkerThreads = iWorkerThreads;
+		g_ppWorkerThreads = new qtractorLv2WorkerThread * [g_iWorkerThreads];
+		for (unsigned int i = 0; i < g_iWorkerThreads; ++i) {
+			g_ppWorkerThreads[i] = new qtractorLv2WorkerThread();
+			g_ppWorkerThreads[i]->start();
+		}
 	}
+
+	// Bind to the least loaded pool thread, so that all work
+	// from this very plugin instance is kept in strict order...
+	m_pWorkerThread = g_ppWorkerThreads[0];
+	for (unsigned int i = 1; i < g_iWorkerThreads; ++i) {
+		qtractorLv2WorkerThread *pWorkerThread = g_ppWorkerThreads[i];
+		if (m_pWorkerThread->refCount() > pWorkerThread->refCount())
+			m_pWorkerThread = pWorkerThread;
+	}
+	m_pWorkerThread->addRef();
 }
 
 // Destructor.
 qtractorLv2Worker::~qtractorLv2Worker (void)
 {
+	m_pWorkerThread->removeRef();
+	m_pWorkerThread = nullptr;
+
 	if (--g_iWorkerRefCount == 0) {
-		if (g_pWorkerThread->isRunning()) do {
-			g_pWorkerThread->setRunState(false);
-		//	g_pWorkerThread->terminate();
-			g_pWorkerThread->sync();
-		} while (!g_pWorkerThread->wait(100));
-		delete g_pWorkerThread;
-		g_pWorkerThread = nullptr;
+		for (unsigned int i = 0; i < g_iWorkerThreads; ++i) {
+			qtractorLv2WorkerThread *pWorkerThread = g_ppWorkerThreads[i];
+			if (pWorkerThread->isRunning()) do {
+				pWorkerThread->setRunState(false);
+			//	pWorkerThread->terminate();
+				pWorkerThread->sync();
+			} while (!pWorkerThread->wait(100));
+			delete pWorkerThread;
+		}
+		delete [] g_ppWorkerThreads;
+		g_ppWorkerThreads = nullptr;
+		g_iWorkerThreads = 0;
 	}
 
 	::jack_ringbuffer_free(m_pRequests);
 	::jack_ringbuffer_free(m_pResponses);
+	::free(m_pRequest);
 	::free(m_pResponse);
 
 	delete [] m_lv2_features;
 }
 
+// Ring-buffer item writer (no allocation, single producer).
+bool qtractorLv2Worker::write_item ( jack_ringbuffer_t *pRingBuffer,
+	uint32_t size, const void *data )
+{
+	Header header;
+	header.size  = size;
+	header.stamp = clock();
+
+	if (::jack_ringbuffer_write_space(pRingBuffer) < sizeof(header) + size)
+		return false;
+
+	::jack_ringbuffer_write(pRingBuffer,
+		(const char *) &header, sizeof(header));
+	::jack_ringbuffer_write(pRingBuffer,
+		(const char *) data, size);
+
+	return true;
+}
+
+// Ring-buffer item reader (only complete items, single consumer).
+bool qtractorLv2Worker::read_item ( jack_ringbuffer_t *pRingBuffer,
+	Header& header, void *data, uint32_t iMaxSize )
+{
+	const uint32_t read_space = ::jack_ringbuffer_read_space(pRingBuffer);
+	if (read_space < sizeof(header))
+		return false;
+
+	::jack_ringbuffer_peek(pRingBuffer, (char *) &header, sizeof(header));
+	if (read_space < sizeof(header) + header.size)
+		return false;
+
+	::jack_ringbuffer_read_advance(pRingBuffer, sizeof(header));
+	if (header.size > iMaxSize) {
+		// Oversized item: skip it altogether.
+		::jack_ringbuffer_read_advance(pRingBuffer, header.size);
+		header.size = 0;
+	} else {
+		::jack_ringbuffer_read(pRingBuffer, (char *) data, header.size);
+	}
+
+	return true;
+}
+
 // Schedule work.
 void qtractorLv2Worker::schedule ( uint32_t size, const void *data )
 {
-	const uint32_t request_size = size + sizeof(size);
+	QTRACTOR_RT_AUDIT_SCOPE("qtractorLv2Worker::schedule");
 
-	if (::jack_ringbuffer_write_space(m_pRequests) >= request_size) {
-		char request_data[request_size];
-		::memcpy(request_data, &size, sizeof(size));
-		::memcpy(request_data + sizeof(size), data, size);
-		::jack_ringbuffer_write(m_pRequests,
-			(const char *) &request_data, request_size);
-	}
+	write_item(m_pRequests, size, data);
 
-	if (g_pWorkerThread)
-		g_pWorkerThread->sync(this);
+	m_pWorkerThread->sync(this);
 }
 
 // Response work.
 void qtractorLv2Worker::respond ( uint32_t size, const void *data )
 {
-	const uint32_t response_size = size + sizeof(size);
-
-	if (::jack_ringbuffer_write_space(m_pResponses) >= response_size) {
-		char response_data[response_size];
-		::memcpy(response_data, &size, sizeof(size));
-		::memcpy(response_data + sizeof(size), data, size);
-		::jack_ringbuffer_write(m_pResponses,
-			(const char *) &response_data, response_size);
-	}
+	write_item(m_pResponses, size, data);
 }
 
 // Commit work.
@@ -518,19 +683,15 @@ void qtractorLv2Worker::commit (void)
 	const unsigned short iInstances = m_pLv2Plugin->instances();
 	unsigned short i;
 
-	uint32_t read_space = ::jack_ringbuffer_read_space(m_pResponses);
-	while (read_space > 0) {
-		uint32_t size = 0;
-		::jack_ringbuffer_read(m_pResponses, (char *) &size, sizeof(size));
-		::jack_ringbuffer_read(m_pResponses, (char *) m_pResponse, size);
-		if (worker->work_response) {
+	Header header;
+	while (read_item(m_pResponses, header, m_pResponse, 4096)) {
+		if (worker->work_response && header.size > 0) {
 			for (i = 0; i < iInstances; ++i) {
 				LV2_Handle handle = m_pLv2Plugin->lv2_handle(i);
 				if (handle)
-					(*worker->work_response)(handle, size, m_pResponse);
+					(*worker->work_response)(handle, header.size, m_pResponse);
 			}
 		}
-		read_space -= sizeof(size) + size;
 	}
 
 	if (worker->end_run) {
@@ -553,28 +714,22 @@ void qtractorLv2Worker::process (void)
 	const unsigned short iInstances = m_pLv2Plugin->instances();
 	unsigned short i;
 
-	void *buf = nullptr;
-	uint32_t size = 0;
-
-	uint32_t read_space = ::jack_ringbuffer_read_space(m_pRequests);
-	if (read_space > 0)
-		buf = ::malloc(read_space);
-
-	while (read_space > 0) {
-		::jack_ringbuffer_read(m_pRequests, (char *) &size, sizeof(size));
-		::jack_ringbuffer_read(m_pRequests, (char *) buf, size);
-		if (worker->work) {
+	Header header;
+	while (read_item(m_pRequests, header, m_pRequest, 4096)) {
+		qtractorTraceScope trace("LV2 worker", "work");
+		const qint64 iStartTime = clock();
+		if (worker->work && header.size > 0) {
 			for (i = 0; i < iInstances; ++i) {
 				LV2_Handle handle = m_pLv2Plugin->lv2_handle(i);
 				if (handle)
 					(*worker->work)(handle,
-						qtractor_lv2_worker_respond, this, size, buf);
+						qtractor_lv2_worker_respond, this,
+						header.size, m_pRequest);
 			}
 		}
-		read_space -= sizeof(size) + size;
+		m_pWorkerThread->stats_update(
+			iStartTime - header.stamp, clock() - iStartTime);
 	}
-
-	if (buf) ::free(buf);
 }
 
 #endif	// CONFIG_LV2_WORKER
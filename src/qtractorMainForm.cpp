@@ -39,6 +39,8 @@
 #include "qtractorSpinBox.h"
 
 #include "qtractorAudioPeak.h"
+#include "qtractorAudioStretch.h"
+#include "qtractorAudioTranscode.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorMidiEngine.h"
@@ -46,6 +48,7 @@
 #include "qtractorSessionCursor.h"
 
 #include "qtractorSessionCommand.h"
+#include "qtractorSessionJournal.h"
 #include "qtractorTimeScaleCommand.h"
 #include "qtractorClipCommand.h"
 
@@ -53,6 +56,7 @@
 #include "qtractorMidiClip.h"
 
 #include "qtractorAudioMeter.h"
+#include "qtractorAudioMonitor.h"
 #include "qtractorMidiMeter.h"
 
 #include "qtractorMidiMonitor.h"
@@ -80,6 +84,10 @@
 #include "qtractorCurveCommand.h"
 
 #include "qtractorMessageList.h"
+#include "qtractorDspProfile.h"
+#include "qtractorTrace.h"
+
+#include "qtractorRtAudit.h"
 
 #include "qtractorPluginFactory.h"
 
@@ -112,6 +120,7 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QFile>
+#include <QTextStream>
 #include <QUrl>
 #include <QRegularExpression>
 
@@ -155,6 +164,13 @@
 #define QTRACTOR_TIMER_MSECS    66
 #define QTRACTOR_TIMER_DELAY    233
 
+// Minimum period (msecs) between xrun trace dumps.
+#define QTRACTOR_XRUN_DUMP_PERIOD  30000
+
+// Auto-save journal period (msecs) and size limit (bytes).
+#define QTRACTOR_JOURNAL_PERIOD    3000
+#define QTRACTOR_JOURNAL_MAX_SIZE  (16 << 20)
+
 #if QT_VERSION < QT_VERSION_CHECK(4, 5, 0)
 namespace Qt {
 const WindowFlags WindowCloseButtonHint = WindowFlags(0x08000000);
@@ -230,6 +246,8 @@ qtractorMainForm::qtractorMainForm (
 	// FIXME: This gotta go, somewhere in time...
 	m_pSession = new qtractorSession();
 	m_pTempoCursor = new qtractorTempoCursor();
+	m_pJournal = new qtractorSessionJournal();
+	m_pSession->commands()->setJournal(m_pJournal);
 	m_pMessageList = new qtractorMessageList();
 	m_pAudioFileFactory = new qtractorAudioFileFactory();
 	m_pPluginFactory = new qtractorPluginFactory();
@@ -263,8 +281,11 @@ qtractorMainForm::qtractorMainForm (
 	m_iXrunCount = 0;
 	m_iXrunSkip  = 0;
 	m_iXrunTimer = 0;
+	m_iXrunDumpTimer = 0;
 
 	m_iAudioPeakTimer = 0;
+	m_iAudioStretchTimer = 0;
+	m_iAudioTranscodeTimer = 0;
 
 	m_iAudioRefreshTimer = 0;
 	m_iMidiRefreshTimer  = 0;
@@ -287,6 +308,24 @@ qtractorMainForm::qtractorMainForm (
 			SLOT(audioPeakNotify()));
 	}
 
+	// Configure the audio time-stretch cache factory...
+	qtractorAudioStretchFactory *pAudioStretchFactory
+		= m_pSession->audioStretchFactory();
+	if (pAudioStretchFactory) {
+		QObject::connect(pAudioStretchFactory,
+			SIGNAL(cacheEvent()),
+			SLOT(audioStretchNotify()));
+	}
+
+	// Configure the audio transcode cache factory...
+	qtractorAudioTranscodeFactory *pAudioTranscodeFactory
+		= m_pSession->audioTranscodeFactory();
+	if (pAudioTranscodeFactory) {
+		QObject::connect(pAudioTranscodeFactory,
+			SIGNAL(cacheEvent()),
+			SLOT(audioTranscodeNotify()));
+	}
+
 	// Configure the audio engine event handling...
 	const qtractorAudioEngineProxy *pAudioEngineProxy = nullptr;
 	qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
@@ -1069,6 +1108,21 @@ qtractorMainForm::qtractorMainForm (
 	QObject::connect(m_ui.viewRefreshAction,
 		SIGNAL(triggered(bool)),
 		SLOT(viewRefresh()));
+	QObject::connect(m_ui.viewDspProfileAction,
+		SIGNAL(triggered(bool)),
+		SLOT(viewDspProfile(bool)));
+	QObject::connect(m_ui.viewDspProfileExportAction,
+		SIGNAL(triggered(bool)),
+		SLOT(viewDspProfileExport()));
+	QObject::connect(m_ui.viewDspProfileResetAction,
+		SIGNAL(triggered(bool)),
+		SLOT(viewDspProfileReset()));
+	QObject::connect(m_ui.viewTraceAction,
+		SIGNAL(triggered(bool)),
+		SLOT(viewTrace(bool)));
+	QObject::connect(m_ui.viewTraceDumpAction,
+		SIGNAL(triggered(bool)),
+		SLOT(viewTraceDump()));
 	QObject::connect(m_ui.viewInstrumentsAction,
 		SIGNAL(triggered(bool)),
 		SLOT(viewInstruments()));
@@ -1253,6 +1307,12 @@ qtractorMainForm::~qtractorMainForm (void)
 	if (m_pTempoCursor)
 		delete m_pTempoCursor;
 
+	// Auto-save journal.
+	if (m_pJournal) {
+		m_pSession->commands()->setJournal(nullptr);
+		delete m_pJournal;
+	}
+
 	// Remove midi controllers.
 	if (m_pMidiControl)
 		delete m_pMidiControl;
@@ -1391,6 +1451,8 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 	m_ui.viewSnapZebraAction->setChecked(pOptions->bTrackViewSnapZebra);
 	m_ui.viewSnapGridAction->setChecked(pOptions->bTrackViewSnapGrid);
 	m_ui.viewToolTipsAction->setChecked(pOptions->bTrackViewToolTips);
+	m_ui.viewDspProfileAction->setChecked(pOptions->bAudioDspProfile);
+	m_ui.viewTraceAction->setChecked(pOptions->bAudioTrace);
 
 	m_ui.transportMetroAction->setChecked(m_pOptions->bMetronome);
 	m_ui.transportFollowAction->setChecked(m_pOptions->bFollowPlayhead);
@@ -1466,6 +1528,8 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 	// Primary startup stabilization...
 	updateRecentFilesMenu();
 	updatePeakAutoRemove();
+	updateAudioStretchCache();
+	updateAudioTranscodeCache();
 	updateDisplayFormat();
 	updateTransportModePre();
 	updateTransportModePost();
@@ -1475,6 +1539,7 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 	updateMidiControlModes();
 	updateMidiQueueTimer();
 	updateMidiDriftCorrect();
+	updateMidiJackOutput();
 	updateMidiPlayer();
 	updateMidiControl();
 	updateMidiMetronome();
@@ -1501,8 +1566,22 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 		m_pOptions->bAudioWsolaTimeStretch);
 	qtractorAudioBuffer::setDefaultWsolaQuickSeek(
 		m_pOptions->bAudioWsolaQuickSeek);
+	// Set default audio-meters loudness metering...
+	qtractorAudioMonitor::setLoudnessMetering(
+		m_pOptions->bAudioLoudnessMeters);
+	// Set default DSP load profiling...
+	qtractorDspProfile::setEnabled(
+		m_pOptions->bAudioDspProfile);
+	// Set default threads activity tracing...
+	qtractorTrace::setEnabled(
+		m_pOptions->bAudioTrace);
 	qtractorTrack::setTrackColorSaturation(
 		m_pOptions->iTrackColorSaturation);
+	// Set default undo/redo history memory budget (MB)...
+	qtractorCommandList::setDefaultMaxMemory(
+		(unsigned long) m_pOptions->iMaxUndoMemory << 20);
+	(m_pSession->commands())->setMaxMemory(
+		qtractorCommandList::defaultMaxMemory());
 
 	// Set default custom spin-box edit mode (deferred)...
 	qtractorSpinBox::setEditMode(qtractorSpinBox::DeferredMode);
@@ -1730,6 +1809,8 @@ bool qtractorMainForm::queryClose (void)
 			m_pOptions->bTrackViewSnapZebra = m_ui.viewSnapZebraAction->isChecked();
 			m_pOptions->bTrackViewSnapGrid = m_ui.viewSnapGridAction->isChecked();
 			m_pOptions->bTrackViewToolTips = m_ui.viewToolTipsAction->isChecked();
+			m_pOptions->bAudioDspProfile = m_ui.viewDspProfileAction->isChecked();
+			m_pOptions->bAudioTrace = m_ui.viewTraceAction->isChecked();
 			m_pOptions->bTrackViewCurveEdit = m_ui.editSelectModeCurveAction->isChecked();
 			m_pOptions->bMetronome = m_ui.transportMetroAction->isChecked();
 			m_pOptions->bFollowPlayhead = m_ui.transportFollowAction->isChecked();
@@ -2366,6 +2447,8 @@ bool qtractorMainForm::closeSession (void)
 		m_iDirtyCount = 0;
 		m_iBackupCount = 0;
 		autoSaveClose();
+		// Former timings are no longer relevant...
+		qtractorDspProfile::reset();
 		appendMessages(tr("Session closed."));
 	}
 
@@ -2546,6 +2629,9 @@ bool qtractorMainForm::loadSessionFileEx (
 
 	appendMessages(tr("Open session: \"%1\".").arg(sessionName(sFilename)));
 
+	// Don't account for the loading itself...
+	qtractorDspProfile::reset();
+
 	// Now we'll try to create (update) the whole GUI session.
 	updateSessionPost();
 
@@ -2897,6 +2983,9 @@ void qtractorMainForm::autoSaveReset (void)
 
 	m_iAutoSaveTimer = 0;
 
+	m_iAutoSaveJournalTimer = 0;
+	m_iAutoSaveJournalDirty = 0;
+
 	if (m_pOptions->bAutoSaveEnabled)
 		m_iAutoSavePeriod = 60000 * m_pOptions->iAutoSavePeriod;
 	else
@@ -2925,8 +3014,10 @@ void qtractorMainForm::autoSaveSession (void)
 		= m_pOptions->sAutoSavePathname;
 	if (!sOldAutoSavePathname.isEmpty()
 		&& sOldAutoSavePathname != sAutoSavePathname
-		&& QFileInfo(sOldAutoSavePathname).exists())
+		&& QFileInfo(sOldAutoSavePathname).exists()) {
 		QFile(sOldAutoSavePathname).remove();
+		m_pJournal->close(true);
+	}
 
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorMainForm::autoSaveSession(\"%s\")",
@@ -2938,10 +3029,33 @@ void qtractorMainForm::autoSaveSession (void)
 		m_pOptions->sAutoSavePathname = sAutoSavePathname;
 		m_pOptions->sAutoSaveFilename = m_sFilename;
 		m_pOptions->saveOptions();
+		// Journal starts over, from this snapshot...
+		const QString& sJournalName
+			= qtractorSessionJournal::journalName(sAutoSavePathname);
+		if (m_pJournal->filename() != sJournalName)
+			m_pJournal->open(sJournalName);
+		m_pJournal->reset(m_pSession);
+		m_iAutoSaveJournalTimer = 0;
+		m_iAutoSaveJournalDirty = m_iDirtyCount;
 	}
 }
 
 
+// Append what changed since last auto-save to its journal...
+void qtractorMainForm::autoSaveJournal (void)
+{
+	if (!m_pJournal->isOpen())
+		return;
+
+	m_iAutoSaveJournalDirty = m_iDirtyCount;
+
+	// Structural changes or just too long? take a full snapshot...
+	if (m_pJournal->update(m_pSession) < 0
+		|| m_pJournal->size() > QTRACTOR_JOURNAL_MAX_SIZE)
+		autoSaveAsap();
+}
+
+
 // Auto-save/crash-recovery setup...
 bool qtractorMainForm::autoSaveOpen (void)
 {
@@ -2966,6 +3080,18 @@ bool qtractorMainForm::autoSaveOpen (void)
 			QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
 			const int iFlags = qtractorDocument::Default;
 			if (loadSessionFileEx(sAutoSavePathname, iFlags, false)) {
+				// Replay whatever got journaled since...
+				const QString& sJournalName
+					= qtractorSessionJournal::journalName(sAutoSavePathname);
+				if (QFileInfo(sJournalName).exists()) {
+					const int iRecords
+						= qtractorSessionJournal::replay(sJournalName, m_pSession);
+					if (iRecords > 0) {
+						appendMessages(tr("Crash-recover: %1 journal record(s) replayed.")
+							.arg(iRecords));
+						updateContents(nullptr, true);
+					}
+				}
 				m_sFilename = m_pOptions->sAutoSaveFilename;
 				++m_iDirtyCount;
 				return true;
@@ -2991,6 +3117,15 @@ void qtractorMainForm::autoSaveClose (void)
 		&& QFileInfo(sAutoSavePathname).exists())
 		QFile(sAutoSavePathname).remove();
 
+	m_pJournal->close(true);
+
+	if (!sAutoSavePathname.isEmpty()) {
+		const QString& sJournalName
+			= qtractorSessionJournal::journalName(sAutoSavePathname);
+		if (QFileInfo(sJournalName).exists())
+			QFile(sJournalName).remove();
+	}
+
 	m_pOptions->sAutoSavePathname.clear();
 	m_pOptions->sAutoSaveFilename.clear();
 
@@ -4998,6 +5133,195 @@ void qtractorMainForm::viewRefresh (void)
 }
 
 
+// Set DSP load profiling mode.
+void qtractorMainForm::viewDspProfile ( bool bOn )
+{
+	qtractorDspProfile::setEnabled(bOn);
+
+	stabilizeForm();
+}
+
+
+// Reset all DSP load profile timings.
+void qtractorMainForm::viewDspProfileReset (void)
+{
+	qtractorDspProfile::reset();
+
+	appendMessages(tr("DSP profile reset."));
+}
+
+
+// DSP load profile CSV record helpers.
+static void qtractorMainForm_dspProfile ( QTextStream& ts,
+	const QString& sType, const QString& sName, qtractorDspProfile *pDspProfile )
+{
+	QString sText = sName;
+	sText.replace('"', "\"\"");
+
+	ts << sType << ",\"" << sText << "\","
+		<< pDspProfile->count() << ','
+		<< QString::number(pDspProfile->mean(), 'f', 2) << ','
+		<< QString::number(pDspProfile->p99(),  'f', 2) << ','
+		<< QString::number(pDspProfile->max(),  'f', 2) << '\n';
+}
+
+static void qtractorMainForm_dspProfile ( QTextStream& ts,
+	const QString& sPrefix, qtractorPluginList *pPluginList )
+{
+	if (pPluginList == nullptr)
+		return;
+
+	for (qtractorPlugin *pPlugin = pPluginList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		qtractorMainForm_dspProfile(ts, "plugin",
+			sPrefix + '/' + (pPlugin->type())->name(),
+			pPlugin->dspProfile());
+	}
+}
+
+
+// Export DSP load profile timings (CSV).
+void qtractorMainForm::viewDspProfileExport (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	const QString& sTitle
+		= tr("Export DSP Profile");
+	QStringList filters;
+	filters.append(tr("CSV files (*.%1)").arg("csv"));
+	filters.append(tr("All files (*.*)"));
+	const QString& sFilter = filters.join(";;");
+
+	QWidget *pParentWidget = nullptr;
+	QFileDialog::Options options;
+	if (m_pOptions->bDontUseNativeDialogs) {
+		options |= QFileDialog::DontUseNativeDialog;
+		pParentWidget = QWidget::window();
+	}
+
+	QString sFilename = QFileInfo(m_pSession->sessionDir(),
+		m_pSession->sessionName() + "-dsp.csv").filePath();
+	sFilename = QFileDialog::getSaveFileName(pParentWidget,
+		sTitle, sFilename, sFilter, nullptr, options);
+	if (sFilename.isEmpty())
+		return;
+
+	if (QFileInfo(sFilename).suffix().isEmpty())
+		sFilename += ".csv";
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+		appendMessagesError(
+			tr("Could not write DSP profile file:\n\n"
+			"\"%1\"\n\nSorry.").arg(sFilename));
+		return;
+	}
+
+	QTextStream ts(&file);
+	ts << "type,name,count,mean_us,p99_us,max_us" << '\n';
+
+	// Tracks (whole, clip reads and plugins)...
+	for (qtractorTrack *pTrack = m_pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		const QString& sName = pTrack->trackName();
+		qtractorMainForm_dspProfile(ts, "track", sName,
+			pTrack->dspProfile());
+		qtractorMainForm_dspProfile(ts, "clips", sName,
+			pTrack->clipsDspProfile());
+		qtractorMainForm_dspProfile(ts, sName, pTrack->pluginList());
+	}
+
+	// Audio buses (commits and plugins)...
+	qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
+	if (pAudioEngine) {
+		for (qtractorBus *pBus = pAudioEngine->buses().first();
+				pBus; pBus = pBus->next()) {
+			qtractorAudioBus *pAudioBus
+				= static_cast<qtractorAudioBus *> (pBus);
+			const QString& sName = pAudioBus->busName();
+			if (pAudioBus->busMode() & qtractorBus::Output) {
+				qtractorMainForm_dspProfile(ts, "bus", sName,
+					pAudioBus->dspProfile());
+			}
+			qtractorMainForm_dspProfile(ts,
+				sName + ' ' + tr("In"), pAudioBus->pluginList_in());
+			qtractorMainForm_dspProfile(ts,
+				sName + ' ' + tr("Out"), pAudioBus->pluginList_out());
+		}
+	}
+
+	// MIDI input-to-plugin latencies (no percentile available)...
+	const float fUsecsPerFrame = (pAudioEngine && pAudioEngine->sampleRate() > 0
+		? 1000000.0f / float(pAudioEngine->sampleRate()) : 0.0f);
+	for (qtractorMidiManager *pMidiManager = m_pSession->midiManagers().first();
+			pMidiManager; pMidiManager = pMidiManager->next()) {
+		QString sText = (pMidiManager->pluginList())->name();
+		sText.replace('"', "\"\"");
+		ts << "midi-in,\"" << sText << "\","
+			<< pMidiManager->directEvents() << ','
+			<< QString::number(fUsecsPerFrame
+				* pMidiManager->directLatencyMean(), 'f', 2) << ",,"
+			<< QString::number(fUsecsPerFrame
+				* float(pMidiManager->directLatencyMax()), 'f', 2) << '\n';
+	}
+
+	file.close();
+
+	appendMessages(tr("DSP profile exported: \"%1\".").arg(sFilename));
+}
+
+
+// Set threads activity tracing mode.
+void qtractorMainForm::viewTrace ( bool bOn )
+{
+	qtractorTrace::setEnabled(bOn);
+
+	stabilizeForm();
+}
+
+
+// Dump recent threads activity trace (Chrome trace JSON).
+void qtractorMainForm::viewTraceDump (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	const QString& sTitle
+		= tr("Dump Trace");
+	QStringList filters;
+	filters.append(tr("Trace files (*.%1)").arg("json"));
+	filters.append(tr("All files (*.*)"));
+	const QString& sFilter = filters.join(";;");
+
+	QWidget *pParentWidget = nullptr;
+	QFileDialog::Options options;
+	if (m_pOptions->bDontUseNativeDialogs) {
+		options |= QFileDialog::DontUseNativeDialog;
+		pParentWidget = QWidget::window();
+	}
+
+	QString sFilename = QFileInfo(m_pSession->sessionDir(),
+		m_pSession->sessionName() + "-trace.json").filePath();
+	sFilename = QFileDialog::getSaveFileName(pParentWidget,
+		sTitle, sFilename, sFilter, nullptr, options);
+	if (sFilename.isEmpty())
+		return;
+
+	if (QFileInfo(sFilename).suffix().isEmpty())
+		sFilename += ".json";
+
+	if (!qtractorTrace::dump(sFilename)) {
+		appendMessagesError(
+			tr("Could not write trace file:\n\n"
+			"\"%1\"\n\nSorry.").arg(sFilename));
+		return;
+	}
+
+	appendMessages(tr("Trace dumped: \"%1\".").arg(sFilename));
+}
+
+
 // Show instruments dialog.
 void qtractorMainForm::viewInstruments (void)
 {
@@ -5056,6 +5380,9 @@ void qtractorMainForm::viewOptions (void)
 	const int     iOldResampleType       = m_pOptions->iAudioResampleType;
 	const bool    bOldWsolaTimeStretch   = m_pOptions->bAudioWsolaTimeStretch;
 	const bool    bOldWsolaQuickSeek     = m_pOptions->bAudioWsolaQuickSeek;
+	const bool    bOldStretchCache       = m_pOptions->bAudioStretchCache;
+	const bool    bOldTranscodeCache     = m_pOptions->bAudioTranscodeCache;
+	const bool    bOldLoudnessMeters     = m_pOptions->bAudioLoudnessMeters;
 	const bool    bOldAudioPlayerAutoConnect = m_pOptions->bAudioPlayerAutoConnect;
 	const bool    bOldAudioPlayerBus     = m_pOptions->bAudioPlayerBus;
 	const bool    bOldAudioMetronome     = m_pOptions->bAudioMetronome;
@@ -5068,6 +5395,7 @@ void qtractorMainForm::viewOptions (void)
 	const int     iOldMidiCaptureQuantize = m_pOptions->iMidiCaptureQuantize;
 	const int     iOldMidiQueueTimer     = m_pOptions->iMidiQueueTimer;
 	const bool    bOldMidiDriftCorrect   = m_pOptions->bMidiDriftCorrect;
+	const bool    bOldMidiJackOutput     = m_pOptions->bMidiJackOutput;
 	const bool    bOldMidiPlayerBus      = m_pOptions->bMidiPlayerBus;
 	const QString sOldMetroBarFilename   = m_pOptions->sMetroBarFilename;
 	const float   fOldMetroBarGain       = m_pOptions->fMetroBarGain;
@@ -5121,6 +5449,22 @@ void qtractorMainForm::viewOptions (void)
 				m_pOptions->bAudioWsolaQuickSeek);
 			iNeedRestart |= RestartSession;
 		}
+		if (( bOldStretchCache && !m_pOptions->bAudioStretchCache) ||
+			(!bOldStretchCache &&  m_pOptions->bAudioStretchCache)) {
+			updateAudioStretchCache();
+			iNeedRestart |= RestartSession;
+		}
+		if (( bOldTranscodeCache && !m_pOptions->bAudioTranscodeCache) ||
+			(!bOldTranscodeCache &&  m_pOptions->bAudioTranscodeCache)) {
+			updateAudioTranscodeCache();
+			iNeedRestart |= RestartSession;
+		}
+		if (( bOldLoudnessMeters && !m_pOptions->bAudioLoudnessMeters) ||
+			(!bOldLoudnessMeters &&  m_pOptions->bAudioLoudnessMeters)) {
+			qtractorAudioMonitor::setLoudnessMetering(
+				m_pOptions->bAudioLoudnessMeters);
+			iNeedRestart |= RestartSession;
+		}
 		// Audio engine control modes...
 		if (iOldTransportMode != m_pOptions->iTransportMode) {
 			++m_iDirtyCount; // Fake session properties change.
@@ -5139,6 +5483,12 @@ void qtractorMainForm::viewOptions (void)
 			updateMidiQueueTimer();
 			iNeedRestart |= RestartSession;
 		}
+		// MIDI engine JACK MIDI output...
+		if (( bOldMidiJackOutput && !m_pOptions->bMidiJackOutput) ||
+			(!bOldMidiJackOutput &&  m_pOptions->bMidiJackOutput)) {
+			updateMidiJackOutput();
+			iNeedRestart |= RestartSession;
+		}
 	#ifdef CONFIG_LV2
 		if (( bOldLv2DynManifest && !m_pOptions->bLv2DynManifest) ||
 			(!bOldLv2DynManifest &&  m_pOptions->bLv2DynManifest)) {
@@ -5992,6 +6342,18 @@ bool qtractorMainForm::setPlaying ( bool bPlaying )
 		}
 		// Stop transport rolling, immediately...
 		setRolling(0);
+		// Silence propagation (idle-skipping) statistics...
+		qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
+		const unsigned long iTrackCycles
+			= (pAudioEngine ? pAudioEngine->trackCycles() : 0);
+		if (qtractorDspProfile::isEnabled() && iTrackCycles > 0) {
+			const unsigned long iSkipCycles = pAudioEngine->skipCycles();
+			appendMessages(
+				tr("Track cycles: %1 processed, %2 skipped as silent (%3%).")
+				.arg(iTrackCycles).arg(iSkipCycles)
+				.arg(QString::number(
+					100.0f * float(iSkipCycles) / float(iTrackCycles), 'f', 1)));
+		}
 		// Session tracks automation recording.
 		qtractorCurveCaptureListCommand *pCurveCommand = nullptr;
 		for (qtractorTrack *pTrack = m_pSession->tracks().first();
@@ -6274,6 +6636,12 @@ void qtractorMainForm::stabilizeForm (void)
 
 	// Update the main menu state...
 	m_ui.fileSaveAction->setEnabled(m_iDirtyCount > 0);
+	m_ui.viewDspProfileExportAction->setEnabled(
+		m_ui.viewDspProfileAction->isChecked());
+	m_ui.viewDspProfileResetAction->setEnabled(
+		m_ui.viewDspProfileAction->isChecked());
+	m_ui.viewTraceDumpAction->setEnabled(
+		m_ui.viewTraceAction->isChecked());
 #ifdef CONFIG_NSM
 	m_ui.fileSaveAsAction->setEnabled(m_pNsmClient == nullptr);
 #endif
@@ -6579,6 +6947,9 @@ void qtractorMainForm::updateSessionPost (void)
 	m_pSession->open();
 	QApplication::restoreOverrideCursor();
 
+	// Graph-wide path latencies, once for all opened tracks...
+	m_pSession->audioEngine()->updatePathLatenciesDirty();
+
 	// HACK: Special treatment for disparate sample rates,
 	// and only for (just loaded) non empty sessions...
 	const unsigned int iSampleRate
@@ -6723,6 +7094,82 @@ void qtractorMainForm::updatePeakAutoRemove (void)
 		= m_pSession->audioPeakFactory();
 	if (pPeakFactory)
 		pPeakFactory->setAutoRemove(m_pOptions->bPeakAutoRemove);
+
+	// Time-stretch cache files go along the same way...
+	qtractorAudioStretchFactory *pStretchFactory
+		= m_pSession->audioStretchFactory();
+	if (pStretchFactory)
+		pStretchFactory->setAutoRemove(m_pOptions->bPeakAutoRemove);
+
+	// And so do the transcode cache files...
+	qtractorAudioTranscodeFactory *pTranscodeFactory
+		= m_pSession->audioTranscodeFactory();
+	if (pTranscodeFactory)
+		pTranscodeFactory->setAutoRemove(m_pOptions->bPeakAutoRemove);
+}
+
+
+// Force update of the pre-rendered time-stretch cache mode.
+void qtractorMainForm::updateAudioStretchCache (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	qtractorAudioStretchFactory *pStretchFactory
+		= m_pSession->audioStretchFactory();
+	if (pStretchFactory)
+		pStretchFactory->setEnabled(m_pOptions->bAudioStretchCache);
+}
+
+
+// Switch time-stretched clips over to their freshly rendered cache files.
+void qtractorMainForm::updateAudioStretchClips (void)
+{
+	qtractorAudioStretchFactory *pStretchFactory
+		= m_pSession->audioStretchFactory();
+	if (pStretchFactory == nullptr)
+		return;
+
+	const int iClips = pStretchFactory->updateClips(m_pSession);
+	if (iClips > 0) {
+		appendMessages(
+			tr("Audio time-stretch cache: %1 clip(s) ready.")
+			.arg(iClips));
+	}
+}
+
+
+// Force update of the transcoded (PCM) cache mode.
+void qtractorMainForm::updateAudioTranscodeCache (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	qtractorAudioTranscodeFactory *pTranscodeFactory
+		= m_pSession->audioTranscodeFactory();
+	if (pTranscodeFactory) {
+		pTranscodeFactory->setFormat(m_pOptions->iAudioTranscodeFormat);
+		pTranscodeFactory->setQuota(m_pOptions->iAudioTranscodeQuota > 0
+			? m_pOptions->iAudioTranscodeQuota : 0);
+		pTranscodeFactory->setEnabled(m_pOptions->bAudioTranscodeCache);
+	}
+}
+
+
+// Switch compressed clips over to their freshly transcoded cache files.
+void qtractorMainForm::updateAudioTranscodeClips (void)
+{
+	qtractorAudioTranscodeFactory *pTranscodeFactory
+		= m_pSession->audioTranscodeFactory();
+	if (pTranscodeFactory == nullptr)
+		return;
+
+	const int iClips = pTranscodeFactory->updateClips(m_pSession);
+	if (iClips > 0) {
+		appendMessages(
+			tr("Audio transcode cache: %1 clip(s) ready.")
+			.arg(iClips));
+	}
 }
 
 
@@ -6858,6 +7305,17 @@ void qtractorMainForm::updateMidiDriftCorrect (void)
 }
 
 
+// Update MIDI playback JACK MIDI output mode.
+void qtractorMainForm::updateMidiJackOutput (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	// Configure the MIDI engine output delivery...
+	m_pSession->midiEngine()->setJackMidi(m_pOptions->bMidiJackOutput);
+}
+
+
 // Update MIDI player parameters.
 void qtractorMainForm::updateMidiPlayer (void)
 {
@@ -7806,6 +8264,10 @@ void qtractorMainForm::slowTimerSlot (void)
 		}
 	}
 
+	// Throttle xrun trace dumps...
+	if (m_iXrunDumpTimer > 0)
+		m_iXrunDumpTimer -= QTRACTOR_TIMER_DELAY;
+
 	// Check if we've got some XRUN callbacks...
 	if (m_iXrunTimer > 0 && --m_iXrunTimer < 1) {
 		m_iXrunTimer = 0;
@@ -7822,14 +8284,42 @@ void qtractorMainForm::slowTimerSlot (void)
 		appendMessagesColor(
 			tr("XRUN(%1): some frames might have been lost.")
 			.arg(m_iXrunCount), "#cc0033");
+		// Dump the most recent threads activity, if tracing,
+		// once in a while and overwriting the previous one...
+		if (qtractorTrace::isEnabled()
+			&& !m_sFilename.isEmpty() && m_iXrunDumpTimer < 1) {
+			m_iXrunDumpTimer = QTRACTOR_XRUN_DUMP_PERIOD;
+			const QString& sFilename = QFileInfo(QDir::temp(),
+				QTRACTOR_TITLE + ('-' + m_pSession->sessionName())
+				+ "-xrun.json").filePath();
+			if (qtractorTrace::dump(sFilename)) {
+				appendMessages(tr("XRUN(%1): trace dumped: \"%2\".")
+					.arg(m_iXrunCount).arg(sFilename));
+			}
+		}
 		// Let the XRUN status item get an update...
 		++m_iStabilizeTimer;
 	}
 
+	// Graph-wide path latencies, if any changed meanwhile...
+	pAudioEngine->updatePathLatenciesDirty();
+
 	// Check if its time to refresh some tracks...
 	if (m_iAudioPeakTimer > 0 && --m_iAudioPeakTimer < 1) {
 		m_iAudioPeakTimer = 0;
-		m_pTracks->trackView()->updateContents();
+		m_pTracks->trackView()->refreshContents();
+	}
+
+	// Check if its time to switch over to time-stretch cache...
+	if (m_iAudioStretchTimer > 0 && --m_iAudioStretchTimer < 1) {
+		m_iAudioStretchTimer = 0;
+		updateAudioStretchClips();
+	}
+
+	// Check if its time to switch over to transcode cache...
+	if (m_iAudioTranscodeTimer > 0 && --m_iAudioTranscodeTimer < 1) {
+		m_iAudioTranscodeTimer = 0;
+		updateAudioTranscodeClips();
 	}
 
 	// Check if its time to refresh Audio connections...
@@ -7880,6 +8370,31 @@ void qtractorMainForm::slowTimerSlot (void)
 		}
 	}
 
+	// MIDI input (direct buffering) overflow reports, if any...
+	for (qtractorMidiManager *pMidiManager = m_pSession->midiManagers().first();
+			pMidiManager; pMidiManager = pMidiManager->next()) {
+		const QString& sReport = pMidiManager->directOverflowReport();
+		if (!sReport.isEmpty())
+			appendMessagesColor(sReport, "#66cc99");
+	}
+
+	// Control update (observer queue) overflow reports, if any...
+	const QString& sQueueReport = qtractorSubject::queueOverflowReport();
+	if (!sQueueReport.isEmpty())
+		appendMessagesColor(sQueueReport, "#66cc99");
+
+	// JACK MIDI output jitter reports, if any...
+	QStringListIterator jacklate(pMidiEngine->jackLateReports());
+	while (jacklate.hasNext())
+		appendMessagesColor(jacklate.next(), "#66cc99");
+
+#ifdef CONFIG_RTAUDIT
+	// Real-time safety audit reports, if any...
+	QStringListIterator rtaudit(qtractorRtAudit::reports());
+	while (rtaudit.hasNext())
+		appendMessagesColor(rtaudit.next(), "#cc6600");
+#endif
+
 	// Slower plugin UI idle cycle...
 #ifdef CONFIG_DSSI
 #ifdef CONFIG_LIBLO
@@ -7894,6 +8409,14 @@ void qtractorMainForm::slowTimerSlot (void)
 			m_iAutoSaveTimer = 0;
 			autoSaveSession();
 		}
+		else
+		if (m_iAutoSaveJournalDirty != m_iDirtyCount) {
+			m_iAutoSaveJournalTimer += QTRACTOR_TIMER_DELAY;
+			if (m_iAutoSaveJournalTimer > QTRACTOR_JOURNAL_PERIOD) {
+				m_iAutoSaveJournalTimer = 0;
+				autoSaveJournal();
+			}
+		}
 	}
 
 	// Check if its time to stabilize main form...
@@ -7931,6 +8454,24 @@ void qtractorMainForm::audioPeakNotify (void)
 }
 
 
+// Custom audio time-stretch cache event handler.
+void qtractorMainForm::audioStretchNotify (void)
+{
+	// A time-stretch cache file has just been rendered;
+	// try to postpone the event effect a little more...
+	if (m_iAudioStretchTimer < 2) ++m_iAudioStretchTimer;
+}
+
+
+// Custom audio transcode cache event handler.
+void qtractorMainForm::audioTranscodeNotify (void)
+{
+	// A transcode cache file has just been rendered;
+	// try to postpone the event effect a little more...
+	if (m_iAudioTranscodeTimer < 2) ++m_iAudioTranscodeTimer;
+}
+
+
 // Custom audio shutdown event handler.
 void qtractorMainForm::audioShutNotify (void)
 {
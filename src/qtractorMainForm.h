@@ -29,6 +29,7 @@
 class qtractorOptions;
 class qtractorSession;
 class qtractorSessionEvent;
+class qtractorSessionJournal;
 class qtractorSyncEvent;
 class qtractorTracks;
 class qtractorThumbView;
@@ -257,6 +258,11 @@ public slots:
 	void viewToolTips(bool bOn);
 	void viewSnap();
 	void viewRefresh();
+	void viewDspProfile(bool bOn);
+	void viewDspProfileExport();
+	void viewDspProfileReset();
+	void viewTrace(bool bOn);
+	void viewTraceDump();
 	void viewInstruments();
 	void viewControllers();
 	void viewBuses();
@@ -308,6 +314,8 @@ protected slots:
 	void alsaNotify();
 
 	void audioPeakNotify();
+	void audioStretchNotify();
+	void audioTranscodeNotify();
 	void audioShutNotify();
 	void audioXrunNotify();
 	void audioPortNotify();
@@ -414,6 +422,10 @@ protected:
 
 	void updateRecentFiles(const QString& sFilename);
 	void updatePeakAutoRemove();
+	void updateAudioStretchCache();
+	void updateAudioStretchClips();
+	void updateAudioTranscodeCache();
+	void updateAudioTranscodeClips();
 	void updateMessagesFont();
 	void updateMessagesLimit();
 	void updateMessagesCapture();
@@ -425,6 +437,7 @@ protected:
 	void updateAudioPlayer();
 	void updateMidiQueueTimer();
 	void updateMidiDriftCorrect();
+	void updateMidiJackOutput();
 	void updateMidiPlayer();
 	void updateMidiControl();
 	void updateAudioMetronome();
@@ -452,6 +465,7 @@ protected:
 	void autoSaveReset();
 	void autoSaveSession();
 	void autoSaveClose();
+	void autoSaveJournal();
 
 	QString sessionDir(const QString& sFilename) const;
 
@@ -503,17 +517,24 @@ private:
 	int m_iXrunCount;
 	int m_iXrunSkip;
 	int m_iXrunTimer;
+	int m_iXrunDumpTimer;
 	int m_iAudioPeakTimer;
+	int m_iAudioStretchTimer;
+	int m_iAudioTranscodeTimer;
 	int m_iAudioRefreshTimer;
 	int m_iMidiRefreshTimer;
 	int m_iPlayerTimer;
 	int m_iAutoSaveTimer;
 	int m_iAutoSavePeriod;
+	int m_iAutoSaveJournalTimer;
+	int m_iAutoSaveJournalDirty;
 	int m_iAudioPropertyChange;
 	int m_iStabilizeTimer;
 
 	qtractorTempoCursor *m_pTempoCursor;
 
+	qtractorSessionJournal *m_pJournal;
+
 	// Status bar item indexes
 	enum {
 		StatusName    = 0,   // Active session track caption.
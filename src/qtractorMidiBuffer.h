@@ -26,10 +26,21 @@
 
 #include <alsa/asoundlib.h>
 
+#include <QAtomicInt>
+
 
 //----------------------------------------------------------------------
 // class qtractorMidiBuffer -- MIDI event FIFO buffer/cache declaration.
 //
+// Single-producer/single-consumer lock-free: the producer only ever
+// writes the write index (release) and the consumer the read index
+// (release); each side acquires the other's index before touching
+// any event slot. Multiple producers must serialize on their own.
+//
+// SysEx events may also get their data copied in-line, right after
+// the event slot itself, so that it lives for as long as the event
+// is buffered (see insertSysex).
+//
 
 class qtractorMidiBuffer
 {
@@ -38,6 +49,9 @@ public:
 	// Minimum buffer size
 	enum { MinBufferSize = 0x400 };
 
+	// In-line SysEx data bytes per slot.
+	enum { SysexSlotSize = sizeof(snd_seq_ev_raw8_t) };
+
 	// Constructor.
 	qtractorMidiBuffer(unsigned int iBufferSize = MinBufferSize) :
 		m_pBuffer(nullptr), m_iBufferSize(0), m_iBufferMask(0),
@@ -57,56 +71,68 @@ public:
 	// Implementation properties.
 	unsigned int bufferSize() const { return m_iBufferSize; }
 
-	// Clears the buffer.
-	void clear() { m_iReadIndex = m_iWriteIndex = 0; }	
+	// Clears the buffer (not concurrent-safe).
+	void clear()
+	{
+		m_iReadIndex.storeRelease(0);
+		m_iWriteIndex.storeRelease(0);
+	}
 
 	// Returns nonzero if there aren't any events available.
-	bool isEmpty() const { return (m_iReadIndex == m_iWriteIndex); }
+	bool isEmpty() const
+		{ return (readIndex() == writeIndex()); }
 
 	// Returns a pointer to the first of the output events. 
 	snd_seq_event_t *peek() const
-		{ return (isEmpty() ? nullptr : &m_pBuffer[m_iReadIndex]); }
+		{ return (isEmpty() ? nullptr : &m_pBuffer[readIndex()]); }
 
-	// Read next event from buffer.
+	// Read next event from buffer (skips any in-line SysEx data).
 	snd_seq_event_t *next()
 	{
-		if (!isEmpty())	++m_iReadIndex &= m_iBufferMask;
+		const unsigned int iReadIndex = readIndex();
+		if (iReadIndex != writeIndex()) {
+			const unsigned int iSlots = slots(&m_pBuffer[iReadIndex]);
+			m_iReadIndex.storeRelease((iReadIndex + iSlots) & m_iBufferMask);
+		}
 		return peek();
 	}
 
 	// Read event from buffer.
 	snd_seq_event_t *pop()
 	{
-		const unsigned int iReadIndex = m_iReadIndex;
-		if (iReadIndex == m_iWriteIndex)
+		const unsigned int iReadIndex = readIndex();
+		if (iReadIndex == writeIndex())
 			return nullptr;
-		m_iReadIndex = (iReadIndex + 1) & m_iBufferMask;
+		m_iReadIndex.storeRelease((iReadIndex + 1) & m_iBufferMask);
 		return &m_pBuffer[iReadIndex];
 	}
 
 	// Write event to buffer.
 	bool push(snd_seq_event_t *pEvent, unsigned long iTick = 0)
 	{
-		const unsigned int iWriteIndex = (m_iWriteIndex + 1) & m_iBufferMask;
-		if (iWriteIndex == m_iReadIndex)
+		const unsigned int iWriteIndex = writeIndex();
+		const unsigned int iWriteNext = (iWriteIndex + 1) & m_iBufferMask;
+		if (iWriteNext == readIndex())
 			return false;
-		m_pBuffer[m_iWriteIndex] = *pEvent;
-		m_pBuffer[m_iWriteIndex].time.tick = iTick;
-		m_iWriteIndex = iWriteIndex;
+		m_pBuffer[iWriteIndex] = *pEvent;
+		m_pBuffer[iWriteIndex].time.tick = iTick;
+		m_iWriteIndex.storeRelease(iWriteNext);
 		return true;
 	}
 
 	// Write event to buffer (ordered).
 	bool insert(snd_seq_event_t *pEvent, unsigned long iTick = 0)
 	{
-		const unsigned int iWriteIndex = (m_iWriteIndex + 1) & m_iBufferMask;
-		if (iWriteIndex == m_iReadIndex)
+		const unsigned int iWriteIndex = writeIndex();
+		const unsigned int iWriteNext = (iWriteIndex + 1) & m_iBufferMask;
+		const unsigned int iReadIndex = readIndex();
+		if (iWriteNext == iReadIndex)
 			return false;
-		unsigned int i = m_iWriteIndex;
+		unsigned int i = iWriteIndex;
 		unsigned int j = i;
 		for (;;) {
 			--i &= m_iBufferMask;
-			if (j == m_iReadIndex
+			if (j == iReadIndex
 				|| iTick >= m_pBuffer[i].time.tick) {
 				m_pBuffer[j] = *pEvent;
 				m_pBuffer[j].time.tick = iTick;
@@ -115,15 +141,104 @@ public:
 			m_pBuffer[j] = m_pBuffer[i];
 			j = i;
 		}
-		m_iWriteIndex = iWriteIndex;
+		m_iWriteIndex.storeRelease(iWriteNext);
 		return true;
 	}
 
+	// Write SysEx event to buffer (ordered), data copied in-line.
+	bool insertSysex(snd_seq_event_t *pEvent, unsigned long iTick = 0)
+	{
+		const unsigned char *pSysex
+			= (const unsigned char *) pEvent->data.ext.ptr;
+		const unsigned int iSysex = pEvent->data.ext.len;
+		if (pSysex == nullptr || iSysex < 1)
+			return false;
+		const unsigned int iSlots
+			= 1 + (iSysex + SysexSlotSize - 1) / SysexSlotSize;
+		if (iSlots > (m_iBufferSize >> 2))
+			return false;
+		const unsigned int iWriteIndex = writeIndex();
+		const unsigned int iReadIndex = readIndex();
+		const unsigned int iCount
+			= (iWriteIndex - iReadIndex) & m_iBufferMask;
+		if (iCount + iSlots >= m_iBufferSize)
+			return false;
+		// Make room, moving later events ahead...
+		unsigned int i = iWriteIndex;
+		while (i != iReadIndex) {
+			const unsigned int k = (i - 1) & m_iBufferMask;
+			if (iTick >= m_pBuffer[k].time.tick)
+				break;
+			m_pBuffer[(k + iSlots) & m_iBufferMask] = m_pBuffer[k];
+			i = k;
+		}
+		// Head event slot (null data pointer means in-line)...
+		snd_seq_event_t *pEv = &m_pBuffer[i];
+		*pEv = *pEvent;
+		pEv->time.tick = iTick;
+		pEv->data.ext.len = iSysex;
+		pEv->data.ext.ptr = nullptr;
+		// Data slots follow, all with the very same time...
+		for (unsigned int n = 0; n < iSysex; n += SysexSlotSize) {
+			++i &= m_iBufferMask;
+			pEv = &m_pBuffer[i];
+			snd_seq_ev_clear(pEv);
+			pEv->time.tick = iTick;
+			const unsigned int iSize = iSysex - n;
+			::memcpy(pEv->data.raw8.d, pSysex + n,
+				iSize < SysexSlotSize ? iSize : SysexSlotSize);
+		}
+		m_iWriteIndex.storeRelease((iWriteIndex + iSlots) & m_iBufferMask);
+		return true;
+	}
+
+	// Copy out in-line SysEx data of the first event, if any.
+	unsigned int peekSysex(unsigned char *pSysex) const
+	{
+		const unsigned int iReadIndex = readIndex();
+		if (iReadIndex == writeIndex())
+			return 0;
+		const snd_seq_event_t *pEv = &m_pBuffer[iReadIndex];
+		if (slots(pEv) < 2)
+			return 0;
+		const unsigned int iSysex = pEv->data.ext.len;
+		unsigned int i = iReadIndex;
+		for (unsigned int n = 0; n < iSysex; n += SysexSlotSize) {
+			++i &= m_iBufferMask;
+			const unsigned int iSize = iSysex - n;
+			::memcpy(pSysex + n, m_pBuffer[i].data.raw8.d,
+				iSize < SysexSlotSize ? iSize : SysexSlotSize);
+		}
+		return iSysex;
+	}
+
+	// Schedule event into a queued/posted buffer pair
+	// (notes with duration get split into note-on/off).
+	static bool queued(qtractorMidiBuffer *pQueued, qtractorMidiBuffer *pPosted,
+		snd_seq_event_t *pEvent, unsigned long iTime, unsigned long iTimeOff = 0)
+	{
+		if (pEvent->type == SND_SEQ_EVENT_NOTE && iTime < iTimeOff) {
+			snd_seq_event_t ev = *pEvent;
+			ev.type = SND_SEQ_EVENT_NOTEON;
+			if (!pQueued->insert(&ev, iTime))
+				return false;
+			ev.type = SND_SEQ_EVENT_NOTEOFF;
+			ev.data.note.velocity = 0;
+			ev.data.note.duration = 0;
+			return pPosted->insert(&ev, iTimeOff);
+		}
+
+		if (pEvent->type == SND_SEQ_EVENT_NOTEOFF)
+			return pPosted->insert(pEvent, iTime);
+		else
+			return pQueued->insert(pEvent, iTime);
+	}
+
 	// Returns number of events currently available.
 	unsigned int count() const
 	{
-		const unsigned int iWriteIndex = m_iWriteIndex;
-		const unsigned int iReadIndex  = m_iReadIndex;
+		const unsigned int iWriteIndex = writeIndex();
+		const unsigned int iReadIndex  = readIndex();
 		if (iWriteIndex > iReadIndex) {
 			return (iWriteIndex - iReadIndex);
 		} else {
@@ -135,27 +250,148 @@ public:
 	snd_seq_event_t *at(unsigned int iIndex) const
 	{
 		const unsigned int iReadIndex
-			= (m_iReadIndex + iIndex) & m_iBufferMask;
+			= (readIndex() + iIndex) & m_iBufferMask;
 		return &m_pBuffer[iReadIndex];
 	}
 
 	// Reset events in buffer.
 	void reset(unsigned long iTick = 0)
 	{
-		unsigned int i = m_iReadIndex;
-		while (i != m_iWriteIndex) {
+		const unsigned int iWriteIndex = writeIndex();
+		unsigned int i = readIndex();
+		while (i != iWriteIndex) {
 			m_pBuffer[i].time.tick = iTick;
 			++i &= m_iBufferMask;
 		}
 	}
 
+protected:
+
+	// Number of slots taken by an event (in-line SysEx data).
+	static unsigned int slots(const snd_seq_event_t *pEv)
+	{
+		if (pEv->type == SND_SEQ_EVENT_SYSEX && pEv->data.ext.ptr == nullptr)
+			return 1 + (pEv->data.ext.len + SysexSlotSize - 1) / SysexSlotSize;
+		else
+			return 1;
+	}
+
+	// Index accessors (acquire).
+	unsigned int readIndex() const
+		{ return (unsigned int) m_iReadIndex.loadAcquire(); }
+	unsigned int writeIndex() const
+		{ return (unsigned int) m_iWriteIndex.loadAcquire(); }
+
 private:
 
 	// Instance variables.
 	snd_seq_event_t *m_pBuffer;
 	unsigned int m_iBufferSize;
 	unsigned int m_iBufferMask;
-	unsigned int m_iWriteIndex;
+	QAtomicInt   m_iWriteIndex;
+	QAtomicInt   m_iReadIndex;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiDirectBuffer -- MIDI event MPSC FIFO declaration.
+//
+// Multiple-producer/single-consumer lock-free: each slot carries its
+// own sequence number; producers claim a slot by compare-and-swap on
+// the write index and then publish it (release) by bumping its sequence,
+// while the consumer (the real-time thread) owns the read index alone.
+// A producer that finds the buffer full just fails, never blocks.
+//
+// SysEx data is not copied (only the event slot itself is).
+//
+
+class qtractorMidiDirectBuffer
+{
+public:
+
+	// Constructor.
+	qtractorMidiDirectBuffer(
+		unsigned int iBufferSize = qtractorMidiBuffer::MinBufferSize) :
+		m_pSlots(nullptr), m_iBufferSize(0), m_iBufferMask(0),
+		m_iWriteIndex(0), m_iReadIndex(0)
+	{
+		// Adjust size to nearest power-of-two, if necessary.
+		m_iBufferSize = qtractorMidiBuffer::MinBufferSize;
+		while (m_iBufferSize < iBufferSize)
+			m_iBufferSize <<= 1;
+		m_iBufferMask = (m_iBufferSize - 1);
+		m_pSlots = new Slot [m_iBufferSize];
+		for (unsigned int i = 0; i < m_iBufferSize; ++i)
+			m_pSlots[i].seq.storeRelease(int(i));
+	}
+
+	// Destructor.
+	~qtractorMidiDirectBuffer() { if (m_pSlots) delete [] m_pSlots; }
+
+	// Implementation properties.
+	unsigned int bufferSize() const { return m_iBufferSize; }
+
+	// Write event to buffer (any thread).
+	bool push(snd_seq_event_t *pEvent, unsigned long iTick = 0)
+	{
+		unsigned int iWriteIndex = (unsigned int) m_iWriteIndex.loadAcquire();
+		for (;;) {
+			Slot *pSlot = &m_pSlots[iWriteIndex & m_iBufferMask];
+			const int iDiff
+				= int((unsigned int) pSlot->seq.loadAcquire() - iWriteIndex);
+			if (iDiff == 0) {
+				if (m_iWriteIndex.testAndSetOrdered(
+						int(iWriteIndex), int(iWriteIndex + 1))) {
+					pSlot->event = *pEvent;
+					pSlot->event.time.tick = iTick;
+					pSlot->seq.storeRelease(int(iWriteIndex + 1));
+					return true;
+				}
+			}
+			else
+			if (iDiff < 0)
+				return false; // Full.
+			iWriteIndex = (unsigned int) m_iWriteIndex.loadAcquire();
+		}
+	}
+
+	// Returns a pointer to the first published event (consumer only).
+	snd_seq_event_t *peek() const
+	{
+		Slot *pSlot = &m_pSlots[m_iReadIndex & m_iBufferMask];
+		const int iDiff = int((unsigned int) pSlot->seq.loadAcquire()
+			- (m_iReadIndex + 1));
+		return (iDiff == 0 ? &pSlot->event : nullptr);
+	}
+
+	// Release the first event and read the next (consumer only).
+	snd_seq_event_t *next()
+	{
+		if (peek()) {
+			Slot *pSlot = &m_pSlots[m_iReadIndex & m_iBufferMask];
+			pSlot->seq.storeRelease(int(m_iReadIndex + m_iBufferSize));
+			++m_iReadIndex;
+		}
+		return peek();
+	}
+
+	// Discards all published events (consumer only).
+	void clear() { while (next()) ; }
+
+private:
+
+	// Event slot.
+	struct Slot
+	{
+		QAtomicInt      seq;
+		snd_seq_event_t event;
+	};
+
+	// Instance variables.
+	Slot        *m_pSlots;
+	unsigned int m_iBufferSize;
+	unsigned int m_iBufferMask;
+	QAtomicInt   m_iWriteIndex;
 	unsigned int m_iReadIndex;
 };
 
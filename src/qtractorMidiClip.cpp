@@ -648,15 +648,37 @@ void qtractorMidiClip::updateEditorEx ( bool bSelectClear )
 }
 
 
+// Sync all ref-counted clip editors, partially (time x note region).
+void qtractorMidiClip::updateEditorRegionEx ( bool bSelectClear,
+	unsigned long iTimeStart, unsigned long iTimeEnd,
+	int iNoteMin, int iNoteMax )
+{
+	if (m_pData == nullptr)
+		return;
+
+	QListIterator<qtractorMidiClip *> iter(m_pData->clips());
+	while (iter.hasNext()) {
+		iter.next()->updateEditorRegion(bSelectClear,
+			iTimeStart, iTimeEnd, iNoteMin, iNoteMax);
+	}
+}
+
+
 // Sync all ref-counted clip-dirtyness.
 void qtractorMidiClip::setDirtyEx ( bool bDirty )
 {
 	if (m_pData == nullptr)
 		return;
 
+	// Sequence has changed: density-map is stale...
+	m_pData->resetDensityMap();
+
 	QListIterator<qtractorMidiClip *> iter(m_pData->clips());
-	while (iter.hasNext())
-		iter.next()->setDirty(bDirty);
+	while (iter.hasNext()) {
+		qtractorMidiClip *pMidiClip = iter.next();
+		pMidiClip->setDirty(bDirty);
+		pMidiClip->updateSerial();
+	}
 }
 
 
@@ -909,6 +931,8 @@ void qtractorMidiClip::open (void)
 {
 	const QString sFilename(filename());
 	openMidiFile(sFilename, m_iTrackChannel);
+
+	updateSerial();
 }
 
 
@@ -1007,8 +1031,8 @@ void qtractorMidiClip::process_export (
 
 
 // MIDI clip paint method.
-void qtractorMidiClip::draw (
-	QPainter *pPainter, const QRect& clipRect, unsigned long iClipOffset )
+void qtractorMidiClip::draw ( QPainter *pPainter, const QRect& clipRect,
+	unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer )
 {
 	qtractorTrack *pTrack = track();
 	if (pTrack == nullptr)
@@ -1052,6 +1076,32 @@ void qtractorMidiClip::draw (
 	const int h2 = (h1 / iNoteSpan) + 1;
 
 	const bool bDrumMode = pTrack->isMidiDrums();
+
+	// Level-of-detail: when there are more visible notes than
+	// they would fit in the visible clip width (a pixel each, or a
+	// diamond each in drum mode), draw a note-range density map...
+	if (!bClipRecord && cw > 0) {
+		const int iNoteWidth = (bDrumMode ? h2 + 2 : 1);
+		const int iNotesMax = cw / iNoteWidth;
+		int iNotes = 0;
+		qtractorMidiEvent *pEvent
+			= m_drawCursor.reset(pSeq, iTimeStart > t0 ? iTimeStart - t0 : 0);
+		while (pEvent && iNotes <= iNotesMax) {
+			const unsigned long t1 = t0 + pEvent->time();
+			if (t1 >= iTimeEnd)
+				break;
+			if (pEvent->type() == qtractorMidiEvent::NOTEON
+				&& t1 + pEvent->duration() > iTimeStart)
+				++iNotes;
+			pEvent = pEvent->next();
+		}
+		if (iNotes > iNotesMax) {
+			drawDensity(pPainter, clipRect, cx, t0, iTimeStart, iTimeEnd,
+				iNoteMin, iNoteSpan, bDrumMode, drawBuffer);
+			return;
+		}
+	}
+
 	QVector<QPoint> diamond;
 	if (bDrumMode) {
 		const int h4 = (h2 >> 1) + 1;
@@ -1105,6 +1155,158 @@ void qtractorMidiClip::draw (
 }
 
 
+// MIDI clip note density-map (re)builder, for a given zoom level
+// (ticks per column); only rebuilt when the sequence has changed.
+const qtractorMidiClip::DensityMap *qtractorMidiClip::densityMap (
+	float fTicks, bool bDrumMode )
+{
+	if (m_pData == nullptr || fTicks <= 0.0f)
+		return nullptr;
+
+	qtractorMidiSequence *pSeq = m_pData->sequence();
+	DensityMap& dmap = m_pData->densityMap();
+
+	if (dmap.ticks == fTicks && dmap.drums == bDrumMode
+		&& dmap.events == pSeq->events().count()
+		&& dmap.duration == pSeq->duration())
+		return &dmap;
+
+	dmap.ticks    = fTicks;
+	dmap.drums    = bDrumMode;
+	dmap.events   = pSeq->events().count();
+	dmap.duration = pSeq->duration();
+	dmap.noteMin  = pSeq->noteMin();
+	dmap.notes    = int(pSeq->noteMax()) - dmap.noteMin + 1;
+	dmap.columns  = int(float(dmap.duration) / fTicks) + 2;
+	if (dmap.notes < 1)
+		dmap.notes = 1;
+
+	dmap.grid.fill(0, dmap.columns * dmap.notes);
+	unsigned char *pGrid = dmap.grid.data();
+
+	qtractorMidiEvent *pEvent = pSeq->events().first();
+	while (pEvent) {
+		if (pEvent->type() == qtractorMidiEvent::NOTEON) {
+			const unsigned long t1 = pEvent->time();
+			const unsigned long t2 = t1 + pEvent->duration();
+			int x1 = int(float(t1) / fTicks);
+			// Drum hits are onsets only, regardless of duration...
+			int x2 = (bDrumMode ? x1 + 1 : int(float(t2) / fTicks));
+			if (x1 >= dmap.columns)
+				x1 = dmap.columns - 1;
+			if (x2 <= x1)
+				x2 = x1 + 1;
+			int iRow = int(pEvent->note()) - dmap.noteMin;
+			if (iRow < 0)
+				iRow = 0;
+			else
+			if (iRow >= dmap.notes)
+				iRow = dmap.notes - 1;
+			unsigned char *pRow = pGrid + iRow * dmap.columns;
+			for (int x = x1; x < x2 && x < dmap.columns; ++x) {
+				if (pRow[x] < 255)
+					++pRow[x];
+			}
+		}
+		pEvent = pEvent->next();
+	}
+
+	return &dmap;
+}
+
+
+// MIDI clip density-map paint method (dense, sub-pixel notes).
+void qtractorMidiClip::drawDensity ( QPainter *pPainter, const QRect& clipRect,
+	int cx, unsigned long t0, unsigned long iTimeStart, unsigned long iTimeEnd,
+	int iNoteMin, int iNoteSpan, bool bDrumMode,
+	qtractorClipDrawBuffer& drawBuffer )
+{
+	qtractorTrack *pTrack = track();
+	qtractorSession *pSession = pTrack->session();
+
+	const int cw = clipRect.width();
+	const int h1 = clipRect.height() - 2;
+	const int h2 = (h1 / iNoteSpan) + 1;
+
+	qtractorTimeScale::Cursor cursor(pSession->timeScale());
+	qtractorTimeScale::Node *pNode = cursor.seekTick(iTimeStart);
+
+	// Precomputed density-map, at the current zoom level...
+	const float fTicks
+		= float(pNode->ticksPerBeat) / float(pNode->pixelsPerBeat());
+	const DensityMap *pDensityMap = densityMap(fTicks, bDrumMode);
+	if (pDensityMap == nullptr)
+		return;
+
+	// Reusable per-view (column x note-row) hit-count grid...
+	QVector<unsigned char>& grid = drawBuffer.grid;
+	const int iGridSize = cw * iNoteSpan;
+	if (grid.size() < iGridSize)
+		grid.resize(iGridSize);
+	unsigned char *pGrid = grid.data();
+	::memset(pGrid, 0, iGridSize);
+
+	// Resample the density-map columns into the view ones...
+	const unsigned char *pMap = pDensityMap->grid.constData();
+	const int iColumns = pDensityMap->columns;
+	for (int x = 0; x < cw; ++x) {
+		pNode = cursor.seekPixel(cx + x);
+		const unsigned long t1 = pNode->tickFromPixel(cx + x);
+		if (t1 >= iTimeEnd)
+			break;
+		if (t1 < t0)
+			continue;
+		const int iColumn = int(float(t1 - t0) / fTicks);
+		if (iColumn >= iColumns)
+			break;
+		for (int i = 0; i < pDensityMap->notes; ++i) {
+			const unsigned char n = pMap[i * iColumns + iColumn];
+			if (n == 0)
+				continue;
+			int iRow = pDensityMap->noteMin + i - iNoteMin;
+			if (iRow < 0)
+				iRow = 0;
+			else
+			if (iRow >= iNoteSpan)
+				iRow = iNoteSpan - 1;
+			unsigned char *pCell = pGrid + iRow * cw + x;
+			*pCell = (int(*pCell) + n < 255 ? *pCell + n : 255);
+		}
+	}
+
+	// Quantize hit-counts into a few intensity levels...
+	static const int c_iLevels = 4;
+	QColor colors[c_iLevels];
+	const QColor& fg = pTrack->foreground();
+	for (int i = 0; i < c_iLevels; ++i) {
+		colors[i] = fg.lighter(100 + 20 * (c_iLevels - i - 1));
+		colors[i].setAlpha(96 + (159 * (i + 1)) / c_iLevels);
+	}
+
+	// Draw merged runs of same intensity, row by row...
+	for (int iRow = 0; iRow < iNoteSpan; ++iRow) {
+		const unsigned char *pRow = pGrid + iRow * cw;
+		const int y = clipRect.bottom() - (h1 * iRow) / iNoteSpan;
+		int x = 0;
+		while (x < cw) {
+			const unsigned char n = pRow[x];
+			if (n == 0) {
+				++x;
+				continue;
+			}
+			const int iLevel = (n < 2 ? 0 : n < 4 ? 1 : n < 8 ? 2 : 3);
+			const int x1 = x;
+			while (++x < cw && pRow[x] > 0) {
+				const unsigned char n2 = pRow[x];
+				if ((n2 < 2 ? 0 : n2 < 4 ? 1 : n2 < 8 ? 2 : 3) != iLevel)
+					break;
+			}
+			pPainter->fillRect(clipRect.x() + x1, y, x - x1, h2, colors[iLevel]);
+		}
+	}
+}
+
+
 // Clip update method. (rolling stats)
 void qtractorMidiClip::update (void)
 {
@@ -1185,6 +1387,28 @@ void qtractorMidiClip::updateEditor ( bool bSelectClear )
 }
 
 
+// Clip editor update, partially (time x note region).
+void qtractorMidiClip::updateEditorRegion ( bool bSelectClear,
+	unsigned long iTimeStart, unsigned long iTimeEnd,
+	int iNoteMin, int iNoteMax )
+{
+	update();
+
+	if (m_pMidiEditorForm == nullptr)
+		return;
+
+	qtractorMidiEditor *pMidiEditor = m_pMidiEditorForm->editor();
+	if (pMidiEditor) {
+		pMidiEditor->reset(false);
+		pMidiEditor->updateContents(
+			iTimeStart, iTimeEnd, iNoteMin, iNoteMax, bSelectClear);
+	}
+
+	m_pMidiEditorForm->resetDirtyCount();
+	m_pMidiEditorForm->stabilizeForm();
+}
+
+
 // Clip editor update.
 void qtractorMidiClip::updateEditorContents (void)
 {
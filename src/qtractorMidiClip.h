@@ -116,8 +116,8 @@ public:
 	void process_export(unsigned long iFrameStart, unsigned long iFrameEnd);
 
 	// Clip paint method.
-	void draw(QPainter *pPainter,
-		const QRect& clipRect, unsigned long iClipOffset);
+	void draw(QPainter *pPainter, const QRect& clipRect,
+		unsigned long iClipOffset, qtractorClipDrawBuffer& drawBuffer);
 
 	// Clip update method (rolling stats).
 	void update();
@@ -125,6 +125,9 @@ public:
 	// Clip editor methods.
 	bool startEditor(QWidget *pParent = nullptr);
 	void updateEditor(bool bSelectClear);
+	void updateEditorRegion(bool bSelectClear,
+		unsigned long iTimeStart, unsigned long iTimeEnd,
+		int iNoteMin, int iNoteMax);
 	void updateEditorContents();
 	bool queryEditor();
 
@@ -150,6 +153,24 @@ public:
 
 	typedef QHash<FileKey, int> FileHash;
 
+	// Note density-map (hit-counts per note-row and tick-column),
+	// valid for one zoom level (ticks per column) and sequence state.
+	struct DensityMap
+	{
+		DensityMap() : ticks(0.0f), drums(false),
+			events(0), duration(0), noteMin(0), notes(0), columns(0) {}
+
+		float         ticks;
+		bool          drums;
+		int           events;
+		unsigned long duration;
+		int           noteMin;
+		int           notes;
+		int           columns;
+
+		QVector<unsigned char> grid;
+	};
+
 	// Most interesting key/data (ref-counted?)...
 	class Key;
 	class Data
@@ -198,6 +219,12 @@ public:
 		void clear()
 			{ m_clips.clear(); }
 
+		// Density-map accessors (shared by all linked clips).
+		DensityMap& densityMap()
+			{ return m_densityMap; }
+		void resetDensityMap()
+			{ m_densityMap = DensityMap(); }
+
 	private:
 
 		// Interesting variables.
@@ -205,6 +232,9 @@ public:
 
 		qtractorMidiSequence *m_pSeq;
 
+		// Note density-map cache.
+		DensityMap m_densityMap;
+
 		// Ref-counting related stuff.
 		QList<qtractorMidiClip *> m_clips;
 	};
@@ -219,6 +249,9 @@ public:
 
 	// Sync all ref-counted clip editors.
 	void updateEditorEx(bool bSelectClear);
+	void updateEditorRegionEx(bool bSelectClear,
+		unsigned long iTimeStart, unsigned long iTimeEnd,
+		int iNoteMin, int iNoteMax);
 
 	// Sync all ref-counted clip-dirtyness.
 	void setDirtyEx(bool bDirty);
@@ -308,6 +341,15 @@ protected:
 	void enqueue_export(qtractorTrack *pTrack,
 		qtractorMidiEvent *pEvent, unsigned long iTime, float fGain) const;
 
+	// Note density-map (re)builder, for a given zoom level.
+	const DensityMap *densityMap(float fTicks, bool bDrumMode);
+
+	// Clip density-map paint method (dense, sub-pixel notes).
+	void drawDensity(QPainter *pPainter, const QRect& clipRect,
+		int cx, unsigned long t0, unsigned long iTimeStart,
+		unsigned long iTimeEnd, int iNoteMin, int iNoteSpan,
+		bool bDrumMode, qtractorClipDrawBuffer& drawBuffer);
+
 private:
 
 	// Instance variables.
@@ -25,6 +25,15 @@
 #include "qtractorMidiEngine.h"
 
 #include "qtractorSession.h"
+#include "qtractorSessionJournal.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+
+// Minimum number of items worth preparing off the GUI thread.
+#define QTRACTOR_MIDI_EDIT_PREPARE_ITEMS 1024
 
 
 //----------------------------------------------------------------------
@@ -35,7 +44,7 @@
 qtractorMidiEditCommand::qtractorMidiEditCommand (
 	qtractorMidiClip *pMidiClip, const QString& sName )
 	: qtractorCommand(sName), m_pMidiClip(pMidiClip), m_bAdjusted(false),
-		m_iDuration((pMidiClip->sequence())->duration())		
+		m_iDuration((pMidiClip->sequence())->duration()), m_iPrepared(0)
 {
 }
 
@@ -43,14 +52,13 @@ qtractorMidiEditCommand::qtractorMidiEditCommand (
 // Destructor.
 qtractorMidiEditCommand::~qtractorMidiEditCommand (void)
 {
-	QListIterator<Item *> iter(m_items);
-	while (iter.hasNext()) {
-		Item *pItem = iter.next();
-		if (pItem->autoDelete)
-			delete pItem->event;
+	QVector<Item>::ConstIterator iter = m_items.constBegin();
+	const QVector<Item>::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		if (iter->autoDelete)
+			delete iter->event;
 	}
 
-	qDeleteAll(m_items);
 	m_items.clear();
 }
 
@@ -58,21 +66,21 @@ qtractorMidiEditCommand::~qtractorMidiEditCommand (void)
 // Primitive command methods.
 void qtractorMidiEditCommand::insertEvent ( qtractorMidiEvent *pEvent )
 {
-	m_items.append(new Item(InsertEvent, pEvent));
+	m_items.append(Item(InsertEvent, pEvent));
 }
 
 
 void qtractorMidiEditCommand::moveEvent ( qtractorMidiEvent *pEvent,
 	int iNote, unsigned long iTime )
 {
-	m_items.append(new Item(MoveEvent, pEvent, iNote, iTime));
+	m_items.append(Item(MoveEvent, pEvent, iNote, iTime));
 }
 
 
 void qtractorMidiEditCommand::resizeEventTime ( qtractorMidiEvent *pEvent,
 	unsigned long iTime, unsigned long iDuration )
 {
-	m_items.append(new Item(ResizeEventTime, pEvent, 0, iTime, iDuration));
+	m_items.append(Item(ResizeEventTime, pEvent, 0, iTime, iDuration));
 }
 
 
@@ -82,13 +90,13 @@ void qtractorMidiEditCommand::resizeEventValue ( qtractorMidiEvent *pEvent,
 	if (pEvent->type() == qtractorMidiEvent::NOTEON && iValue < 1)
 		iValue = 1;	// Avoid zero velocity (aka. NOTEOFF)
 
-	m_items.append(new Item(ResizeEventValue, pEvent, 0, 0, 0, iValue));
+	m_items.append(Item(ResizeEventValue, pEvent, 0, 0, 0, iValue));
 }
 
 
 void qtractorMidiEditCommand::removeEvent ( qtractorMidiEvent *pEvent )
 {
-	m_items.append(new Item(RemoveEvent, pEvent));
+	m_items.append(Item(RemoveEvent, pEvent));
 }
 
 
@@ -96,9 +104,10 @@ void qtractorMidiEditCommand::removeEvent ( qtractorMidiEvent *pEvent )
 bool qtractorMidiEditCommand::findEvent ( qtractorMidiEvent *pEvent,
 	qtractorMidiEditCommand::CommandType cmd ) const
 {
-	QListIterator<Item *> iter(m_items);
-	while (iter.hasNext()) {
-		Item *pItem = iter.next();
+	QVector<Item>::ConstIterator iter = m_items.constBegin();
+	const QVector<Item>::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const Item *pItem = &(*iter);
 		if (pItem->event == pEvent
 			&& (pItem->command == InsertEvent || pItem->command == cmd))
 			return true;
@@ -130,17 +139,20 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 	const unsigned long iOldDuration = pSeq->duration();
 	int iSelectClear = 0;
 
+	// Whether the resulting event order is already prepared...
+	const bool bPrepared = (m_iPrepared == (bRedo ? +1 : -1));
+
 	// Changes are due...
-	QListIterator<Item *> iter(m_items);
-	if (!bRedo)
-		iter.toBack();
-	while (bRedo ? iter.hasNext() : iter.hasPrevious()) {
-		Item *pItem = (bRedo ? iter.next() : iter.previous());
+	const int iItems = m_items.count();
+	for (int i = 0; i < iItems; ++i) {
+		Item *pItem = &m_items[bRedo ? i : iItems - i - 1];
 		qtractorMidiEvent *pEvent = pItem->event;
 		// Execute the command item...
 		switch (pItem->command) {
 		case InsertEvent: {
-			if (bRedo)
+			if (bPrepared)
+				; // Relinked later...
+			else if (bRedo)
 				pSeq->insertEvent(pEvent);
 			else
 				pSeq->unlinkEvent(pEvent);
@@ -151,10 +163,12 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		case MoveEvent: {
 			const int iOldNote = int(pEvent->note());
 			const unsigned long iOldTime = pEvent->time();
-			pSeq->unlinkEvent(pEvent);
+			if (!bPrepared)
+				pSeq->unlinkEvent(pEvent);
 			pEvent->setNote(pItem->note);
 			pEvent->setTime(pItem->time);
-			pSeq->insertEvent(pEvent);
+			if (!bPrepared)
+				pSeq->insertEvent(pEvent);
 			pItem->note = iOldNote;
 			pItem->time = iOldTime;
 			break;
@@ -162,11 +176,13 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		case ResizeEventTime: {
 			const unsigned long iOldTime = pEvent->time();
 			const unsigned long iOldDuration = pEvent->duration();
-			pSeq->unlinkEvent(pEvent);
+			if (!bPrepared)
+				pSeq->unlinkEvent(pEvent);
 			pEvent->setTime(pItem->time);
 			if (pEvent->type() == qtractorMidiEvent::NOTEON)
 				pEvent->setDuration(pItem->duration);
-			pSeq->insertEvent(pEvent);
+			if (!bPrepared)
+				pSeq->insertEvent(pEvent);
 			pItem->time = iOldTime;
 			pItem->duration = iOldDuration;
 			break;
@@ -189,7 +205,9 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 			break;
 		}
 		case RemoveEvent: {
-			if (bRedo)
+			if (bPrepared)
+				; // Relinked later...
+			else if (bRedo)
 				pSeq->unlinkEvent(pEvent);
 			else
 				pSeq->insertEvent(pEvent);
@@ -202,6 +220,18 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		}
 	}
 
+	// Relink the whole prepared order in one go...
+	if (bPrepared) {
+		// Out of the MIDI output thread way, as event links
+		// are all going to be rewritten while it may walk them...
+		if (pSession)
+			pSession->lock();
+		pSeq->relinkEvents(m_prepared);
+		if (pSession)
+			pSession->unlock();
+		unprepare();
+	}
+
 	// It's dirty, definitely...
 	m_pMidiClip->setDirtyEx(true);
 
@@ -225,8 +255,21 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		}
 	}
 
-	// Just reset/update editor internals...
-	m_pMidiClip->updateEditorEx(iSelectClear > 0);
+	// Just reset/update editor internals, partially
+	// whenever the sequence extents are the same...
+	const bool bRegion
+		= (pSeq->duration() == iOldDuration && !m_items.isEmpty());
+	if (bRegion) {
+		unsigned long iTimeStart, iTimeEnd;
+		int iNoteMin, iNoteMax;
+		changeRegion(iTimeStart, iTimeEnd, iNoteMin, iNoteMax);
+		m_pMidiClip->updateEditorRegionEx(iSelectClear > 0,
+			iTimeStart, iTimeEnd, iNoteMin, iNoteMax);
+	}
+	else m_pMidiClip->updateEditorEx(iSelectClear > 0);
+
+	// No need for another complete refresh, if partial...
+	setRefresh(!bRegion);
 
 	// Re-enqueue dropped events...
 	if (pSession && pSession->isPlaying()) {
@@ -381,6 +424,235 @@ bool qtractorMidiEditCommand::adjust (void)
 }
 
 
+// The (time x note) region affected by this command.
+void qtractorMidiEditCommand::changeRegion (
+	unsigned long& iTimeStart, unsigned long& iTimeEnd,
+	int& iNoteMin, int& iNoteMax ) const
+{
+	iTimeStart = (unsigned long) -1;
+	iTimeEnd = 0;
+	iNoteMin = 127;
+	iNoteMax = 0;
+
+	// Union of current and former event extents...
+	QVector<Item>::ConstIterator iter = m_items.constBegin();
+	const QVector<Item>::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const Item *pItem = &(*iter);
+		const qtractorMidiEvent *pEvent = pItem->event;
+		unsigned long t1 = pEvent->time();
+		unsigned long t2 = t1 + pEvent->duration();
+		int n1 = int(pEvent->note());
+		int n2 = n1;
+		if (pItem->command == MoveEvent) {
+			if (t1 > pItem->time)
+				t1 = pItem->time;
+			if (t2 < pItem->time + pEvent->duration())
+				t2 = pItem->time + pEvent->duration();
+			if (n1 > pItem->note)
+				n1 = pItem->note;
+			if (n2 < pItem->note)
+				n2 = pItem->note;
+		}
+		else
+		if (pItem->command == ResizeEventTime) {
+			if (t1 > pItem->time)
+				t1 = pItem->time;
+			if (t2 < pItem->time + pItem->duration)
+				t2 = pItem->time + pItem->duration;
+		}
+		// Non-note events are all across the board...
+		if (pEvent->type() != qtractorMidiEvent::NOTEON &&
+			pEvent->type() != qtractorMidiEvent::KEYPRESS) {
+			n1 = 0;
+			n2 = 127;
+		}
+		if (iTimeStart > t1)
+			iTimeStart = t1;
+		if (iTimeEnd < t2)
+			iTimeEnd = t2;
+		if (iNoteMin > n1)
+			iNoteMin = n1;
+		if (iNoteMax < n2)
+			iNoteMax = n2;
+	}
+}
+
+
+// Heavy event re-ordering preparation (off the GUI thread).
+bool qtractorMidiEditCommand::isPrepare ( bool /*bRedo*/ ) const
+{
+	if (m_items.count() < QTRACTOR_MIDI_EDIT_PREPARE_ITEMS)
+		return false;
+
+	// Never while recording into this very clip...
+	qtractorTrack *pTrack = m_pMidiClip->track();
+	return (pTrack == nullptr || pTrack->clipRecord() != m_pMidiClip);
+}
+
+
+// Simulates the item changes on event time-order only, then merges
+// the moved events back into the untouched ones, just the same as
+// unlinking and inserting each one in turn would do, but without
+// touching the live sequence: that is left to a plain relink pass.
+bool qtractorMidiEditCommand::prepare ( bool bRedo )
+{
+	unprepare();
+
+	qtractorMidiSequence *pSeq = m_pMidiClip->sequence();
+	if (pSeq == nullptr)
+		return false;
+
+	// Moved event (re)insertion state.
+	struct Moved
+	{
+		unsigned long time;
+		int rank;
+		bool linked;
+		qtractorMidiEvent *event;
+		bool operator< (const Moved& other) const
+			{ return (time < other.time
+				|| (time == other.time && rank < other.rank)); }
+	};
+
+	QHash<qtractorMidiEvent *, Moved> moved;
+
+	int iRank = 0;
+	const int iItems = m_items.count();
+	for (int i = 0; i < iItems; ++i) {
+		const Item *pItem = &m_items.at(bRedo ? i : iItems - i - 1);
+		qtractorMidiEvent *pEvent = pItem->event;
+		if (pItem->command == ResizeEventValue)
+			continue;
+		if (isCancel())
+			return false;
+		if (!moved.contains(pEvent)) {
+			Moved& m = moved[pEvent];
+			m.time = pEvent->time();
+			m.rank = 0;
+			m.linked = !((pItem->command == InsertEvent &&  bRedo)
+				|| (pItem->command == RemoveEvent && !bRedo));
+			m.event = pEvent;
+		}
+		Moved& m = moved[pEvent];
+		switch (pItem->command) {
+		case InsertEvent:
+			m.linked = bRedo;
+			m.rank = ++iRank;
+			break;
+		case RemoveEvent:
+			m.linked = !bRedo;
+			m.rank = ++iRank;
+			break;
+		case MoveEvent:
+		case ResizeEventTime:
+			m.time = pItem->time;
+			m.rank = ++iRank;
+			break;
+		default:
+			break;
+		}
+	}
+
+	setProgress(10);
+
+	// Sort the ones left linked...
+	QVector<Moved> sorted;
+	sorted.reserve(moved.count());
+	QHash<qtractorMidiEvent *, Moved>::ConstIterator it = moved.constBegin();
+	const QHash<qtractorMidiEvent *, Moved>::ConstIterator& it_end = moved.constEnd();
+	for ( ; it != it_end; ++it) {
+		if (it.value().linked)
+			sorted.append(it.value());
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	if (isCancel())
+		return false;
+
+	setProgress(20);
+
+	// Merge with the untouched ones, in current order...
+	const int iEvents = pSeq->events().count();
+	m_prepared.reserve(iEvents + sorted.count());
+
+	int i = 0, j = 0;
+	const int iSorted = sorted.count();
+	qtractorMidiEvent *pEvent = pSeq->events().first();
+	while (pEvent) {
+		if (!moved.contains(pEvent)) {
+			while (j < iSorted && sorted.at(j).time < pEvent->time())
+				m_prepared.append(sorted.at(j++).event);
+			m_prepared.append(pEvent);
+		}
+		if ((++i & 0x3ff) == 0) {
+			if (isCancel()) {
+				m_prepared.clear();
+				return false;
+			}
+			setProgress(20 + (80 * i) / (iEvents + 1));
+		}
+		pEvent = pEvent->next();
+	}
+	while (j < iSorted)
+		m_prepared.append(sorted.at(j++).event);
+
+	setProgress(100);
+
+	m_iPrepared = (bRedo ? +1 : -1);
+
+	return true;
+}
+
+
+// Approximate memory held by this command.
+unsigned long qtractorMidiEditCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize()
+		+ sizeof(*this) - sizeof(qtractorCommand)
+		+ m_items.capacity() * sizeof(Item)
+		+ m_prepared.capacity() * sizeof(qtractorMidiEvent *);
+
+	// Events owned (removed or not inserted) are ours too...
+	QVector<Item>::ConstIterator iter = m_items.constBegin();
+	const QVector<Item>::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		if (iter->autoDelete) {
+			const qtractorMidiEvent *pEvent = iter->event;
+			iMemorySize += sizeof(qtractorMidiEvent);
+			if (pEvent->type() == qtractorMidiEvent::SYSEX)
+				iMemorySize += pEvent->sysex_len();
+		}
+	}
+
+	return iMemorySize;
+}
+
+
+// Release spare item capacity, once in history.
+void qtractorMidiEditCommand::compact (void)
+{
+	m_items.squeeze();
+}
+
+
+// Session journal delta: this very clip contents.
+bool qtractorMidiEditCommand::journal ( qtractorSessionJournal *pJournal ) const
+{
+	pJournal->touch(m_pMidiClip);
+
+	return true;
+}
+
+
+// Discard any prepared data.
+void qtractorMidiEditCommand::unprepare (void)
+{
+	m_prepared.clear();
+	m_iPrepared = 0;
+}
+
+
 // Virtual command methods.
 bool qtractorMidiEditCommand::redo (void)
 {
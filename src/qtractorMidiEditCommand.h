@@ -27,6 +27,7 @@
 #include "qtractorMidiEvent.h"
 
 #include <QList>
+#include <QVector>
 
 
 // Forward declarations.
@@ -75,6 +76,18 @@ public:
 	bool redo();
 	bool undo();
 
+	// Heavy event re-ordering preparation (off the GUI thread).
+	bool isPrepare(bool bRedo) const;
+	bool prepare(bool bRedo);
+	void unprepare();
+
+	// Undo history memory accounting.
+	unsigned long memorySize() const;
+	void compact();
+
+	// Session journal delta.
+	bool journal(qtractorSessionJournal *pJournal) const;
+
 	// Adjust edit-command result to prevent event overlapping.
 	bool adjust();
 
@@ -83,36 +96,46 @@ protected:
 	// Common executive method.
 	bool execute(bool bRedo);
 
+	// The (time x note) region affected by this command.
+	void changeRegion(unsigned long& iTimeStart, unsigned long& iTimeEnd,
+		int& iNoteMin, int& iNoteMax) const;
+
 private:
 
-	// Event item struct.
+	// Event item struct (packed by value, delta only).
 	struct Item
 	{
 		// Item constructor.
-		Item(CommandType cmd, qtractorMidiEvent *pEvent, int iNote = 0,
+		Item(CommandType cmd = InsertEvent,
+			qtractorMidiEvent *pEvent = nullptr, int iNote = 0,
 			unsigned long iTime = 0, unsigned long iDuration = 0,
 			unsigned int iValue = 0)
-			: command(cmd), event(pEvent), note(iNote),
-				time(iTime), duration(iDuration), value(iValue),
+			: event(pEvent), time(iTime), duration(iDuration),
+				note(iNote), value(iValue), command(cmd),
 				autoDelete(false) {}
 		// Item members.
-		CommandType        command;
 		qtractorMidiEvent *event;
-		int                note;
 		unsigned long      time;
 		unsigned long      duration;
+		int                note;
 		int                value;
+		CommandType        command;
 		bool               autoDelete;
 	};
 
 	// Instance variables.
 	qtractorMidiClip *m_pMidiClip;
 
-	QList<Item *> m_items;
+	QVector<Item> m_items;
 
 	bool m_bAdjusted;
 
 	unsigned long m_iDuration;
+
+	// Prepared resulting event order (1=redo, -1=undo).
+	QVector<qtractorMidiEvent *> m_prepared;
+
+	int m_iPrepared;
 };
 
 
@@ -0,0 +1,141 @@
+// qtractorMidiEditIndex.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorMidiEditIndex.h"
+#include "qtractorMidiSequence.h"
+
+
+//-------------------------------------------------------------------------
+// qtractorMidiEditIndex -- MIDI event spatial (time x note) index.
+
+// Constructor.
+qtractorMidiEditIndex::qtractorMidiEditIndex (void)
+	: m_pSeq(nullptr), m_eventType(qtractorMidiEvent::NOTEON),
+		m_iEventCount(0), m_iDuration(0), m_bValid(false)
+{
+}
+
+
+// Whether the index is current.
+bool qtractorMidiEditIndex::isValid ( qtractorMidiSequence *pSeq,
+	qtractorMidiEvent::EventType eventType ) const
+{
+	return m_bValid
+		&& m_pSeq == pSeq
+		&& m_eventType == eventType
+		&& m_iEventCount == pSeq->events().count()
+		&& m_iDuration == pSeq->duration();
+}
+
+
+// Force a rebuild on next update.
+void qtractorMidiEditIndex::reset (void)
+{
+	m_bValid = false;
+}
+
+
+// (Re)build the index, only if stale.
+void qtractorMidiEditIndex::update ( qtractorMidiSequence *pSeq,
+	qtractorMidiEvent::EventType eventType )
+{
+	if (pSeq == nullptr || isValid(pSeq, eventType))
+		return;
+
+	for (int i = 0; i < 128; ++i) {
+		m_rows[i].items.resize(0);
+		m_rows[i].maxEnds.resize(0);
+	}
+
+	// Sequence events are already time sorted...
+	qtractorMidiEvent *pEvent = pSeq->events().first();
+	while (pEvent) {
+		if (pEvent->type() == eventType) {
+			Row& row = m_rows[pEvent->note() & 0x7f];
+			Item item;
+			item.time = pEvent->time();
+			item.timeEnd = item.time + pEvent->duration();
+			item.event = pEvent;
+			const unsigned long iMaxEnd = (row.maxEnds.isEmpty()
+				? item.timeEnd : qMax(row.maxEnds.last(), item.timeEnd));
+			row.items.append(item);
+			row.maxEnds.append(iMaxEnd);
+		}
+		pEvent = pEvent->next();
+	}
+
+	m_pSeq = pSeq;
+	m_eventType = eventType;
+	m_iEventCount = pSeq->events().count();
+	m_iDuration = pSeq->duration();
+
+	m_bValid = true;
+}
+
+
+// Region query.
+const QVector<qtractorMidiEvent *>& qtractorMidiEditIndex::events (
+	int iNoteMin, int iNoteMax,
+	unsigned long iTimeStart, unsigned long iTimeEnd )
+{
+	m_events.resize(0);
+
+	if (!m_bValid)
+		return m_events;
+
+	if (iNoteMin < 0)
+		iNoteMin = 0;
+	if (iNoteMax > 127)
+		iNoteMax = 127;
+
+	for (int iNote = iNoteMin; iNote <= iNoteMax; ++iNote) {
+		const Row& row = m_rows[iNote];
+		const int iCount = row.items.count();
+		if (iCount < 1)
+			continue;
+		// Binary search the first item that might still
+		// be reaching the start (running max end-time)...
+		const unsigned long *pMaxEnds = row.maxEnds.constData();
+		int lo = 0;
+		int hi = iCount;
+		while (lo < hi) {
+			const int mid = (lo + hi) >> 1;
+			if (pMaxEnds[mid] < iTimeStart)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		// Collect the overlapping ones...
+		const Item *pItems = row.items.constData();
+		for (int i = lo; i < iCount; ++i) {
+			const Item& item = pItems[i];
+			if (item.time >= iTimeEnd)
+				break;
+			if (item.timeEnd >= iTimeStart)
+				m_events.append(item.event);
+		}
+	}
+
+	return m_events;
+}
+
+
+// end of qtractorMidiEditIndex.cpp
@@ -0,0 +1,98 @@
+// qtractorMidiEditIndex.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorMidiEditIndex_h
+#define __qtractorMidiEditIndex_h
+
+#include "qtractorMidiEvent.h"
+
+#include <QVector>
+
+// Forward declarations.
+class qtractorMidiSequence;
+
+
+//-------------------------------------------------------------------------
+// qtractorMidiEditIndex -- MIDI event spatial (time x note) index.
+
+class qtractorMidiEditIndex
+{
+public:
+
+	// Constructor.
+	qtractorMidiEditIndex();
+
+	// (Re)build the index, only if stale.
+	void update(qtractorMidiSequence *pSeq,
+		qtractorMidiEvent::EventType eventType);
+
+	// Force a rebuild on next update.
+	void reset();
+
+	// Whether the index is current.
+	bool isValid(qtractorMidiSequence *pSeq,
+		qtractorMidiEvent::EventType eventType) const;
+
+	// Region query: all events on notes [iNoteMin, iNoteMax]
+	// overlapping the [iTimeStart, iTimeEnd) sequence time-span,
+	// in note-row, then time order.
+	const QVector<qtractorMidiEvent *>& events(
+		int iNoteMin, int iNoteMax,
+		unsigned long iTimeStart, unsigned long iTimeEnd);
+
+private:
+
+	// Interval item.
+	struct Item
+	{
+		unsigned long time;
+		unsigned long timeEnd;
+		qtractorMidiEvent *event;
+	};
+
+	// Note-row interval list, sorted by start time,
+	// with a running maximum of end times for lookup.
+	struct Row
+	{
+		QVector<Item> items;
+		QVector<unsigned long> maxEnds;
+	};
+
+	// Instance variables.
+	Row m_rows[128];
+
+	qtractorMidiSequence *m_pSeq;
+	qtractorMidiEvent::EventType m_eventType;
+
+	int           m_iEventCount;
+	unsigned long m_iDuration;
+
+	bool m_bValid;
+
+	// Reusable query result.
+	QVector<qtractorMidiEvent *> m_events;
+};
+
+
+#endif  // __qtractorMidiEditIndex_h
+
+
+// end of qtractorMidiEditIndex.h
@@ -53,10 +53,13 @@ qtractorMidiEditSelect::Item *qtractorMidiEditSelect::findItem (
 void qtractorMidiEditSelect::addItem ( qtractorMidiEvent *pEvent,
 	const QRect& rectEvent, const QRect& rectView, unsigned long iDeltaTime )
 {
-	m_items.insert(pEvent, new Item(rectEvent, rectView, iDeltaTime));
+	Item *pItem = new Item(rectEvent, rectView, iDeltaTime);
+	m_items.insert(pEvent, pItem);
 
 	m_rectEvent = m_rectEvent.united(rectEvent);
 	m_rectView = m_rectView.united(rectView);
+
+	changeItem(pEvent, pItem);
 }
 
 
@@ -75,47 +78,117 @@ void qtractorMidiEditSelect::selectItem ( qtractorMidiEvent *pEvent,
 		if ( ( bSelect && (flags & 2) == 0) ||
 			((!bSelect && (flags & 3) == 2) && bToggle))
 			pItem->flags |=  1;
+		if ((pItem->flags ^ flags) & 1)
+			changeItem(pEvent, pItem);
 	} 
 	else if (bSelect)
 		addItem(pEvent, rectEvent, rectView);
 }
 
 
-// Selection commit method.
-void qtractorMidiEditSelect::update ( bool bCommit )
+// Mark an item as changed since last update.
+void qtractorMidiEditSelect::changeItem (
+	qtractorMidiEvent *pEvent, Item *pItem )
 {
-	// Remove unselected...
-	int iUpdate = 0;
+	if ((pItem->flags & 8) == 0) {
+		pItem->flags |= 8;
+		m_changed.append(pEvent);
+	}
+}
 
-	m_pAnchorEvent = nullptr;
 
-	ItemList::Iterator iter = m_items.begin();
-	const ItemList::Iterator& iter_end = m_items.end();
-	while (iter != iter_end) {
-		Item *pItem = iter.value();
-		if (bCommit) {
+// Whether removing a rectangle might shrink the united one.
+static inline bool qtractorMidiEditSelect_shrink (
+	const QRect& rectUnited, const QRect& rect )
+{
+	return !rect.isEmpty()
+		&& !rectUnited.adjusted(1, 1, -1, -1).contains(rect);
+}
+
+
+// Selection commit method.
+void qtractorMidiEditSelect::update ( bool bCommit )
+{
+	// Full commit: remove unselected, all over...
+	if (bCommit) {
+		int iUpdate = 0;
+		ItemList::Iterator iter = m_items.begin();
+		const ItemList::Iterator& iter_end = m_items.end();
+		while (iter != iter_end) {
+			Item *pItem = iter.value();
+			pItem->flags &= ~8;
 			if (pItem->flags & 1)
 				pItem->flags |=  2;
 			else
 				pItem->flags &= ~2;
+			if ((pItem->flags & 3) == 0) {
+				delete pItem;
+				iter = m_items.erase(iter);
+				++iUpdate;
+			}
+			else ++iter;
 		}
+		m_changed.clear();
+		// Did we remove any?
+		if (iUpdate > 0)
+			commit();
+		updateAnchor();
+		return;
+	}
+
+	// Incremental: just visit the ones changed since last time...
+	bool bShrink = false;
+
+	QListIterator<qtractorMidiEvent *> iter(m_changed);
+	while (iter.hasNext()) {
+		qtractorMidiEvent *pEvent = iter.next();
+		Item *pItem = m_items.value(pEvent, nullptr);
+		if (pItem == nullptr)
+			continue;
+		pItem->flags &= ~8;
 		if (pItem->flags & 1) {
-			qtractorMidiEvent *pEvent = iter.key();
+			m_rectEvent = m_rectEvent.united(pItem->rectEvent);
+			m_rectView  = m_rectView.united(pItem->rectView);
 			if (m_pAnchorEvent == nullptr ||
 				m_pAnchorEvent->time() > pEvent->time())
 				m_pAnchorEvent = pEvent;
+		} else {
+			if (m_pAnchorEvent == pEvent
+				|| qtractorMidiEditSelect_shrink(m_rectEvent, pItem->rectEvent)
+				|| qtractorMidiEditSelect_shrink(m_rectView, pItem->rectView))
+				bShrink = true;
+			if ((pItem->flags & 3) == 0) {
+				m_items.remove(pEvent);
+				delete pItem;
+			}
 		}
-		if ((pItem->flags & 3) == 0) {
-			delete pItem;
-			iter = m_items.erase(iter);
-			++iUpdate;
-		}
-		else ++iter;
 	}
 
-	// Did we remove any?
-	if (iUpdate > 0)
+	m_changed.clear();
+
+	// Did we remove any from the edges?
+	if (bShrink) {
 		commit();
+		updateAnchor();
+	}
+}
+
+
+// Most probable anchor event (re)scan.
+void qtractorMidiEditSelect::updateAnchor (void)
+{
+	m_pAnchorEvent = nullptr;
+
+	ItemList::ConstIterator iter = m_items.constBegin();
+	const ItemList::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		if (iter.value()->flags & 1) {
+			qtractorMidiEvent *pEvent = iter.key();
+			if (m_pAnchorEvent == nullptr ||
+				m_pAnchorEvent->time() > pEvent->time())
+				m_pAnchorEvent = pEvent;
+		}
+	}
 }
 
 
@@ -147,6 +220,8 @@ void qtractorMidiEditSelect::clear (void)
 	qDeleteAll(m_items);
 	m_items.clear();
 
+	m_changed.clear();
+
 	m_pAnchorEvent = nullptr;
 }
 
@@ -23,6 +23,7 @@
 #define __qtractorMidiEditSelect_h
 
 #include <QHash>
+#include <QList>
 #include <QRect>
 
 // Forward declarations.
@@ -42,7 +43,8 @@ public:
 	// Default destructor.
 	~qtractorMidiEditSelect();
 
-	// Selection item struct.
+	// Selection item struct
+	// (flags: 1=selected, 2=committed, 8=changed).
 	struct Item
 	{
 		// Item constructor.
@@ -95,6 +97,14 @@ public:
 
 	qtractorMidiEvent *anchorEvent() const { return m_pAnchorEvent; }
 	
+protected:
+
+	// Mark an item as changed since last update.
+	void changeItem(qtractorMidiEvent *pEvent, Item *pItem);
+
+	// Most probable anchor event (re)scan.
+	void updateAnchor();
+
 private:
 
 	// The clip selection list.
@@ -106,6 +116,9 @@ private:
 
 	// The most probable anchor event.
 	qtractorMidiEvent *m_pAnchorEvent;
+
+	// Items changed since last update.
+	QList<qtractorMidiEvent *> m_changed;
 };
 
 
@@ -188,9 +188,12 @@ void qtractorMidiEditView::updateContentsWidth ( int iContentsWidth )
 // Local rectangular contents update.
 void qtractorMidiEditView::updateContents ( const QRect& rect )
 {
-	updatePixmap(
-		qtractorScrollView::contentsX(),
-		qtractorScrollView::contentsY());
+	// Redraw just the dirty region (viewport coordinates)...
+	const int cx = qtractorScrollView::contentsX();
+	const int cy = qtractorScrollView::contentsY();
+
+	updatePixmapRect(cx, cy,
+		QRect(rect.x() - cx, rect.y() - cy, rect.width(), rect.height()));
 
 	qtractorScrollView::updateContents(rect);
 }
@@ -207,6 +210,13 @@ void qtractorMidiEditView::updateContents (void)
 }
 
 
+// Event spatial index reset (on sequence changes).
+void qtractorMidiEditView::resetEventIndex (void)
+{
+	m_index.reset();
+}
+
+
 // Current event selection accessors.
 void qtractorMidiEditView::setEventType (
 	qtractorMidiEvent::EventType eventType )
@@ -310,6 +320,13 @@ void qtractorMidiEditView::resizeEvent ( QResizeEvent *pResizeEvent )
 
 // (Re)create the complete track view pixmap.
 void qtractorMidiEditView::updatePixmap ( int cx, int cy )
+{
+	updatePixmapRect(cx, cy, QRect());
+}
+
+
+// (Re)draw a (partial) track view pixmap region.
+void qtractorMidiEditView::updatePixmapRect ( int cx, int cy, const QRect& rect )
 {
 	QWidget *pViewport = qtractorScrollView::viewport();
 	const int w = pViewport->width();
@@ -325,8 +342,26 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 	const QColor& rgbDark  = rgbBase.darker(110);
 	const bool bDark = (rgbBase.value() < 128);
 
-	m_pixmap = QPixmap(w, h);
-	m_pixmap.fill(rgbBase);
+	// A partial update only applies to the very same pixmap,
+	// otherwise it's a complete (re)creation...
+	QRect rectDirty(0, 0, w, h);
+	const bool bPartial = (rect.isValid()
+		&& m_pixmap.width() == w && m_pixmap.height() == h
+		&& m_posPixmap == QPoint(cx, cy));
+	if (bPartial) {
+		rectDirty = rectDirty.intersected(rect);
+		if (rectDirty.isEmpty())
+			return;
+	} else {
+		m_pixmap = QPixmap(w, h);
+		m_posPixmap = QPoint(cx, cy);
+	}
+
+	QPainter painter(&m_pixmap);
+//	painter.initFrom(this);
+	if (bPartial)
+		painter.setClipRect(rectDirty);
+	painter.fillRect(rectDirty, rgbBase);
 
 	qtractorSession *pSession = qtractorSession::getInstance();
 	if (pSession == nullptr)
@@ -336,8 +371,6 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 	if (pTimeScale == nullptr)
 		return;
 
-	QPainter painter(&m_pixmap);
-//	painter.initFrom(this);
 	painter.setFont(qtractorScrollView::font());
 
 	// Show that we may have clip limits...
@@ -494,9 +527,20 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 	if (pSeq == nullptr)
 		return;
 
-	pNode = cursor.seekPixel(x = dx);
+	// Partial updates only need the dirty horizontal span
+	// (widened for the drum-mode diamonds)...
+	int x1 = 0;
+	int x2 = w;
+	if (bPartial) {
+		x1 = rectDirty.left() - h1;
+		x2 = rectDirty.right() + h1 + 1;
+		if (x1 + dx < 0)
+			x1 = -dx;
+	}
+
+	pNode = cursor.seekPixel(x = dx + x1);
 	const unsigned long iTickStart = pNode->tickFromPixel(x);
-	pNode = cursor.seekPixel(x += w);
+	pNode = cursor.seekPixel(x = dx + x2);
 	const unsigned long iTickEnd = pNode->tickFromPixel(x);
 
 	const unsigned long f1 = f0 + m_pEditor->length();
@@ -506,7 +550,7 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 	// Draw ghost-track events in dimmed transparecncy (alpha=55)...
 	qtractorTrack *pTrack = m_pEditor->ghostTrack();
 	if (pTrack) {
-		// Don't draw beyhond the right-most position (x = dx + w)...
+		// Don't draw beyhond the right-most position (x = dx + x2)...
 		const unsigned long f2 = pTimeScale->frameFromPixel(x);
 		const bool bDrumMode = pTrack->isMidiDrums();
 		qtractorClip *pClip = pTrack->clips().first();
@@ -525,7 +569,7 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 				const unsigned long t1 = pNode->tickFromFrame(iClipStart);
 				pNode = cursor.seekFrame(iClipEnd);
 				const unsigned long t2 = pNode->tickFromFrame(iClipEnd);
-				drawEvents(painter, dx, cy, pMidiClip->sequence(),
+				drawEvents(painter, rectDirty, dx, cy, pMidiClip->sequence(),
 					t1, iTickStart, iTickEnd, t2, bDrumMode,
 					pTrack->foreground(), pTrack->background(), 55);
 			}
@@ -535,10 +579,12 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 		m_pEditor->reset(false);
 	}
 
-	// Draw actual events in full brightness (alpha=255)...
-	drawEvents(painter, dx, cy, pSeq,
+	// Draw actual events in full brightness (alpha=255),
+	// looked up through the spatial index unless recording...
+	drawEvents(painter, rectDirty, dx, cy, pSeq,
 		t0, iTickStart, iTickEnd, iTickEnd2, m_pEditor->isDrumMode(),
-		m_pEditor->foreground(), m_pEditor->background());
+		m_pEditor->foreground(), m_pEditor->background(), 255,
+		m_pEditor->isClipRecord() ? nullptr : &m_index);
 
 	// Draw loop boundaries, if applicable...
 	if (pSession->isLooping()) {
@@ -588,12 +634,12 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 
 // Draw the track view events.
 void qtractorMidiEditView::drawEvents ( QPainter& painter,
-	int dx, int dy, qtractorMidiSequence *pSeq, unsigned long t0,
-	unsigned long iTickStart, unsigned long iTickEnd,
+	const QRect& rect, int dx, int dy, qtractorMidiSequence *pSeq,
+	unsigned long t0, unsigned long iTickStart, unsigned long iTickEnd,
 	unsigned long iTickEnd2, bool bDrumMode,
-	const QColor& fore, const QColor& back, int alpha )
+	const QColor& fore, const QColor& back, int alpha,
+	qtractorMidiEditIndex *pIndex )
 {
-	const int h  = qtractorScrollView::viewport()->height();
 	const int h1 = m_pEditor->editList()->itemHeight();
 	const int ch = qtractorScrollView::contentsHeight() - dy;
 
@@ -626,19 +672,44 @@ void qtractorMidiEditView::drawEvents ( QPainter& painter,
 
 	const qtractorMidiEvent::EventType eventType = m_eventType;
 
-	qtractorMidiEvent *pEvent
-		= m_pEditor->seekEvent(pSeq, iTickStart > t0 ? iTickStart - t0 : 0);
-	while (pEvent) {
+	// Vertical extents, as seen by the note rows...
+	const int y1 = rect.top() - h1 - 2;
+	const int y2 = rect.bottom() + h1 + 2;
+
+	// Gather all candidate events, either from the
+	// spatial index (time x note) or linearly (time)...
+	const QVector<qtractorMidiEvent *> *pEvents = &m_events;
+	if (pIndex) {
+		pIndex->update(pSeq, eventType);
+		const int iNoteMin = (ch - y2) / h1 - 1;
+		const int iNoteMax = (ch - y1) / h1;
+		pEvents = &pIndex->events(iNoteMin, iNoteMax,
+			iTickStart > t0 ? iTickStart - t0 : 0,
+			iTickEnd   > t0 ? iTickEnd   - t0 : 0);
+	} else {
+		m_events.resize(0);
+		qtractorMidiEvent *pEvent
+			= m_pEditor->seekEvent(pSeq, iTickStart > t0 ? iTickStart - t0 : 0);
+		while (pEvent) {
+			if (t0 + pEvent->time() >= iTickEnd)
+				break;
+			if (pEvent->type() == eventType)
+				m_events.append(pEvent);
+			pEvent = pEvent->next();
+		}
+	}
+
+	const int iEvents = pEvents->count();
+	for (int i = 0; i < iEvents; ++i) {
+		qtractorMidiEvent *pEvent = pEvents->at(i);
 		const unsigned long t1 = t0 + pEvent->time();
-		if (t1 >= iTickEnd)
-			break;
 		unsigned long t2 = t1 + pEvent->duration();
 		if (t2 > iTickEnd2)
 			t2 = iTickEnd2;
-		// Filter event type!...
-		if (pEvent->type() == eventType && t2 >= iTickStart) {
+		// Filter event span!...
+		if (t2 >= iTickStart) {
 			y = ch - h1 * (pEvent->note() + 1);
-			if (y + h1 >= 0 && y < h) {
+			if (y >= y1 && y <= y2) {
 				pNode = cursor.seekTick(t1);
 				x = pNode->pixelFromTick(t1) - dx;
 				pNode = cursor.seekTick(t2);
@@ -679,7 +750,6 @@ void qtractorMidiEditView::drawEvents ( QPainter& painter,
 				}
 			}
 		}
-		pEvent = pEvent->next();
 	}
 
 	if (bDrumMode)
@@ -25,6 +25,7 @@
 #include "qtractorScrollView.h"
 
 #include "qtractorMidiEvent.h"
+#include "qtractorMidiEditIndex.h"
 
 #include <QPixmap>
 #include <QBrush>
@@ -64,6 +65,9 @@ public:
 	void updateContents(const QRect& rect);
 	void updateContents();
 
+	// Event spatial index reset (on sequence changes).
+	void resetEventIndex();
+
 	// Current event selection accessors.
 	void setEventType(qtractorMidiEvent::EventType eventType);
 	qtractorMidiEvent::EventType eventType() const;
@@ -85,11 +89,15 @@ protected:
 	void resizeEvent(QResizeEvent *pResizeEvent);
 
 	// Draw the track view events.
-	void drawEvents(QPainter& painter, int dx, int dy,
+	void drawEvents(QPainter& painter, const QRect& rect, int dx, int dy,
 		qtractorMidiSequence *pSeq, unsigned long t0,
 		unsigned long iTickStart, unsigned long iTickEnd,
 		unsigned long iTickEnd2, bool bDrumMode,
-		const QColor& fore, const QColor& back, int alpha = 255);
+		const QColor& fore, const QColor& back, int alpha = 255,
+		qtractorMidiEditIndex *pIndex = nullptr);
+
+	// (Re)draw a (partial) track view pixmap region.
+	void updatePixmapRect(int cx, int cy, const QRect& rect);
 
 	// Draw the track view
 	void drawContents(QPainter *pPainter, const QRect& rect);
@@ -132,6 +140,13 @@ private:
 
 	// Local double-buffering pixmap.
 	QPixmap m_pixmap;
+	QPoint  m_posPixmap;
+
+	// Event spatial (time x note) index.
+	qtractorMidiEditIndex m_index;
+
+	// Reusable event drawing list.
+	QVector<qtractorMidiEvent *> m_events;
 
 	// Current selection holder.
 	qtractorMidiEvent::EventType m_eventType;
@@ -2194,6 +2194,20 @@ void qtractorMidiEditor::clearSelect (void)
 
 // Update all selection rectangular areas.
 void qtractorMidiEditor::updateSelect ( bool bSelectReset )
+{
+	updateSelectRegion(0, (unsigned long) -1, 0, 127);
+
+	if (bSelectReset) {
+		m_rectDrag = m_select.rectView();
+		m_posDrag  = m_rectDrag.topLeft();
+		resetDragState(nullptr);
+	}
+}
+
+
+// Update selection rectangular areas, in (time x note) region only.
+void qtractorMidiEditor::updateSelectRegion (
+	unsigned long iTimeStart, unsigned long iTimeEnd, int iNoteMin, int iNoteMax )
 {
 	qtractorTimeScale::Cursor cursor(m_pTimeScale);
 	qtractorTimeScale::Node *pNode = cursor.seekFrame(m_iOffset);
@@ -2217,6 +2231,16 @@ void qtractorMidiEditor::updateSelect ( bool bSelectReset )
 	for ( ; iter != iter_end; ++iter) {
 		qtractorMidiEvent *pEvent = iter.key();
 		qtractorMidiEditSelect::Item *pItem = iter.value();
+		// Skip the ones off the region, as left unchanged...
+		const qtractorMidiEvent::EventType etype = pEvent->type();
+		if (pEvent->time() > iTimeEnd
+			|| pEvent->time() + pEvent->duration() < iTimeStart)
+			continue;
+		if ((etype == qtractorMidiEvent::NOTEON ||
+			 etype == qtractorMidiEvent::KEYPRESS) &&
+			(int(pEvent->note()) < iNoteMin ||
+			 int(pEvent->note()) > iNoteMax))
+			continue;
 		// Common event coords...
 		int y;
 		const unsigned long t1 = t0 + pEvent->time();
@@ -2228,7 +2252,6 @@ void qtractorMidiEditor::updateSelect ( bool bSelectReset )
 		if (w1 < 5)
 			w1 = 5;
 		// View item...
-		const qtractorMidiEvent::EventType etype = pEvent->type();
 		if (etype == m_pEditView->eventType()) {
 			y = ch - h1 * (pEvent->note() + 1);
 			if (m_bDrumMode)
@@ -2265,12 +2288,6 @@ void qtractorMidiEditor::updateSelect ( bool bSelectReset )
 
 	// Final touch.
 	m_select.commit();
-
-	if (bSelectReset) {
-		m_rectDrag = m_select.rectView();
-		m_posDrag  = m_rectDrag.topLeft();
-		resetDragState(nullptr);
-	}
 }
 
 
@@ -2465,6 +2482,9 @@ void qtractorMidiEditor::removeEditRange (void)
 // Update/sync integral contents.
 void qtractorMidiEditor::updateContents (void)
 {
+	// Sequence might have changed...
+	m_pEditView->resetEventIndex();
+
 	// Update dependent views.
 	m_pEditList->updateContentsHeight();
 	m_pEditView->updateContentsWidth();
@@ -2481,6 +2501,55 @@ void qtractorMidiEditor::updateContents (void)
 }
 
 
+// Update/sync a partial (sequence time x note) region of contents.
+void qtractorMidiEditor::updateContents (
+	unsigned long iTimeStart, unsigned long iTimeEnd,
+	int iNoteMin, int iNoteMax, bool bSelectClear )
+{
+	// Sequence have changed, surely...
+	m_pEditView->resetEventIndex();
+
+	if (bSelectClear)
+		clearSelect();
+
+	// Update the affected selection items only...
+	QRect rectUpdateView(m_select.rectView());
+	updateSelectRegion(iTimeStart, iTimeEnd, iNoteMin, iNoteMax);
+	rectUpdateView = rectUpdateView.united(m_select.rectView());
+
+	// Map the region into edit-view contents coordinates...
+	qtractorTimeScale::Cursor cursor(m_pTimeScale);
+	qtractorTimeScale::Node *pNode = cursor.seekFrame(m_iOffset);
+	const unsigned long t0 = pNode->tickFromFrame(m_iOffset);
+	const int x0 = m_pTimeScale->pixelFromFrame(m_iOffset);
+
+	const int ch = m_pEditView->contentsHeight();
+	const int h1 = m_pEditList->itemHeight();
+
+	const unsigned long t1 = t0 + iTimeStart;
+	pNode = cursor.seekTick(t1);
+	const int x1 = pNode->pixelFromTick(t1) - x0 - h1 - 2;
+	const unsigned long t2 = t0 + iTimeEnd;
+	pNode = cursor.seekTick(t2);
+	const int x2 = pNode->pixelFromTick(t2) - x0 + h1 + 6;
+	const int y1 = ch - h1 * (iNoteMax + 2) - 2;
+	const int y2 = ch - h1 * (iNoteMin - 1) + 2;
+
+	// Redraw the dirty region only...
+	m_pEditView->updateContents(QRect(x1, y1, x2 - x1, y2 - y1));
+
+	// And old/new selection areas...
+	const QSize pad(2, 2);
+	m_pEditView->viewport()->update(QRect(
+		m_pEditView->contentsToViewport(rectUpdateView.topLeft()),
+		rectUpdateView.size() + pad));
+
+	m_pEditEvent->updateContents();
+
+	m_pThumbView->updateContents();
+}
+
+
 // Try to center vertically the edit-view...
 void qtractorMidiEditor::centerContents (void)
 {
@@ -269,6 +269,10 @@ public:
 
 	// Update/sync integral contents.
 	void updateContents();
+
+	// Update/sync a partial (sequence time x note) region of contents.
+	void updateContents(unsigned long iTimeStart, unsigned long iTimeEnd,
+		int iNoteMin, int iNoteMax, bool bSelectClear = false);
 	
 	// Try to center vertically the edit-view...
 	void centerContents();
@@ -462,6 +466,10 @@ protected:
 	// Update all selection rectangular areas.
 	void updateSelect(bool bSelectReset);
 
+	// Update selection rectangular areas, in (time x note) region only.
+	void updateSelectRegion(unsigned long iTimeStart, unsigned long iTimeEnd,
+		int iNoteMin, int iNoteMax);
+
 	// Update the event selection list.
 	void updateDragSelect(qtractorScrollView *pScrollView,
 		const QRect& rectSelect, int flags);
@@ -34,6 +34,7 @@
 #include "qtractorMidiSequence.h"
 #include "qtractorMidiClip.h"
 #include "qtractorMidiManager.h"
+#include "qtractorMidiBuffer.h"
 #include "qtractorMidiControl.h"
 #include "qtractorMidiTimer.h"
 #include "qtractorMidiSysex.h"
@@ -43,6 +44,8 @@
 
 #include "qtractorCurveFile.h"
 
+#include "qtractorTrace.h"
+
 #include <QApplication>
 #include <QFileInfo>
 
@@ -56,6 +59,8 @@
 
 #include <QElapsedTimer>
 
+#include <jack/midiport.h>
+
 #include <cmath>
 
 
@@ -553,6 +558,9 @@ void qtractorMidiOutputThread::run (void)
 
 	m_mutex.unlock();
 
+	// Give back our trace buffer, if any.
+	qtractorTrace::release();
+
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorMidiOutputThread[%p]::run(): stopped.", this);
 #endif
@@ -566,7 +574,9 @@ void qtractorMidiOutputThread::process (void)
 	qtractorSession *pSession = m_pMidiEngine->session();
 	if (pSession == nullptr)
 		return;
-	
+
+	qtractorTraceScope trace("MIDI output", "output cycle");
+
 	// Get a handle on our slave MIDI engine...
 	qtractorSessionCursor *pMidiCursor = midiCursorSync();
 	// Isn't MIDI slightly behind audio?
@@ -1204,6 +1214,8 @@ qtractorMidiEngine::qtractorMidiEngine ( qtractorSession *pSession )
 
 	m_bDriftCorrect = true;
 
+	m_bJackMidi     = false;
+
 	m_iDriftCheck   = 0;
 	m_iDriftCount   = DRIFT_CHECK;
 
@@ -1499,8 +1511,10 @@ void qtractorMidiEngine::shutOffAllBuses ( bool bClose )
 			pBus; pBus = pBus->next()) {
 		qtractorMidiBus *pMidiBus
 			= static_cast<qtractorMidiBus *> (pBus);
-		if (pMidiBus)
+		if (pMidiBus) {
 			pMidiBus->shutOff(bClose);
+			pMidiBus->reset_jack();
+		}
 	}
 }
 
@@ -1828,7 +1842,7 @@ void qtractorMidiEngine::capture ( snd_seq_event_t *pEv )
 						snd_seq_ev_set_source(pEv, pMidiBus->alsaPort());
 						snd_seq_ev_set_subs(pEv);
 						snd_seq_ev_set_direct(pEv);
-						snd_seq_event_output_direct(m_pAlsaSeq, pEv);
+						pMidiBus->direct(pEv);
 						// Done with MIDI-thru.
 						pMidiBus->midiMonitor_out()->enqueue(type, value);
 						// Do it for the MIDI plugins too...
@@ -1874,7 +1888,7 @@ void qtractorMidiEngine::capture ( snd_seq_event_t *pEv )
 				snd_seq_ev_set_source(pEv, pMidiBus->alsaPort());
 				snd_seq_ev_set_subs(pEv);
 				snd_seq_ev_set_direct(pEv);
-				snd_seq_event_output_direct(m_pAlsaSeq, pEv);
+				pMidiBus->direct(pEv);
 				// Done with MIDI-thru.
 				pMidiBus->midiMonitor_out()->enqueue(type, value);
 			}
@@ -2067,20 +2081,7 @@ void qtractorMidiEngine::enqueue ( qtractorTrack *pTrack,
 			break;
 	}
 
-	// Pump it into the queue.
-	snd_seq_event_output(m_pAlsaSeq, &ev);
-
-	// MIDI track monitoring...
-	qtractorMidiMonitor *pMidiMonitor
-		= static_cast<qtractorMidiMonitor *> (pTrack->monitor());
-	if (pMidiMonitor)
-		pMidiMonitor->enqueue(pEvent->type(), pEvent->value(), tick);
-	// MIDI bus monitoring...
-	if (pMidiBus->midiMonitor_out())
-		pMidiBus->midiMonitor_out()->enqueue(
-			pEvent->type(), pEvent->value(), tick);
-
-	// Do it for the MIDI track plugins too...
+	// Frame-accurate schedule (MIDI plugins, JACK MIDI)...
 	qtractorTimeScale::Cursor& cursor = pSession->timeScale()->cursor();
 	qtractorTimeScale::Node *pNode = cursor.seekTick(iTime);
 	const long f0 = m_iFrameStart;
@@ -2094,6 +2095,25 @@ void qtractorMidiEngine::enqueue ( qtractorTrack *pTrack,
 		t2 += (pNode->frameFromTick(iTimeOff) - t0);
 	}
 
+	// Pump it into the queue,
+	// or render it later in the audio process cycle...
+	if (pMidiBus->jackMidiPort())
+		pMidiBus->queued(&ev, t1, t2);
+	else
+		snd_seq_event_output(m_pAlsaSeq, &ev);
+
+	// MIDI track monitoring...
+	qtractorMidiMonitor *pMidiMonitor
+		= static_cast<qtractorMidiMonitor *> (pTrack->monitor());
+	if (pMidiMonitor)
+		pMidiMonitor->enqueue(pEvent->type(), pEvent->value(), tick);
+	// MIDI bus monitoring...
+	if (pMidiBus->midiMonitor_out())
+		pMidiBus->midiMonitor_out()->enqueue(
+			pEvent->type(), pEvent->value(), tick);
+
+	// Do it for the MIDI track plugins too...
+
 	qtractorMidiManager *pMidiManager
 		= (pTrack->pluginList())->midiManager();
 	if (pMidiManager)
@@ -2135,7 +2155,7 @@ void qtractorMidiEngine::resetDrift (void)
 // Do ouput queue status (audio vs. MIDI)...
 void qtractorMidiEngine::driftCheck (void)
 {
-	if (!m_bDriftCorrect)
+	if (!m_bDriftCorrect || m_bJackMidi)
 		return;
 	if (++m_iDriftCheck < m_iDriftCount)
 		return;
@@ -2994,7 +3014,7 @@ void qtractorMidiEngine::sendSppCommand (
 	ev.data.control.value = iSongPos;
 
 	// Bail out...
-	snd_seq_event_output_direct(m_pAlsaSeq, &ev);
+	m_pOControlBus->direct(&ev);
 }
 
 
@@ -3291,7 +3311,15 @@ void qtractorMidiEngine::processMetro (
 					const unsigned long tick
 						= (long(iTimeClock) > m_iTimeStart ? iTimeClock - m_iTimeStart : 0);
 					snd_seq_ev_schedule_tick(&ev_clock, m_iAlsaQueue, 0, tick);
-					snd_seq_event_output(m_pAlsaSeq, &ev_clock);
+					// Pump it into the queue,
+					// or render it later in the audio process cycle...
+					if (m_pOControlBus && m_pOControlBus->jackMidiPort()) {
+						const long f0 = m_iFrameStart;
+						const unsigned long t0 = pNode->frameFromTick(iTimeClock);
+						m_pOControlBus->queued(&ev_clock,
+							(long(t0) < f0 ? t0 : t0 - f0));
+					}
+					else snd_seq_event_output(m_pAlsaSeq, &ev_clock);
 				}
 				iTimeClock += iTicksPerClock;
 			}
@@ -3314,8 +3342,17 @@ void qtractorMidiEngine::processMetro (
 				ev.data.note.velocity = m_iMetroBeatVelocity;
 				ev.data.note.duration = m_iMetroBeatDuration;
 			}
-			// Pump it into the queue.
-			snd_seq_event_output(m_pAlsaSeq, &ev);
+			// Pump it into the queue,
+			// or render it later in the audio process cycle...
+			if (m_pMetroBus && m_pMetroBus->jackMidiPort()) {
+				const long f0 = m_iFrameStart;
+				const unsigned long t0 = pNode->frameFromTick(iTimeOffset);
+				const unsigned long t1 = (long(t0) < f0 ? t0 : t0 - f0);
+				const unsigned long t2 = t1 + (pNode->frameFromTick(
+					iTimeOffset + ev.data.note.duration) - t0);
+				m_pMetroBus->queued(&ev, t1, t2);
+			}
+			else snd_seq_event_output(m_pAlsaSeq, &ev);
 			// MIDI track monitoring...
 			if (m_pMetroBus && m_pMetroBus->midiMonitor_out()) {
 				m_pMetroBus->midiMonitor_out()->enqueue(
@@ -3738,6 +3775,77 @@ bool qtractorMidiEngine::isDriftCorrect (void) const
 }
 
 
+// JACK MIDI output mode accessors.
+// (takes effect on next bus activation)
+void qtractorMidiEngine::setJackMidi ( bool bJackMidi )
+{
+	m_bJackMidi = bJackMidi;
+}
+
+bool qtractorMidiEngine::isJackMidi (void) const
+{
+	return m_bJackMidi;
+}
+
+
+// JACK MIDI output processing (in audio process cycle).
+void qtractorMidiEngine::process_jack (
+	unsigned long iFrameTimeStart, unsigned long iFrameTimeEnd,
+	unsigned int nframes )
+{
+	if (!m_bJackMidi)
+		return;
+
+	qtractorBus *pBus;
+	for (pBus = qtractorEngine::buses().first(); pBus; pBus = pBus->next()) {
+		qtractorMidiBus *pMidiBus
+			= static_cast<qtractorMidiBus *> (pBus);
+		if (pMidiBus && pMidiBus->jackMidiPort())
+			pMidiBus->process_jack(iFrameTimeStart, iFrameTimeEnd, nframes);
+	}
+
+	for (pBus = qtractorEngine::busesEx().first(); pBus; pBus = pBus->next()) {
+		qtractorMidiBus *pMidiBus
+			= static_cast<qtractorMidiBus *> (pBus);
+		if (pMidiBus && pMidiBus->jackMidiPort())
+			pMidiBus->process_jack(iFrameTimeStart, iFrameTimeEnd, nframes);
+	}
+}
+
+
+// JACK MIDI output jitter reports, if any new (non real-time).
+QStringList qtractorMidiEngine::jackLateReports (void) const
+{
+	QStringList reports;
+
+	if (!m_bJackMidi)
+		return reports;
+
+	qtractorBus *pBus;
+	for (pBus = qtractorEngine::buses().first(); pBus; pBus = pBus->next()) {
+		qtractorMidiBus *pMidiBus
+			= static_cast<qtractorMidiBus *> (pBus);
+		if (pMidiBus && pMidiBus->jackMidiPort()) {
+			const QString& sReport = pMidiBus->jackLateReport();
+			if (!sReport.isEmpty())
+				reports.append(sReport);
+		}
+	}
+
+	for (pBus = qtractorEngine::busesEx().first(); pBus; pBus = pBus->next()) {
+		qtractorMidiBus *pMidiBus
+			= static_cast<qtractorMidiBus *> (pBus);
+		if (pMidiBus && pMidiBus->jackMidiPort()) {
+			const QString& sReport = pMidiBus->jackLateReport();
+			if (!sReport.isEmpty())
+				reports.append(sReport);
+		}
+	}
+
+	return reports;
+}
+
+
 // MMC device-id accessors.
 void qtractorMidiEngine::setMmcDevice ( unsigned char mmcDevice )
 {
@@ -3805,6 +3913,18 @@ qtractorMidiBus::qtractorMidiBus ( qtractorMidiEngine *pMidiEngine,
 {
 	m_iAlsaPort = -1;
 
+	m_pJackMidiPort = nullptr;
+	m_pJackQueued   = nullptr;
+	m_pJackPosted   = nullptr;
+	m_pJackDirect   = nullptr;
+	m_pJackCoder    = nullptr;
+	m_iJackChannels = 0;
+	m_bJackReset    = false;
+
+	m_iJackLateEvents   = 0;
+	m_iJackLateFrames   = 0;
+	m_iJackLateReported = 0;
+
 	if ((busMode & qtractorBus::Input) && !(busMode & qtractorBus::Ex)) {
 		m_pIMidiMonitor = new qtractorMidiMonitor();
 		m_pIPluginList  = createPluginList(qtractorPluginList::MidiInBus);
@@ -3897,6 +4017,33 @@ bool qtractorMidiBus::open (void)
 	if (snd_seq_set_port_info(pAlsaSeq, m_iAlsaPort, pinfo) < 0)
 		return false;
 
+	// Sample-accurate JACK MIDI output, if applicable...
+	qtractorSession *pSession = pMidiEngine->session();
+	if (pMidiEngine->isJackMidi() && (busMode & qtractorBus::Output)
+		&& pSession && pSession->audioEngine()->jackClient()) {
+		qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+		const QString& sPortName = busName() + "/out";
+		jack_port_t *pJackMidiPort = jack_port_register(
+			pAudioEngine->jackClient(),
+			sPortName.toUtf8().constData(),
+			JACK_DEFAULT_MIDI_TYPE, JackPortIsOutput, 0);
+		if (pJackMidiPort) {
+			m_pJackQueued = new qtractorMidiBuffer(4 * qtractorMidiBuffer::MinBufferSize);
+			m_pJackPosted = new qtractorMidiBuffer(4 * qtractorMidiBuffer::MinBufferSize);
+			m_pJackDirect = new qtractorMidiBuffer(qtractorMidiBuffer::MinBufferSize);
+			if (snd_midi_event_new(4, &m_pJackCoder) == 0)
+				snd_midi_event_no_status(m_pJackCoder, 1);
+			m_iJackChannels = 0;
+			m_bJackReset = false;
+			// Only now the real-time cycle may have it...
+			pSession->lock();
+			m_pJackMidiPort = pJackMidiPort;
+			pSession->unlock();
+			// Get it cleared on every cycle...
+			pAudioEngine->resetOutputSnapshot();
+		}
+	}
+
 	// Update monitor subject names...
 	qtractorMidiBus::updateBusName();
 
@@ -3932,6 +4079,40 @@ void qtractorMidiBus::close (void)
 
 	shutOff(true);
 
+	if (m_pJackMidiPort) {
+		jack_port_t *pJackMidiPort = m_pJackMidiPort;
+		qtractorSession *pSession = pMidiEngine->session();
+		// Take it out of the real-time cycle, before anything else...
+		if (pSession)
+			pSession->lock();
+		m_pJackMidiPort = nullptr;
+		if (pSession) {
+			pSession->unlock();
+			qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+			pAudioEngine->resetOutputSnapshot();
+			if (pAudioEngine->jackClient())
+				jack_port_unregister(pAudioEngine->jackClient(), pJackMidiPort);
+		}
+	}
+
+	if (m_pJackCoder) {
+		snd_midi_event_free(m_pJackCoder);
+		m_pJackCoder = nullptr;
+	}
+	if (m_pJackQueued) {
+		delete m_pJackQueued;
+		m_pJackQueued = nullptr;
+	}
+	if (m_pJackPosted) {
+		delete m_pJackPosted;
+		m_pJackPosted = nullptr;
+	}
+	if (m_pJackDirect) {
+		QMutexLocker locker(&m_jackMutex);
+		delete m_pJackDirect;
+		m_pJackDirect = nullptr;
+	}
+
 	snd_seq_delete_simple_port(pAlsaSeq, m_iAlsaPort);
 
 	m_iAlsaPort = -1;
@@ -4129,7 +4310,7 @@ void qtractorMidiBus::setPatch ( unsigned short iChannel,
 			ev.data.control.value = (iBank & 0x3f80) >> 7;
 		else
 			ev.data.control.value = (iBank & 0x007f);
-		snd_seq_event_output_direct(pAlsaSeq, &ev);
+		direct(&ev);
 		if (pTrackMidiManager)
 			pTrackMidiManager->direct(&ev);
 		if (pBusMidiManager)
@@ -4142,7 +4323,7 @@ void qtractorMidiBus::setPatch ( unsigned short iChannel,
 		ev.data.control.channel = iChannel;
 		ev.data.control.param   = BANK_SELECT_LSB;
 		ev.data.control.value   = (iBank & 0x007f);
-		snd_seq_event_output_direct(pAlsaSeq, &ev);
+		direct(&ev);
 		if (pTrackMidiManager)
 			pTrackMidiManager->direct(&ev);
 		if (pBusMidiManager)
@@ -4154,7 +4335,7 @@ void qtractorMidiBus::setPatch ( unsigned short iChannel,
 		ev.type = SND_SEQ_EVENT_PGMCHANGE;
 		ev.data.control.channel = iChannel;
 		ev.data.control.value   = iProg;
-		snd_seq_event_output_direct(pAlsaSeq, &ev);
+		direct(&ev);
 		if (pTrackMidiManager)
 			pTrackMidiManager->direct(&ev);
 		if (pBusMidiManager)
@@ -4232,7 +4413,7 @@ void qtractorMidiBus::setControllerEx ( unsigned short iChannel,
 	ev.data.control.channel = iChannel;
 	ev.data.control.param   = iController;
 	ev.data.control.value   = iValue;
-	snd_seq_event_output_direct(pAlsaSeq, &ev);
+	direct(&ev);
 
 	// Do it for the MIDI plugins too...
 	if (pTrack && (pTrack->pluginList())->midiManager())
@@ -4341,7 +4522,7 @@ void qtractorMidiBus::sendEvent ( qtractorMidiEvent::EventType etype,
 		break;
 	}
 
-	snd_seq_event_output_direct(pAlsaSeq, &ev);
+	direct(&ev);
 }
 
 
@@ -4384,7 +4565,7 @@ void qtractorMidiBus::sendNote (
 	ev.data.note.channel  = iChannel;
 	ev.data.note.note     = iNote;
 	ev.data.note.velocity = iVelocity;
-	snd_seq_event_output_direct(pAlsaSeq, &ev);
+	direct(&ev);
 
 	// Do it for the MIDI plugins too...
 	if ((pTrack->pluginList())->midiManager())
@@ -4446,7 +4627,7 @@ void qtractorMidiBus::sendSysex (
 	// Just set SYSEX stuff and send it out..
 	ev.type = SND_SEQ_EVENT_SYSEX;
 	snd_seq_ev_set_sysex(&ev, iSysex, pSysex);
-	snd_seq_event_output_direct(pAlsaSeq, &ev);
+	direct(&ev);
 
 //	pMidiEngine->flush();
 }
@@ -4495,7 +4676,7 @@ void qtractorMidiBus::sendSysexList (void) const
 		// Just set SYSEX stuff and send it out..
 		ev.type = SND_SEQ_EVENT_SYSEX;
 		snd_seq_ev_set_sysex(&ev, pSysex->size(), pSysex->data());
-		snd_seq_event_output(pAlsaSeq, &ev);
+		direct(&ev);
 		// AG: Do it for the MIDI plugins too...
 		if (pluginList_out() && pluginList_out()->midiManager())
 			(pluginList_out()->midiManager())->direct(&ev);
@@ -4803,6 +4984,200 @@ void qtractorMidiBus::setVolume ( qtractorTrack *pTrack, float fVolume )
 }
 
 
+// JACK MIDI output port accessor.
+jack_port_t *qtractorMidiBus::jackMidiPort (void) const
+{
+	return m_pJackMidiPort;
+}
+
+
+// JACK MIDI output scheduling (in output thread).
+bool qtractorMidiBus::queued (
+	snd_seq_event_t *pEvent, unsigned long iTime, unsigned long iTimeOff )
+{
+	if (m_pJackQueued == nullptr || m_pJackPosted == nullptr)
+		return false;
+
+	// SysEx data gets copied while queued...
+	if (pEvent->type == SND_SEQ_EVENT_SYSEX)
+		return m_pJackQueued->insertSysex(pEvent, iTime);
+
+	return qtractorMidiBuffer::queued(
+		m_pJackQueued, m_pJackPosted, pEvent, iTime, iTimeOff);
+}
+
+
+// Direct (immediate) event output: either straight to the ALSA
+// port, or on the very next JACK MIDI cycle, if applicable.
+void qtractorMidiBus::direct ( snd_seq_event_t *pEvent ) const
+{
+	if (m_pJackDirect) {
+		QMutexLocker locker(&m_jackMutex);
+		if (pEvent->type == SND_SEQ_EVENT_SYSEX)
+			m_pJackDirect->insertSysex(pEvent, 0);
+		else
+			m_pJackDirect->push(pEvent, 0);
+		return;
+	}
+
+	qtractorMidiEngine *pMidiEngine
+		= static_cast<qtractorMidiEngine *> (engine());
+	if (pMidiEngine && pMidiEngine->alsaSeq())
+		snd_seq_event_output_direct(pMidiEngine->alsaSeq(), pEvent);
+}
+
+
+// JACK MIDI output event encoder (in audio process cycle).
+void qtractorMidiBus::write_jack ( void *pJackBuffer,
+	unsigned int offset, qtractorMidiBuffer *pBuffer, snd_seq_event_t *pEv )
+{
+	if (pEv->type == SND_SEQ_EVENT_SYSEX) {
+		const unsigned int iSysex = pEv->data.ext.len;
+		jack_midi_data_t *pSysex
+			= jack_midi_event_reserve(pJackBuffer, offset, iSysex);
+		if (pSysex == nullptr)
+			return;
+		if (pEv->data.ext.ptr)
+			::memcpy(pSysex, pEv->data.ext.ptr, iSysex);
+		else
+			pBuffer->peekSysex(pSysex);
+		return;
+	}
+
+	if (m_pJackCoder == nullptr)
+		return;
+
+	unsigned char data[16];
+
+	snd_midi_event_reset_decode(m_pJackCoder);
+	const long iMidiData
+		= snd_midi_event_decode(m_pJackCoder, data, sizeof(data), pEv);
+	// Split into single messages (eg. RPN/NRPN/CC14)...
+	long i = 0;
+	while (i < iMidiData) {
+		long j = i + 1;
+		while (j < iMidiData && (data[j] & 0x80) == 0)
+			++j;
+		jack_midi_event_write(pJackBuffer, offset, &data[i], j - i);
+		if (data[i] >= 0x80 && data[i] < 0xf0)
+			m_iJackChannels |= (1 << (data[i] & 0x0f));
+		i = j;
+	}
+}
+
+
+// JACK MIDI output processing (in audio process cycle).
+void qtractorMidiBus::process_jack (
+	unsigned long iTimeStart, unsigned long iTimeEnd, unsigned int nframes )
+{
+	if (m_pJackMidiPort == nullptr)
+		return;
+
+	void *pJackBuffer = jack_port_get_buffer(m_pJackMidiPort, nframes);
+	jack_midi_clear_buffer(pJackBuffer);
+
+	// Direct (immediate) events go first...
+	snd_seq_event_t *pEv = m_pJackDirect->peek();
+	while (pEv) {
+		write_jack(pJackBuffer, 0, m_pJackDirect, pEv);
+		pEv = m_pJackDirect->next();
+	}
+
+	unsigned char data[3];
+
+	// Deferred reset: silence whatever channels were in use...
+	if (m_bJackReset) {
+		m_bJackReset = false;
+		m_pJackQueued->clear();
+		m_pJackPosted->clear();
+		for (unsigned short iChannel = 0; iChannel < 16; ++iChannel) {
+			if ((m_iJackChannels & (1 << iChannel)) == 0)
+				continue;
+			data[0] = 0xb0 | iChannel;
+			data[1] = ALL_SOUND_OFF;
+			data[2] = 0;
+			jack_midi_event_write(pJackBuffer, 0, data, 3);
+			data[1] = ALL_NOTES_OFF;
+			jack_midi_event_write(pJackBuffer, 0, data, 3);
+		}
+		m_iJackChannels = 0;
+		return;
+	}
+
+	// Merge queued/posted events due in this cycle...
+	snd_seq_event_t *pEv1 = m_pJackQueued->peek();
+	snd_seq_event_t *pEv2 = m_pJackPosted->peek();
+
+	while ((pEv1 && pEv1->time.tick < iTimeEnd)
+		|| (pEv2 && pEv2->time.tick < iTimeEnd)) {
+		qtractorMidiBuffer *pBuffer;
+		if (pEv1 && pEv1->time.tick < iTimeEnd
+			&& (pEv2 == nullptr || pEv2->time.tick >= pEv1->time.tick)) {
+			pEv = pEv1;
+			pBuffer = m_pJackQueued;
+		} else {
+			pEv = pEv2;
+			pBuffer = m_pJackPosted;
+		}
+		// Sample-accurate offset (late events go first)...
+		jack_nframes_t offset = 0;
+		if (pEv->time.tick > iTimeStart) {
+			offset = jack_nframes_t(pEv->time.tick - iTimeStart);
+		} else if (pEv->time.tick < iTimeStart) {
+			const unsigned long iLateFrames = iTimeStart - pEv->time.tick;
+			if (m_iJackLateFrames < iLateFrames)
+				m_iJackLateFrames = iLateFrames;
+			++m_iJackLateEvents;
+		}
+		// Decode into raw MIDI data...
+		write_jack(pJackBuffer, offset, pBuffer, pEv);
+		// Only then release the event slot(s)...
+		if (pBuffer == m_pJackQueued)
+			pEv1 = m_pJackQueued->next();
+		else
+			pEv2 = m_pJackPosted->next();
+	}
+}
+
+
+// JACK MIDI output reset (deferred to next process cycle).
+void qtractorMidiBus::reset_jack (void)
+{
+	if (m_pJackMidiPort)
+		m_bJackReset = true;
+}
+
+
+// JACK MIDI output statistics.
+unsigned long qtractorMidiBus::jackLateEvents (void) const
+{
+	return m_iJackLateEvents;
+}
+
+unsigned long qtractorMidiBus::jackLateFrames (void) const
+{
+	return m_iJackLateFrames;
+}
+
+
+// JACK MIDI output jitter report, if any new (non real-time).
+QString qtractorMidiBus::jackLateReport (void)
+{
+	const unsigned long iLateEvents = m_iJackLateEvents;
+	if (m_iJackLateReported == iLateEvents)
+		return QString();
+
+	const QString& sReport
+		= QObject::tr("JACK MIDI: %1 late events on \"%2\" (max. %3 frames).")
+		.arg(iLateEvents - m_iJackLateReported).arg(busName())
+		.arg(m_iJackLateFrames);
+
+	m_iJackLateReported = iLateEvents;
+
+	return sReport;
+}
+
+
 // MIDI channel stereo panning.
 void qtractorMidiBus::setPanning ( qtractorTrack *pTrack, float fPanning )
 {
@@ -29,8 +29,12 @@
 
 #include <alsa/asoundlib.h>
 
+#include <jack/jack.h>
+
 #include <QHash>
 #include <QObject>
+#include <QMutex>
+#include <QStringList>
 
 // Forward declarations.
 class qtractorMidiBus;
@@ -41,6 +45,7 @@ class qtractorMidiOutputThread;
 class qtractorMidiMonitor;
 class qtractorMidiSysexList;
 class qtractorMidiInputBuffer;
+class qtractorMidiBuffer;
 class qtractorMidiPlayer;
 class qtractorPluginList;
 class qtractorCurveList;
@@ -279,6 +284,17 @@ public:
 	// Reset ouput queue drift stats (audio vs. MIDI)...
 	void resetDrift();
 
+	// JACK MIDI output mode accessors.
+	void setJackMidi(bool bJackMidi);
+	bool isJackMidi() const;
+
+	// JACK MIDI output processing (in audio process cycle).
+	void process_jack(unsigned long iFrameTimeStart,
+		unsigned long iFrameTimeEnd, unsigned int nframes);
+
+	// JACK MIDI output jitter reports, if any new (non real-time).
+	QStringList jackLateReports() const;
+
 protected:
 
 	// Concrete device (de)activation methods.
@@ -333,6 +349,9 @@ private:
 	// Whether to check for time drift.
 	bool m_bDriftCorrect;
 
+	// Whether output buses deliver through JACK MIDI.
+	bool m_bJackMidi;
+
 	// The number of times we check for time drift.
 	unsigned int m_iDriftCheck;
 	unsigned int m_iDriftCount;
@@ -510,12 +529,40 @@ public:
 	// MIDI channel stereo panning.
 	void setPanning(qtractorTrack *pTrack, float fPanning);
 
+	// JACK MIDI output port accessor.
+	jack_port_t *jackMidiPort() const;
+
+	// JACK MIDI output scheduling (in output thread).
+	bool queued(snd_seq_event_t *pEvent,
+		unsigned long iTime, unsigned long iTimeOff = 0);
+
+	// Direct (immediate) event output (ALSA or JACK MIDI).
+	void direct(snd_seq_event_t *pEvent) const;
+
+	// JACK MIDI output processing (in audio process cycle).
+	void process_jack(unsigned long iTimeStart,
+		unsigned long iTimeEnd, unsigned int nframes);
+
+	// JACK MIDI output reset (deferred to next process cycle).
+	void reset_jack();
+
+	// JACK MIDI output statistics (late events, max. lateness in frames).
+	unsigned long jackLateEvents() const;
+	unsigned long jackLateFrames() const;
+
+	// JACK MIDI output jitter report, if any new (non real-time).
+	QString jackLateReport();
+
 	// Document element methods.
 	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
 	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement) const;
 
 protected:
 
+	// JACK MIDI output event encoder (in audio process cycle).
+	void write_jack(void *pJackBuffer, unsigned int offset,
+		qtractorMidiBuffer *pBuffer, snd_seq_event_t *pEv);
+
 	// Direct MIDI controller common helper.
 	void setControllerEx(unsigned short iChannel, int iController,
 		int iValue = 0, qtractorTrack *pTrack = nullptr) const;
@@ -547,6 +594,23 @@ private:
 	// Instance variables.
 	int m_iAlsaPort;
 
+	// JACK MIDI output port and event schedule.
+	jack_port_t        *m_pJackMidiPort;
+	qtractorMidiBuffer *m_pJackQueued;
+	qtractorMidiBuffer *m_pJackPosted;
+	qtractorMidiBuffer *m_pJackDirect;
+	snd_midi_event_t   *m_pJackCoder;
+	unsigned short      m_iJackChannels;
+	volatile bool       m_bJackReset;
+
+	// Direct events producers serialization.
+	mutable QMutex      m_jackMutex;
+
+	// JACK MIDI output statistics.
+	unsigned long m_iJackLateEvents;
+	unsigned long m_iJackLateFrames;
+	unsigned long m_iJackLateReported;
+
 	// Specific monitor instances.
 	qtractorMidiMonitor *m_pIMidiMonitor;
 	qtractorMidiMonitor *m_pOMidiMonitor;
@@ -401,6 +401,10 @@ qtractorMidiManager::qtractorMidiManager (
 	m_pSyncItem(new SyncItem(this)),
 	m_pPluginList(pPluginList),
 	m_directBuffer(iBufferSize >> 1),
+	m_iDirectOverflowsReported(0),
+	m_iDirectEvents(0),
+	m_iDirectLatencySum(0),
+	m_iDirectLatencyMax(0),
 	m_queuedBuffer(iBufferSize),
 	m_postedBuffer(iBufferSize),
 	m_controllerBuffer(iBufferSize >> 2),
@@ -422,6 +426,8 @@ qtractorMidiManager::qtractorMidiManager (
 {
 	const unsigned int MaxMidiEvents = bufferSize();
 
+	ATOMIC_SET(&m_iDirectOverflows, 0);
+
 #ifdef CONFIG_MIDI_PARSER
 	if (snd_midi_event_new(c_iMaxMidiData, &m_pMidiParser) == 0)
 		snd_midi_event_no_status(m_pMidiParser, 1);
@@ -510,27 +516,53 @@ qtractorMidiManager::~qtractorMidiManager (void)
 }
 
 
-// Direct buffering.
+// Direct buffering (timestamped on capture).
 bool qtractorMidiManager::direct ( snd_seq_event_t *pEvent )
 {
-	if (pEvent->type == SND_SEQ_EVENT_CONTROLLER) {
-		switch (pEvent->data.control.param) {
-		case BANK_SELECT_MSB:
-			m_iPendingBankMSB = pEvent->data.control.value;
-			break;
-		case BANK_SELECT_LSB:
-			m_iPendingBankLSB = pEvent->data.control.value;
-			break;
-		default:
-			m_controllerBuffer.push(pEvent);
-			break;
-		}
-	}
-	else
-	if (pEvent->type == SND_SEQ_EVENT_PGMCHANGE)
-		m_iPendingProg = pEvent->data.control.value;
+	// Capture timestamp (absolute JACK frame time)...
+	unsigned long iFrameTime = 0;
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession && pSession->audioEngine())
+		iFrameTime = pSession->audioEngine()->jackFrameTime();
+
+	// Multiple producers (MIDI input, sync and GUI threads) may
+	// get here concurrently, lock-free; any program change and
+	// controller side-effects are taken on the consumer side
+	// (audio thread) while draining, in capture order.
+	const bool bResult = m_directBuffer.push(pEvent, iFrameTime);
+	if (!bResult)
+		ATOMIC_INC(&m_iDirectOverflows);
+
+	return bResult;
+}
+
+
+// Direct buffering overflow report, if any new (non real-time).
+QString qtractorMidiManager::directOverflowReport (void)
+{
+	const unsigned long iOverflows = directOverflows();
+	if (m_iDirectOverflowsReported == iOverflows)
+		return QString();
+
+	const QString& sReport
+		= QObject::tr("MIDI input: %1 events dropped on \"%2\".")
+		.arg(iOverflows - m_iDirectOverflowsReported)
+		.arg(m_pPluginList->name());
+
+	m_iDirectOverflowsReported = iOverflows;
 
-	return m_directBuffer.push(pEvent);
+	return sReport;
+}
+
+
+// Direct input-to-plugin latency statistics (frames).
+float qtractorMidiManager::directLatencyMean (void) const
+{
+	const unsigned long iEvents = m_iDirectEvents;
+	if (iEvents < 1)
+		return 0.0f;
+
+	return float(double(m_iDirectLatencySum) / double(iEvents));
 }
 
 
@@ -538,21 +570,8 @@ bool qtractorMidiManager::direct ( snd_seq_event_t *pEvent )
 bool qtractorMidiManager::queued (
 	snd_seq_event_t *pEvent, unsigned long iTime, unsigned long iTimeOff )
 {
-	if (pEvent->type == SND_SEQ_EVENT_NOTE && iTime < iTimeOff) {
-		snd_seq_event_t ev = *pEvent;
-		ev.type = SND_SEQ_EVENT_NOTEON;
-		if (!m_queuedBuffer.insert(&ev, iTime))
-			return false;
-		ev.type = SND_SEQ_EVENT_NOTEOFF;
-		ev.data.note.velocity = 0;
-		ev.data.note.duration = 0;
-		return m_postedBuffer.insert(&ev, iTimeOff);
-	}
-
-	if (pEvent->type == SND_SEQ_EVENT_NOTEOFF)
-		return m_postedBuffer.insert(pEvent, iTime);
-	else
-		return m_queuedBuffer.insert(pEvent, iTime);
+	return qtractorMidiBuffer::queued(
+		&m_queuedBuffer, &m_postedBuffer, pEvent, iTime, iTimeOff);
 }
 
 
@@ -591,21 +610,11 @@ void qtractorMidiManager::process (
 	const unsigned short iInputBuffer = m_iEventBuffer & 1;
 	qtractorMidiBuffer *pEventBuffer = m_ppEventBuffers[iInputBuffer];
 
-	// Check for program changes and controller messages...
-	if (m_iPendingProg >= 0 || !m_controllerBuffer.isEmpty())
-		qtractorMidiSyncItem::syncItem(m_pSyncItem);
-
 	// Merge events in buffer for plugin processing...
 	snd_seq_event_t *pEv0 = m_directBuffer.peek();
 	snd_seq_event_t *pEv1 = m_queuedBuffer.peek();
 	snd_seq_event_t *pEv2 = m_postedBuffer.peek();
 
-	// Direct events...
-	while (pEv0) {
-		pEventBuffer->push(pEv0, pEv0->time.tick);
-		pEv0 = m_directBuffer.next();
-	}
-
 	// Queued/posted events...
 	while ((pEv1 && pEv1->time.tick < iTimeEnd)
 		|| (pEv2 && pEv2->time.tick < iTimeEnd)) {
@@ -625,6 +634,55 @@ void qtractorMidiManager::process (
 		}
 	}
 
+	// Direct events, at their capture offset, one period late,
+	// so that relative timing (jitter) is kept sample-accurate...
+	if (pEv0) {
+		const jack_nframes_t nframes = (iTimeEnd - iTimeStart);
+		jack_nframes_t iCycleTime = 0;
+		qtractorSession *pSession = qtractorSession::getInstance();
+		if (pSession && pSession->audioEngine())
+			iCycleTime = pSession->audioEngine()->jackCycleTime();
+		while (pEv0) {
+			if (pEv0->type == SND_SEQ_EVENT_CONTROLLER) {
+				switch (pEv0->data.control.param) {
+				case BANK_SELECT_MSB:
+					m_iPendingBankMSB = pEv0->data.control.value;
+					break;
+				case BANK_SELECT_LSB:
+					m_iPendingBankLSB = pEv0->data.control.value;
+					break;
+				default:
+					m_controllerBuffer.push(pEv0);
+					break;
+				}
+			}
+			else
+			if (pEv0->type == SND_SEQ_EVENT_PGMCHANGE)
+				m_iPendingProg = pEv0->data.control.value;
+			const int iAge = int(iCycleTime - jack_nframes_t(pEv0->time.tick));
+			unsigned long iOffset = 0;
+			if (iAge <= 0)
+				iOffset = (nframes > 0 ? nframes - 1 : 0);
+			else
+			if (jack_nframes_t(iAge) < nframes)
+				iOffset = nframes - jack_nframes_t(iAge);
+			pEventBuffer->insert(pEv0, iOffset);
+			// Input-to-plugin latency statistics...
+			const int iLatency = iAge + int(iOffset);
+			if (iLatency > 0) {
+				m_iDirectLatencySum += iLatency;
+				if (m_iDirectLatencyMax < (unsigned long) iLatency)
+					m_iDirectLatencyMax = iLatency;
+			}
+			++m_iDirectEvents;
+			pEv0 = m_directBuffer.next();
+		}
+	}
+
+	// Check for program changes and controller messages...
+	if (m_iPendingProg >= 0 || !m_controllerBuffer.isEmpty())
+		qtractorMidiSyncItem::syncItem(m_pSyncItem);
+
 #ifdef CONFIG_DEBUG_0
 	const unsigned int iEventCount = pEventBuffer->count();
 	for (unsigned int i = 0; i < iEventCount; ++i) {
@@ -661,6 +719,7 @@ void qtractorMidiManager::process (
 			m_pAudioOutputBus->process_commit(nframes);
 		} else {
 			m_pAudioOutputBus->buffer_prepare(nframes);
+			m_pAudioOutputBus->buffer_touch(nframes);
 			m_pPluginList->process(m_pAudioOutputBus->buffer(), nframes);
 			if (m_bAudioOutputMonitor)
 				m_pAudioOutputMonitor->process_meter(
@@ -25,6 +25,8 @@
 #include "qtractorAbout.h"
 #include "qtractorMidiBuffer.h"
 
+#include "qtractorAtomic.h"
+
 #ifdef CONFIG_VST
 #include "qtractorVstPlugin.h"
 #ifndef CONFIG_MIDI_PARSER
@@ -205,9 +207,23 @@ public:
 	qtractorMidiBuffer *buffer_out() const
 		{ return m_ppEventBuffers[(m_iEventBuffer + 1) & 1]; }
 
-	// Direct buffering.
+	// Direct buffering (timestamped on capture).
 	bool direct(snd_seq_event_t *pEvent);
 
+	// Direct buffering overflow counter.
+	unsigned long directOverflows() const
+		{ return (unsigned long) ATOMIC_GET(&m_iDirectOverflows); }
+
+	// Direct buffering overflow report, if any new (non real-time).
+	QString directOverflowReport();
+
+	// Direct input-to-plugin latency statistics (frames).
+	unsigned long directEvents() const
+		{ return m_iDirectEvents; }
+	float directLatencyMean() const;
+	unsigned long directLatencyMax() const
+		{ return m_iDirectLatencyMax; }
+
 	// Queued buffering.
 	bool queued(snd_seq_event_t *pEvent,
 		unsigned long iTime, unsigned long iTimeOff = 0);
@@ -380,7 +396,12 @@ private:
 	// Instance variables
 	qtractorPluginList *m_pPluginList;
 
-	qtractorMidiBuffer  m_directBuffer;
+	qtractorMidiDirectBuffer m_directBuffer;
+	qtractorAtomic      m_iDirectOverflows;
+	unsigned long       m_iDirectOverflowsReported;
+	unsigned long       m_iDirectEvents;
+	unsigned long long  m_iDirectLatencySum;
+	unsigned long       m_iDirectLatencyMax;
 	qtractorMidiBuffer  m_queuedBuffer;
 	qtractorMidiBuffer  m_postedBuffer;
 
@@ -165,6 +165,34 @@ void qtractorMidiSequence::removeEvent ( qtractorMidiEvent *pEvent )
 }
 
 
+// Relink all events in one go, in the given (time sorted) order
+// (session lock must be held, as MIDI output may walk them).
+void qtractorMidiSequence::relinkEvents (
+	const QVector<qtractorMidiEvent *>& events )
+{
+	while (m_events.first())
+		m_events.unlink(m_events.first());
+
+	const int iCount = events.count();
+	for (int i = 0; i < iCount; ++i) {
+		qtractorMidiEvent *pEvent = events.at(i);
+		m_events.append(pEvent);
+		// Keep note stats, as in insertEvent()...
+		unsigned long iTime = pEvent->time();
+		if (pEvent->type() == qtractorMidiEvent::NOTEON) {
+			const unsigned char note = pEvent->note();
+			if (m_noteMin > note || m_noteMin == 0)
+				m_noteMin = note;
+			if (m_noteMax < note || m_noteMax == 0)
+				m_noteMax = note;
+			iTime += pEvent->duration();
+		}
+		if (m_duration < iTime)
+			m_duration = iTime;
+	}
+}
+
+
 // Sequence closure method.
 void qtractorMidiSequence::close (void)
 {
@@ -26,6 +26,7 @@
 
 #include <QString>
 #include <QMultiHash>
+#include <QVector>
 
 // typedef unsigned long long uint64_t;
 #include <stdint.h>
@@ -107,6 +108,9 @@ public:
 	void unlinkEvent (qtractorMidiEvent *pEvent);
 	void removeEvent (qtractorMidiEvent *pEvent);
 
+	// Relink all events in one go, in the given (time sorted) order.
+	void relinkEvents(const QVector<qtractorMidiEvent *>& events);
+
 	// Adjust time resolutions (64bit).
 	unsigned long timep(unsigned long iTime, unsigned short p) const
 		{ return uint64_t(iTime) * p / m_iTicksPerBeat; }
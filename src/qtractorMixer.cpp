@@ -56,6 +56,8 @@
 #include <QContextMenuEvent>
 #include <QResizeEvent>
 #include <QMouseEvent>
+#include <QHelpEvent>
+#include <QToolTip>
 
 #include <QPainter>
 
@@ -634,6 +636,74 @@ void qtractorMixerStrip::updateName (void)
 }
 
 
+// Total path latency (plugin delay compensation).
+unsigned long qtractorMixerStrip::pathLatency (void) const
+{
+	if (m_pTrack)
+		return m_pTrack->pathLatency();
+
+	if (m_pBus && m_pBus->busType() == qtractorTrack::Audio
+		&& (m_busMode & qtractorBus::Output)) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (m_pBus);
+		if (pAudioBus)
+			return pAudioBus->pathLatency();
+	}
+
+	return 0;
+}
+
+
+// DSP load profile, if any.
+qtractorDspProfile *qtractorMixerStrip::dspProfile (void) const
+{
+	if (m_pTrack)
+		return m_pTrack->dspProfile();
+
+	if (m_pBus && m_pBus->busType() == qtractorTrack::Audio
+		&& (m_busMode & qtractorBus::Output)) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (m_pBus);
+		if (pAudioBus)
+			return pAudioBus->dspProfile();
+	}
+
+	return nullptr;
+}
+
+
+// Tool-tip event handler (total path latency, DSP load).
+bool qtractorMixerStrip::event ( QEvent *pEvent )
+{
+	if (pEvent->type() == QEvent::ToolTip) {
+		QString sToolTip;
+		qtractorSession *pSession = qtractorSession::getInstance();
+		const unsigned long iLatency = pathLatency();
+		if (pSession && iLatency > 0) {
+			const float fLatencyMs
+				= 1000.0f * float(iLatency) / float(pSession->sampleRate());
+			sToolTip += '\n' + tr("Latency: %1 ms (%2 frames)")
+				.arg(QString::number(fLatencyMs, 'f', 1))
+				.arg(iLatency);
+		}
+		qtractorDspProfile *pDspProfile = dspProfile();
+		if (pDspProfile) {
+			const QString& sText = pDspProfile->text();
+			if (!sText.isEmpty())
+				sToolTip += '\n' + sText;
+		}
+		if (!sToolTip.isEmpty()) {
+			QHelpEvent *pHelpEvent = static_cast<QHelpEvent *> (pEvent);
+			QToolTip::showText(pHelpEvent->globalPos(),
+				QFrame::toolTip() + sToolTip, this);
+			return true;
+		}
+	}
+
+	return QFrame::event(pEvent);
+}
+
+
 // MIDI (channel) label updater.
 void qtractorMixerStrip::updateMidiLabel (void)
 {
@@ -46,6 +46,8 @@ class qtractorPluginListView;
 class qtractorMidiManager;
 class qtractorAudioBus;
 
+class qtractorDspProfile;
+
 class QHBoxLayout;
 class QVBoxLayout;
 class QGridLayout;
@@ -185,6 +187,15 @@ protected:
 	void updateMidiLabel();
 	void updateName();
 
+	// Total path latency (plugin delay compensation).
+	unsigned long pathLatency() const;
+
+	// DSP load profile, if any.
+	qtractorDspProfile *dspProfile() const;
+
+	// Tool-tip event handler (total path latency, DSP load).
+	bool event(QEvent *pEvent);
+
 	// Mouse selection event handlers.
 	void mousePressEvent(QMouseEvent *);
 
@@ -22,98 +22,140 @@
 #include "qtractorAbout.h"
 #include "qtractorObserver.h"
 
+#include <QThread>
+
 
 //---------------------------------------------------------------------------
 // qtractorSubjectQueue - Update/notify subject queue.
+//
+// Bounded multiple-producer lock-free queue (after D. Vyukov's,
+// with a sequence number per cell); subjects are coalesced on push,
+// so that any one subject is only queued once until it gets popped
+// and notified, with its current (latest) value.
 
 class qtractorSubjectQueue
 {
 public:
 
-	struct QueueItem
+	// Constructor.
+	qtractorSubjectQueue ( unsigned int iQueueSize = 4096 )
 	{
-		qtractorSubject  *subject;
-		qtractorObserver *sender;
-		float             value;
-	};
-
-	qtractorSubjectQueue ( unsigned int iQueueSize = 1024 )
-		: m_iQueueIndex(0), m_iQueueSize(0), m_pQueueItems(nullptr)
-		{ resize(iQueueSize); }
+		m_iQueueSize = 1024;
+		while (m_iQueueSize < iQueueSize)
+			m_iQueueSize <<= 1;
+		m_iQueueMask = (m_iQueueSize - 1);
+		m_pQueueCells = new QueueCell [m_iQueueSize];
+		for (unsigned int i = 0; i < m_iQueueSize; ++i) {
+			m_pQueueCells[i].sequence.storeRelease(int(i));
+			m_pQueueCells[i].subject = nullptr;
+		}
+		ATOMIC_SET(&m_iPushIndex, 0);
+		ATOMIC_SET(&m_iPopIndex, 0);
+		ATOMIC_SET(&m_iOverflows, 0);
+	}
 
+	// Destructor.
 	~qtractorSubjectQueue ()
-		{ clear(); delete [] m_pQueueItems; }
-
-	void clear()
-		{ m_iQueueIndex = 0; }
+		{ delete [] m_pQueueCells; }
 
-	bool push ( qtractorSubject *pSubject, qtractorObserver *pSender, float fValue )
+	// Enqueue (any thread; never blocks nor allocates).
+	bool push ( qtractorSubject *pSubject )
 	{
-		if (m_iQueueIndex >= m_iQueueSize)
-			return false;
-		pSubject->setQueued(true);
-		QueueItem *pItem = &m_pQueueItems[m_iQueueIndex++];
-		pItem->subject = pSubject;
-		pItem->sender  = pSender;
-		pItem->value   = fValue;
-		return true;
-	}
-
-	bool pop (bool bUpdate)
-	{
-		if (m_iQueueIndex == 0)
-			return false;
-		QueueItem *pItem = &m_pQueueItems[--m_iQueueIndex];
-		qtractorSubject *pSubject = pItem->subject;
-		pSubject->notify(pItem->sender, pItem->value, bUpdate);
-		pSubject->setQueued(false);
+		QueueCell *pCell;
+		unsigned int iPos = ATOMIC_GET(&m_iPushIndex);
+		for (;;) {
+			pCell = &m_pQueueCells[iPos & m_iQueueMask];
+			const int iDiff = int(pCell->sequence.loadAcquire()) - int(iPos);
+			if (iDiff == 0) {
+				if (ATOMIC_CAS(&m_iPushIndex, int(iPos), int(iPos + 1)))
+					break;
+				iPos = ATOMIC_GET(&m_iPushIndex);
+			}
+			else if (iDiff < 0) {
+				m_iOverflows.fetchAndAddRelaxed(1);
+				return false; // Full.
+			}
+			else iPos = ATOMIC_GET(&m_iPushIndex);
+		}
+		pCell->subject = pSubject;
+		pCell->sequence.storeRelease(int(iPos + 1));
 		return true;
 	}
 
-	bool flush (bool bUpdate)
-		{ int i = 0; while (pop(bUpdate)) ++i; return (i > 0); }
-
-	void reset ()
+	// Dequeue (non-blocking).
+	qtractorSubject *pop ()
 	{
-		while (m_iQueueIndex > 0) {
-			QueueItem *pItem = &m_pQueueItems[--m_iQueueIndex];
-			(pItem->subject)->setQueued(false);
+		QueueCell *pCell;
+		unsigned int iPos = ATOMIC_GET(&m_iPopIndex);
+		for (;;) {
+			pCell = &m_pQueueCells[iPos & m_iQueueMask];
+			const int iDiff = int(pCell->sequence.loadAcquire()) - int(iPos + 1);
+			if (iDiff == 0) {
+				if (ATOMIC_CAS(&m_iPopIndex, int(iPos), int(iPos + 1)))
+					break;
+				iPos = ATOMIC_GET(&m_iPopIndex);
+			}
+			else if (iDiff < 0)
+				return nullptr; // Empty.
+			else iPos = ATOMIC_GET(&m_iPopIndex);
 		}
-		clear();
+		qtractorSubject *pSubject = pCell->subject;
+		pCell->sequence.storeRelease(int(iPos + m_iQueueSize));
+		return pSubject;
 	}
 
-	void resize ( unsigned int iNewSize )
+	// Approximate number of queued items.
+	unsigned int count () const
 	{
-		QueueItem *pOldItems = m_pQueueItems;
-		QueueItem *pNewItems = new QueueItem [iNewSize];
-		if (pOldItems) {
-			unsigned int iOldSize = m_iQueueIndex;
-			if (iOldSize > iNewSize)
-				iOldSize = iNewSize;
-			if (iOldSize > 0)
-				::memcpy(pNewItems, pOldItems, iOldSize * sizeof(QueueItem));
-			m_iQueueSize  = iNewSize;
-			m_pQueueItems = pNewItems;
-			delete [] pOldItems;
-		} else {
-			m_iQueueSize  = iNewSize;
-			m_pQueueItems = pNewItems;
-		}
+		const unsigned int iCount = (unsigned int) (
+			ATOMIC_GET(&m_iPushIndex) - ATOMIC_GET(&m_iPopIndex));
+		return (iCount > m_iQueueSize ? 0 : iCount);
 	}
 
-	bool isEmpty() const
-		{ return (m_iQueueIndex == 0); }
+	bool isEmpty () const
+		{ return (count() == 0); }
+
+	// Overflow (dropped notifications) counter.
+	unsigned int overflows () const
+		{ return ATOMIC_GET(&m_iOverflows); }
 
 private:
 
-	unsigned int m_iQueueIndex;
-	unsigned int m_iQueueSize;
-	QueueItem   *m_pQueueItems;
+	// Queue cell.
+	struct QueueCell
+	{
+		qtractorAtomic   sequence;
+		qtractorSubject *subject;
+	};
+
+	// Instance variables.
+	unsigned int   m_iQueueSize;
+	unsigned int   m_iQueueMask;
+	QueueCell     *m_pQueueCells;
+
+	qtractorAtomic m_iPushIndex;
+	qtractorAtomic m_iPopIndex;
+	qtractorAtomic m_iOverflows;
 };
 
 
-// The local subject queue singleton.
-static qtractorSubjectQueue g_subjectQueue;
+// The local subject queues singleton:
+// updates originated from the GUI thread are kept apart
+// from those coming from the real-time (audio, MIDI) threads.
+static struct qtractorSubjectQueues
+{
+	qtractorSubjectQueues ()
+		: guiThreadId(QThread::currentThreadId()) {}
+
+	qtractorSubjectQueue& queue ()
+		{ return (QThread::currentThreadId() == guiThreadId ? gui : rt); }
+
+	Qt::HANDLE guiThreadId;
+
+	qtractorSubjectQueue rt;
+	qtractorSubjectQueue gui;
+
+} g_subjectQueues;
 
 
 //---------------------------------------------------------------------------
@@ -121,11 +163,12 @@ static qtractorSubjectQueue g_subjectQueue;
 
 // Constructor.
 qtractorSubject::qtractorSubject ( float fValue, float fDefaultValue )
-	: m_fValue(fValue), m_bQueued(false),
+	: m_fValue(fValue), m_pQueueSender(nullptr),
 		m_fPrevValue(fValue), m_fLastValue(fValue),
 		m_fMinValue(0.0f), m_fMaxValue(1.0f), m_fDefaultValue(fDefaultValue),
 		m_bToggled(false), m_bInteger(false), m_pCurve(nullptr)
 {
+	ATOMIC_SET(&m_queued, 0);
 }
 
 // Destructor.
@@ -145,12 +188,17 @@ void qtractorSubject::setValue ( float fValue, qtractorObserver *pSender )
 	if (fValue == m_fValue)
 		return;
 
-	if (!m_bQueued) {
-		m_fPrevValue = m_fValue;
-		g_subjectQueue.push(this, pSender, fValue);
-	}
+	const float fPrevValue = m_fValue;
 
 	m_fValue = safeValue(fValue);
+	m_pQueueSender = pSender;
+
+	// Coalesce: queued only once until notified...
+	if (ATOMIC_CAS(&m_queued, 0, 1)) {
+		m_fPrevValue = fPrevValue;
+		if (!g_subjectQueues.queue().push(this))
+			ATOMIC_SET(&m_queued, 0);
+	}
 }
 
 
@@ -169,22 +217,91 @@ void qtractorSubject::notify (
 }
 
 
+// Queue flush helper -- notify pending observers, as much
+// as it was queued on entry (never starves on busy input).
+static int qtractorSubject_flush ( qtractorSubjectQueue& queue, bool bUpdate )
+{
+	int i = 0;
+	int n = int(queue.count());
+	qtractorSubject *pSubject;
+	while (n-- > 0 && (pSubject = queue.pop()) != nullptr) {
+		pSubject->setQueued(false);
+		pSubject->notify(pSubject->queueSender(), pSubject->value(), bUpdate);
+		++i;
+	}
+	return i;
+}
+
+
 // Queue flush (singleton) -- notify all pending observers.
 bool qtractorSubject::flushQueue ( bool bUpdate )
 {
-	return g_subjectQueue.flush(bUpdate);
+	int i = qtractorSubject_flush(g_subjectQueues.rt, bUpdate);
+	i += qtractorSubject_flush(g_subjectQueues.gui, bUpdate);
+
+	return (i > 0);
 }
 
 
 // Queue reset (clear).
 void qtractorSubject::resetQueue (void)
 {
-	g_subjectQueue.reset();
+	qtractorSubject *pSubject;
+	while ((pSubject = g_subjectQueues.rt.pop()) != nullptr)
+		pSubject->setQueued(false);
+	while ((pSubject = g_subjectQueues.gui.pop()) != nullptr)
+		pSubject->setQueued(false);
 }
 
 void qtractorSubject::clearQueue (void)
 {
-	g_subjectQueue.clear();
+	// Subjects may be already gone, don't touch'em...
+	while (g_subjectQueues.rt.pop())
+		;
+	while (g_subjectQueues.gui.pop())
+		;
+}
+
+
+// Queue status (index).
+bool qtractorSubject::isQueueEmpty (void)
+{
+	return g_subjectQueues.rt.isEmpty() && g_subjectQueues.gui.isEmpty();
+}
+
+
+// Queue overflow counters (real-time and GUI originated).
+unsigned int qtractorSubject::rtQueueOverflows (void)
+{
+	return g_subjectQueues.rt.overflows();
+}
+
+unsigned int qtractorSubject::guiQueueOverflows (void)
+{
+	return g_subjectQueues.gui.overflows();
+}
+
+
+// Queue overflow report (dropped since last call), if any.
+QString qtractorSubject::queueOverflowReport (void)
+{
+	static unsigned int s_iRtOverflows  = 0;
+	static unsigned int s_iGuiOverflows = 0;
+
+	const unsigned int iRtOverflows  = rtQueueOverflows();
+	const unsigned int iGuiOverflows = guiQueueOverflows();
+	if (s_iRtOverflows == iRtOverflows && s_iGuiOverflows == iGuiOverflows)
+		return QString();
+
+	const QString& sReport
+		= QObject::tr("Control updates: %1 real-time and %2 GUI notifications dropped.")
+		.arg(iRtOverflows - s_iRtOverflows)
+		.arg(iGuiOverflows - s_iGuiOverflows);
+
+	s_iRtOverflows  = iRtOverflows;
+	s_iGuiOverflows = iGuiOverflows;
+
+	return sReport;
 }
 
 
@@ -22,6 +22,8 @@
 #ifndef __qtractorObserver_h
 #define __qtractorObserver_h
 
+#include "qtractorAtomic.h"
+
 #include <QString>
 #include <QList>
 
@@ -71,9 +73,13 @@ public:
 
 	// Queue status accessors.
 	void setQueued(bool bQueued)
-		{ m_bQueued = bQueued; }
+		{ ATOMIC_SET(&m_queued, bQueued ? 1 : 0); }
 	bool isQueued() const
-		{ return m_bQueued; }
+		{ return (ATOMIC_GET(&m_queued) != 0); }
+
+	// Last queued sender accessor.
+	qtractorObserver *queueSender() const
+		{ return m_pQueueSender; }
 
 	// Direct address accessor.
 	float *data() { return &m_fValue; }
@@ -162,11 +168,21 @@ public:
 	// Queue status (index).
 	static bool isQueueEmpty ();
 
+	// Queue overflow counters (real-time and GUI originated).
+	static unsigned int rtQueueOverflows();
+	static unsigned int guiQueueOverflows();
+
+	// Queue overflow report (dropped since last call), if any.
+	static QString queueOverflowReport();
+
 private:
 
 	// Instance variables.
 	float   m_fValue;
-	bool	m_bQueued;
+
+	// Queue status (coalescing) and last sender.
+	qtractorAtomic    m_queued;
+	qtractorObserver *m_pQueueSender;
 
 	float   m_fPrevValue;
 	float   m_fLastValue;
@@ -101,6 +101,7 @@ void qtractorOptions::loadOptions (void)
 	iDisplayFormat  = m_settings.value("/DisplayFormat", 1).toInt();
 	iMaxRecentFiles = m_settings.value("/MaxRecentFiles", 5).toInt();
 	iBaseFontSize   = m_settings.value("/BaseFontSize", 0).toInt();
+	iMaxUndoMemory  = m_settings.value("/MaxUndoMemory", 256).toInt();
 	m_settings.endGroup();
 
 	// Load logging options...
@@ -148,6 +149,13 @@ void qtractorOptions::loadOptions (void)
 	bAudioAutoTimeStretch = m_settings.value("/AutoTimeStretch", false).toBool();
 	bAudioWsolaTimeStretch = m_settings.value("/WsolaTimeStretch", true).toBool();
 	bAudioWsolaQuickSeek = m_settings.value("/WsolaQuickSeek", false).toBool();
+	bAudioStretchCache   = m_settings.value("/StretchCache", false).toBool();
+	bAudioTranscodeCache = m_settings.value("/TranscodeCache", false).toBool();
+	iAudioTranscodeFormat = m_settings.value("/TranscodeFormat", 0).toInt();
+	iAudioTranscodeQuota = m_settings.value("/TranscodeQuota", 4096).toInt();
+	bAudioLoudnessMeters = m_settings.value("/LoudnessMeters", false).toBool();
+	bAudioDspProfile = m_settings.value("/DspProfile", false).toBool();
+	bAudioTrace = m_settings.value("/Trace", false).toBool();
 	bAudioPlayerBus      = m_settings.value("/PlayerBus", false).toBool();
 	bAudioMetroBus       = m_settings.value("/MetroBus", false).toBool();
 	bAudioMetronome      = m_settings.value("/Metronome", false).toBool();
@@ -164,6 +172,7 @@ void qtractorOptions::loadOptions (void)
 	iMidiCaptureQuantize = m_settings.value("/CaptureQuantize", 0).toInt();
 	iMidiQueueTimer    = m_settings.value("/QueueTimer", 0).toInt();
 	bMidiDriftCorrect  = m_settings.value("/DriftCorrect", true).toBool();
+	bMidiJackOutput    = m_settings.value("/JackOutput", false).toBool();
 	bMidiPlayerBus     = m_settings.value("/PlayerBus", false).toBool();
 	bMidiControlBus    = m_settings.value("/ControlBus", false).toBool();
 	bMidiMetroBus      = m_settings.value("/MetroBus", false).toBool();
@@ -405,6 +414,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/DisplayFormat", iDisplayFormat);
 	m_settings.setValue("/MaxRecentFiles", iMaxRecentFiles);
 	m_settings.setValue("/BaseFontSize", iBaseFontSize);
+	m_settings.setValue("/MaxUndoMemory", iMaxUndoMemory);
 	m_settings.endGroup();
 
 	// Save logging options...
@@ -452,6 +462,13 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/AutoTimeStretch", bAudioAutoTimeStretch);
 	m_settings.setValue("/WsolaTimeStretch", bAudioWsolaTimeStretch);
 	m_settings.setValue("/WsolaQuickSeek", bAudioWsolaQuickSeek);
+	m_settings.setValue("/StretchCache", bAudioStretchCache);
+	m_settings.setValue("/TranscodeCache", bAudioTranscodeCache);
+	m_settings.setValue("/TranscodeFormat", iAudioTranscodeFormat);
+	m_settings.setValue("/TranscodeQuota", iAudioTranscodeQuota);
+	m_settings.setValue("/LoudnessMeters", bAudioLoudnessMeters);
+	m_settings.setValue("/DspProfile", bAudioDspProfile);
+	m_settings.setValue("/Trace", bAudioTrace);
 	m_settings.setValue("/PlayerBus", bAudioPlayerBus);
 	m_settings.setValue("/MetroBus", bAudioMetroBus);
 	m_settings.setValue("/Metronome", bAudioMetronome);
@@ -468,6 +485,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/CaptureQuantize", iMidiCaptureQuantize);
 	m_settings.setValue("/QueueTimer", iMidiQueueTimer);
 	m_settings.setValue("/DriftCorrect", bMidiDriftCorrect);
+	m_settings.setValue("/JackOutput", bMidiJackOutput);
 	m_settings.setValue("/PlayerBus", bMidiPlayerBus);
 	m_settings.setValue("/ControlBus", bMidiControlBus);
 	m_settings.setValue("/MetroBus", bMidiMetroBus);
@@ -75,6 +75,7 @@ public:
 	bool    bKeepEditorsOnTop;
 	int     iDisplayFormat;
 	int     iBaseFontSize;
+	int     iMaxUndoMemory;
 
 	// Logging options...
 	bool    bMessagesLog;
@@ -114,6 +115,13 @@ public:
 	bool    bAudioAutoTimeStretch;
 	bool    bAudioWsolaTimeStretch;
 	bool    bAudioWsolaQuickSeek;
+	bool    bAudioStretchCache;
+	bool    bAudioTranscodeCache;
+	int     iAudioTranscodeFormat;
+	int     iAudioTranscodeQuota;
+	bool    bAudioLoudnessMeters;
+	bool    bAudioDspProfile;
+	bool    bAudioTrace;
 	bool    bAudioPlayerBus;
 	bool    bAudioMetroBus;
 	bool    bAudioMetronome;
@@ -137,6 +145,7 @@ public:
 	int  iMidiCaptureQuantize;
 	int  iMidiQueueTimer;
 	bool bMidiDriftCorrect;
+	bool bMidiJackOutput;
 	bool bMidiPlayerBus;
 	bool bMidiControlBus;
 	bool bMidiMetroBus;
@@ -248,6 +248,15 @@ qtractorOptionsForm::qtractorOptionsForm ( QWidget *pParent )
 	QObject::connect(m_ui.AudioWsolaQuickSeekCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.AudioStretchCacheCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.AudioTranscodeCacheCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.AudioLoudnessMetersCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.AudioPlayerBusCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
@@ -296,6 +305,9 @@ qtractorOptionsForm::qtractorOptionsForm ( QWidget *pParent )
 	QObject::connect(m_ui.MidiDriftCorrectCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.MidiJackOutputCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.MidiPlayerBusCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
@@ -585,6 +597,9 @@ void qtractorOptionsForm::setOptions ( qtractorOptions *pOptions )
 	m_ui.AudioWsolaTimeStretchCheckBox->setEnabled(false);
 #endif
 	m_ui.AudioWsolaQuickSeekCheckBox->setChecked(m_pOptions->bAudioWsolaQuickSeek);
+	m_ui.AudioStretchCacheCheckBox->setChecked(m_pOptions->bAudioStretchCache);
+	m_ui.AudioTranscodeCacheCheckBox->setChecked(m_pOptions->bAudioTranscodeCache);
+	m_ui.AudioLoudnessMetersCheckBox->setChecked(m_pOptions->bAudioLoudnessMeters);
 	m_ui.AudioPlayerBusCheckBox->setChecked(m_pOptions->bAudioPlayerBus);
 	m_ui.AudioPlayerAutoConnectCheckBox->setChecked(m_pOptions->bAudioPlayerAutoConnect);
 
@@ -616,6 +631,7 @@ void qtractorOptionsForm::setOptions ( qtractorOptions *pOptions )
 	m_ui.MidiQueueTimerComboBox->setCurrentIndex(
 		timer.indexOf(m_pOptions->iMidiQueueTimer));
 	m_ui.MidiDriftCorrectCheckBox->setChecked(m_pOptions->bMidiDriftCorrect);
+	m_ui.MidiJackOutputCheckBox->setChecked(m_pOptions->bMidiJackOutput);
 	m_ui.MidiPlayerBusCheckBox->setChecked(m_pOptions->bMidiPlayerBus);
 
 	// MIDI control options.
@@ -823,6 +839,9 @@ void qtractorOptionsForm::accept (void)
 		m_pOptions->bAudioAutoTimeStretch = m_ui.AudioAutoTimeStretchCheckBox->isChecked();
 		m_pOptions->bAudioWsolaTimeStretch = m_ui.AudioWsolaTimeStretchCheckBox->isChecked();
 		m_pOptions->bAudioWsolaQuickSeek = m_ui.AudioWsolaQuickSeekCheckBox->isChecked();
+		m_pOptions->bAudioStretchCache   = m_ui.AudioStretchCacheCheckBox->isChecked();
+		m_pOptions->bAudioTranscodeCache = m_ui.AudioTranscodeCacheCheckBox->isChecked();
+		m_pOptions->bAudioLoudnessMeters = m_ui.AudioLoudnessMetersCheckBox->isChecked();
 		m_pOptions->bAudioPlayerBus      = m_ui.AudioPlayerBusCheckBox->isChecked();
 		m_pOptions->bAudioPlayerAutoConnect = m_ui.AudioPlayerAutoConnectCheckBox->isChecked();
 		// Audio metronome options.
@@ -840,6 +859,7 @@ void qtractorOptionsForm::accept (void)
 		m_pOptions->iMidiQueueTimer      = m_ui.MidiQueueTimerComboBox->itemData(
 			m_ui.MidiQueueTimerComboBox->currentIndex()).toInt();
 		m_pOptions->bMidiDriftCorrect    = m_ui.MidiDriftCorrectCheckBox->isChecked();
+		m_pOptions->bMidiJackOutput      = m_ui.MidiJackOutputCheckBox->isChecked();
 		m_pOptions->bMidiPlayerBus       = m_ui.MidiPlayerBusCheckBox->isChecked();
 		m_pOptions->iMidiMmcMode         = m_ui.MidiMmcModeComboBox->currentIndex();
 		m_pOptions->iMidiMmcDevice       = m_ui.MidiMmcDeviceComboBox->currentIndex();
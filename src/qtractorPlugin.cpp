@@ -37,6 +37,8 @@
 
 #include "qtractorMessageList.h"
 
+#include "qtractorRtAudit.h"
+
 #include <QDomDocument>
 #include <QDomElement>
 #include <QTextStream>
@@ -46,6 +48,8 @@
 #include <QFile>
 #include <QDir>
 
+#include <QThread>
+
 #include <cmath>
 
 #include <dlfcn.h>
@@ -241,8 +245,16 @@ qtractorPlugin::qtractorPlugin (
 		m_bActivated(false), m_bAutoDeactivated(false),
 		m_activateObserver(this),
 		m_iActivateSubjectIndex(0), m_pForm(nullptr), m_iEditorType(-1),
-		m_iDirectAccessParamIndex(-1)
+		m_iDirectAccessParamIndex(-1),
+		m_pParamChanges(nullptr), m_iParamChanges(0), m_iParamBlock(0),
+		m_pParamChangesPending(nullptr)
 {
+	// Parameter change blocks are allocated on demand...
+	m_paramChanges[0] = nullptr;
+	m_paramChanges[1] = nullptr;
+
+	ATOMIC_SET(&m_paramChangesBusy, 0);
+
 	// Acquire a local unique id in chain...
 	if (m_pList && m_pType)
 		m_iUniqueID = m_pList->createUniqueID(m_pType);
@@ -263,6 +275,10 @@ qtractorPlugin::~qtractorPlugin (void)
 	qDeleteAll(m_params);
 	m_params.clear();
 
+	// Parameter change blocks...
+	delete m_paramChanges[1];
+	delete m_paramChanges[0];
+
 	qDeleteAll(m_properties);
 	m_properties.clear();
 
@@ -989,7 +1005,9 @@ void qtractorPlugin::realizeValues (void)
 	qDebug("qtractorPlugin[%p]::realizeValues()", this);
 #endif
 
-	// (Re)set parameter values (initial)...
+	// (Re)set parameter values (initial), all at once...
+	beginParamChanges();
+
 	ValueIndex::ConstIterator param = m_values.index.constBegin();
 	const ValueIndex::ConstIterator& param_end = m_values.index.constEnd();
 	for ( ; param != param_end; ++param) {
@@ -1004,6 +1022,8 @@ void qtractorPlugin::realizeValues (void)
 		if (pParam)
 			pParam->setValue(param.value(), true);
 	}
+
+	endParamChanges();
 }
 
 
@@ -1115,6 +1135,212 @@ void qtractorPlugin::updateParamValue (
 }
 
 
+// Parameter change block (staged changes).
+struct qtractorPlugin::ParamChanges
+{
+	// Constructor.
+	ParamChanges(unsigned int iSize)
+		: count(0), size(iSize),
+			params(new Param * [iSize]), values(new float [iSize]) {}
+
+	// Destructor.
+	~ParamChanges() { delete [] values; delete [] params; }
+
+	// Make room, keeping the changes staged so far.
+	void resize(unsigned int iSize)
+	{
+		if (size >= iSize)
+			return;
+		Param **new_params = new Param * [iSize];
+		float  *new_values = new float [iSize];
+		for (unsigned int i = 0; i < count; ++i) {
+			new_params[i] = params[i];
+			new_values[i] = values[i];
+		}
+		delete [] values;
+		delete [] params;
+		params = new_params;
+		values = new_values;
+		size = iSize;
+	}
+
+	// Carry over another block's changes, ahead of these.
+	void prepend(ParamChanges *pParamChanges)
+	{
+		const unsigned int n = pParamChanges->count;
+		resize(count + n);
+		for (unsigned int i = count; i > 0; --i) {
+			params[i - 1 + n] = params[i - 1];
+			values[i - 1 + n] = values[i - 1];
+		}
+		for (unsigned int i = 0; i < n; ++i) {
+			params[i] = pParamChanges->params[i];
+			values[i] = pParamChanges->values[i];
+		}
+		count += n;
+		pParamChanges->count = 0;
+	}
+
+	// Member fields.
+	unsigned int count;
+	unsigned int size;
+	Param      **params;
+	float       *values;
+};
+
+
+// Parameter change batching.
+void qtractorPlugin::beginParamChanges (void)
+{
+	if (++m_iParamChanges > 1)
+		return;
+
+	m_pParamChanges = acquireParamChanges();
+}
+
+
+void qtractorPlugin::endParamChanges (void)
+{
+	if (m_iParamChanges < 1 || --m_iParamChanges > 0)
+		return;
+
+	publishParamChanges(m_pParamChanges);
+
+	m_pParamChanges = nullptr;
+}
+
+
+// Stage a parameter change (while batching only).
+bool qtractorPlugin::stageParamChange ( Param *pParam, float fValue )
+{
+	if (m_pParamChanges == nullptr)
+		return false;
+
+	// Block full? hand it over and carry on with the other one...
+	if (m_pParamChanges->count >= m_pParamChanges->size) {
+		publishParamChanges(m_pParamChanges);
+		m_pParamChanges = acquireParamChanges();
+	}
+
+	const unsigned int i = m_pParamChanges->count++;
+	m_pParamChanges->params[i] = pParam;
+	m_pParamChanges->values[i] = fValue;
+
+	return true;
+}
+
+
+// Get hold of the block that's not in use by the real-time thread.
+qtractorPlugin::ParamChanges *qtractorPlugin::acquireParamChanges (void)
+{
+	// Blocks alternate on each hand over...
+	const int iBlock = m_iParamBlock;
+	ParamChanges *pParamChanges = m_paramChanges[iBlock];
+
+	// Still not taken? reclaim it, carrying its changes over,
+	// as only the real-time thread may apply them (eg. VST3);
+	// otherwise wait for the real-time thread to be done with it.
+	if (pParamChanges && m_pParamChangesPending.testAndSetOrdered(
+			pParamChanges, nullptr))
+		; // Keep staged changes, in order...
+	else
+	while (ATOMIC_GET(&m_paramChangesBusy))
+		QThread::yieldCurrentThread();
+
+	// Make sure there's room for all parameters...
+	const unsigned int iSize = qMax(m_params.count(), 16);
+	if (pParamChanges == nullptr) {
+		pParamChanges = new ParamChanges(iSize);
+		m_paramChanges[iBlock] = pParamChanges;
+	}
+	else pParamChanges->resize(iSize);
+
+	return pParamChanges;
+}
+
+
+// Hand a staged block over to the real-time thread.
+void qtractorPlugin::publishParamChanges ( ParamChanges *pParamChanges )
+{
+	if (pParamChanges == nullptr || pParamChanges->count < 1)
+		return;
+
+	// Next one goes to the other block...
+	m_iParamBlock = (pParamChanges == m_paramChanges[0] ? 1 : 0);
+
+	// Update specifics, as would have been done on each change...
+	updateParamChanges(pParamChanges);
+
+	// Reclaim any previous one, not yet taken, carrying it over...
+	ParamChanges *pPrevChanges = m_pParamChangesPending.fetchAndStoreOrdered(nullptr);
+	if (pPrevChanges && pPrevChanges != pParamChanges)
+		pParamChanges->prepend(pPrevChanges);
+
+	// Not being processed? apply'em right away...
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr || !pSession->isActivated()
+		|| m_pList == nullptr || !m_pList->isActivated()) {
+		applyParamChanges(pParamChanges);
+		return;
+	}
+
+	// Make sure the chain gets processed next cycle...
+	m_pList->resetTail();
+
+	m_pParamChangesPending.storeRelease(pParamChanges);
+}
+
+
+// Update plugin specifics of a parameter change block (non real-time).
+void qtractorPlugin::updateParamChanges ( ParamChanges *pParamChanges )
+{
+	bool bDirectAccessParam = false;
+
+	for (unsigned int i = 0; i < pParamChanges->count; ++i) {
+		Param *pParam = pParamChanges->params[i];
+		updateStagedParam(pParam, pParamChanges->values[i]);
+		if (m_iDirectAccessParamIndex == long(pParam->index()))
+			bDirectAccessParam = true;
+	}
+
+	if (bDirectAccessParam)
+		updateDirectAccessParam();
+}
+
+
+// Apply pending parameter changes (real-time).
+void qtractorPlugin::applyParamChanges (void)
+{
+	if (m_pParamChangesPending.loadAcquire() == nullptr)
+		return;
+
+	ATOMIC_SET(&m_paramChangesBusy, 1);
+
+	ParamChanges *pParamChanges = m_pParamChangesPending.fetchAndStoreOrdered(nullptr);
+	if (pParamChanges)
+		applyParamChanges(pParamChanges);
+
+	ATOMIC_CAS(&m_paramChangesBusy, 1, 0);
+}
+
+
+// Apply a parameter change block (real-time, or else while not being
+// processed): raw values and real-time specifics only, as the others
+// were already updated on hand over; other observers (eg. widgets)
+// get notified later, through the subject queue.
+void qtractorPlugin::applyParamChanges ( ParamChanges *pParamChanges )
+{
+	for (unsigned int i = 0; i < pParamChanges->count; ++i) {
+		Param *pParam = pParamChanges->params[i];
+		const float fValue = pParamChanges->values[i];
+		pParam->observer()->setValue(fValue);
+		applyStagedParam(pParam, fValue);
+	}
+
+	pParamChanges->count = 0;
+}
+
+
 // Load plugin parameter controllers (MIDI).
 void qtractorPlugin::loadControllers (
 	QDomElement *pElement, qtractorMidiControl::Controllers& controllers )
@@ -1593,6 +1819,10 @@ void qtractorPlugin::Param::setValue ( float fValue, bool bUpdate )
 	if (isBoundedBelow() && fValue < minValue())
 		fValue = minValue();
 
+	// Batching? leave it for the real-time thread...
+	if (bUpdate && m_pPlugin->stageParamChange(this, fValue))
+		return;
+
 	m_observer.setValue(fValue);
 
 	// Update specifics.
@@ -1691,7 +1921,7 @@ qtractorPluginList::qtractorPluginList (
 		m_pMidiProgramSubject(nullptr),
 		m_bAutoDeactivated(false),
 		m_bAudioOutputMonitor(false),
-		m_bLatency(false), m_iLatency(0)
+		m_bLatency(false), m_iLatency(0), m_iTailFrames(0)
 {
 	setAutoDelete(true);
 
@@ -1886,6 +2116,9 @@ void qtractorPluginList::resetBuffers (void)
 		for (unsigned short i = 0; i < m_iChannels; ++i)
 			::memset(m_pppBuffers[1][i], 0, iBufferSizeEx * sizeof(float));
 	}
+
+	// Reset tail/decay tracking...
+	resetTail();
 #if 0
 	// Restore activation of all previously deactivated plugins...
 	for (qtractorPlugin *pPlugin = first();
@@ -1900,6 +2133,16 @@ void qtractorPluginList::resetBuffers (void)
 }
 
 
+// Graph-wide plugin delay compensation (path latencies) reset,
+// deferred: just mark dirty, all gets reset once when idle.
+static void qtractorPluginList_resetPathLatencies (void)
+{
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession && pSession->audioEngine())
+		pSession->audioEngine()->setPathLatenciesDirty();
+}
+
+
 // Add-guarded plugin method.
 void qtractorPluginList::addPlugin ( qtractorPlugin *pPlugin )
 {
@@ -1934,6 +2177,9 @@ void qtractorPluginList::insertPlugin (
 
 	// Update plugins for auto-plugin-deactivation...
 	autoDeactivatePlugins(m_bAutoDeactivated, true);
+
+	// Plugin topology has changed, so might path latencies...
+	qtractorPluginList_resetPathLatencies();
 }
 
 
@@ -2012,6 +2258,9 @@ void qtractorPluginList::movePlugin (
 	autoDeactivatePlugins(m_bAutoDeactivated, true);
 	if (pPluginList != this)
 		pPluginList->autoDeactivatePlugins(m_bAutoDeactivated, true);
+
+	// Plugin topology has changed, so might path latencies...
+	qtractorPluginList_resetPathLatencies();
 }
 
 
@@ -2029,6 +2278,9 @@ void qtractorPluginList::removePlugin ( qtractorPlugin *pPlugin )
 
 	// update Plugins for Auto-plugin-deactivation
 	autoDeactivatePlugins(m_bAutoDeactivated, true);
+
+	// Plugin topology has changed, so might path latencies...
+	qtractorPluginList_resetPathLatencies();
 }
 
 
@@ -2096,6 +2348,8 @@ void qtractorPluginList::removeView ( qtractorPluginListView *pView )
 // The meta-main audio-processing plugin-chain procedure.
 void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 {
+	QTRACTOR_RT_AUDIT_SCOPE("qtractorPluginList::process");
+
 	// Sanity checks...
 	if (!isActivated())
 		return;
@@ -2113,6 +2367,9 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 	for (qtractorPlugin *pPlugin = first();
 			pPlugin; pPlugin = pPlugin->next()) {
 
+		// Staged parameter changes, all at once...
+		pPlugin->applyParamChanges();
+
 		// Must be properly activated...
 		if (!pPlugin->isActivated())
 			continue;
@@ -2121,6 +2378,7 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 		float **ppIBuffer = m_pppBuffers[  iBuffer & 1];
 		float **ppOBuffer = m_pppBuffers[++iBuffer & 1];
 		// Time for the real thing...
+		qtractorDspProfileScope dspProfile(pPlugin->dspProfile());
 		pPlugin->process(ppIBuffer, ppOBuffer, nframes);
 	}
 
@@ -2134,6 +2392,40 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 }
 
 
+// Plugin-chain tail/decay tracking: whether the input was silent,
+// measures the output and counts down the remaining tail frames,
+// held for as long as the output is found above threshold.
+void qtractorPluginList::updateTail ( float **ppBuffer,
+	unsigned int nframes, bool bSilent, unsigned long iTailHold )
+{
+	// Decay threshold (about -120dB).
+	static const float c_fTailThreshold = 1E-6f;
+
+	iTailHold += m_iLatency;
+
+	if (!bSilent || m_iTailFrames > iTailHold) {
+		m_iTailFrames = iTailHold;
+		return;
+	}
+
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		const float *pFrames = ppBuffer[i];
+		for (unsigned int n = 0; n < nframes; ++n) {
+			if (pFrames[n] > c_fTailThreshold
+				|| pFrames[n] < -c_fTailThreshold) {
+				m_iTailFrames = iTailHold;
+				return;
+			}
+		}
+	}
+
+	if (m_iTailFrames > nframes)
+		m_iTailFrames -= nframes;
+	else
+		m_iTailFrames = 0;
+}
+
+
 // Create/load plugin state.
 qtractorPlugin *qtractorPluginList::loadPlugin ( QDomElement *pElement )
 {
@@ -28,6 +28,9 @@
 
 #include "qtractorDocument.h"
 
+#include "qtractorAtomic.h"
+#include "qtractorDspProfile.h"
+
 #include <QStringList>
 #include <QPoint>
 #include <QSize>
@@ -334,6 +337,14 @@ public:
 	virtual void updateParam(
 		Param */*pParam*/, float /*fValue*/, bool /*bUpdate*/) {}
 
+	// Staged parameter change specifics: the non real-time part,
+	// updated on hand over (default: as any other update), and
+	// the real-time part, applied right before processing.
+	virtual void updateStagedParam(Param *pParam, float fValue)
+		{ updateParam(pParam, fValue, true); }
+	virtual void applyStagedParam(
+		Param */*pParam*/, float /*fValue*/) {}
+
 	// Specific MIDI instrument selector.
 	virtual void selectProgram(int /*iBank*/, int /*iProg*/) {}
 
@@ -549,6 +560,25 @@ public:
 	// Parameter update executive.
 	void updateParamValue(unsigned long iIndex, float fValue, bool bUpdate);
 
+	// DSP load profile accessor.
+	qtractorDspProfile *dspProfile()
+		{ return &m_dspProfile; }
+
+	// Parameter change batching (eg. preset loads): changes in between
+	// are staged and then handed over to the real-time thread as a whole,
+	// applied at once at the start of its next process cycle.
+	void beginParamChanges();
+	void endParamChanges();
+
+	bool isParamChanges() const
+		{ return (m_iParamChanges > 0); }
+
+	// Stage a parameter change (while batching only).
+	bool stageParamChange(Param *pParam, float fValue);
+
+	// Apply pending parameter changes (real-time).
+	void applyParamChanges();
+
 	// Auto-plugin-deactivation
 	void autoDeactivatePlugin(bool bDeactivated);
 	bool canBeConnectedToOtherTracks() const;
@@ -565,6 +595,14 @@ protected:
 	void updateActivated(bool bActivated);
 	void updateActivatedEx(bool bActivated);
 
+	// Parameter change block (double-buffered) helpers.
+	struct ParamChanges;
+
+	ParamChanges *acquireParamChanges();
+	void publishParamChanges(ParamChanges *pParamChanges);
+	void updateParamChanges(ParamChanges *pParamChanges);
+	void applyParamChanges(ParamChanges *pParamChanges);
+
 	// Plugin configure and parameter/state clearance.
 	void clearConfigs() { m_configs.clear(); m_ctypes.clear(); }
 	void clearValues()  { m_values.names.clear(); m_values.index.clear(); }
@@ -653,6 +691,18 @@ private:
 	// Direct access parameter, if any.
 	long m_iDirectAccessParamIndex;
 
+	// Parameter change blocks (double-buffered).
+	ParamChanges *m_paramChanges[2];
+	ParamChanges *m_pParamChanges;
+	unsigned int  m_iParamChanges;
+	int           m_iParamBlock;
+
+	QAtomicPointer<ParamChanges> m_pParamChangesPending;
+	qtractorAtomic m_paramChangesBusy;
+
+	// DSP load profile.
+	qtractorDspProfile m_dspProfile;
+
 	// Default preset name.
 	static QString g_sDefPreset;
 };
@@ -894,6 +944,7 @@ public:
 		else
 		if (m_iActivated > 0)
 			--m_iActivated;
+		resetTail();
 	}
 
 	bool isActivatedAll() const
@@ -921,6 +972,18 @@ public:
 	// The meta-main audio-processing plugin-chain procedure.
 	void process(float **ppBuffer, unsigned int nframes);
 
+	// Silence propagation: whether the plugin-chain may be
+	// skipped altogether, while its input is kept silent.
+	bool isIdle() const
+		{ return (m_iTailFrames == 0 || !isActivated())
+			&& !isAudioInsertActivated(); }
+
+	// Plugin-chain tail/decay tracking (after processing).
+	void updateTail(float **ppBuffer, unsigned int nframes,
+		bool bSilent, unsigned long iTailHold);
+	void resetTail()
+		{ m_iTailFrames = (unsigned long) -1; }
+
 	// Forward declarations.
 	class Document;
 	class WaitCursor;
@@ -1094,6 +1157,9 @@ private:
 	// Plugin chain total latency (in frames);
 	bool          m_bLatency;
 	unsigned long m_iLatency;
+
+	// Plugin chain remaining tail/decay (in frames).
+	unsigned long m_iTailFrames;
 };
 
 
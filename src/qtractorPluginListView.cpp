@@ -1394,6 +1394,10 @@ bool qtractorPluginListView::eventFilter ( QObject *pObject, QEvent *pEvent )
 								.arg(pDirectAccessParam->display()));
 						}
 					}
+					const QString& sDspProfile
+						= pPlugin->dspProfile()->text();
+					if (!sDspProfile.isEmpty())
+						sToolTip.append('\n' + sDspProfile);
 					QToolTip::showText(pHelpEvent->globalPos(),
 						sToolTip, pViewport);
 					return true;
@@ -0,0 +1,347 @@
+// qtractorRtAudit.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorRtAudit.h"
+
+
+#ifdef CONFIG_RTAUDIT
+
+#include "qtractorAtomic.h"
+
+#include <QObject>
+#include <QHash>
+
+#include <execinfo.h>
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <errno.h>
+
+
+// Audit log size (power of two) and caller frames per record.
+#define QTRACTOR_RT_AUDIT_SIZE    512
+#define QTRACTOR_RT_AUDIT_FRAMES  4
+
+// Frames to skip on backtrace (record() and the interposer).
+#define QTRACTOR_RT_AUDIT_SKIP    2
+
+
+// Audit log record.
+struct qtractorRtAudit_Record
+{
+	qtractorAtomic ready;
+	int            kind;
+	const char    *tag;
+	void          *frames[QTRACTOR_RT_AUDIT_FRAMES];
+};
+
+
+// Audit log (lock-free ring).
+static qtractorRtAudit_Record g_rtAuditRecords[QTRACTOR_RT_AUDIT_SIZE];
+
+static qtractorAtomic g_iRtAuditWrite;
+static qtractorAtomic g_iRtAuditRead;
+
+static qtractorAtomic g_iRtAuditCount;
+static qtractorAtomic g_iRtAuditDropped;
+
+
+// Per-thread audit state.
+static __thread const char *g_pszRtAuditTag = nullptr;
+static __thread bool g_bRtAuditRealTime = false;
+static __thread bool g_bRtAuditBusy = false;
+
+
+//----------------------------------------------------------------------
+// class qtractorRtAudit::Scope -- Audit scope guard (stack-tagged).
+//
+
+// Constructor.
+qtractorRtAudit::Scope::Scope ( const char *pszTag, bool bRealTime )
+	: m_pszPrevTag(g_pszRtAuditTag), m_bPrevRealTime(g_bRtAuditRealTime)
+{
+	g_pszRtAuditTag = pszTag;
+
+	if (bRealTime)
+		g_bRtAuditRealTime = true;
+}
+
+
+// Destructor.
+qtractorRtAudit::Scope::~Scope (void)
+{
+	g_bRtAuditRealTime = m_bPrevRealTime;
+	g_pszRtAuditTag = m_pszPrevTag;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorRtAudit -- Real-time safety audit (instrumentation).
+//
+
+// Whether the current thread is inside a real-time scope.
+bool qtractorRtAudit::isRealTime (void)
+{
+	return g_bRtAuditRealTime && !g_bRtAuditBusy;
+}
+
+
+// Record a violation (lock-free, never allocates).
+void qtractorRtAudit::record ( Kind kind )
+{
+	g_bRtAuditBusy = true;
+
+	g_iRtAuditCount.fetchAndAddRelaxed(1);
+
+	// Reserve a slot, if any...
+	int iWrite;
+	for (;;) {
+		iWrite = ATOMIC_GET(&g_iRtAuditWrite);
+		if (iWrite - ATOMIC_GET(&g_iRtAuditRead) >= QTRACTOR_RT_AUDIT_SIZE) {
+			g_iRtAuditDropped.fetchAndAddRelaxed(1);
+			g_bRtAuditBusy = false;
+			return;
+		}
+		if (ATOMIC_CAS(&g_iRtAuditWrite, iWrite, iWrite + 1))
+			break;
+	}
+
+	qtractorRtAudit_Record *pRecord
+		= &g_rtAuditRecords[iWrite & (QTRACTOR_RT_AUDIT_SIZE - 1)];
+
+	pRecord->kind = int(kind);
+	pRecord->tag  = g_pszRtAuditTag;
+
+	void *frames[QTRACTOR_RT_AUDIT_FRAMES + QTRACTOR_RT_AUDIT_SKIP];
+	const int nframes = ::backtrace(frames,
+		QTRACTOR_RT_AUDIT_FRAMES + QTRACTOR_RT_AUDIT_SKIP);
+	for (int i = 0; i < QTRACTOR_RT_AUDIT_FRAMES; ++i) {
+		const int j = i + QTRACTOR_RT_AUDIT_SKIP;
+		pRecord->frames[i] = (j < nframes ? frames[j] : nullptr);
+	}
+
+	pRecord->ready.storeRelease(1);
+
+	g_bRtAuditBusy = false;
+}
+
+
+// Caller frame symbol name resolver (non real-time).
+static QString qtractorRtAudit_symbol ( void *pvFrame )
+{
+	Dl_info info;
+	if (::dladdr(pvFrame, &info) == 0 || info.dli_sname == nullptr)
+		return QString("%1").arg(quintptr(pvFrame), 0, 16);
+
+	int status = 0;
+	char *pszName = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+	if (pszName == nullptr || status != 0)
+		return QString::fromLatin1(info.dli_sname);
+
+	const QString sName = QString::fromLatin1(pszName);
+	::free(pszName);
+	return sName;
+}
+
+
+// Collect new (unique) violation reports (non real-time).
+QStringList qtractorRtAudit::reports (void)
+{
+	static const char *s_apszKinds[] = {
+		"malloc", "calloc", "realloc", "free", "memalign", "mutex lock"
+	};
+
+	// Already reported sites (by tag and callers).
+	static QHash<QString, unsigned int> s_sites;
+	static unsigned int s_iDropped = 0;
+
+	QStringList reports;
+
+	int iRead = ATOMIC_GET(&g_iRtAuditRead);
+	while (iRead != ATOMIC_GET(&g_iRtAuditWrite)) {
+		qtractorRtAudit_Record *pRecord
+			= &g_rtAuditRecords[iRead & (QTRACTOR_RT_AUDIT_SIZE - 1)];
+		if (pRecord->ready.loadAcquire() == 0)
+			break;
+		QStringList callers;
+		for (int i = 0; i < QTRACTOR_RT_AUDIT_FRAMES; ++i) {
+			if (pRecord->frames[i])
+				callers.append(qtractorRtAudit_symbol(pRecord->frames[i]));
+		}
+		const char *pszKind = s_apszKinds[pRecord->kind];
+		const char *pszTag = (pRecord->tag ? pRecord->tag : "?");
+		pRecord->ready.storeRelease(0);
+		ATOMIC_SET(&g_iRtAuditRead, ++iRead);
+		const QString& sSite = QString("%1 in %2: %3")
+			.arg(pszKind).arg(pszTag).arg(callers.join(" < "));
+		if (++s_sites[sSite] == 1)
+			reports.append(QObject::tr("RT-AUDIT: %1").arg(sSite));
+	}
+
+	const unsigned int iDropped = dropped();
+	if (s_iDropped != iDropped) {
+		reports.append(QObject::tr("RT-AUDIT: %1 records dropped.")
+			.arg(iDropped - s_iDropped));
+		s_iDropped = iDropped;
+	}
+
+	return reports;
+}
+
+
+// Total number of violations and dropped records so far.
+unsigned int qtractorRtAudit::count (void)
+{
+	return ATOMIC_GET(&g_iRtAuditCount);
+}
+
+unsigned int qtractorRtAudit::dropped (void)
+{
+	return ATOMIC_GET(&g_iRtAuditDropped);
+}
+
+
+#if defined(__GLIBC__)
+
+// Real (next in line) pthread_mutex_lock, resolved at run-time,
+// as its __pthread_mutex_lock alias is not linkable with newer glibc.
+typedef int (*qtractorRtAudit_MutexLock)(pthread_mutex_t *);
+
+static qtractorRtAudit_MutexLock g_pfnRtAuditMutexLock = nullptr;
+
+static qtractorRtAudit_MutexLock qtractorRtAudit_mutexLock (void)
+{
+	if (g_pfnRtAuditMutexLock == nullptr) {
+		g_pfnRtAuditMutexLock = qtractorRtAudit_MutexLock(
+			::dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+	}
+
+	return g_pfnRtAuditMutexLock;
+}
+
+#endif	// __GLIBC__
+
+
+// Early initialization (eg. backtrace warm-up).
+void qtractorRtAudit::init (void)
+{
+	// First backtrace() call may load libgcc_s and allocate...
+	void *frames[QTRACTOR_RT_AUDIT_FRAMES];
+	::backtrace(frames, QTRACTOR_RT_AUDIT_FRAMES);
+
+#if defined(__GLIBC__)
+	// Never resolve symbols from the real-time thread...
+	qtractorRtAudit_mutexLock();
+#endif
+}
+
+
+//----------------------------------------------------------------------
+// Process-wide interposers (GNU libc only).
+//
+
+#if defined(__GLIBC__)
+
+extern "C" {
+
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void *, size_t);
+extern void  __libc_free(void *);
+extern void *__libc_memalign(size_t, size_t);
+
+
+void *malloc ( size_t size )
+{
+	if (qtractorRtAudit::isRealTime())
+		qtractorRtAudit::record(qtractorRtAudit::Malloc);
+
+	return __libc_malloc(size);
+}
+
+void *calloc ( size_t nmemb, size_t size )
+{
+	if (qtractorRtAudit::isRealTime())
+		qtractorRtAudit::record(qtractorRtAudit::Calloc);
+
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc ( void *ptr, size_t size )
+{
+	if (qtractorRtAudit::isRealTime())
+		qtractorRtAudit::record(qtractorRtAudit::Realloc);
+
+	return __libc_realloc(ptr, size);
+}
+
+void free ( void *ptr )
+{
+	if (ptr && qtractorRtAudit::isRealTime())
+		qtractorRtAudit::record(qtractorRtAudit::Free);
+
+	__libc_free(ptr);
+}
+
+void *memalign ( size_t alignment, size_t size )
+{
+	if (qtractorRtAudit::isRealTime())
+		qtractorRtAudit::record(qtractorRtAudit::MemAlign);
+
+	return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc ( size_t alignment, size_t size )
+{
+	return memalign(alignment, size);
+}
+
+int posix_memalign ( void **memptr, size_t alignment, size_t size )
+{
+	if (alignment % sizeof(void *) || (alignment & (alignment - 1)))
+		return EINVAL;
+
+	void *ptr = memalign(alignment, size);
+	if (ptr == nullptr)
+		return ENOMEM;
+
+	*memptr = ptr;
+	return 0;
+}
+
+int pthread_mutex_lock ( pthread_mutex_t *mutex )
+{
+	if (qtractorRtAudit::isRealTime())
+		qtractorRtAudit::record(qtractorRtAudit::MutexLock);
+
+	return (*qtractorRtAudit_mutexLock())(mutex);
+}
+
+}	// extern "C"
+
+#endif	// __GLIBC__
+
+#endif	// CONFIG_RTAUDIT
+
+
+// end of qtractorRtAudit.cpp
@@ -0,0 +1,103 @@
+// qtractorRtAudit.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorRtAudit_h
+#define __qtractorRtAudit_h
+
+#include "qtractorAbout.h"
+
+
+#ifdef CONFIG_RTAUDIT
+
+#include <QStringList>
+
+
+//----------------------------------------------------------------------
+// class qtractorRtAudit -- Real-time safety audit (instrumentation).
+//
+// Heap allocations (malloc, calloc, realloc, free, memalign) and mutex
+// locks are interposed process-wide; the ones called from inside a
+// real-time scope (ie. the JACK process callback) are recorded, tagged
+// with the innermost audit scope name and a few caller frames, into a
+// lock-free log, to be reported later on the messages window.
+//
+
+class qtractorRtAudit
+{
+public:
+
+	// Violation kinds.
+	enum Kind { Malloc = 0, Calloc, Realloc, Free, MemAlign, MutexLock };
+
+	// Audit scope guard (stack-tagged).
+	class Scope
+	{
+	public:
+
+		// Constructor.
+		Scope(const char *pszTag, bool bRealTime = false);
+
+		// Destructor.
+		~Scope();
+
+	private:
+
+		// Instance variables.
+		const char *m_pszPrevTag;
+		bool        m_bPrevRealTime;
+	};
+
+	// Whether the current thread is inside a real-time scope.
+	static bool isRealTime();
+
+	// Record a violation (lock-free, never allocates).
+	static void record(Kind kind);
+
+	// Collect new (unique) violation reports (non real-time).
+	static QStringList reports();
+
+	// Total number of violations and dropped records so far.
+	static unsigned int count();
+	static unsigned int dropped();
+
+	// Early initialization (eg. backtrace warm-up).
+	static void init();
+};
+
+
+// Audit scope helper macros.
+#define QTRACTOR_RT_AUDIT_PROCESS(tag) \
+	qtractorRtAudit::Scope __qtractor_rt_audit(tag, true)
+#define QTRACTOR_RT_AUDIT_SCOPE(tag) \
+	qtractorRtAudit::Scope __qtractor_rt_audit(tag)
+
+#else
+
+#define QTRACTOR_RT_AUDIT_PROCESS(tag)
+#define QTRACTOR_RT_AUDIT_SCOPE(tag)
+
+#endif	// CONFIG_RTAUDIT
+
+
+#endif  // __qtractorRtAudit_h
+
+
+// end of qtractorRtAudit.h
@@ -25,6 +25,8 @@
 
 #include "qtractorAudioEngine.h"
 #include "qtractorAudioPeak.h"
+#include "qtractorAudioStretch.h"
+#include "qtractorAudioTranscode.h"
 #include "qtractorAudioClip.h"
 #include "qtractorAudioBuffer.h"
 
@@ -118,6 +120,8 @@ qtractorSession::qtractorSession (void)
 	m_pMidiEngine       = new qtractorMidiEngine(this);
 	m_pAudioEngine      = new qtractorAudioEngine(this);
 	m_pAudioPeakFactory = new qtractorAudioPeakFactory();
+	m_pAudioStretchFactory = new qtractorAudioStretchFactory();
+	m_pAudioTranscodeFactory = new qtractorAudioTranscodeFactory();
 
 	m_bAutoTimeStretch  = false;
 
@@ -135,6 +139,8 @@ qtractorSession::~qtractorSession (void)
 	close();
 	clear();
 
+	delete m_pAudioTranscodeFactory;
+	delete m_pAudioStretchFactory;
 	delete m_pAudioPeakFactory;
 	delete m_pAudioEngine;
 	delete m_pMidiEngine;
@@ -324,6 +330,8 @@ void qtractorSession::clear (void)
 	}
 
 	m_pAudioPeakFactory->cleanup();
+	m_pAudioStretchFactory->cleanup();
+	m_pAudioTranscodeFactory->cleanup();
 
 	qtractorMidiControl *pMidiControl = qtractorMidiControl::getInstance();
 	if (pMidiControl)
@@ -1912,6 +1920,20 @@ qtractorAudioPeakFactory *qtractorSession::audioPeakFactory (void) const
 }
 
 
+// Audio stretch cache factory accessor.
+qtractorAudioStretchFactory *qtractorSession::audioStretchFactory (void) const
+{
+	return m_pAudioStretchFactory;
+}
+
+
+// Audio transcode cache factory accessor.
+qtractorAudioTranscodeFactory *qtractorSession::audioTranscodeFactory (void) const
+{
+	return m_pAudioTranscodeFactory;
+}
+
+
 // MIDI track tagging specifics.
 unsigned short qtractorSession::midiTag (void) const
 {
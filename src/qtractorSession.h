@@ -38,6 +38,8 @@ class qtractorClip;
 class qtractorMidiEngine;
 class qtractorAudioEngine;
 class qtractorAudioPeakFactory;
+class qtractorAudioStretchFactory;
+class qtractorAudioTranscodeFactory;
 class qtractorSessionCursor;
 class qtractorMidiManager;
 class qtractorInstrumentList;
@@ -331,6 +333,12 @@ public:
 	// Audio peak factory accessor.
 	qtractorAudioPeakFactory *audioPeakFactory() const;
 
+	// Audio stretch cache factory accessor.
+	qtractorAudioStretchFactory *audioStretchFactory() const;
+
+	// Audio transcode cache factory accessor.
+	qtractorAudioTranscodeFactory *audioTranscodeFactory() const;
+
 	// MIDI track tagging specifics.
 	unsigned short midiTag() const;
 	void acquireMidiTag(qtractorTrack *pTrack);
@@ -457,6 +465,12 @@ private:
 	// Audio peak factory (singleton) instance.
 	qtractorAudioPeakFactory *m_pAudioPeakFactory;
 
+	// Audio stretch cache factory (singleton) instance.
+	qtractorAudioStretchFactory *m_pAudioStretchFactory;
+
+	// Audio transcode cache factory (singleton) instance.
+	qtractorAudioTranscodeFactory *m_pAudioTranscodeFactory;
+
 	// Track recording counts.
 	unsigned short m_iAudioRecord;
 	unsigned short m_iMidiRecord;
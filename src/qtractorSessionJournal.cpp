@@ -0,0 +1,681 @@
+// qtractorSessionJournal.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorSessionJournal.h"
+
+#include "qtractorSession.h"
+#include "qtractorMidiClip.h"
+#include "qtractorCurve.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QFile>
+#include <QList>
+#include <QVector>
+
+
+// Journal file magic and format version.
+#define QTRACTOR_JOURNAL_MAGIC   0x5154524a	// "QTRJ"
+#define QTRACTOR_JOURNAL_VERSION 2
+
+
+//----------------------------------------------------------------------
+// class qtractorSessionJournalThread -- Journal appender thread.
+//
+
+class qtractorSessionJournalThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorSessionJournalThread(const QString& sFilename)
+		: QThread(), m_sFilename(sFilename), m_bRunState(false) {}
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_bRunState = bRunState;
+		m_cond.wakeAll();
+	}
+
+	// Enqueue data to append (or truncate to, when header).
+	void append(const QByteArray& data, bool bTruncate = false)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_queue.append(Chunk(data, bTruncate));
+		m_cond.wakeAll();
+	}
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+private:
+
+	// Queued data chunk.
+	struct Chunk
+	{
+		Chunk(const QByteArray& d = QByteArray(), bool t = false)
+			: data(d), truncate(t) {}
+		QByteArray data;
+		bool truncate;
+	};
+
+	// Instance variables.
+	QString m_sFilename;
+
+	QList<Chunk> m_queue;
+
+	bool m_bRunState;
+
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+};
+
+
+// The main thread executive.
+void qtractorSessionJournalThread::run (void)
+{
+	QFile file(m_sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+		return;
+
+	m_mutex.lock();
+	for (;;) {
+		// Drain whatever is queued...
+		while (!m_queue.isEmpty()) {
+			const Chunk& chunk = m_queue.takeFirst();
+			m_mutex.unlock();
+			if (chunk.truncate)
+				file.resize(0);
+			file.write(chunk.data);
+			file.flush();
+			m_mutex.lock();
+		}
+		if (!m_bRunState)
+			break;
+		m_cond.wait(&m_mutex);
+	}
+	m_mutex.unlock();
+
+	file.close();
+}
+
+
+//----------------------------------------------------------------------
+// qtractorSessionJournal_xxx -- Record (de)serialization helpers.
+//
+
+// Write a MIDI sequence, delta-time compact.
+static void qtractorSessionJournal_writeEvents (
+	QDataStream& ds, qtractorMidiSequence *pSeq )
+{
+	ds << quint32(pSeq->events().count());
+
+	unsigned long iPrevTime = 0;
+	qtractorMidiEvent *pEvent = pSeq->events().first();
+	while (pEvent) {
+		const unsigned long iTime = pEvent->time();
+		ds << quint32(iTime - iPrevTime) << quint8(pEvent->type());
+		if (pEvent->type() == qtractorMidiEvent::SYSEX) {
+			ds << quint16(pEvent->sysex_len());
+			ds.writeRawData((const char *) pEvent->sysex(), pEvent->sysex_len());
+		} else {
+			ds << quint16(pEvent->param()) << quint16(pEvent->value());
+			if (pEvent->type() == qtractorMidiEvent::NOTEON)
+				ds << quint32(pEvent->duration());
+		}
+		iPrevTime = iTime;
+		pEvent = pEvent->next();
+	}
+}
+
+
+// Read back a MIDI sequence, replacing all current events.
+static bool qtractorSessionJournal_readEvents (
+	QDataStream& ds, qtractorMidiSequence *pSeq )
+{
+	quint32 iCount = 0;
+	ds >> iCount;
+
+	QVector<qtractorMidiEvent *> events;
+	events.reserve(iCount);
+
+	unsigned long iTime = 0;
+	for (quint32 i = 0; i < iCount && ds.status() == QDataStream::Ok; ++i) {
+		quint32 iDeltaTime = 0;
+		quint8 iType = 0;
+		ds >> iDeltaTime >> iType;
+		iTime += iDeltaTime;
+		const qtractorMidiEvent::EventType type
+			= qtractorMidiEvent::EventType(iType);
+		qtractorMidiEvent *pEvent = new qtractorMidiEvent(iTime, type);
+		if (type == qtractorMidiEvent::SYSEX) {
+			quint16 iSysex = 0;
+			ds >> iSysex;
+			QByteArray sysex(iSysex, 0);
+			ds.readRawData(sysex.data(), iSysex);
+			pEvent->setSysex((unsigned char *) sysex.data(), iSysex);
+		} else {
+			quint16 iParam = 0, iValue = 0;
+			ds >> iParam >> iValue;
+			pEvent->setParam(iParam);
+			pEvent->setValue(iValue);
+			if (type == qtractorMidiEvent::NOTEON) {
+				quint32 iDuration = 0;
+				ds >> iDuration;
+				pEvent->setDuration(iDuration);
+			}
+		}
+		events.append(pEvent);
+	}
+
+	if (ds.status() != QDataStream::Ok) {
+		qDeleteAll(events);
+		return false;
+	}
+
+	while (pSeq->events().first())
+		pSeq->removeEvent(pSeq->events().first());
+
+	pSeq->relinkEvents(events);
+	return true;
+}
+
+
+// Track/clip/curve lookup by list index.
+static qtractorTrack *qtractorSessionJournal_track (
+	qtractorSession *pSession, int iTrack )
+{
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack && --iTrack >= 0)
+		pTrack = pTrack->next();
+	return pTrack;
+}
+
+// Clip identities (index in track, as of the snapshot).
+static QVector<qtractorClip *> qtractorSessionJournal_clips (
+	qtractorTrack *pTrack )
+{
+	QVector<qtractorClip *> clips;
+	clips.reserve(pTrack->clips().count());
+	for (qtractorClip *pClip = pTrack->clips().first();
+			pClip; pClip = pClip->next())
+		clips.append(pClip);
+	return clips;
+}
+
+static qtractorCurve *qtractorSessionJournal_curve (
+	qtractorTrack *pTrack, int iCurve )
+{
+	qtractorCurveList *pCurveList = pTrack->curveList();
+	if (pCurveList == nullptr)
+		return nullptr;
+	qtractorCurve *pCurve = pCurveList->first();
+	while (pCurve && --iCurve >= 0)
+		pCurve = pCurve->next();
+	return pCurve;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorSessionJournal -- Append-only auto-save journal.
+//
+
+// Constructor.
+qtractorSessionJournal::qtractorSessionJournal (void)
+	: m_iSize(0), m_iStructureKey(0), m_bTouchAll(false), m_pThread(nullptr)
+{
+}
+
+
+// Destructor.
+qtractorSessionJournal::~qtractorSessionJournal (void)
+{
+	close();
+}
+
+
+// Journal file open/close (truncates).
+bool qtractorSessionJournal::open ( const QString& sFilename )
+{
+	close();
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	file.close();
+
+	m_sFilename = sFilename;
+	m_iSize = 0;
+
+	m_pThread = new qtractorSessionJournalThread(m_sFilename);
+	m_pThread->setRunState(true);
+	m_pThread->start(QThread::LowPriority);
+
+	return true;
+}
+
+
+void qtractorSessionJournal::close ( bool bRemove )
+{
+	if (m_pThread) {
+		m_pThread->setRunState(false);
+		m_pThread->wait();
+		delete m_pThread;
+		m_pThread = nullptr;
+	}
+
+	if (bRemove && !m_sFilename.isEmpty() && QFileInfo(m_sFilename).exists())
+		QFile(m_sFilename).remove();
+
+	m_sFilename.clear();
+	m_hashes.clear();
+	m_clipIds.clear();
+	m_touched.clear();
+	m_bTouchAll = false;
+	m_iSize = 0;
+	m_iStructureKey = 0;
+}
+
+
+bool qtractorSessionJournal::isOpen (void) const
+{
+	return (m_pThread != nullptr);
+}
+
+
+// Journal file name accessor.
+const QString& qtractorSessionJournal::filename (void) const
+{
+	return m_sFilename;
+}
+
+
+// Journal file size (bytes), as appended so far.
+unsigned long qtractorSessionJournal::size (void) const
+{
+	return m_iSize;
+}
+
+
+// Re-baseline on a full snapshot save (truncates).
+void qtractorSessionJournal::reset ( qtractorSession *pSession )
+{
+	if (m_pThread == nullptr)
+		return;
+
+	m_hashes.clear();
+	m_iStructureKey = structureKey(pSession);
+
+	// Clip identities, as they are in this snapshot...
+	m_clipIds.clear();
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		int iClip = 0;
+		for (qtractorClip *pClip = pTrack->clips().first();
+				pClip; pClip = pClip->next())
+			m_clipIds.insert(pClip, iClip++);
+	}
+
+	// Baseline current contents (nothing gets written)...
+	QByteArray data;
+	int iRecords = 0;
+	m_bTouchAll = true;
+	clipRecords(pSession, data, iRecords, true);
+	curveRecords(pSession, data, iRecords, true);
+	m_bTouchAll = false;
+	m_touched.clear();
+
+	// Journal header...
+	QByteArray header;
+	QDataStream ds(&header, QIODevice::WriteOnly);
+	ds << quint32(QTRACTOR_JOURNAL_MAGIC)
+		<< quint32(QTRACTOR_JOURNAL_VERSION)
+		<< quint32(m_iStructureKey);
+
+	m_pThread->append(header, true);
+	m_iSize = header.size();
+}
+
+
+// Per command deltas: mark a clip or curve as touched.
+void qtractorSessionJournal::touch ( const void *pKey )
+{
+	if (m_pThread && pKey)
+		m_touched.insert(pKey);
+}
+
+
+// Per command deltas: everything's due (full scan).
+void qtractorSessionJournal::touchAll (void)
+{
+	if (m_pThread)
+		m_bTouchAll = true;
+}
+
+
+// Record what changed since last update or reset.
+int qtractorSessionJournal::update ( qtractorSession *pSession )
+{
+	if (m_pThread == nullptr || m_iSize == 0)
+		return 0;
+
+	// Clips and curves are addressed by position,
+	// so no journaling past any structural change...
+	if (structureKey(pSession) != m_iStructureKey)
+		return -1;
+
+	// Nothing touched since last time?
+	if (!m_bTouchAll && m_touched.isEmpty())
+		return 0;
+
+	QByteArray data;
+	int iRecords = 0;
+	const bool bClipRecords = clipRecords(pSession, data, iRecords, false);
+	if (bClipRecords)
+		curveRecords(pSession, data, iRecords, false);
+
+	m_bTouchAll = false;
+	m_touched.clear();
+
+	// Clips not in snapshot (replaced)?
+	if (!bClipRecords)
+		return -1;
+
+	if (iRecords > 0) {
+		m_pThread->append(data);
+		m_iSize += data.size();
+	}
+
+#ifdef CONFIG_DEBUG
+	if (iRecords > 0) {
+		qDebug("qtractorSessionJournal::update() records=%d size=%lu",
+			iRecords, m_iSize);
+	}
+#endif
+
+	return iRecords;
+}
+
+
+// Session structure signature.
+uint qtractorSessionJournal::structureKey ( qtractorSession *pSession )
+{
+	QByteArray key;
+	QDataStream ds(&key, QIODevice::WriteOnly);
+
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		ds << quint8(pTrack->trackType()) << quint32(pTrack->clips().count());
+		qtractorCurveList *pCurveList = pTrack->curveList();
+		ds << quint32(pCurveList ? pCurveList->count() : 0);
+	}
+
+	return qHash(key);
+}
+
+
+// Clip records: geometry and MIDI contents (dirty ones only),
+// of the touched ones; false if any clip is not in the snapshot.
+bool qtractorSessionJournal::clipRecords ( qtractorSession *pSession,
+	QByteArray& data, int& iRecords, bool bReset )
+{
+	int iTrack = 0;
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next(), ++iTrack) {
+		for (qtractorClip *pClip = pTrack->clips().first();
+				pClip; pClip = pClip->next()) {
+			QHash<const qtractorClip *, int>::ConstIterator iter
+				= m_clipIds.constFind(pClip);
+			if (iter == m_clipIds.constEnd())
+				return false;
+			if (!isTouched(pClip))
+				continue;
+			const int iClip = iter.value();
+			// Geometry...
+			QByteArray payload;
+			QDataStream ds(&payload, QIODevice::WriteOnly);
+			ds << quint32(iTrack) << quint32(iClip)
+				<< quint64(pClip->clipStart())
+				<< quint64(pClip->clipOffset())
+				<< quint64(pClip->clipLength())
+				<< quint64(pClip->fadeInLength())
+				<< quint64(pClip->fadeOutLength());
+			if (appendRecord(data, pClip, ClipGeometry, payload, bReset))
+				++iRecords;
+			// MIDI contents...
+			if (pTrack->trackType() != qtractorTrack::Midi || !pClip->isDirty())
+				continue;
+			qtractorMidiClip *pMidiClip
+				= static_cast<qtractorMidiClip *> (pClip);
+			qtractorMidiSequence *pSeq = pMidiClip->sequence();
+			if (pSeq == nullptr)
+				continue;
+			QByteArray payload2;
+			QDataStream ds2(&payload2, QIODevice::WriteOnly);
+			ds2 << quint32(iTrack) << quint32(iClip);
+			qtractorSessionJournal_writeEvents(ds2, pSeq);
+			if (appendRecord(data, pClip, MidiClip, payload2, bReset))
+				++iRecords;
+		}
+	}
+
+	return true;
+}
+
+
+// Automation curve records.
+void qtractorSessionJournal::curveRecords ( qtractorSession *pSession,
+	QByteArray& data, int& iRecords, bool bReset )
+{
+	int iTrack = 0;
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next(), ++iTrack) {
+		qtractorCurveList *pCurveList = pTrack->curveList();
+		if (pCurveList == nullptr)
+			continue;
+		int iCurve = 0;
+		for (qtractorCurve *pCurve = pCurveList->first();
+				pCurve; pCurve = pCurve->next(), ++iCurve) {
+			if (!isTouched(pCurve))
+				continue;
+			QByteArray payload;
+			QDataStream ds(&payload, QIODevice::WriteOnly);
+			ds.setFloatingPointPrecision(QDataStream::SinglePrecision);
+			ds << quint32(iTrack) << quint32(iCurve);
+			qtractorSubject *pSubject = pCurve->subject();
+			ds << (pSubject ? pSubject->name() : QString());
+			ds << quint32(pCurve->nodes().count());
+			qtractorCurve::Node *pNode = pCurve->nodes().first();
+			while (pNode) {
+				ds << quint64(pNode->frame) << pNode->value;
+				pNode = pNode->next();
+			}
+			if (appendRecord(data, pCurve, Curve, payload, bReset))
+				++iRecords;
+		}
+	}
+}
+
+
+// Append a single record (if changed since last time).
+bool qtractorSessionJournal::appendRecord ( QByteArray& data,
+	const void *pKey, RecordType type, const QByteArray& payload, bool bReset )
+{
+	const uint iHash = qHash(payload);
+	const RecordKey key(pKey, int(type));
+	QHash<RecordKey, uint>::Iterator iter = m_hashes.find(key);
+	if (iter == m_hashes.end()) {
+		m_hashes.insert(key, iHash);
+		// All start baselined; MIDI contents only when dirty...
+		if (bReset || type != MidiClip)
+			return false;
+	} else {
+		if (iter.value() == iHash)
+			return false;
+		iter.value() = iHash;
+	}
+
+	if (bReset)
+		return false;
+
+	// Record: type, length, payload, checksum.
+	QDataStream ds(&data, QIODevice::WriteOnly | QIODevice::Append);
+	ds << quint8(type) << quint32(payload.size());
+	ds.writeRawData(payload.constData(), payload.size());
+	ds << quint16(qChecksum(payload.constData(), payload.size()));
+
+	return true;
+}
+
+
+// Replay journal records onto a (just loaded) snapshot.
+int qtractorSessionJournal::replay (
+	const QString& sFilename, qtractorSession *pSession )
+{
+	QFile file(sFilename);
+	if (!file.open(QIODevice::ReadOnly))
+		return -1;
+
+	const QByteArray& data = file.readAll();
+	file.close();
+
+	QDataStream ds(data);
+	quint32 iMagic = 0, iVersion = 0, iStructureKey = 0;
+	ds >> iMagic >> iVersion >> iStructureKey;
+	if (ds.status() != QDataStream::Ok
+		|| iMagic != QTRACTOR_JOURNAL_MAGIC
+		|| iVersion != QTRACTOR_JOURNAL_VERSION)
+		return -1;
+
+	// Must match the very same snapshot structure...
+	if (iStructureKey != structureKey(pSession))
+		return -1;
+
+	// Clip identities, as they are in the snapshot...
+	QVector<QVector<qtractorClip *> > clips;
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next())
+		clips.append(qtractorSessionJournal_clips(pTrack));
+
+	int iRecords = 0;
+
+	while (!ds.atEnd()) {
+		quint8 iType = 0;
+		quint32 iLength = 0;
+		ds >> iType >> iLength;
+		if (ds.status() != QDataStream::Ok)
+			break;
+		QByteArray payload(iLength, 0);
+		if (ds.readRawData(payload.data(), iLength) != int(iLength))
+			break;	// Truncated (crashed while appending)...
+		quint16 iChecksum = 0;
+		ds >> iChecksum;
+		if (ds.status() != QDataStream::Ok
+			|| iChecksum != qChecksum(payload.constData(), payload.size()))
+			break;
+		// Apply the record...
+		QDataStream ds2(payload);
+		ds2.setFloatingPointPrecision(QDataStream::SinglePrecision);
+		quint32 iTrack = 0, iIndex = 0;
+		ds2 >> iTrack >> iIndex;
+		qtractorTrack *pTrack = qtractorSessionJournal_track(pSession, iTrack);
+		if (pTrack == nullptr)
+			continue;
+		qtractorClip *pClip = nullptr;
+		if (iType == MidiClip || iType == ClipGeometry) {
+			const QVector<qtractorClip *>& track_clips = clips.at(iTrack);
+			if (iIndex < quint32(track_clips.count()))
+				pClip = track_clips.at(iIndex);
+			if (pClip == nullptr)
+				continue;
+		}
+		if (iType == ClipGeometry) {
+			quint64 iClipStart = 0, iClipOffset = 0, iClipLength = 0;
+			quint64 iFadeInLength = 0, iFadeOutLength = 0;
+			ds2 >> iClipStart >> iClipOffset >> iClipLength
+				>> iFadeInLength >> iFadeOutLength;
+			if (ds2.status() != QDataStream::Ok)
+				continue;
+			pTrack->unlinkClip(pClip);
+			pClip->setClipStart(iClipStart);
+			pClip->setClipOffset(iClipOffset);
+			pClip->setClipLength(iClipLength);
+			pClip->setFadeInLength(iFadeInLength);
+			pClip->setFadeOutLength(iFadeOutLength);
+			pTrack->insertClip(pClip);
+			++iRecords;
+		}
+		else
+		if (iType == MidiClip && pTrack->trackType() == qtractorTrack::Midi) {
+			qtractorMidiClip *pMidiClip
+				= static_cast<qtractorMidiClip *> (pClip);
+			if (pMidiClip && pMidiClip->sequence()
+				&& qtractorSessionJournal_readEvents(ds2, pMidiClip->sequence())) {
+				pMidiClip->setDirty(true);
+				++iRecords;
+			}
+		}
+		else
+		if (iType == Curve) {
+			qtractorCurve *pCurve = qtractorSessionJournal_curve(pTrack, iIndex);
+			QString sName;
+			quint32 iNodes = 0;
+			ds2 >> sName >> iNodes;
+			qtractorSubject *pSubject = (pCurve ? pCurve->subject() : nullptr);
+			if (pSubject == nullptr || pSubject->name() != sName)
+				continue;
+			pCurve->clear();
+			for (quint32 i = 0; i < iNodes && !ds2.atEnd(); ++i) {
+				quint64 iFrame = 0;
+				float fValue = 0.0f;
+				ds2 >> iFrame >> fValue;
+				pCurve->insertNode(new qtractorCurve::Node(iFrame, fValue));
+			}
+			pCurve->update();
+			++iRecords;
+		}
+	}
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorSessionJournal::replay(\"%s\") records=%d",
+		sFilename.toUtf8().constData(), iRecords);
+#endif
+
+	return iRecords;
+}
+
+
+// Standard journal file name, for an auto-save file name.
+QString qtractorSessionJournal::journalName ( const QString& sFilename )
+{
+	return sFilename + ".journal";
+}
+
+
+// end of qtractorSessionJournal.cpp
@@ -0,0 +1,141 @@
+// qtractorSessionJournal.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorSessionJournal_h
+#define __qtractorSessionJournal_h
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+
+
+// Forward declarations.
+class qtractorSession;
+class qtractorClip;
+class qtractorSessionJournalThread;
+
+
+//----------------------------------------------------------------------
+// class qtractorSessionJournal -- Append-only auto-save journal.
+//
+// Records the contents of MIDI clips, clip geometry and automation
+// curves that changed since the last full (auto-)save snapshot, as
+// compact binary records, appended by a background thread; replayed
+// on crash-recovery. Only what was touched by each executed command
+// (per command deltas) gets re-recorded on the next update.
+//
+
+class qtractorSessionJournal
+{
+public:
+
+	// Constructor.
+	qtractorSessionJournal();
+
+	// Destructor.
+	~qtractorSessionJournal();
+
+	// Journal file open/close (truncates).
+	bool open(const QString& sFilename);
+	void close(bool bRemove = false);
+
+	bool isOpen() const;
+
+	// Journal file name accessor.
+	const QString& filename() const;
+
+	// Journal file size (bytes), as appended so far.
+	unsigned long size() const;
+
+	// Re-baseline on a full snapshot save (truncates).
+	void reset(qtractorSession *pSession);
+
+	// Per command deltas: mark a clip or curve as touched,
+	// or everything, when not known (full scan is due).
+	void touch(const void *pKey);
+	void touchAll();
+
+	// Record what changed since last update or reset;
+	// returns the number of records appended or -1 when
+	// the session structure changed (snapshot is due).
+	int update(qtractorSession *pSession);
+
+	// Replay journal records onto a (just loaded) snapshot;
+	// returns the number of records applied, -1 on error.
+	static int replay(const QString& sFilename, qtractorSession *pSession);
+
+	// Standard journal file name, for an auto-save file name.
+	static QString journalName(const QString& sFilename);
+
+protected:
+
+	// Record types.
+	enum RecordType { MidiClip = 1, Curve = 2, ClipGeometry = 3 };
+
+	// Session structure signature.
+	static uint structureKey(qtractorSession *pSession);
+
+	// Whether a clip or curve is due for recording.
+	bool isTouched(const void *pKey) const
+		{ return m_bTouchAll || m_touched.contains(pKey); }
+
+	// Record makers.
+	bool clipRecords(qtractorSession *pSession,
+		QByteArray& data, int& iRecords, bool bReset);
+	void curveRecords(qtractorSession *pSession,
+		QByteArray& data, int& iRecords, bool bReset);
+
+	// Append a single record (if changed since last time).
+	bool appendRecord(QByteArray& data, const void *pKey,
+		RecordType type, const QByteArray& payload, bool bReset);
+
+private:
+
+	// Instance variables.
+	QString m_sFilename;
+
+	unsigned long m_iSize;
+
+	uint m_iStructureKey;
+
+	// Last recorded payload hash, per clip/curve and record type.
+	typedef QPair<const void *, int> RecordKey;
+
+	QHash<RecordKey, uint> m_hashes;
+
+	// Clip identities, as of last snapshot (index in track).
+	QHash<const qtractorClip *, int> m_clipIds;
+
+	// Clips and curves touched since last update.
+	QSet<const void *> m_touched;
+	bool m_bTouchAll;
+
+	// The background appender thread.
+	qtractorSessionJournalThread *m_pThread;
+};
+
+
+#endif  // __qtractorSessionJournal_h
+
+
+// end of qtractorSessionJournal.h
@@ -219,7 +219,7 @@ protected:
 			= iRangeStart - pClip->clipStart();
 		const QRect rectClip(0, 0, w, h);
 		painter.drawRect(rectClip);
-		pClip->draw(&painter, rectClip, iClipOffset);
+		pClip->draw(&painter, rectClip, iClipOffset, m_drawBuffer);
 	}
 
 	// Paint method...
@@ -276,6 +276,9 @@ private:
 	// Local double-buffering pixmap.
 	QPixmap m_pixmap;
 
+	// Clip paint scratch buffers.
+	qtractorClipDrawBuffer m_drawBuffer;
+
 	// Extracted beat offsets.
 	QList<unsigned long> m_beats;
 };
@@ -0,0 +1,262 @@
+// qtractorTrace.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorTrace.h"
+
+#include "qtractorAtomic.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QVector>
+
+#include <string.h>
+
+
+// Maximum number of traced threads (buffers pool size).
+#define QTRACTOR_TRACE_THREADS  16
+
+// Events per thread buffer (power of two).
+#define QTRACTOR_TRACE_EVENTS   16384
+
+
+// Trace event (compact binary).
+struct qtractorTrace_Event
+{
+	const char        *name;
+	unsigned long long start;
+	unsigned long long end;
+};
+
+
+// Per-thread trace buffer (single writer).
+struct qtractorTrace_Buffer
+{
+	const char         *thread;
+	qtractorAtomic      owned;
+	qtractorAtomic      write;
+	qtractorTrace_Event events[QTRACTOR_TRACE_EVENTS];
+};
+
+
+// Pre-allocated buffers pool.
+static qtractorTrace_Buffer *g_traceBuffers[QTRACTOR_TRACE_THREADS];
+
+
+// Claim tokens (nonzero owner marks).
+static qtractorAtomic g_traceClaims;
+
+
+// Per-thread buffer claim (or none when pool's exhausted): plain
+// thread-local PODs, trivially destructible, so that first use on
+// a real-time thread never registers any thread-exit destructor;
+// buffers are given back explicitly (see release).
+static __thread qtractorTrace_Buffer *g_pTraceBuffer = nullptr;
+static __thread int g_iTraceClaim = 0;
+
+
+// Global enablement.
+volatile bool qtractorTrace::g_bEnabled = false;
+
+
+//----------------------------------------------------------------------
+// class qtractorTrace -- Engine and worker threads activity tracing.
+//
+
+// Record a complete (duration) event.
+void qtractorTrace::event ( const char *pszThread, const char *pszName,
+	unsigned long long iStartTicks, unsigned long long iEndTicks )
+{
+	if (!g_bEnabled)
+		return;
+
+	// Given back meanwhile (eg. foreign thread released by name)?
+	qtractorTrace_Buffer *pBuffer = g_pTraceBuffer;
+	if (pBuffer && ATOMIC_GET(&pBuffer->owned) != g_iTraceClaim) {
+		g_pTraceBuffer = pBuffer = nullptr;
+		g_iTraceClaim = 0;
+	}
+
+	// Claim a free buffer from pool, once while owned...
+	if (g_iTraceClaim == 0) {
+		const int iClaim = ATOMIC_INC(&g_traceClaims);
+		g_iTraceClaim = -1; // Pool exhausted, don't try again.
+		for (int i = 0; i < QTRACTOR_TRACE_THREADS; ++i) {
+			pBuffer = g_traceBuffers[i];
+			if (ATOMIC_CAS(&pBuffer->owned, 0, iClaim)) {
+				pBuffer->thread = pszThread;
+				pBuffer->write.storeRelease(0);
+				g_pTraceBuffer = pBuffer;
+				g_iTraceClaim = iClaim;
+				break;
+			}
+		}
+		pBuffer = g_pTraceBuffer;
+	}
+
+	if (pBuffer == nullptr)
+		return;
+
+	const int iWrite = ATOMIC_GET(&pBuffer->write);
+	qtractorTrace_Event *pEvent
+		= &pBuffer->events[iWrite & (QTRACTOR_TRACE_EVENTS - 1)];
+	pEvent->name  = pszName;
+	pEvent->start = iStartTicks;
+	pEvent->end   = iEndTicks;
+
+	pBuffer->write.storeRelease(iWrite + 1);
+}
+
+
+// Give back the calling thread's buffer (explicit thread-exit hook).
+void qtractorTrace::release (void)
+{
+	qtractorTrace_Buffer *pBuffer = g_pTraceBuffer;
+	if (pBuffer)
+		ATOMIC_CAS(&pBuffer->owned, g_iTraceClaim, 0);
+
+	g_pTraceBuffer = nullptr;
+	g_iTraceClaim = 0;
+}
+
+
+// Give back all buffers claimed under a thread name (eg. foreign
+// JACK threads, which can't release on their own; non real-time).
+void qtractorTrace::release ( const char *pszThread )
+{
+	if (g_traceBuffers[0] == nullptr)
+		return;
+
+	for (int i = 0; i < QTRACTOR_TRACE_THREADS; ++i) {
+		qtractorTrace_Buffer *pBuffer = g_traceBuffers[i];
+		if (pBuffer->thread && ::strcmp(pBuffer->thread, pszThread) == 0)
+			pBuffer->owned.storeRelease(0);
+	}
+}
+
+
+// JSON string escape helper.
+static QString qtractorTrace_escape ( const char *psz )
+{
+	QString s = QString::fromLatin1(psz ? psz : "?");
+	s.replace('\\', "\\\\");
+	s.replace('"', "\\\"");
+	return s;
+}
+
+
+// Dump all recorded events as Chrome trace JSON (non real-time).
+bool qtractorTrace::dump ( const QString& sFilename )
+{
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+		return false;
+
+	// Snapshot buffers first...
+	QVector<QVector<qtractorTrace_Event> > threads;
+	unsigned long long iStartTicks = 0;
+
+	const int iBuffers
+		= (g_traceBuffers[0] ? QTRACTOR_TRACE_THREADS : 0);
+	for (int i = 0; i < iBuffers; ++i) {
+		QVector<qtractorTrace_Event> events;
+		qtractorTrace_Buffer *pBuffer = g_traceBuffers[i];
+		const unsigned int iWrite = pBuffer->write.loadAcquire();
+		const unsigned int iRead = (iWrite > QTRACTOR_TRACE_EVENTS
+			? iWrite - QTRACTOR_TRACE_EVENTS : 0);
+		events.reserve(iWrite - iRead);
+		for (unsigned int j = iRead; j != iWrite; ++j)
+			events.append(pBuffer->events[j & (QTRACTOR_TRACE_EVENTS - 1)]);
+		// Drop the ones possibly overwritten meanwhile...
+		const int iDrop = int((unsigned int)
+			pBuffer->write.loadAcquire() - iWrite);
+		if (iDrop > 0)
+			events.remove(0, qMin(iDrop, events.count()));
+		QVector<qtractorTrace_Event>::ConstIterator iter = events.constBegin();
+		const QVector<qtractorTrace_Event>::ConstIterator& iter_end = events.constEnd();
+		for ( ; iter != iter_end; ++iter) {
+			if (iStartTicks == 0 || iStartTicks > iter->start)
+				iStartTicks = iter->start;
+		}
+		threads.append(events);
+	}
+
+	const double fTicksPerUsec = qtractorDspProfile::ticksPerUsec();
+
+	QTextStream ts(&file);
+	ts << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool bComma = false;
+	for (int i = 0; i < threads.count(); ++i) {
+		// Never claimed so far?
+		if (g_traceBuffers[i]->thread == nullptr)
+			continue;
+		const int tid = i + 1;
+		if (bComma) ts << ',';
+		ts << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			<< tid << ",\"args\":{\"name\":\""
+			<< qtractorTrace_escape(g_traceBuffers[i]->thread) << "\"}}";
+		bComma = true;
+		const QVector<qtractorTrace_Event>& events = threads.at(i);
+		QVector<qtractorTrace_Event>::ConstIterator iter = events.constBegin();
+		const QVector<qtractorTrace_Event>::ConstIterator& iter_end = events.constEnd();
+		for ( ; iter != iter_end; ++iter) {
+			const double ts0 = double(iter->start - iStartTicks) / fTicksPerUsec;
+			ts << ",\n{\"name\":\"" << qtractorTrace_escape(iter->name)
+				<< "\",\"pid\":1,\"tid\":" << tid
+				<< ",\"ts\":" << QString::number(ts0, 'f', 3);
+			if (iter->end > iter->start) {
+				const double dur = double(iter->end - iter->start) / fTicksPerUsec;
+				ts << ",\"ph\":\"X\",\"dur\":" << QString::number(dur, 'f', 3) << '}';
+			} else {
+				ts << ",\"ph\":\"i\",\"s\":\"g\"}";
+			}
+		}
+	}
+
+	ts << "\n]}\n";
+
+	file.close();
+	return true;
+}
+
+
+// Global enablement (tracing is off by default).
+void qtractorTrace::setEnabled ( bool bEnabled )
+{
+	// Pre-allocate the buffers pool, for good...
+	if (bEnabled && g_traceBuffers[0] == nullptr) {
+		for (int i = 0; i < QTRACTOR_TRACE_THREADS; ++i) {
+			qtractorTrace_Buffer *pBuffer = new qtractorTrace_Buffer;
+			pBuffer->thread = nullptr;
+			ATOMIC_SET(&pBuffer->owned, 0);
+			ATOMIC_SET(&pBuffer->write, 0);
+			g_traceBuffers[i] = pBuffer;
+		}
+		// Timestamp counter rate calibration...
+		qtractorDspProfile::ticksPerUsec();
+	}
+
+	g_bEnabled = bEnabled;
+}
+
+
+// end of qtractorTrace.cpp
@@ -0,0 +1,114 @@
+// qtractorTrace.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorTrace_h
+#define __qtractorTrace_h
+
+#include "qtractorDspProfile.h"
+
+
+//----------------------------------------------------------------------
+// class qtractorTrace -- Engine and worker threads activity tracing.
+//
+// Compact binary events (static name, start and end timestamps) are
+// written lock-free into per-thread flight-recorder ring buffers, taken
+// from a pre-allocated pool on first use and given back explicitly on
+// thread exit (see release);
+// the most recent ones may be dumped any time (eg. on xrun) as Chrome
+// trace JSON (eg. for Perfetto).
+//
+
+class qtractorTrace
+{
+public:
+
+	// Record a complete (duration) event.
+	static void event(const char *pszThread, const char *pszName,
+		unsigned long long iStartTicks, unsigned long long iEndTicks);
+
+	// Record an instant event.
+	static void instant(const char *pszThread, const char *pszName)
+	{
+		if (g_bEnabled) {
+			const unsigned long long iTicks = qtractorDspProfile::ticks();
+			event(pszThread, pszName, iTicks, iTicks);
+		}
+	}
+
+	// Give back the calling thread's buffer to the pool
+	// (explicit thread-exit hook, any thread that traced).
+	static void release();
+
+	// Give back all buffers claimed under a thread name
+	// (foreign threads, eg. JACK's, after deactivation).
+	static void release(const char *pszThread);
+
+	// Dump all recorded events as Chrome trace JSON (non real-time).
+	static bool dump(const QString& sFilename);
+
+	// Global enablement (tracing is off by default).
+	static void setEnabled(bool bEnabled);
+	static bool isEnabled()
+		{ return g_bEnabled; }
+
+private:
+
+	// Global enablement.
+	static volatile bool g_bEnabled;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorTraceScope -- Tracing duration event guard.
+//
+
+class qtractorTraceScope
+{
+public:
+
+	// Constructor.
+	qtractorTraceScope(const char *pszThread, const char *pszName)
+		: m_pszThread(pszThread), m_pszName(pszName),
+			m_iStartTicks(qtractorTrace::isEnabled()
+				? qtractorDspProfile::ticks() : 0) {}
+
+	// Destructor.
+	~qtractorTraceScope()
+	{
+		if (m_iStartTicks > 0 && qtractorTrace::isEnabled()) {
+			qtractorTrace::event(m_pszThread, m_pszName,
+				m_iStartTicks, qtractorDspProfile::ticks());
+		}
+	}
+
+private:
+
+	// Instance variables.
+	const char        *m_pszThread;
+	const char        *m_pszName;
+	unsigned long long m_iStartTicks;
+};
+
+
+#endif  // __qtractorTrace_h
+
+
+// end of qtractorTrace.h
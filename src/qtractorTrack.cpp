@@ -39,6 +39,7 @@
 #include "qtractorMixer.h"
 #include "qtractorMeter.h"
 #include "qtractorCurveFile.h"
+#include "qtractorRtAudit.h"
 
 #include "qtractorTrackCommand.h"
 
@@ -296,6 +297,11 @@ qtractorTrack::qtractorTrack ( qtractorSession *pSession, TrackType trackType )
 	m_pOutputBus = nullptr;
 	m_pMonitor   = nullptr;
 
+	m_pRenderBuffer = nullptr;
+
+	setPathLatency(0);
+	m_pOutputDelay = new qtractorAudioDelay();
+
 	m_iMidiTag = 0;
 
 	m_midiNoteMin = 0;
@@ -375,6 +381,8 @@ qtractorTrack::~qtractorTrack (void)
 	qDeleteAll(m_controllers);
 	m_controllers.clear();
 
+	delete m_pOutputDelay;
+
 	if (m_pCurveFile)
 		delete m_pCurveFile;
 	if (m_pPluginList)
@@ -505,6 +513,15 @@ bool qtractorTrack::open (void)
 				pAudioBus->channels(), m_props.gain, m_props.panning);
 			m_pPluginList->setChannels(pAudioBus->channels(),
 				qtractorPluginList::AudioTrack);
+			// Private render buffer, from the pool; swapped while
+			// the session is locked, so that the old one is surely
+			// out of the process cycle before it gets back to pool...
+			qtractorAudioRenderBuffer *pRenderBuffer
+				= pAudioEngine->acquireRenderBuffer(pAudioBus->channels());
+			m_pSession->lock();
+			qSwap(m_pRenderBuffer, pRenderBuffer);
+			m_pSession->unlock();
+			pAudioEngine->releaseRenderBuffer(pRenderBuffer);
 		}
 		break;
 	}
@@ -615,6 +632,11 @@ bool qtractorTrack::open (void)
 	// Set on plug-list latency compensation...
 	m_pPluginList->setLatency(m_props.pluginListLatency);
 
+	// Graph-wide plugin delay compensation (path latencies),
+	// deferred: reset only once, for all tracks, when idle...
+	if (pAudioEngine)
+		pAudioEngine->setPathLatenciesDirty();
+
 	// Ah, at least make new name feedback...
 	updateTrackName();
 
@@ -655,6 +677,23 @@ void qtractorTrack::close (void)
 	m_pInputBus  = nullptr;
 	m_pOutputBus = nullptr;
 
+	// Give back the private render buffer,
+	// once surely out of the process cycle...
+	if (m_pRenderBuffer) {
+		m_pSession->lock();
+		qtractorAudioRenderBuffer *pRenderBuffer = m_pRenderBuffer;
+		m_pRenderBuffer = nullptr;
+		m_pSession->unlock();
+		qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
+		if (pAudioEngine)
+			pAudioEngine->releaseRenderBuffer(pRenderBuffer);
+		else
+			delete pRenderBuffer;
+	}
+
+	// Plugin delay compensation is left as is, as it belongs to
+	// the graph-wide path latencies (see track open/removal)...
+
 	setClipRecord(nullptr);
 }
 
@@ -1449,6 +1488,10 @@ void qtractorTrack::resetProperties (void)
 void qtractorTrack::process ( qtractorClip *pClip,
 	unsigned long iFrameStart, unsigned long iFrameEnd )
 {
+	QTRACTOR_RT_AUDIT_SCOPE("qtractorTrack::process");
+
+	qtractorDspProfileScope dspProfile(&m_dspProfile);
+
 	// Audio-buffers needs some preparation...
 	const unsigned int nframes = iFrameEnd - iFrameStart;
 	qtractorAudioMonitor *pAudioMonitor = nullptr;
@@ -1456,19 +1499,20 @@ void qtractorTrack::process ( qtractorClip *pClip,
 	if (m_props.trackType == qtractorTrack::Audio) {
 		pAudioMonitor = static_cast<qtractorAudioMonitor *> (m_pMonitor);
 		pOutputBus = static_cast<qtractorAudioBus *> (m_pOutputBus);
-		// Prepare this track buffer...
+		// Prepare this track (private) buffer...
 		if (pOutputBus) {
 			qtractorAudioBus *pInputBus = (m_pSession->isTrackMonitor(this)
 				? static_cast<qtractorAudioBus *> (m_pInputBus) : nullptr);
-			pOutputBus->buffer_prepare(nframes, pInputBus);
+			pOutputBus->buffer_prepare(m_pRenderBuffer, nframes, pInputBus);
 		}
 	}
 
 	// Playback...
 	if (!isMute() && (!m_pSession->soloTracks() || isSolo())) {
-		const unsigned long iLatency = m_pPluginList->latency();
+		const unsigned long iLatency = pathLatency();
 		const unsigned long iFrameStart2 = iFrameStart + iLatency;
 		const unsigned long iFrameEnd2 = iFrameEnd + iLatency;
+		qtractorDspProfileScope clipsDspProfile(&m_clipsDspProfile);
 		// Now, for every clip...
 		while (pClip && pClip->clipStart() < iFrameEnd2) {
 			if (iFrameStart2 < pClip->clipStart() + pClip->clipLength())
@@ -1478,13 +1522,35 @@ void qtractorTrack::process ( qtractorClip *pClip,
 	}
 
 	// Audio buffers needs monitoring and commitment...
-	if (pAudioMonitor && pOutputBus) {
-		// Plugin chain post-processing...
-		m_pPluginList->process(pOutputBus->buffer(), nframes);
-		// Monitor passthru...
-		pAudioMonitor->process(pOutputBus->buffer(), nframes);
-		// Actually render it...
-		pOutputBus->buffer_commit(nframes);
+	if (pAudioMonitor && pOutputBus && m_pRenderBuffer) {
+		// Silence propagation: skip it all, once the plugin
+		// chain tail has decayed and no signal's in sight...
+		const bool bSilent = m_pRenderBuffer->isSilent();
+		const bool bSkipped = (bSilent && m_pPluginList->isIdle());
+		if (!bSkipped) {
+			m_pRenderBuffer->touch(nframes);
+			float **ppBuffer = m_pRenderBuffer->buffer();
+			// Plugin chain post-processing...
+			m_pPluginList->process(ppBuffer, nframes);
+			const unsigned long iDelay = m_pOutputDelay->delay();
+			m_pPluginList->updateTail(ppBuffer, nframes,
+				bSilent, (m_pSession->sampleRate() << 1) + iDelay);
+			// Plugin delay compensation (aux-sends alignment)...
+			if (iDelay > 0)
+				m_pOutputDelay->process(ppBuffer, nframes);
+			// Monitor passthru...
+			pAudioMonitor->process(ppBuffer, nframes);
+			// Actually render it (bus final sum)...
+			pOutputBus->buffer_commit(m_pRenderBuffer, nframes);
+		}
+		else
+		if (pAudioMonitor->loudness()) {
+			// Keep loudness metering falling through silence...
+			m_pRenderBuffer->touch(nframes);
+			pAudioMonitor->process_meter(m_pRenderBuffer->buffer(), nframes);
+		}
+		// Idle-skipping statistics...
+		m_pSession->audioEngine()->updateTrackCycles(bSkipped);
 	}
 }
 
@@ -1505,13 +1571,15 @@ void qtractorTrack::process_export ( qtractorClip *pClip,
 	if (m_props.trackType == qtractorTrack::Audio) {
 		pAudioMonitor = static_cast<qtractorAudioMonitor *> (m_pMonitor);
 		pOutputBus = static_cast<qtractorAudioBus *> (m_pOutputBus);
-		if (pOutputBus)
-			pOutputBus->buffer_prepare(nframes);
+		if (pOutputBus && m_pRenderBuffer) {
+			pOutputBus->buffer_prepare(m_pRenderBuffer, nframes);
+			m_pRenderBuffer->touch(nframes);
+		}
 	}
 
 	// Playback...
 	if (!isMute() && (!m_pSession->soloTracks() || isSolo())) {
-		const unsigned long iLatency = m_pPluginList->latency();
+		const unsigned long iLatency = pathLatency();
 		const unsigned long iFrameStart2 = iFrameStart + iLatency;
 		const unsigned long iFrameEnd2 = iFrameEnd + iLatency;
 		// Now, for every clip...
@@ -1523,13 +1591,17 @@ void qtractorTrack::process_export ( qtractorClip *pClip,
 	}
 
 	// Audio buffers needs monitoring and commitment...
-	if (pAudioMonitor && pOutputBus) {
+	if (pAudioMonitor && pOutputBus && m_pRenderBuffer) {
+		float **ppBuffer = m_pRenderBuffer->buffer();
 		// Plugin chain post-processing...
-		m_pPluginList->process(pOutputBus->buffer(), nframes);
+		m_pPluginList->process(ppBuffer, nframes);
+		// Plugin delay compensation (aux-sends alignment)...
+		if (m_pOutputDelay->delay() > 0)
+			m_pOutputDelay->process(ppBuffer, nframes);
 		// Monitor passthru...
-		pAudioMonitor->process(pOutputBus->buffer(), nframes);
+		pAudioMonitor->process(ppBuffer, nframes);
 		// Actually render it...
-		pOutputBus->buffer_commit(nframes);
+		pOutputBus->buffer_commit(m_pRenderBuffer, nframes);
 	}
 }
 
@@ -1588,7 +1660,8 @@ void qtractorTrack::process_curve ( unsigned long iFrame )
 
 // Track paint method.
 void qtractorTrack::drawTrack ( QPainter *pPainter, const QRect& trackRect,
-	unsigned long iTrackStart, unsigned long iTrackEnd, qtractorClip *pClip )
+	unsigned long iTrackStart, unsigned long iTrackEnd,
+	qtractorClipDrawBuffer& drawBuffer, qtractorClip *pClip )
 {
 	const int y = trackRect.y();
 	const int h = trackRect.height();
@@ -1631,7 +1704,7 @@ void qtractorTrack::drawTrack ( QPainter *pPainter, const QRect& trackRect,
 			pPainter->setBrush(brush);
 			// Draw the clip...
 			const QRect clipRect(x1, y, x2 - x1, h);
-			pClip->drawClip(pPainter, clipRect, iClipOffset);
+			pClip->drawClip(pPainter, clipRect, iClipOffset, drawBuffer);
 			if (pClip == pClipRecordEx)
 				pPainter->fillRect(clipRect, QColor(255, 0, 0, 60));
 		}
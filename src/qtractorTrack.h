@@ -25,6 +25,8 @@
 #include "qtractorList.h"
 
 #include "qtractorMidiControl.h"
+#include "qtractorDspProfile.h"
+#include "qtractorAtomic.h"
 
 #include <QColor>
 
@@ -41,7 +43,10 @@ class qtractorBus;
 class qtractorSubject;
 class qtractorMidiControlObserver;
 class qtractorAudioBufferThread;
+class qtractorAudioRenderBuffer;
+class qtractorAudioDelay;
 class qtractorCurveList;
+class qtractorClipDrawBuffer;
 class qtractorCurveFile;
 class qtractorCurve;
 
@@ -174,6 +179,10 @@ public:
 	// Track monitor accessors.
 	qtractorMonitor *monitor() const;
 
+	// Track private render buffer accessor (audio only).
+	qtractorAudioRenderBuffer *renderBuffer() const
+		{ return m_pRenderBuffer; }
+
 	// Track plugin-chain accessor.
 	qtractorPluginList *pluginList() const;
 
@@ -181,6 +190,22 @@ public:
 	void setPluginListLatency(bool bPluginListLatency);
 	bool isPluginListLatency() const;
 
+	// Graph-wide plugin delay compensation: total path latency
+	// (clip read-ahead) and own output delay line (aligning aux-sends).
+	void setPathLatency(unsigned long iPathLatency)
+		{ ATOMIC_SET(&m_pathLatency, int(iPathLatency)); }
+	unsigned long pathLatency() const
+		{ return (unsigned long) ATOMIC_GET(&m_pathLatency); }
+
+	qtractorAudioDelay *outputDelay() const
+		{ return m_pOutputDelay; }
+
+	// DSP load profiles (whole track and clip reads).
+	qtractorDspProfile *dspProfile()
+		{ return &m_dspProfile; }
+	qtractorDspProfile *clipsDspProfile()
+		{ return &m_clipsDspProfile; }
+
 	// Base height (in pixels).
 	enum { HeightMin = 24, HeightBase = 96 };
 
@@ -244,7 +269,7 @@ public:
 	// Track paint method.
 	void drawTrack(QPainter *pPainter, const QRect& trackRect,
 		unsigned long iTrackStart, unsigned long iTrackEnd,
-		qtractorClip *pClip = nullptr);
+		qtractorClipDrawBuffer& drawBuffer, qtractorClip *pClip = nullptr);
 
 	// MIDI track instrument patching.
 	void setMidiPatch(qtractorInstrumentList *pInstruments);
@@ -387,6 +412,14 @@ private:
 
 	qtractorMonitor *m_pMonitor;    // Track monitor.
 
+	qtractorAudioRenderBuffer *m_pRenderBuffer; // Track render buffer.
+
+	qtractorAtomic      m_pathLatency;  // Track total path latency.
+	qtractorAudioDelay *m_pOutputDelay; // Track output delay line.
+
+	qtractorDspProfile m_dspProfile;      // Track DSP load profile.
+	qtractorDspProfile m_clipsDspProfile; // Clip reads DSP load profile.
+
 	unsigned short   m_iMidiTag;    // MIDI specific: track-tag;
 
 	unsigned char    m_midiNoteMax; // MIDI specific: track-maximum note;
@@ -61,6 +61,37 @@ qtractorTrackCommand::~qtractorTrackCommand (void)
 }
 
 
+// Approximate memory held by this command.
+unsigned long qtractorTrackCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize()
+		+ sizeof(*this) - sizeof(qtractorCommand);
+
+	// Only an owned (removed or not added) track is ours,
+	// along with all its clips and automation curves...
+	if (m_pTrack == nullptr || !isAutoDelete())
+		return iMemorySize;
+
+	iMemorySize += sizeof(qtractorTrack);
+
+	for (qtractorClip *pClip = m_pTrack->clips().first();
+			pClip; pClip = pClip->next()) {
+		iMemorySize += qtractorClipCommand::clipMemorySize(pClip);
+	}
+
+	qtractorCurveList *pCurveList = m_pTrack->curveList();
+	if (pCurveList) {
+		for (qtractorCurve *pCurve = pCurveList->first();
+				pCurve; pCurve = pCurve->next()) {
+			iMemorySize += sizeof(qtractorCurve)
+				+ pCurve->nodes().count() * sizeof(qtractorCurve::Node);
+		}
+	}
+
+	return iMemorySize;
+}
+
+
 // Track command methods.
 bool qtractorTrackCommand::addTrack (void)
 {
@@ -675,6 +706,20 @@ qtractorImportTrackCommand::~qtractorImportTrackCommand (void)
 }
 
 
+// Approximate memory held by this command.
+unsigned long qtractorImportTrackCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize()
+		+ sizeof(*this) - sizeof(qtractorCommand);
+
+	QListIterator<qtractorAddTrackCommand *> iter(m_trackCommands);
+	while (iter.hasNext())
+		iMemorySize += iter.next()->memorySize();
+
+	return iMemorySize;
+}
+
+
 // Track-import list methods.
 void qtractorImportTrackCommand::addTrack ( qtractorTrack *pTrack )
 {
@@ -57,6 +57,9 @@ public:
 	// After/previous track accessor.
 	qtractorTrack *afterTrack() const { return m_pAfterTrack; }
 
+	// Approximate memory held by this command (bytes).
+	unsigned long memorySize() const;
+
 protected:
 
 	// Extra track list item.
@@ -211,6 +214,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory held by this command (bytes).
+	unsigned long memorySize() const;
+
 private:
 
 	// Instance variables.
@@ -83,6 +83,68 @@
 #define QTRACTOR_SYNC_VIEW_HOLD 46
 
 
+//----------------------------------------------------------------------------
+// Track view tile cache signature helpers.
+
+// Time-scale grid signature (tempo-map and snap modes).
+static uint qtractorTrackView_gridStamp (
+	qtractorSession *pSession, bool bSnapGrid, bool bSnapZebra )
+{
+	uint h = (bSnapGrid ? 1 : 0) | (bSnapZebra ? 2 : 0);
+	h = uint(qHash(pSession->soloTracks(), h));
+
+	qtractorTimeScale *pTimeScale = pSession->timeScale();
+	if (pTimeScale == nullptr)
+		return h;
+
+	h = uint(qHash(pTimeScale->horizontalZoom(), h));
+	h = uint(qHash(pTimeScale->pixelsPerBeat(), h));
+
+	qtractorTimeScale::Node *pNode = pTimeScale->nodes().first();
+	while (pNode) {
+		h = uint(qHash(pNode->frame, h));
+		h = uint(qHash(pNode->tempo, h));
+		h = uint(qHash(pNode->beatsPerBar, h));
+		h = uint(qHash(pNode->beatDivisor, h));
+		pNode = pNode->next();
+	}
+
+	return h;
+}
+
+
+// Track contents signature (clip geometry and contents serial).
+static uint qtractorTrackView_trackStamp (
+	qtractorSession *pSession, qtractorTrack *pTrack )
+{
+	uint h = (pTrack == pSession->tracks().first() ? 1 : 0)
+		| (pTrack->isMute() ? 2 : 0)
+		| (pTrack->isSolo() ? 4 : 0)
+		| (pTrack->isClipRecordEx() ? 8 : 0);
+	h = uint(qHash(pTrack->background().rgba(), h));
+	h = uint(qHash(pTrack->foreground().rgba(), h));
+	h = uint(qHash(pTrack->clipRecord(), h));
+
+	qtractorClip *pClip = pTrack->clips().first();
+	while (pClip) {
+		h = uint(qHash(pClip, h));
+		h = uint(qHash(pClip->clipStart(), h));
+		h = uint(qHash(pClip->clipLength(), h));
+		h = uint(qHash(pClip->clipOffset(), h));
+		h = uint(qHash(pClip->clipGain(), h));
+		h = uint(qHash(pClip->clipName(), h));
+		h = uint(qHash(pClip->fadeInLength(), h));
+		h = uint(qHash(pClip->fadeOutLength(), h));
+		h = uint(qHash(int(pClip->fadeInType()), h));
+		h = uint(qHash(int(pClip->fadeOutType()), h));
+		h = uint(qHash(pClip->serial(), h));
+		pClip = pClip->next();
+	}
+
+	return h;
+}
+
+
 //----------------------------------------------------------------------------
 // qtractorTrackView::ClipBoard - Local clipaboard singleton.
 
@@ -105,6 +167,12 @@ qtractorTrackView::qtractorTrackView ( qtractorTracks *pTracks,
 	m_pSessionCursor = nullptr;
 	m_pRubberBand    = nullptr;
 
+	m_iTileZoom     = 0;
+	m_iTileGridStamp = 0;
+	m_pTileCursor   = nullptr;
+	m_bTileScroll   = false;
+	m_bTilePrefetch = false;
+
 	m_selectMode = SelectClip;
 
 	m_bDropSpan  = true;
@@ -237,6 +305,12 @@ void qtractorTrackView::clear (void)
 		delete m_pSessionCursor;
 	m_pSessionCursor = nullptr;
 
+	if (m_pTileCursor)
+		delete m_pTileCursor;
+	m_pTileCursor = nullptr;
+
+	clearTiles();
+
 	if (m_pRubberBand)
 		delete m_pRubberBand;
 	m_pRubberBand = nullptr;
@@ -359,6 +433,9 @@ void qtractorTrackView::updateContentsWidth ( int iContentsWidth )
 // Local rectangular contents update.
 void qtractorTrackView::updateContents ( const QRect& rect )
 {
+	if (!m_bTileScroll)
+		clearTiles(rect);
+
 	updatePixmap(
 		qtractorScrollView::contentsX(), qtractorScrollView::contentsY());
 
@@ -366,9 +443,12 @@ void qtractorTrackView::updateContents ( const QRect& rect )
 }
 
 
-// Overall contents update.
+// Overall contents update (re-renders changed tracks only).
 void qtractorTrackView::updateContents (void)
 {
+	if (!m_bTileScroll)
+		updateTiles();
+
 	updatePixmap(
 		qtractorScrollView::contentsX(), qtractorScrollView::contentsY());
 
@@ -376,6 +456,24 @@ void qtractorTrackView::updateContents (void)
 }
 
 
+// Overall contents update, dropping all cached tiles.
+void qtractorTrackView::refreshContents (void)
+{
+	clearTiles();
+
+	updateContents();
+}
+
+
+// Scroll area updater (reuses cached tiles).
+void qtractorTrackView::scrollContentsBy ( int dx, int dy )
+{
+	m_bTileScroll = true;
+	qtractorScrollView::scrollContentsBy(dx, dy);
+	m_bTileScroll = false;
+}
+
+
 // Special recording visual feedback.
 void qtractorTrackView::updateContentsRecord (void)
 {
@@ -457,7 +555,7 @@ void qtractorTrackView::drawContents ( QPainter *pPainter, const QRect& rect )
 				pPainter->setPen(bg.darker());
 				pPainter->setBrush(bg);
 				pPainter->drawRect(rectClip);
-				pClip->draw(pPainter, rectClip, offset);
+				pClip->draw(pPainter, rectClip, offset, m_drawBuffer);
 				pPainter->restore();
 			}
 		}
@@ -623,8 +721,8 @@ void qtractorTrackView::drawContents ( QPainter *pPainter, const QRect& rect )
 								= QRect(x, y1 - cy + 1, w, h).intersected(trackRect);
 							if (!headRect.isEmpty()) {
 								const QBrush brush(pPainter->brush());
-								pClipRecord->drawClipRecord(
-									pPainter, headRect, iHeadOffset);
+								pClipRecord->drawClipRecord(pPainter,
+									headRect, iHeadOffset, m_drawBuffer);
 								pPainter->setBrush(brush);
 							}
 							if (iPlayHead < iFrameTime)
@@ -645,8 +743,8 @@ void qtractorTrackView::drawContents ( QPainter *pPainter, const QRect& rect )
 						const QRect& clipRect
 							= QRect(x, y1 - cy + 1, w, h).intersected(trackRect);
 						if (!clipRect.isEmpty())
-							pClipRecord->drawClipRecord(
-								pPainter, clipRect, iClipOffset);
+							pClipRecord->drawClipRecord(pPainter,
+								clipRect, iClipOffset, m_drawBuffer);
 					}
 				}
 				pTrack = pTrack->next();
@@ -910,6 +1008,14 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 	if (pTimeScale == nullptr)
 		return;
 
+	// Any zoom level change invalidates all cached tiles...
+	const unsigned int iTileZoom = (pTimeScale->horizontalZoom() << 16)
+		| pTimeScale->pixelsPerBeat();
+	if (m_iTileZoom != iTileZoom) {
+		m_iTileZoom = iTileZoom;
+		clearTiles();
+	}
+
 	QPainter painter(&m_pixmap);
 //	painter.initFrom(this);
 	painter.setFont(qtractorScrollView::font());
@@ -917,7 +1023,6 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 	// Update view session cursor location,
 	// so that we'll start drawing clips from there...
 	const unsigned long iTrackStart = pTimeScale->frameFromPixel(cx);
-	const unsigned long iTrackEnd   = iTrackStart + pTimeScale->frameFromPixel(w);
 	// Create cursor now if applicable...
 	if (m_pSessionCursor == nullptr) {
 		m_pSessionCursor = pSession->createSessionCursor(iTrackStart);
@@ -925,45 +1030,14 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 		m_pSessionCursor->seek(iTrackStart);
 	}
 
-	const QColor& rgbLight = pal.midlight().color();
-	const QColor& rgbDark  = rgbMid.darker(120);
+	// Visible tile columns...
+	const int iTile1 = cx / TileWidth;
+	const int iTile2 = (cx + w) / TileWidth;
 
-	// Draw vertical grid lines...
-	if (m_bSnapGrid || m_bSnapZebra) {
-		const QBrush zebra(QColor(0, 0, 0, 20));
-		qtractorTimeScale::Cursor cursor(pTimeScale);
-		qtractorTimeScale::Node *pNode = cursor.seekPixel(cx);
-		unsigned short iPixelsPerBeat = pNode->pixelsPerBeat();
-		unsigned int iBeat = pNode->beatFromPixel(cx);
-		if (iBeat > 0) pNode = cursor.seekBeat(--iBeat);
-		unsigned short iBar = pNode->barFromBeat(iBeat);
-		int x = pNode->pixelFromBeat(iBeat) - cx;
-		int x2 = x;
-		while (x < w) {
-			bool bBeatIsBar = pNode->beatIsBar(iBeat);
-			if (bBeatIsBar) {
-				if (m_bSnapGrid) {
-					painter.setPen(rgbLight);
-					painter.drawLine(x, 0, x, h);
-				}
-				if (m_bSnapZebra && (x > x2) && (++iBar & 1))
-					painter.fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
-				x2 = x;
-				if (iBeat == pNode->beat)
-					iPixelsPerBeat = pNode->pixelsPerBeat();
-			}
-			if (m_bSnapGrid && (bBeatIsBar || iPixelsPerBeat > 16)) {
-				painter.setPen(rgbDark);
-				painter.drawLine(x - 1, 0, x - 1, h);
-			}
-			pNode = cursor.seekBeat(++iBeat);
-			x = pNode->pixelFromBeat(iBeat) - cx;
-		}
-		if (m_bSnapZebra && (x > x2) && (++iBar & 1))
-			painter.fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
-	}
+	// Tile clips get drawn from the leftmost column on...
+	seekTiles(iTile1);
 
-	// Draw track and horizontal lines...
+	// Blit track tiles (render only newly exposed ones)...
 	int y1, y2;
 	y1 = y2 = 0;
 	int iTrack = 0;
@@ -972,22 +1046,26 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 		y1  = y2;
 		y2 += pTrack->zoomHeight();
 		if (y2 > cy) {
-			// Dispatch to paint this track...
-			if (y1 > cy) {
-				painter.setPen(rgbLight);
-				painter.drawLine(0, y1 - cy, w, y1 - cy);
+			qtractorClip *pClip = m_pTileCursor->clip(iTrack);
+			for (int iTile = iTile1; iTile <= iTile2; ++iTile) {
+				painter.drawPixmap(iTile * TileWidth - cx, y1 - cy,
+					trackTile(pTrack, iTile, y2 - y1, pClip));
 			}
-			const QRect trackRect(0, y1 - cy + 1, w, y2 - y1 - 2);
-		//	painter.fillRect(trackRect, rgbMid);
-			pTrack->drawTrack(&painter, trackRect, iTrackStart, iTrackEnd,
-				m_pSessionCursor->clip(iTrack));
-			painter.setPen(rgbDark);
-			painter.drawLine(0, y2 - cy - 1, w, y2 - cy - 1);
 		}
 		pTrack = pTrack->next();
 		++iTrack;
 	}
 
+	// Keep the cache within bounds...
+	if (m_tiles.count() > TileCacheMax)
+		trimTiles(iTile1 - 2, iTile2 + 2);
+
+	// Pre-render neighbouring tiles, when idle...
+	if (!m_bTilePrefetch) {
+		m_bTilePrefetch = true;
+		QTimer::singleShot(0, this, SLOT(prefetchTilesSlot()));
+	}
+
 	// Fill the empty area...
 	if (y2 < cy + h) {
 		painter.setPen(rgbMid);
@@ -1052,6 +1130,261 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 }
 
 
+// Draw the time-scale grid (beat/bar lines and zebra).
+void qtractorTrackView::drawGrid (
+	QPainter *pPainter, int cx, int w, int h ) const
+{
+	if (!m_bSnapGrid && !m_bSnapZebra)
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr)
+		return;
+
+	qtractorTimeScale *pTimeScale = pSession->timeScale();
+	if (pTimeScale == nullptr)
+		return;
+
+	const QPalette& pal = qtractorScrollView::palette();
+	const QColor& rgbLight = pal.midlight().color();
+	const QColor& rgbDark  = pal.mid().color().darker(120);
+
+	// Draw vertical grid lines...
+	const QBrush zebra(QColor(0, 0, 0, 20));
+	qtractorTimeScale::Cursor cursor(pTimeScale);
+	qtractorTimeScale::Node *pNode = cursor.seekPixel(cx);
+	unsigned short iPixelsPerBeat = pNode->pixelsPerBeat();
+	unsigned int iBeat = pNode->beatFromPixel(cx);
+	if (iBeat > 0) pNode = cursor.seekBeat(--iBeat);
+	unsigned short iBar = pNode->barFromBeat(iBeat);
+	int x = pNode->pixelFromBeat(iBeat) - cx;
+	int x2 = x;
+	while (x < w) {
+		bool bBeatIsBar = pNode->beatIsBar(iBeat);
+		if (bBeatIsBar) {
+			if (m_bSnapGrid) {
+				pPainter->setPen(rgbLight);
+				pPainter->drawLine(x, 0, x, h);
+			}
+			if (m_bSnapZebra && (x > x2) && (++iBar & 1))
+				pPainter->fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
+			x2 = x;
+			if (iBeat == pNode->beat)
+				iPixelsPerBeat = pNode->pixelsPerBeat();
+		}
+		if (m_bSnapGrid && (bBeatIsBar || iPixelsPerBeat > 16)) {
+			pPainter->setPen(rgbDark);
+			pPainter->drawLine(x - 1, 0, x - 1, h);
+		}
+		pNode = cursor.seekBeat(++iBeat);
+		x = pNode->pixelFromBeat(iBeat) - cx;
+	}
+	if (m_bSnapZebra && (x > x2) && (++iBar & 1))
+		pPainter->fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
+}
+
+
+// Track view tile cache: get (or render) a track tile,
+// drawing its clips from the given (cursor) clip on.
+const QPixmap& qtractorTrackView::trackTile (
+	qtractorTrack *pTrack, int iTile, int h, qtractorClip *pClip )
+{
+	const TileKey key(pTrack, iTile);
+	QHash<TileKey, QPixmap>::Iterator iter = m_tiles.find(key);
+	if (iter != m_tiles.end() && iter.value().height() == h)
+		return iter.value();
+
+	const QPalette& pal = qtractorScrollView::palette();
+	const QColor& rgbMid = pal.mid().color();
+
+	QPixmap tile(TileWidth, h);
+	tile.fill(rgbMid);
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession) {
+		QPainter painter(&tile);
+		painter.setFont(qtractorScrollView::font());
+		const int cx = iTile * TileWidth;
+		drawGrid(&painter, cx, TileWidth, h);
+		// Track separator lines...
+		if (pTrack != pSession->tracks().first()) {
+			painter.setPen(pal.midlight().color());
+			painter.drawLine(0, 0, TileWidth, 0);
+		}
+		painter.setPen(rgbMid.darker(120));
+		painter.drawLine(0, h - 1, TileWidth, h - 1);
+		// Draw clips over a slightly larger (clipped) extent,
+		// so that no clip frame edges show up on tile seams...
+		const int x0 = (cx > TileMargin ? cx - TileMargin : 0);
+		const int w0 = cx + TileWidth + TileMargin - x0;
+		const unsigned long iTrackStart = pSession->frameFromPixel(x0);
+		const unsigned long iTrackEnd = pSession->frameFromPixel(x0 + w0);
+		painter.setClipRect(0, 1, TileWidth, h - 2);
+		painter.translate(x0 - cx, 0);
+		pTrack->drawTrack(&painter, QRect(0, 1, w0, h - 2),
+			iTrackStart, iTrackEnd, m_drawBuffer, pClip);
+	}
+
+	return m_tiles.insert(key, tile).value();
+}
+
+
+// Track view tile cache: seek the tile clip cursor
+// to the leftmost (margin included) tile column.
+void qtractorTrackView::seekTiles ( int iTile )
+{
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr)
+		return;
+
+	const int x0 = iTile * TileWidth - TileMargin;
+	const unsigned long iFrame = pSession->frameFromPixel(x0 > 0 ? x0 : 0);
+	if (m_pTileCursor == nullptr) {
+		m_pTileCursor = pSession->createSessionCursor(iFrame);
+	} else {
+		m_pTileCursor->seek(iFrame);
+	}
+}
+
+
+// Track view tile cache: invalidate changed tracks only,
+// as told by their current contents signatures...
+void qtractorTrackView::updateTiles (void)
+{
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr)
+		return;
+
+	// Any grid (time-scale/tempo-map) change invalidates all...
+	const uint iGridStamp = qtractorTrackView_gridStamp(
+		pSession, m_bSnapGrid, m_bSnapZebra);
+	if (m_iTileGridStamp != iGridStamp) {
+		m_iTileGridStamp = iGridStamp;
+		clearTiles();
+	}
+
+	QHash<qtractorTrack *, uint> stamps;
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack) {
+		const uint iStamp = qtractorTrackView_trackStamp(pSession, pTrack);
+		QHash<qtractorTrack *, uint>::ConstIterator iter
+			= m_tileStamps.constFind(pTrack);
+		if (iter == m_tileStamps.constEnd() || iter.value() != iStamp)
+			clearTiles(pTrack);
+		stamps.insert(pTrack, iStamp);
+		pTrack = pTrack->next();
+	}
+
+	// Tracks gone missing (eg. removed) drop their tiles as well...
+	QHash<qtractorTrack *, uint>::ConstIterator iter
+		= m_tileStamps.constBegin();
+	const QHash<qtractorTrack *, uint>::ConstIterator& iter_end
+		= m_tileStamps.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		if (!stamps.contains(iter.key()))
+			clearTiles(iter.key());
+	}
+
+	m_tileStamps = stamps;
+}
+
+
+// Track view tile cache: invalidate all tiles.
+void qtractorTrackView::clearTiles (void)
+{
+	m_tiles.clear();
+}
+
+
+// Track view tile cache: invalidate tiles over a contents rectangle
+// (only those of the tracks overlapping it vertically).
+void qtractorTrackView::clearTiles ( const QRect& rect )
+{
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr)
+		return;
+
+	const int iTile1 = rect.left() / TileWidth;
+	const int iTile2 = rect.right() / TileWidth;
+
+	int y1, y2;
+	y1 = y2 = 0;
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack && y2 <= rect.bottom()) {
+		y1  = y2;
+		y2 += pTrack->zoomHeight();
+		if (y2 > rect.top()) {
+			for (int iTile = iTile1; iTile <= iTile2; ++iTile)
+				m_tiles.remove(TileKey(pTrack, iTile));
+		}
+		pTrack = pTrack->next();
+	}
+}
+
+
+// Track view tile cache: invalidate all tiles of a track.
+void qtractorTrackView::clearTiles ( qtractorTrack *pTrack )
+{
+	QMutableHashIterator<TileKey, QPixmap> iter(m_tiles);
+	while (iter.hasNext()) {
+		if (iter.next().key().first == pTrack)
+			iter.remove();
+	}
+}
+
+
+// Track view tile cache: drop tiles out of given column range.
+void qtractorTrackView::trimTiles ( int iTile1, int iTile2 )
+{
+	QMutableHashIterator<TileKey, QPixmap> iter(m_tiles);
+	while (iter.hasNext()) {
+		const int iTile = iter.next().key().second;
+		if (iTile < iTile1 || iTile > iTile2)
+			iter.remove();
+	}
+}
+
+
+// Track view tile cache idle pre-rendering.
+void qtractorTrackView::prefetchTilesSlot (void)
+{
+	m_bTilePrefetch = false;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == nullptr)
+		return;
+
+	QWidget *pViewport = qtractorScrollView::viewport();
+	const int cx = qtractorScrollView::contentsX();
+	const int cy = qtractorScrollView::contentsY();
+	const int w = pViewport->width();
+	const int h = pViewport->height();
+
+	// Next (or previous) tile columns, just out of sight...
+	const int iTile1 = cx / TileWidth - 1;
+	const int iTile2 = (cx + w) / TileWidth + 1;
+
+	seekTiles(iTile1 > 0 ? iTile1 : 0);
+
+	int y1, y2;
+	y1 = y2 = 0;
+	int iTrack = 0;
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack && y2 < cy + h) {
+		y1  = y2;
+		y2 += pTrack->zoomHeight();
+		if (y2 > cy) {
+			qtractorClip *pClip = m_pTileCursor->clip(iTrack);
+			if (iTile1 >= 0)
+				trackTile(pTrack, iTile1, y2 - y1, pClip);
+			trackTile(pTrack, iTile2, y2 - y1, pClip);
+		}
+		pTrack = pTrack->next();
+		++iTrack;
+	}
+}
+
+
 // To have track view in v-sync with track list.
 void qtractorTrackView::contentsYMovingSlot ( int /*cx*/, int cy )
 {
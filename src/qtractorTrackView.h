@@ -25,11 +25,13 @@
 #include "qtractorScrollView.h"
 #include "qtractorRubberBand.h"
 
-#include "qtractorTrack.h"
+#include "qtractorClip.h"
 #include "qtractorCurve.h"
 
 #include <QPixmap>
 #include <QBrush>
+#include <QHash>
+#include <QPair>
 
 
 // Forward declarations.
@@ -83,6 +85,9 @@ public:
 	void updateContents(const QRect& rect);
 	void updateContents();
 
+	// Overall contents update, dropping all cached tiles.
+	void refreshContents();
+
 	// Special recording visual feedback.
 	void updateContentsRecord();
 
@@ -263,9 +268,25 @@ protected:
 	// Resize event handler.
 	void resizeEvent(QResizeEvent *pResizeEvent);
 
+	// Scroll area updater (reuses cached tiles).
+	void scrollContentsBy(int dx, int dy);
+
 	// Draw the track view
 	void drawContents(QPainter *pPainter, const QRect& rect);
 
+	// Draw the time-scale grid (beat/bar lines and zebra).
+	void drawGrid(QPainter *pPainter, int cx, int w, int h) const;
+
+	// Track view tile cache methods.
+	const QPixmap& trackTile(qtractorTrack *pTrack,
+		int iTile, int h, qtractorClip *pClip);
+	void seekTiles(int iTile);
+	void updateTiles();
+	void clearTiles();
+	void clearTiles(const QRect& rect);
+	void clearTiles(qtractorTrack *pTrack);
+	void trimTiles(int iTile1, int iTile2);
+
 	// Track view state info.
 	struct TrackViewInfo
 	{
@@ -416,6 +437,9 @@ protected slots:
 	// (Re)create the complete track view pixmap.
 	void updatePixmap(int cx, int cy);
 
+	// Track view tile cache idle pre-rendering.
+	void prefetchTilesSlot();
+
 	// Drag-reset timer slot.
 	void dragTimeout();
 
@@ -438,6 +462,27 @@ private:
 	// Local double-buffering pixmap.
 	QPixmap m_pixmap;
 
+	// Track view tile cache (per track and tile column),
+	// valid while zoom level and contents stay the same.
+	enum { TileWidth = 256, TileMargin = 4, TileCacheMax = 1024 };
+
+	typedef QPair<qtractorTrack *, int> TileKey;
+	QHash<TileKey, QPixmap> m_tiles;
+	unsigned int m_iTileZoom;
+
+	// Tile contents signatures (per track and overall grid).
+	QHash<qtractorTrack *, uint> m_tileStamps;
+	uint m_iTileGridStamp;
+
+	// Tile clip drawing cursor (leftmost tile column).
+	qtractorSessionCursor *m_pTileCursor;
+
+	bool m_bTileScroll;
+	bool m_bTilePrefetch;
+
+	// Clip paint scratch buffers.
+	qtractorClipDrawBuffer m_drawBuffer;
+
 	// To maintain the current track/clip positioning.
 	qtractorSessionCursor *m_pSessionCursor;
 
@@ -1863,6 +1863,9 @@ bool qtractorTracks::crossFadeClip ( qtractorClip *pClip )
 	const unsigned long iClipStart = pClip->clipStart();
 	const unsigned long iClipEnd = iClipStart + pClip->clipLength();
 
+	// Audio cross-fades are equal-power (constant loudness)...
+	const bool bEqualPower = (pTrack->trackType() == qtractorTrack::Audio);
+
 	qtractorClip *pClip2 = pTrack->clips().first();
 
 	while (pClip2 && pClip2->clipStart() < iClipEnd) {
@@ -1871,25 +1874,37 @@ bool qtractorTracks::crossFadeClip ( qtractorClip *pClip )
 		const unsigned long iClipEnd2 = iClipStart2 + pClip2->clipLength();
 		if (iClipEnd2 > iClipStart && iClipStart > iClipStart2) {
 			const unsigned long iCrossFadeLength = iClipEnd2 - iClipStart;
-			if (pClip2->fadeOutLength() != iCrossFadeLength) {
+			const qtractorClip::FadeType fadeOutType = (bEqualPower
+				? qtractorClip::EqualPower : pClip2->fadeOutType());
+			const qtractorClip::FadeType fadeInType = (bEqualPower
+				? qtractorClip::EqualPower : pClip->fadeInType());
+			if (pClip2->fadeOutLength() != iCrossFadeLength
+				|| pClip2->fadeOutType() != fadeOutType) {
 				pClipCommand->fadeOutClip(pClip2,
-					iCrossFadeLength, pClip2->fadeOutType());
+					iCrossFadeLength, fadeOutType);
 			}
-			if (pClip->fadeInLength() != iCrossFadeLength) {
+			if (pClip->fadeInLength() != iCrossFadeLength
+				|| pClip->fadeInType() != fadeInType) {
 				pClipCommand->fadeInClip(pClip,
-					iCrossFadeLength, pClip->fadeInType());
+					iCrossFadeLength, fadeInType);
 			}
 		}
 		else
 		if (iClipStart2 < iClipEnd && iClipEnd < iClipEnd2) {
 			const unsigned long iCrossFadeLength = iClipEnd - iClipStart2;
-			if (pClip->fadeOutLength() != iCrossFadeLength) {
+			const qtractorClip::FadeType fadeOutType = (bEqualPower
+				? qtractorClip::EqualPower : pClip->fadeOutType());
+			const qtractorClip::FadeType fadeInType = (bEqualPower
+				? qtractorClip::EqualPower : pClip2->fadeInType());
+			if (pClip->fadeOutLength() != iCrossFadeLength
+				|| pClip->fadeOutType() != fadeOutType) {
 				pClipCommand->fadeOutClip(pClip,
-					iCrossFadeLength, pClip->fadeOutType());
+					iCrossFadeLength, fadeOutType);
 			}
-			if (pClip2->fadeInLength() != iCrossFadeLength) {
+			if (pClip2->fadeInLength() != iCrossFadeLength
+				|| pClip2->fadeInType() != fadeInType) {
 				pClipCommand->fadeInClip(pClip2,
-					iCrossFadeLength, pClip2->fadeInType());
+					iCrossFadeLength, fadeInType);
 			}
 		}
 		// Move forward...
@@ -29,6 +29,7 @@
 #include "qtractorSessionCursor.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorMidiManager.h"
+#include "qtractorRtAudit.h"
 
 #include "pluginterfaces/vst/ivsthostapplication.h"
 #include "pluginterfaces/vst/ivstpluginterfacesupport.h"
@@ -3139,6 +3140,45 @@ void qtractorVst3Plugin::updateParam (
 }
 
 
+// Staged parameter change specifics (non real-time).
+void qtractorVst3Plugin::updateStagedParam (
+	qtractorPlugin::Param *pParam, float fValue )
+{
+	qtractorVst3PluginType *pType
+		= static_cast<qtractorVst3PluginType *> (type());
+	if (pType == nullptr)
+		return;
+
+	Vst::IEditController *controller = pType->impl()->controller();
+	if (!controller)
+		return;
+
+	Param *pVst3Param = static_cast<Param *> (pParam);
+	if (pVst3Param == nullptr)
+		return;
+	if (pVst3Param->impl() == nullptr)
+		return;
+
+	const Vst::ParamID id = pVst3Param->impl()->paramInfo().id;
+	controller->setParamNormalized(id, Vst::ParamValue(fValue));
+}
+
+
+// Staged parameter change specifics (real-time).
+void qtractorVst3Plugin::applyStagedParam (
+	qtractorPlugin::Param *pParam, float fValue )
+{
+	Param *pVst3Param = static_cast<Param *> (pParam);
+	if (pVst3Param == nullptr)
+		return;
+	if (pVst3Param->impl() == nullptr)
+		return;
+
+	const Vst::ParamID id = pVst3Param->impl()->paramInfo().id;
+	m_pImpl->setParameter(id, Vst::ParamValue(fValue), 0);
+}
+
+
 // All parameters update method.
 void qtractorVst3Plugin::updateParamValues ( bool bUpdate )
 {
@@ -3381,6 +3421,8 @@ void qtractorVst3Plugin::process_midi_in (
 	unsigned char *data, unsigned int size,
 	unsigned long offset, unsigned short port )
 {
+	QTRACTOR_RT_AUDIT_SCOPE("qtractorVst3Plugin::process_midi_in");
+
 	m_pImpl->process_midi_in(data, size, offset, port);
 }
 
@@ -106,6 +106,12 @@ public:
 	// Parameter update methods.
 	void updateParam(qtractorPlugin::Param *pParam, float fValue, bool bUpdate);
 
+	// Staged parameter change specifics: the controller gets
+	// updated on hand over, the processor input parameter
+	// queue only on the real-time side, right before process.
+	void updateStagedParam(qtractorPlugin::Param *pParam, float fValue);
+	void applyStagedParam(qtractorPlugin::Param *pParam, float fValue);
+
 	// Parameters update method.
 	void updateParamValues(bool bUpdate);
 
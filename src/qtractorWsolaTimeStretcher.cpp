@@ -119,9 +119,96 @@ static inline float sse_cross_corr (
 	return (pvCorr[0] + pvCorr[1] + pvCorr[2] + pvCorr[3]) / ::sqrtf(fNorm);
 }
 
+
+// SSE enabled version (dot-product only; norm is tracked by caller).
+static inline float sse_dot_prod (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	__m128 vCorr0, vCorr1, *pVec2;
+
+	const unsigned int iBlocks = (iOverlapLength >> 4);
+
+	// Two independent accumulators to hide the add latency.
+	pVec2 = (__m128 *) pV2;
+	vCorr0 = _mm_setzero_ps();
+	vCorr1 = _mm_setzero_ps();
+
+	for (unsigned int i = 0; i < iBlocks; ++i) {
+		vCorr0 = _mm_add_ps(vCorr0, _mm_mul_ps(_mm_loadu_ps(pV1), pVec2[0]));
+		vCorr1 = _mm_add_ps(vCorr1, _mm_mul_ps(_mm_loadu_ps(pV1 + 4), pVec2[1]));
+		vCorr0 = _mm_add_ps(vCorr0, _mm_mul_ps(_mm_loadu_ps(pV1 + 8), pVec2[2]));
+		vCorr1 = _mm_add_ps(vCorr1, _mm_mul_ps(_mm_loadu_ps(pV1 + 12), pVec2[3]));
+		pV1 += 16;
+		pVec2 += 4;
+	}
+
+	// Overlap length is only divisible by 8: the last 8 frames
+	// must be accounted too, as the running norm covers them all.
+	if (iOverlapLength & 8) {
+		vCorr0 = _mm_add_ps(vCorr0, _mm_mul_ps(_mm_loadu_ps(pV1), pVec2[0]));
+		vCorr1 = _mm_add_ps(vCorr1, _mm_mul_ps(_mm_loadu_ps(pV1 + 4), pVec2[1]));
+	}
+
+	vCorr0 = _mm_add_ps(vCorr0, vCorr1);
+
+	float *pvCorr = (float *) &vCorr0;
+	return (pvCorr[0] + pvCorr[1] + pvCorr[2] + pvCorr[3]);
+}
+
 #endif
 
 
+#if defined(__ARM_NEON__)
+
+#include "arm_neon.h"
+
+// NEON enabled versions.
+static inline float neon_cross_corr (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	float32x4_t vCorr = vdupq_n_f32(0.0f);
+	float32x4_t vNorm = vdupq_n_f32(0.0f);
+	float32x4_t vTemp;
+
+	// Overlap length is always divisible by 8.
+	for (unsigned int i = 0; i < iOverlapLength; i += 4) {
+		vTemp = vld1q_f32(pV1 + i);
+		vCorr = vmlaq_f32(vCorr, vTemp, vld1q_f32(pV2 + i));
+		vNorm = vmlaq_f32(vNorm, vTemp, vTemp);
+	}
+
+	float __attribute__ ((aligned (16))) fCorr[4];
+	float __attribute__ ((aligned (16))) fNorm[4];
+	vst1q_f32(fCorr, vCorr);
+	vst1q_f32(fNorm, vNorm);
+
+	float fNormSum = (fNorm[0] + fNorm[1] + fNorm[2] + fNorm[3]);
+
+	if (fNormSum < 1e-9f) fNormSum = 1.0f; // avoid div by zero
+
+	return (fCorr[0] + fCorr[1] + fCorr[2] + fCorr[3]) / ::sqrtf(fNormSum);
+}
+
+static inline float neon_dot_prod (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	float32x4_t vCorr0 = vdupq_n_f32(0.0f);
+	float32x4_t vCorr1 = vdupq_n_f32(0.0f);
+
+	for (unsigned int i = 0; i < iOverlapLength; i += 8) {
+		vCorr0 = vmlaq_f32(vCorr0, vld1q_f32(pV1 + i), vld1q_f32(pV2 + i));
+		vCorr1 = vmlaq_f32(vCorr1, vld1q_f32(pV1 + i + 4), vld1q_f32(pV2 + i + 4));
+	}
+
+	float __attribute__ ((aligned (16))) fCorr[4];
+	vst1q_f32(fCorr, vaddq_f32(vCorr0, vCorr1));
+
+	return (fCorr[0] + fCorr[1] + fCorr[2] + fCorr[3]);
+}
+
+#endif // __ARM_NEON__
+
+
 // Standard (slow) version.
 static inline float std_cross_corr (
 	const float *pV1, const float *pV2, unsigned int iOverlapLength )
@@ -140,6 +227,37 @@ static inline float std_cross_corr (
 }
 
 
+// Standard (slow) version (dot-product only).
+static inline float std_dot_prod (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	float fCorr = 0.0f;
+
+	for (unsigned int i = 0; i < iOverlapLength; ++i)
+		fCorr += pV1[i] * pV2[i];
+
+	return fCorr;
+}
+
+
+// Exact sum of squares, used to (re)start the running norm.
+static inline double std_sum_squares (
+	const float *pV1, unsigned int iOverlapLength )
+{
+	double fNorm = 0.0;
+
+	for (unsigned int i = 0; i < iOverlapLength; ++i)
+		fNorm += double(pV1[i]) * double(pV1[i]);
+
+	return fNorm;
+}
+
+
+// Running norm gets recomputed exactly every so many offsets,
+// keeping any accumulated round-off drift well under control.
+static const int c_iNormResync = 256;
+
+
 //---------------------------------------------------------------------------
 // qtractorWsolaTimeStretcher - Time-stretch (tempo change) effect for processed sound.
 //
@@ -162,12 +280,23 @@ qtractorWsolaTimeStretcher::qtractorWsolaTimeStretcher (
 
 	m_iOverlapLength = 0;
 
+	m_pNorms = nullptr;
+
+#if defined(__ARM_NEON__)
+	m_pfnCrossCorr = neon_cross_corr;
+	m_pfnDotProd = neon_dot_prod;
+#else
 #if defined(__SSE__)
-	if (sse_enabled())
+	if (sse_enabled()) {
 		m_pfnCrossCorr = sse_cross_corr;
-	else
+		m_pfnDotProd = sse_dot_prod;
+	} else
+#endif
+	{
+		m_pfnCrossCorr = std_cross_corr;
+		m_pfnDotProd = std_dot_prod;
+	}
 #endif
-	m_pfnCrossCorr = std_cross_corr;
 
 	setParameters(iSampleRate);
 }
@@ -185,6 +314,7 @@ qtractorWsolaTimeStretcher::~qtractorWsolaTimeStretcher (void)
 		delete [] m_ppRefMidBufferUnaligned;
 		delete [] m_ppRefMidBuffer;
 		delete [] m_ppFrames;
+		delete [] m_pNorms;
 	}
 }
 
@@ -389,14 +519,31 @@ unsigned int qtractorWsolaTimeStretcher::seekBestOverlapPosition (void)
 		}
 	} else {
 		// Linear search...
+		//
+		// Consecutive offsets share all but one frame of the
+		// overlap window, so the window energy (norm) is slid
+		// along incrementally and only the dot-product kernel
+		// is run per offset, saving about a third of the work.
+		const float *pInput;
 		iBestOffs = 0;
 		for (iOffs = 0; iOffs < (int) m_iSeekLength; ++iOffs) {
 			for (i = 0; i < m_iChannels; ++i) {
+				pInput = m_inputBuffer.ptrBegin(i) + iOffs;
+				// Update the running norm for this position.
+				if ((iOffs % c_iNormResync) == 0) {
+					m_pNorms[i] = std_sum_squares(pInput, m_iOverlapLength);
+				} else {
+					const double fHead = pInput[-1];
+					const double fTail = pInput[m_iOverlapLength - 1];
+					m_pNorms[i] += fTail * fTail - fHead * fHead;
+				}
+				float fNorm = float(m_pNorms[i]);
+				if (fNorm < 1e-9f) fNorm = 1.0f; // avoid div by zero
 				// Calculates correlation value for the mixing
 				// position corresponding to iOffs.
-				fCorr = (*m_pfnCrossCorr)(
-					m_inputBuffer.ptrBegin(i) + iOffs,
-					m_ppRefMidBuffer[i], m_iOverlapLength);
+				fCorr = (*m_pfnDotProd)(
+					pInput, m_ppRefMidBuffer[i], m_iOverlapLength)
+					/ ::sqrtf(fNorm);
 				// Checks for the highest correlation value.
 				if (fCorr > fBestCorr) {
 					fBestCorr = fCorr;
@@ -571,15 +718,17 @@ void qtractorWsolaTimeStretcher::calcOverlapLength (void)
 		unsigned short i;
 		if (m_ppFrames) {
 			for (i = 0; i < m_iChannels; ++i) {
-				delete [] m_ppMidBuffer;
-				delete [] m_ppRefMidBufferUnaligned;
+				delete [] m_ppMidBuffer[i];
+				delete [] m_ppRefMidBufferUnaligned[i];
 			}
 			delete [] m_ppMidBuffer;
 			delete [] m_ppRefMidBufferUnaligned;
 			delete [] m_ppRefMidBuffer;
 			delete [] m_ppFrames;
+			delete [] m_pNorms;
 		}
 		m_ppFrames = new float * [m_iChannels];
+		m_pNorms = new double [m_iChannels];
 		m_ppMidBuffer = new float * [m_iChannels];
 		m_ppRefMidBufferUnaligned = new float * [m_iChannels];
 		m_ppRefMidBuffer = new float * [m_iChannels];
@@ -280,6 +280,11 @@ private:
 
 	// Calculates the cross-correlation value over the overlap period.
 	float (*m_pfnCrossCorr)(const float *, const float *, unsigned int);
+
+	// Calculates the plain dot-product over the overlap period;
+	// used by linear search, along with per-channel running norms.
+	float (*m_pfnDotProd)(const float *, const float *, unsigned int);
+	double *m_pNorms;
 };
 
 
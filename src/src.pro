@@ -15,15 +15,20 @@ HEADERS += config.h \
 	qtractorAtomic.h \
 	qtractorActionControl.h \
 	qtractorAudioBuffer.h \
+	qtractorAudioCache.h \
 	qtractorAudioClip.h \
 	qtractorAudioConnect.h \
 	qtractorAudioEngine.h \
 	qtractorAudioFile.h \
 	qtractorAudioListView.h \
+	qtractorAudioLoudness.h \
 	qtractorAudioMadFile.h \
 	qtractorAudioMeter.h \
 	qtractorAudioMonitor.h \
 	qtractorAudioPeak.h \
+	qtractorAudioSeekIndex.h \
+	qtractorAudioStretch.h \
+	qtractorAudioTranscode.h \
 	qtractorAudioSndFile.h \
 	qtractorAudioVorbisFile.h \
 	qtractorClip.h \
@@ -39,6 +44,7 @@ HEADERS += config.h \
 	qtractorCurveFile.h \
 	qtractorCurveSelect.h \
 	qtractorDocument.h \
+	qtractorDspProfile.h \
 	qtractorDssiPlugin.h \
 	qtractorEngine.h \
 	qtractorEngineCommand.h \
@@ -68,6 +74,7 @@ HEADERS += config.h \
 	qtractorMidiEditor.h \
 	qtractorMidiEditCommand.h \
 	qtractorMidiEditEvent.h \
+	qtractorMidiEditIndex.h \
 	qtractorMidiEditList.h \
 	qtractorMidiEditSelect.h \
 	qtractorMidiEditTime.h \
@@ -99,16 +106,19 @@ HEADERS += config.h \
 	qtractorPluginListView.h \
 	qtractorPropertyCommand.h \
 	qtractorRingBuffer.h \
+	qtractorRtAudit.h \
 	qtractorRubberBand.h \
 	qtractorScrollView.h \
 	qtractorSession.h \
 	qtractorSessionCommand.h \
 	qtractorSessionCursor.h \
+	qtractorSessionJournal.h \
 	qtractorSpinBox.h \
 	qtractorThumbView.h \
 	qtractorTimeScale.h \
 	qtractorTimeScaleCommand.h \
 	qtractorTimeStretcher.h \
+	qtractorTrace.h \
 	qtractorTrack.h \
 	qtractorTrackButton.h \
 	qtractorTrackCommand.h \
@@ -148,15 +158,20 @@ SOURCES += \
 	qtractor.cpp \
 	qtractorActionControl.cpp \
 	qtractorAudioBuffer.cpp \
+	qtractorAudioCache.cpp \
 	qtractorAudioClip.cpp \
 	qtractorAudioConnect.cpp \
 	qtractorAudioEngine.cpp \
 	qtractorAudioFile.cpp \
 	qtractorAudioListView.cpp \
+	qtractorAudioLoudness.cpp \
 	qtractorAudioMadFile.cpp \
 	qtractorAudioMeter.cpp \
 	qtractorAudioMonitor.cpp \
 	qtractorAudioPeak.cpp \
+	qtractorAudioSeekIndex.cpp \
+	qtractorAudioStretch.cpp \
+	qtractorAudioTranscode.cpp \
 	qtractorAudioSndFile.cpp \
 	qtractorAudioVorbisFile.cpp \
 	qtractorClip.cpp \
@@ -167,6 +182,7 @@ SOURCES += \
 	qtractorConnect.cpp \
 	qtractorConnections.cpp \
 	qtractorDocument.cpp \
+	qtractorDspProfile.cpp \
 	qtractorCurve.cpp \
 	qtractorCurveCommand.cpp \
 	qtractorCurveFile.cpp \
@@ -198,6 +214,7 @@ SOURCES += \
 	qtractorMidiEditor.cpp \
 	qtractorMidiEditCommand.cpp \
 	qtractorMidiEditEvent.cpp \
+	qtractorMidiEditIndex.cpp \
 	qtractorMidiEditList.cpp \
 	qtractorMidiEditSelect.cpp \
 	qtractorMidiEditTime.cpp \
@@ -224,16 +241,19 @@ SOURCES += \
 	qtractorPluginFactory.cpp \
 	qtractorPluginCommand.cpp \
 	qtractorPluginListView.cpp \
+	qtractorRtAudit.cpp \
 	qtractorRubberBand.cpp \
 	qtractorScrollView.cpp \
 	qtractorSession.cpp \
 	qtractorSessionCommand.cpp \
 	qtractorSessionCursor.cpp \
+	qtractorSessionJournal.cpp \
 	qtractorSpinBox.cpp \
 	qtractorThumbView.cpp \
 	qtractorTimeScale.cpp \
 	qtractorTimeScaleCommand.cpp \
 	qtractorTimeStretcher.cpp \
+	qtractorTrace.cpp \
 	qtractorTrack.cpp \
 	qtractorTrackButton.cpp \
 	qtractorTrackCommand.cpp \